@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Lock-free single-producer/multi-consumer broadcast ring
+// Every consumer sees every record: each reader keeps its own cursor and the
+// producer never waits for anyone. A reader that falls N records behind
+// skips ahead to the oldest record still intact (the newest N - 1) and counts
+// the rest as lost. A copy the producer overwrote mid-read is detected and retried.
+// Capacity must be a power of two so indices can wrap with a mask.
+template <typename T, size_t N>
+class BroadcastRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "BroadcastRing capacity must be a power of two");
+
+public:
+    // Per-consumer read position
+    struct Cursor
+    {
+        uint32_t next; // Sequence number of the next record to read
+        uint32_t lost; // Records overwritten before this reader got to them
+    };
+
+private:
+    T buffer[N];
+    std::atomic<uint32_t> head; // Records written so far (owned by producer)
+
+    // A slot is stable while the producer is fewer than N records past it
+    bool stillValid(uint32_t sequence) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return head.load(std::memory_order_relaxed) - sequence < N;
+    }
+
+public:
+    BroadcastRing() : head(0) {}
+
+    // Producer side: never blocks, overwrites the oldest record
+    void push(const T &item)
+    {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        buffer[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // Consumer side: start reading at the next record written
+    Cursor subscribe() const { return Cursor{head.load(std::memory_order_acquire), 0}; }
+
+    // Consumer side: returns false when the reader has caught up
+    bool read(Cursor &cursor, T &item) const
+    {
+        while (true)
+        {
+            uint32_t h = head.load(std::memory_order_acquire);
+            if (cursor.next == h)
+                return false;
+            if (h - cursor.next >= N)
+            {
+                // Record h may be mid-write over the slot of h - N
+                cursor.lost += h - cursor.next - (N - 1);
+                cursor.next = h - (N - 1);
+            }
+            item = buffer[cursor.next & (N - 1)];
+            if (stillValid(cursor.next))
+            {
+                cursor.next++;
+                return true;
+            }
+        }
+    }
+
+    // Any consumer: copy the newest record without a cursor
+    bool latest(T &item) const
+    {
+        while (true)
+        {
+            uint32_t h = head.load(std::memory_order_acquire);
+            if (h == 0)
+                return false;
+            item = buffer[(h - 1) & (N - 1)];
+            if (stillValid(h - 1))
+                return true;
+        }
+    }
+
+    uint32_t written() const { return head.load(std::memory_order_acquire); }
+    static constexpr size_t capacity() { return N; }
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Lock-free multi-producer/single-consumer ring buffer (bounded, Vyukov style)
+// Producers on any task or core claim a slot with one compare-and-swap, fill it
+// in place and publish it through the slot's sequence number; they never wait
+// for each other or for the consumer. A producer preempted between claim and
+// publish only holds up the consumer at that slot until it resumes.
+// Capacity must be a power of two so indices can wrap with a mask.
+template <typename T, size_t N>
+class MpscQueue
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "MpscQueue capacity must be a power of two");
+
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence; // == position: free to claim, == position + 1: ready to read
+        T item;
+    };
+
+    Slot slots[N];
+    std::atomic<uint32_t> head; // Next position to claim (shared by producers)
+    uint32_t tail;              // Next position to read (owned by consumer)
+
+public:
+    MpscQueue() : head(0), tail(0)
+    {
+        for (uint32_t i = 0; i < N; i++)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Producer side: 'fill(T &)' writes the item in place. False when full.
+    template <typename Fill>
+    bool emplace(Fill fill)
+    {
+        uint32_t position = head.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true)
+        {
+            slot = &slots[position & (N - 1)];
+            int32_t diff = (int32_t)(slot->sequence.load(std::memory_order_acquire) - position);
+            if (diff == 0)
+            {
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false; // Consumer hasn't freed this slot yet
+            }
+            else
+            {
+                position = head.load(std::memory_order_relaxed); // Another producer took it
+            }
+        }
+        fill(slot->item);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(const T &item)
+    {
+        return emplace([&item](T &slot) { slot = item; });
+    }
+
+    // Consumer side: the oldest published item, or nullptr when there is none
+    // (or its producer hasn't published yet). Release it with pop() when done.
+    const T *front() const
+    {
+        const Slot &slot = slots[tail & (N - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1)
+            return nullptr;
+        return &slot.item;
+    }
+
+    void pop()
+    {
+        slots[tail & (N - 1)].sequence.store(tail + N, std::memory_order_release);
+        tail++;
+    }
+
+    bool pop(T &item)
+    {
+        const T *next = front();
+        if (!next)
+            return false;
+        item = *next;
+        pop();
+        return true;
+    }
+
+    static constexpr size_t capacity() { return N; }
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// Single-writer sequence lock for a small value
+// The writer makes the sequence odd, copies the value in and makes it even
+// again; it never waits for readers. Readers copy without locking and retry
+// when the sequence was odd or moved during the copy, so a torn copy is never
+// returned. A reader must not outrank the writer on the writer's core, or it
+// spins until the writer is scheduled again.
+template <typename T>
+class Seqlock
+{
+private:
+    T value;
+    std::atomic<uint32_t> sequence; // Odd while a write is in progress
+
+public:
+    Seqlock() : value(), sequence(0) {}
+
+    // Writer side: never blocks
+    void write(const T &item)
+    {
+        uint32_t s = sequence.load(std::memory_order_relaxed);
+        sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        value = item;
+        sequence.store(s + 2, std::memory_order_release);
+    }
+
+    // Any reader: copy of the last complete write; false before the first one
+    bool read(T &item) const
+    {
+        while (true)
+        {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1)
+                continue;
+            item = value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+                return before != 0;
+        }
+    }
+
+    // Writes completed so far
+    uint32_t written() const { return sequence.load(std::memory_order_acquire) / 2; }
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+
+// Lock-free single-producer/single-consumer ring buffer
+// One task (or ISR) may push and one other task (or ISR) may pop without locking.
+// Capacity must be a power of two so indices can wrap with a mask.
+template <typename T, size_t N>
+class SpscQueue
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+private:
+    T buffer[N];
+    std::atomic<size_t> head; // Next slot to write (owned by producer)
+    std::atomic<size_t> tail; // Next slot to read (owned by consumer)
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // Producer side: returns false when the queue is full. Always inlined, so a
+    // push from an IRAM ISR never calls into flash (it may run with the cache off).
+    __attribute__((always_inline)) inline bool push(const T &item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == N)
+        {
+            return false;
+        }
+        buffer[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: returns false when the queue is empty
+    bool pop(T &item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = buffer[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: look at the oldest item without removing it
+    bool peek(T &item) const
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = buffer[t & (N - 1)];
+        return true;
+    }
+
+    // Consumer side: drop everything currently queued
+    void clear() { tail.store(head.load(std::memory_order_acquire), std::memory_order_release); }
+
+    size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    bool isEmpty() const { return size() == 0; }
+    bool isFull() const { return size() == N; }
+    static constexpr size_t capacity() { return N; }
+};
@@ -0,0 +1,89 @@
+#ifndef TASK_CONFIG_H
+#define TASK_CONFIG_H
+#include <Arduino.h>
+
+// FreeRTOS task layout
+// The motor task has core 1 to itself: it runs motorController.update() in a
+// loop at a priority nothing else on that core reaches. The step timer ISR is
+// registered from setup() and fires there too. Everything else (WiFi, web
+// server, input, encoder sampling, TMC UART, logging) shares core 0.
+// Each value can be overridden with a build flag, e.g. -DMOTOR_TASK_PRIORITY=20.
+
+#define MOTOR_CORE 1
+#define SYSTEM_CORE 0
+
+// Motor task: one below the IPC task, which flash writes need to preempt it
+#ifndef MOTOR_TASK_PRIORITY
+#define MOTOR_TASK_PRIORITY (configMAX_PRIORITIES - 2)
+#endif
+#ifndef MOTOR_TASK_STACK
+#define MOTOR_TASK_STACK 8192
+#endif
+
+// Encoder sampling (2 kHz, woken by its esp_timer)
+#ifndef ENCODER_TASK_PRIORITY
+#define ENCODER_TASK_PRIORITY 3
+#endif
+#ifndef ENCODER_TASK_STACK
+#define ENCODER_TASK_STACK 3072
+#endif
+
+// Buttons, limit switches and the periodic encoder checks
+#ifndef INPUT_TASK_PRIORITY
+#define INPUT_TASK_PRIORITY 2
+#endif
+#ifndef INPUT_TASK_STACK
+#define INPUT_TASK_STACK 8192
+#endif
+
+// WebSocket, WiFi reconnection, broadcasts
+#ifndef WEB_SERVER_TASK_PRIORITY
+#define WEB_SERVER_TASK_PRIORITY 1
+#endif
+#ifndef WEB_SERVER_TASK_STACK
+#define WEB_SERVER_TASK_STACK 16384
+#endif
+
+// TMC2209 register flushes and status polls over UART
+#ifndef TMC_TASK_PRIORITY
+#define TMC_TASK_PRIORITY 1
+#endif
+#ifndef TMC_TASK_STACK
+#define TMC_TASK_STACK 3072
+#endif
+
+// Position snapshot NVS writes (keeps flash writes off the motor task)
+#ifndef POSITION_TASK_PRIORITY
+#define POSITION_TASK_PRIORITY 1
+#endif
+#ifndef POSITION_TASK_STACK
+#define POSITION_TASK_STACK 3072
+#endif
+
+// Log sink: formats queued LOG_* records, writes Serial and the debug WebSocket
+#ifndef LOG_TASK_PRIORITY
+#define LOG_TASK_PRIORITY 1
+#endif
+#ifndef LOG_TASK_STACK
+#define LOG_TASK_STACK 4096
+#endif
+
+// Benchmark reporter (-DTASK_BENCHMARK builds only)
+#ifndef BENCHMARK_TASK_PRIORITY
+#define BENCHMARK_TASK_PRIORITY 1
+#endif
+#ifndef BENCHMARK_TASK_STACK
+#define BENCHMARK_TASK_STACK 4096
+#endif
+
+// -DTASK_LAYOUT_LEGACY restores the previous layout for comparison: the motor
+// loop in loop() (core 1, priority 1) sharing core 1 with the web server task
+#ifdef TASK_LAYOUT_LEGACY
+#define WEB_SERVER_CORE MOTOR_CORE
+#define TASK_LAYOUT_NAME "legacy"
+#else
+#define WEB_SERVER_CORE SYSTEM_CORE
+#define TASK_LAYOUT_NAME "dedicated motor core"
+#endif
+
+#endif
@@ -0,0 +1,64 @@
+#include "TimingStats.h"
+#include <math.h>
+
+TimingStats::TimingStats()
+{
+    reset();
+}
+
+void TimingStats::reset()
+{
+    count = 0;
+    minimum = 0;
+    maximum = 0;
+    mean = 0;
+    m2 = 0;
+    for (uint8_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        histogram[i] = 0;
+    }
+}
+
+void TimingStats::add(int32_t sample)
+{
+    if (count == 0 || sample < minimum)
+        minimum = sample;
+    if (count == 0 || sample > maximum)
+        maximum = sample;
+
+    // Welford's online algorithm for mean and variance
+    count++;
+    double delta = sample - mean;
+    mean += delta / count;
+    m2 += delta * (sample - mean);
+
+    uint32_t magnitude = sample < 0 ? (uint32_t)(-(int64_t)sample) : (uint32_t)sample;
+    uint8_t bucket = 0;
+    while (magnitude && bucket < HISTOGRAM_BUCKETS - 1)
+    {
+        magnitude >>= 1;
+        bucket++;
+    }
+    histogram[bucket]++;
+}
+
+int32_t TimingStats::getMaxAbs() const
+{
+    int32_t lo = getMin() < 0 ? -getMin() : getMin();
+    int32_t hi = getMax() < 0 ? -getMax() : getMax();
+    return lo > hi ? lo : hi;
+}
+
+double TimingStats::getStdDev() const
+{
+    return count > 1 ? sqrt(m2 / (count - 1)) : 0;
+}
+
+uint32_t TimingStats::bucketLimit(uint8_t index)
+{
+    if (index == 0)
+        return 1;
+    if (index >= HISTOGRAM_BUCKETS - 1)
+        return UINT32_MAX;
+    return 1UL << index;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+
+// Running statistics for timing samples (jitter, latency, loop periods)
+// Keeps min/max/mean/stddev (Welford) plus a log2 histogram of absolute values.
+class TimingStats
+{
+public:
+    // Bucket 0 counts zero samples, bucket i counts |x| in [2^(i-1), 2^i),
+    // the last bucket collects everything larger.
+    static constexpr uint8_t HISTOGRAM_BUCKETS = 20;
+
+    TimingStats();
+
+    void reset();
+    void add(int32_t sample);
+
+    uint32_t getCount() const { return count; }
+    int32_t getMin() const { return count ? minimum : 0; }
+    int32_t getMax() const { return count ? maximum : 0; }
+    int32_t getMaxAbs() const;
+    double getMean() const { return mean; }
+    double getStdDev() const;
+    uint32_t getBucket(uint8_t index) const { return index < HISTOGRAM_BUCKETS ? histogram[index] : 0; }
+
+    // Upper bound (exclusive) of the given histogram bucket
+    static uint32_t bucketLimit(uint8_t index);
+
+private:
+    uint32_t count;
+    int32_t minimum;
+    int32_t maximum;
+    double mean;
+    double m2;
+    uint32_t histogram[HISTOGRAM_BUCKETS];
+};
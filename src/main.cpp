@@ -1,12 +1,20 @@
 #include <Arduino.h>
+#include <esp_timer.h>
 
 // Import our modules
 #include "util.h"
+#include "TaskConfig.h"
 #include "modules/Configuration/Configuration.h"
 #include "modules/MotorController/MotorController.h"
 #include "modules/LimitSwitch/LimitSwitch.h"
 #include "modules/ButtonController/ButtonController.h"
+#include "modules/InputScheduler/InputEvents.h"
 #include "modules/WebServer/WebServer.h"
+#ifdef TASK_BENCHMARK
+#include "modules/TaskBenchmark/TaskBenchmark.h"
+#endif
+
+static constexpr LogModule logModule = LogModule::System;
 
 /*
  * LilyGo Motion Controller
@@ -21,6 +29,9 @@
  * - Configuration persistence via ESP32 Preferences
  * - Over-the-air firmware updates
  * - Real-time position feedback via encoder
+ * - Following-error monitoring (encoder vs commanded steps)
+ * - Event-driven input handling (pin interrupts wake InputTask)
+ * - Dedicated motor core: the motor task runs alone on core 1 (see TaskConfig.h)
  *
  * Hardware:
  * - LilyGo T-Motor with ESP32 Pico
@@ -31,10 +42,12 @@
  */
 
 // Task handles
+TaskHandle_t motorTaskHandle = NULL;
 TaskHandle_t inputTaskHandle = NULL;
 TaskHandle_t webServerTaskHandle = NULL;
 
 // Task function declarations
+void MotorTask(void *pvParameters);
 void InputTask(void *pvParameters);
 void WebServerTask(void *pvParameters);
 
@@ -42,6 +55,7 @@ void setup()
 {
     Serial.begin(115200);
     delay(1000); // Allow serial to initialize
+    logger.begin(); // LOG_* only queue until the log task runs
     LOG_INFO("========================================");
     LOG_INFO("LilyGo Motion Controller Starting...");
     LOG_INFO("========================================");
@@ -57,7 +71,7 @@ void setup()
             delay(1000);
     }
 
-    // 2. Motor controller
+    // 2. Motor controller (registers the step timer ISR on this core, MOTOR_CORE)
     if (!motorController.begin())
     {
         LOG_ERROR("FATAL: Failed to initialize Motor Controller");
@@ -91,28 +105,45 @@ void setup()
 
     LOG_INFO("All modules initialized successfully");
 
+#ifdef TASK_BENCHMARK
+    taskBenchmark.begin();
+#endif
+
     // Create FreeRTOS tasks
-    LOG_INFO("Creating FreeRTOS tasks...");
+    LOG_INFO("Creating FreeRTOS tasks (%s layout)...", TASK_LAYOUT_NAME);
+
+    xTaskCreatePinnedToCore(
+        InputTask,           // Task function
+        "InputTask",         // Task name
+        INPUT_TASK_STACK,    // Stack size
+        NULL,                // Parameters
+        INPUT_TASK_PRIORITY, // Priority
+        &inputTaskHandle,    // Task handle
+        SYSTEM_CORE          // Core (shared with WiFi and the other system tasks)
+    );
 
     xTaskCreatePinnedToCore(
-        InputTask,        // Task function
-        "InputTask",      // Task name
-        8192,             // Stack size
-        NULL,             // Parameters
-        2,                // Priority
-        &inputTaskHandle, // Task handle
-        0                 // Core (0 for input monitoring)
+        WebServerTask,            // Task function
+        "WebServerTask",          // Task name
+        WEB_SERVER_TASK_STACK,    // Stack size (larger for web operations)
+        NULL,                     // Parameters
+        WEB_SERVER_TASK_PRIORITY, // Priority
+        &webServerTaskHandle,     // Task handle
+        WEB_SERVER_CORE           // Core (SYSTEM_CORE unless TASK_LAYOUT_LEGACY)
     );
 
+#ifndef TASK_LAYOUT_LEGACY
+    // Created last, so setup() has finished with the motor controller before it runs
     xTaskCreatePinnedToCore(
-        WebServerTask,        // Task function
-        "WebServerTask",      // Task name
-        16384,                // Stack size (larger for web operations)
-        NULL,                 // Parameters
-        1,                    // Priority
-        &webServerTaskHandle, // Task handle
-        1                     // Core (1 for web server)
+        MotorTask,           // Task function
+        "MotorTask",         // Task name
+        MOTOR_TASK_STACK,    // Stack size
+        NULL,                // Parameters
+        MOTOR_TASK_PRIORITY, // Priority (above everything else on its core)
+        &motorTaskHandle,    // Task handle
+        MOTOR_CORE           // Core (nothing else runnable there)
     );
+#endif
 
     LOG_INFO("FreeRTOS tasks created");
     LOG_INFO("========================================");
@@ -122,11 +153,32 @@ void setup()
 
 void loop()
 {
-    // Main loop handles motor control (time-critical)
+#ifdef TASK_LAYOUT_LEGACY
+    // Legacy layout: loop() runs the motor at priority 1, sharing core 1 with WebServerTask
     motorController.update();
+#ifdef TASK_BENCHMARK
+    taskBenchmark.recordLoop();
+#endif
+#else
+    // MotorTask has taken over; leave core 1 to it
+    vTaskDelete(NULL);
+#endif
+}
+
+void MotorTask(void *pvParameters)
+{
+    LOG_INFO("Motor Task started on core %d", xPortGetCoreID());
 
-    // No delay - AccelStepper needs maximum call frequency for high speeds
-    // Watchdog is automatically fed by FreeRTOS idle task
+    while (1)
+    {
+        motorController.update();
+#ifdef TASK_BENCHMARK
+        taskBenchmark.recordLoop();
+#endif
+
+        // No delay - AccelStepper needs maximum call frequency for high speeds.
+        // Starving IDLE1 is fine: the task watchdog only checks IDLE0 on Arduino.
+    }
 }
 
 void InputTask(void *pvParameters)
@@ -136,21 +188,53 @@ void InputTask(void *pvParameters)
     // Initialize encoder
     motorController.initEncoder();
 
-    // Task main loop
+    // Each consumer runs on its own period and/or when an ISR posts its event
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    const uint8_t buttons = inputScheduler.add("buttons", 0, 1UL << INPUT_EVENT_BUTTONS, now);
+    const uint8_t limits = inputScheduler.add("limits", 0, 1UL << INPUT_EVENT_LIMITS, now);
+    const uint8_t followingError = inputScheduler.add("followingError", 10000, 0, now); // Fixed 100Hz rate
+    const uint8_t calibration = inputScheduler.add("calibration", 10000, 0, now);
+    const uint8_t velocity = inputScheduler.add("velocity", 10000, 0, now);
+    setInputEventTask(xTaskGetCurrentTaskHandle());
+
     while (1)
     {
-        // Update button controller
-        buttonController.update();
-
-        // Update limit switches
-        minLimitSwitch.update();
-        maxLimitSwitch.update();
-
-        // Calculate speed from encoder
-        motorController.calculateSpeed(100);
-
-        // 100ms update rate for input monitoring
-        vTaskDelay(pdMS_TO_TICKS(100));
+        // Sleep until the next period or deadline, or until an ISR posts
+        now = (uint32_t)esp_timer_get_time();
+        waitInputEvents(inputScheduler, inputScheduler.sleepTime(now));
+
+        now = (uint32_t)esp_timer_get_time();
+        uint32_t run = dueInputConsumers(inputScheduler, now);
+        uint32_t deadline;
+
+        // Debounced button edges; debounce and long-press expiry come back as deadlines
+        if (run & (1UL << buttons))
+        {
+            if (buttonController.update(now, deadline))
+                inputScheduler.wakeAt(buttons, deadline);
+        }
+
+        // Limit switch trips (the ISR already stopped the motor)
+        if (run & (1UL << limits))
+        {
+            minLimitSwitch.update();
+            maxLimitSwitch.update();
+            // Either one still telling a trip from a glitch: come back (the other re-asks then)
+            if (minLimitSwitch.nextDeadline(deadline) || maxLimitSwitch.nextDeadline(deadline))
+                inputScheduler.wakeAt(limits, deadline);
+        }
+
+        // Compare encoder against commanded position
+        if (run & (1UL << followingError))
+            motorController.checkFollowingError();
+
+        // Encoder calibration sweep, when one is running
+        if (run & (1UL << calibration))
+            motorController.updateCalibration();
+
+        // Velocity observer catches up on the encoder samples taken since the last run
+        if (run & (1UL << velocity))
+            motorController.updateVelocity();
     }
 }
 
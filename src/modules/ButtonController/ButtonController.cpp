@@ -2,89 +2,140 @@
 #include "../MotorController/MotorController.h"
 #include "../LimitSwitch/LimitSwitch.h"
 #include "../Configuration/Configuration.h"
+#include "../InputScheduler/InputEvents.h"
 #include "util.h"
+#include <driver/gpio.h>
+#include <esp_timer.h>
+
+static constexpr LogModule logModule = LogModule::Buttons;
 
 // Global instance
 ButtonController buttonController;
 
 ButtonController::ButtonController(uint8_t btn1Pin, uint8_t btn2Pin, uint8_t btn3Pin)
 {
-    button1 = new OneButton(btn1Pin, true); // true = INPUT_PULLUP, active LOW
-    button2 = new OneButton(btn2Pin, true);
-    button3 = new OneButton(btn3Pin, true);
+    const uint8_t pins[3] = {btn1Pin, btn2Pin, btn3Pin};
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        buttons[i].pin = pins[i];
+        buttons[i].overflowed = false;
+    }
+
+    // Buttons 1 and 3 jog while held; button 2 stops on the press itself
+    buttons[0].debounce = DebouncedButton(JOG_PRESS_US);
+    buttons[1].debounce = DebouncedButton();
+    buttons[2].debounce = DebouncedButton(JOG_PRESS_US);
 }
 
 bool ButtonController::begin()
 {
     LOG_INFO("Initializing Button Controller...");
 
-    // Button 1: Jog backward (press and hold)
-    button1->attachLongPressStart(onButton1Press);
-    button1->attachLongPressStop(onButton1Release);
-    button1->setPressMs(100); // Start jogging after 100ms
-
-    // Button 2: Emergency stop (click)
-    button2->attachClick(onButton2Click);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        Button &button = buttons[i];
+        pinMode(button.pin, INPUT_PULLUP); // Active LOW
+        button.debounce.reset(digitalRead(button.pin) == LOW);
 
-    // Button 3: Jog forward (press and hold)
-    button3->attachLongPressStart(onButton3Press);
-    button3->attachLongPressStop(onButton3Release);
-    button3->setPressMs(100); // Start jogging after 100ms
+        // Both edges, timestamped in the ISR. GPIO34-39 may see spurious interrupts
+        // (ESP32 errata); they read the unchanged level and debounce to nothing.
+        attachInterruptArg(digitalPinToInterrupt(button.pin), onISR, &button, CHANGE);
+    }
 
     LOG_INFO("Button Controller initialized (pins: %d, %d, %d)",
-             button1->pin(), button2->pin(), button3->pin());
+             buttons[0].pin, buttons[1].pin, buttons[2].pin);
     return true;
 }
 
-void ButtonController::update()
+// Static ISR handler: record the edge and wake InputTask, nothing else
+// Runs with the flash cache off during NVS writes, so it only calls IRAM code:
+// gpio_get_level() rather than digitalRead(), and the always-inlined push()
+void IRAM_ATTR ButtonController::onISR(void *arg)
 {
-    // Update button states (OneButton handles debouncing)
-    button1->tick();
-    button2->tick();
-    button3->tick();
+    Button *button = static_cast<Button *>(arg);
+    Edge edge = {gpio_get_level((gpio_num_t)button->pin) == 0, (uint32_t)esp_timer_get_time()};
+    if (!button->edges.push(edge))
+        button->overflowed = true;
+    postInputEventFromISR(INPUT_EVENT_BUTTONS);
 }
 
-// Static callback implementations
-void ButtonController::onButton1Press()
+bool ButtonController::update(uint32_t nowUs, uint32_t &nextUs)
 {
-    // Button 1: Jog backward (to min limit)
-    LOG_INFO("Button 1 press - Jog backward");
-    if (!motorController.isEmergencyStopActive())
+    bool waiting = false;
+    for (uint8_t i = 0; i < 3; i++)
     {
-        int jogSpeed = config.getMaxSpeed() * 0.3; // 30% of max speed
-        long targetPosition = config.getMinLimit();
-        motorController.moveTo(targetPosition, jogSpeed);
-        LOG_INFO("Jog backward started to %ld at speed %d", targetPosition, jogSpeed);
+        Button &button = buttons[i];
+        DebouncedButton::Event event;
+
+        Edge edge;
+        while (button.edges.pop(edge))
+        {
+            // Deadlines that fell before this edge first, in order
+            while ((event = button.debounce.poll(edge.timeUs)) != DebouncedButton::Event::None)
+                handle(i, event);
+            if ((event = button.debounce.onEdge(edge.pressed, edge.timeUs)) != DebouncedButton::Event::None)
+                handle(i, event);
+        }
+
+        // Queue was full: the edges lost can't be replayed, the pin's level now is the truth
+        if (button.overflowed)
+        {
+            button.overflowed = false;
+            if ((event = button.debounce.onEdge(digitalRead(button.pin) == LOW, nowUs)) != DebouncedButton::Event::None)
+                handle(i, event);
+            LOG_WARN("Button %d: edge queue overflowed, resynced from the pin", i + 1);
+        }
+
+        while ((event = button.debounce.poll(nowUs)) != DebouncedButton::Event::None)
+            handle(i, event);
+
+        uint32_t deadline;
+        if (button.debounce.nextDeadline(deadline))
+        {
+            if (!waiting || (int32_t)(deadline - nextUs) < 0)
+                nextUs = deadline;
+            waiting = true;
+        }
     }
+    return waiting;
 }
 
-void ButtonController::onButton1Release()
+void ButtonController::handle(uint8_t index, DebouncedButton::Event event)
 {
-    LOG_INFO("Button 1 release - Stop jog");
-    motorController.jogStop();
-}
+    switch (index)
+    {
+    case 0: // Button 1: Jog backward (press and hold)
+    case 2: // Button 3: Jog forward (press and hold)
+        if (event == DebouncedButton::Event::LongPressStart)
+            jog(index == 2);
+        else if (event == DebouncedButton::Event::LongPressStop)
+            stopJog(index + 1);
+        break;
 
-void ButtonController::onButton2Click()
-{
-    LOG_INFO("Button 2 pressed - Emergency stop");
-    motorController.emergencyStop();
+    case 1: // Button 2: Emergency stop (on the press, no waiting for the release)
+        if (event == DebouncedButton::Event::Press)
+        {
+            LOG_INFO("Button 2 pressed - Emergency stop");
+            motorController.emergencyStop();
+        }
+        break;
+    }
 }
 
-void ButtonController::onButton3Press()
+void ButtonController::jog(bool forward)
 {
-    // Button 3: Jog forward (to max limit)
-    LOG_INFO("Button 3 press - Jog forward");
+    LOG_INFO("Button %d press - Jog %s", forward ? 3 : 1, forward ? "forward" : "backward");
     if (!motorController.isEmergencyStopActive())
     {
         int jogSpeed = config.getMaxSpeed() * 0.3; // 30% of max speed
-        long targetPosition = config.getMaxLimit();
-        motorController.moveTo(targetPosition, jogSpeed);
-        LOG_INFO("Jog forward started to %ld at speed %d", targetPosition, jogSpeed);
+        long targetPosition = forward ? config.getMaxLimit() : config.getMinLimit();
+        motorController.moveTo(targetPosition, jogSpeed, CommandSource::Input);
+        LOG_INFO("Jog %s started to %ld at speed %d", forward ? "forward" : "backward", targetPosition, jogSpeed);
     }
 }
 
-void ButtonController::onButton3Release()
+void ButtonController::stopJog(uint8_t number)
 {
-    LOG_INFO("Button 3 release - Stop jog");
-    motorController.jogStop();
+    LOG_INFO("Button %d release - Stop jog", number);
+    motorController.jogStop(CommandSource::Input);
 }
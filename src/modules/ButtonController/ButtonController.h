@@ -1,21 +1,40 @@
 #pragma once
 
 #include <Arduino.h>
-#include <OneButton.h>
+#include "DebouncedButton.h"
+#include "../../SpscQueue.h"
 
 class ButtonController
 {
+public:
+    static constexpr uint32_t JOG_PRESS_US = 100000; // Hold this long before a jog starts
+
 private:
-    OneButton *button1;
-    OneButton *button2;
-    OneButton *button3;
+    // Pin edge as the ISR saw it
+    struct Edge
+    {
+        bool pressed;
+        uint32_t timeUs;
+    };
+
+    struct Button
+    {
+        uint8_t pin;
+        DebouncedButton debounce;
+        SpscQueue<Edge, 16> edges;   // ISR -> InputTask
+        volatile bool overflowed;    // Edges were dropped: resync from the pin
+    };
+
+    Button buttons[3];
 
-    // Button callback functions
-    static void onButton1Press();
-    static void onButton1Release();
-    static void onButton2Click();
-    static void onButton3Press();
-    static void onButton3Release();
+    // ISR handler: one per pin, both edges, 'arg' is the Button
+    static void IRAM_ATTR onISR(void *arg);
+
+    void handle(uint8_t index, DebouncedButton::Event event);
+
+    // Button actions
+    void jog(bool forward);
+    void stopJog(uint8_t number);
 
 public:
     // Constructor
@@ -24,15 +43,10 @@ public:
     // Initialize button controller
     bool begin();
 
-    // Update function (call from InputTask loop)
-    void update();
-
-    // Allow static callbacks to access private members
-    friend void onButton1Press();
-    friend void onButton1Release();
-    friend void onButton2Click();
-    friend void onButton3Press();
-    friend void onButton3Release();
+    // Process the edges the ISRs queued and any debounce/long-press deadline due
+    // by 'nowUs' (call from InputTask). Returns false when nothing waits on time,
+    // otherwise 'nextUs' is when to call again.
+    bool update(uint32_t nowUs, uint32_t &nextUs);
 };
 
 extern ButtonController buttonController;
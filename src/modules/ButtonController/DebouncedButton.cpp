@@ -0,0 +1,72 @@
+#include "DebouncedButton.h"
+
+DebouncedButton::DebouncedButton(uint32_t longPress)
+    : longPressUs(longPress), pressed(false), raw(false), rawSinceUs(0), settled(false), lastChangeUs(0),
+      pressedAtUs(0), longPressed(false), eventTimeUs(0)
+{
+}
+
+void DebouncedButton::reset(bool isPressed)
+{
+    pressed = isPressed;
+    raw = isPressed;
+    settled = false;
+    pressedAtUs = 0;
+    // Held at start-up: counts as a long press already under way, so none starts
+    longPressed = isPressed;
+}
+
+DebouncedButton::Event DebouncedButton::change(uint32_t atUs)
+{
+    pressed = raw;
+    settled = true;
+    lastChangeUs = atUs;
+    eventTimeUs = rawSinceUs;
+    if (pressed)
+    {
+        pressedAtUs = atUs;
+        longPressed = false;
+        return Event::Press;
+    }
+    return longPressed && longPressUs ? Event::LongPressStop : Event::Release;
+}
+
+DebouncedButton::Event DebouncedButton::onEdge(bool isPressed, uint32_t timeUs)
+{
+    raw = isPressed;
+    rawSinceUs = timeUs;
+    if (raw == pressed)
+        return Event::None; // Bounced back
+    if (settled && !reached(timeUs, lastChangeUs + DEBOUNCE_US))
+        return Event::None; // Inside the window: poll() takes the settled level
+    return change(timeUs);
+}
+
+DebouncedButton::Event DebouncedButton::poll(uint32_t nowUs)
+{
+    if (raw != pressed && reached(nowUs, lastChangeUs + DEBOUNCE_US))
+        return change(lastChangeUs + DEBOUNCE_US);
+
+    if (pressed && longPressUs && !longPressed && reached(nowUs, pressedAtUs + longPressUs))
+    {
+        longPressed = true;
+        eventTimeUs = pressedAtUs + longPressUs;
+        return Event::LongPressStart;
+    }
+    return Event::None;
+}
+
+bool DebouncedButton::nextDeadline(uint32_t &atUs) const
+{
+    if (raw != pressed)
+    {
+        atUs = lastChangeUs + DEBOUNCE_US;
+        return true;
+    }
+    if (pressed && longPressUs && !longPressed)
+    {
+        atUs = pressedAtUs + longPressUs;
+        return true;
+    }
+    return false;
+}
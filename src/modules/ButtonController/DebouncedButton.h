@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+
+// Timestamp debouncing for a push button
+// Fed with the edges the pin interrupt timestamped, in order. A change is
+// taken on its first edge, so a press acts without delay, then further
+// changes wait out DEBOUNCE_US: contact bounce inside that window is dropped
+// and the level it settles on is taken at the end of it. A press held
+// longPressUs also reports LongPressStart; its release is LongPressStop
+// instead of Release. Times are 32-bit µs and may wrap.
+class DebouncedButton
+{
+public:
+    enum class Event : uint8_t
+    {
+        None,
+        Press,
+        Release,        // After a press shorter than the long press
+        LongPressStart,
+        LongPressStop
+    };
+
+    static constexpr uint32_t DEBOUNCE_US = 20000;
+
+private:
+    uint32_t longPressUs; // 0 = no long presses
+    bool pressed;         // Debounced level
+    bool raw;             // Level of the latest edge
+    uint32_t rawSinceUs;
+    bool settled;         // A change was taken before: lastChangeUs is valid
+    uint32_t lastChangeUs;
+    uint32_t pressedAtUs;
+    bool longPressed;
+    uint32_t eventTimeUs;
+
+    static bool reached(uint32_t nowUs, uint32_t atUs) { return (int32_t)(nowUs - atUs) >= 0; }
+    Event change(uint32_t atUs);
+
+public:
+    explicit DebouncedButton(uint32_t longPressUs = 0);
+
+    // Level at start-up (no edge for it)
+    void reset(bool isPressed);
+
+    // Pin edge at 'timeUs'; returns what it caused. Drain poll(timeUs) first so a
+    // long press that was due before the edge is reported ahead of it.
+    Event onEdge(bool isPressed, uint32_t timeUs);
+
+    // Events due by 'nowUs' from waiting out a bounce or a long press; call until None
+    Event poll(uint32_t nowUs);
+
+    // When poll() next has something to do; false if nothing is waiting
+    bool nextDeadline(uint32_t &atUs) const;
+
+    bool isPressed() const { return pressed; }
+    uint32_t getEventTime() const { return eventTimeUs; } // Edge (or deadline) behind the last event
+};
@@ -2,6 +2,8 @@
 #include "util.h"
 #include <Arduino.h>
 
+static constexpr LogModule logModule = LogModule::Configuration;
+
 // Global instance
 Configuration config;
 
@@ -13,6 +15,18 @@ Configuration::Configuration() {
     motorConfig.limitPos2 = 2000; // Sane default to allow motor movement even without calibration
     motorConfig.useStealthChop = true;
     motorConfig.freewheelAfterMove = false; // Disabled by default - motor holds position
+    motorConfig.useTimerStepEngine = true;  // Polled stepping stays available as a fallback
+    motorConfig.maxJerk = 0;                // S-curve disabled by default - trapezoidal ramps
+    motorConfig.followingErrorWindow = 24;  // 3 full steps: a lost electrical cycle (4 full steps) trips it
+    motorConfig.servoMode = false;          // Open loop by default
+    motorConfig.stallThreshold = 50;        // Tune per motor: stall at SG_RESULT <= 100
+    motorConfig.hardwareModeSwitch = true;  // Driver switches chopper modes itself (no CPU)
+    motorConfig.modeHysteresis = 10;        // Software fallback: back to StealthChop below 90% of the threshold
+    motorConfig.adaptiveMicrosteps = false; // Fixed 1/8 microstepping
+    motorConfig.limitBackoff = 160;         // 20 full steps off a tripped limit switch
+    motorConfig.softLimits = false;         // Off until both limits are learned: moves may have to find the switches
+    motorConfig.softLimitZone = 800;        // Creep over the last 100 full steps
+    positionSnapshotValid = false;
 }
 
 bool Configuration::begin() {
@@ -33,10 +47,23 @@ void Configuration::loadConfiguration() {
     motorConfig.limitPos2 = preferences.getLong("limitPos2", motorConfig.limitPos2);
     motorConfig.useStealthChop = preferences.getBool("stealthChop", motorConfig.useStealthChop);
     motorConfig.freewheelAfterMove = preferences.getBool("freewheel", motorConfig.freewheelAfterMove);
+    motorConfig.useTimerStepEngine = preferences.getBool("timerEngine", motorConfig.useTimerStepEngine);
+    motorConfig.maxJerk = preferences.getLong("maxJerk", motorConfig.maxJerk);
+    motorConfig.followingErrorWindow = preferences.getLong("followErr", motorConfig.followingErrorWindow);
+    motorConfig.servoMode = preferences.getBool("servoMode", motorConfig.servoMode);
+    motorConfig.stallThreshold = preferences.getLong("stallThr", motorConfig.stallThreshold);
+    motorConfig.hardwareModeSwitch = preferences.getBool("hwModeSw", motorConfig.hardwareModeSwitch);
+    motorConfig.modeHysteresis = preferences.getLong("modeHyst", motorConfig.modeHysteresis);
+    motorConfig.adaptiveMicrosteps = preferences.getBool("adaptMres", motorConfig.adaptiveMicrosteps);
+    motorConfig.limitBackoff = preferences.getLong("limBackoff", motorConfig.limitBackoff);
+    motorConfig.softLimits = preferences.getBool("softLimits", motorConfig.softLimits);
+    motorConfig.softLimitZone = preferences.getLong("softZone", motorConfig.softLimitZone);
+    positionSnapshotValid = preferences.getBool("posValid", false);
 
-    LOG_INFO("Configuration loaded - Accel: %ld, MaxSpeed: %ld, Limit1: %ld, Limit2: %ld, Freewheel: %d",
+    LOG_INFO("Configuration loaded - Accel: %ld, MaxSpeed: %ld, Limit1: %ld, Limit2: %ld, Freewheel: %d, TimerEngine: %d, Jerk: %ld, FollowErr: %ld, Servo: %d",
              motorConfig.acceleration, motorConfig.maxSpeed, motorConfig.limitPos1, motorConfig.limitPos2,
-             motorConfig.freewheelAfterMove);
+             motorConfig.freewheelAfterMove, motorConfig.useTimerStepEngine, motorConfig.maxJerk,
+             motorConfig.followingErrorWindow, motorConfig.servoMode);
 }
 
 void Configuration::saveConfiguration() {
@@ -46,6 +73,17 @@ void Configuration::saveConfiguration() {
     preferences.putLong("limitPos2", motorConfig.limitPos2);
     preferences.putBool("stealthChop", motorConfig.useStealthChop);
     preferences.putBool("freewheel", motorConfig.freewheelAfterMove);
+    // timerEngine: saved by setUseTimerStepEngine() once the motor loop has switched
+    preferences.putLong("maxJerk", motorConfig.maxJerk);
+    preferences.putLong("followErr", motorConfig.followingErrorWindow);
+    preferences.putBool("servoMode", motorConfig.servoMode);
+    preferences.putLong("stallThr", motorConfig.stallThreshold);
+    preferences.putBool("hwModeSw", motorConfig.hardwareModeSwitch);
+    preferences.putLong("modeHyst", motorConfig.modeHysteresis);
+    preferences.putBool("adaptMres", motorConfig.adaptiveMicrosteps);
+    preferences.putLong("limBackoff", motorConfig.limitBackoff);
+    preferences.putBool("softLimits", motorConfig.softLimits);
+    preferences.putLong("softZone", motorConfig.softLimitZone);
     LOG_INFO("Configuration saved");
 }
 
@@ -57,6 +95,43 @@ void Configuration::saveLimitPositions(long pos1, long pos2) {
     LOG_INFO("Limit positions saved: %ld, %ld", pos1, pos2);
 }
 
+bool Configuration::loadPositionSnapshot(PositionSnapshot &snapshot) {
+    if (!positionSnapshotValid) {
+        return false;
+    }
+    snapshot.encoderCount = preferences.getLong64("posCount", 0);
+    snapshot.steps = preferences.getLong("posSteps", 0);
+    snapshot.polarity = (int8_t)preferences.getLong("posPolarity", 0);
+    return true;
+}
+
+void Configuration::savePositionSnapshot(const PositionSnapshot &snapshot) {
+    preferences.putLong64("posCount", snapshot.encoderCount);
+    preferences.putLong("posSteps", snapshot.steps);
+    preferences.putLong("posPolarity", snapshot.polarity);
+    preferences.putBool("posValid", true); // Written last: a cut mid-save leaves it invalid
+    positionSnapshotValid = true;
+}
+
+void Configuration::invalidatePositionSnapshot() {
+    if (positionSnapshotValid) {
+        preferences.putBool("posValid", false);
+        positionSnapshotValid = false;
+    }
+}
+
+bool Configuration::loadEncoderCalibration(int16_t *table, size_t entries) {
+    size_t bytes = entries * sizeof(int16_t);
+    if (preferences.getBytesLength("encCal") != bytes) {
+        return false;
+    }
+    return preferences.getBytes("encCal", table, bytes) == bytes;
+}
+
+void Configuration::saveEncoderCalibration(const int16_t *table, size_t entries) {
+    preferences.putBytes("encCal", table, entries * sizeof(int16_t));
+}
+
 void Configuration::setAcceleration(long accel) {
     motorConfig.acceleration = accel;
     preferences.putLong("acceleration", accel);
@@ -70,4 +145,83 @@ void Configuration::setMaxSpeed(long speed) {
 void Configuration::setFreewheelAfterMove(bool value) {
     motorConfig.freewheelAfterMove = value;
     preferences.putBool("freewheel", value);
+}
+
+void Configuration::setUseTimerStepEngine(bool value) {
+    motorConfig.useTimerStepEngine = value;
+    preferences.putBool("timerEngine", value);
+}
+
+void Configuration::setMaxJerk(long jerk) {
+    motorConfig.maxJerk = jerk;
+    preferences.putLong("maxJerk", jerk);
+}
+
+void Configuration::setFollowingErrorWindow(long steps) {
+    motorConfig.followingErrorWindow = steps;
+    preferences.putLong("followErr", steps);
+}
+
+void Configuration::setServoMode(bool value) {
+    motorConfig.servoMode = value;
+    preferences.putBool("servoMode", value);
+}
+
+void Configuration::setStallThreshold(long value) {
+    // SGTHRS is an 8-bit register
+    if (value < 0) {
+        value = 0;
+    } else if (value > 255) {
+        value = 255;
+    }
+    motorConfig.stallThreshold = value;
+    preferences.putLong("stallThr", value);
+}
+
+void Configuration::setHardwareModeSwitch(bool value) {
+    motorConfig.hardwareModeSwitch = value;
+    preferences.putBool("hwModeSw", value);
+}
+
+void Configuration::setAdaptiveMicrosteps(bool value) {
+    motorConfig.adaptiveMicrosteps = value;
+    preferences.putBool("adaptMres", value);
+}
+
+void Configuration::setLimitBackoff(long steps) {
+    // Up to one turn; 0 disables automatic recovery
+    if (steps < 0) {
+        steps = 0;
+    } else if (steps > 1600) {
+        steps = 1600;
+    }
+    motorConfig.limitBackoff = steps;
+    preferences.putLong("limBackoff", steps);
+}
+
+void Configuration::setSoftLimits(bool value) {
+    motorConfig.softLimits = value;
+    preferences.putBool("softLimits", value);
+}
+
+void Configuration::setSoftLimitZone(long steps) {
+    // Up to ten turns; 0 keeps full speed up to the soft limit
+    if (steps < 0) {
+        steps = 0;
+    } else if (steps > 16000) {
+        steps = 16000;
+    }
+    motorConfig.softLimitZone = steps;
+    preferences.putLong("softZone", steps);
+}
+
+void Configuration::setModeHysteresis(long percent) {
+    // Past 50% the fallback would hold StealthChop down to half the threshold
+    if (percent < 0) {
+        percent = 0;
+    } else if (percent > 50) {
+        percent = 50;
+    }
+    motorConfig.modeHysteresis = percent;
+    preferences.putLong("modeHyst", percent);
 }
\ No newline at end of file
@@ -8,6 +8,8 @@ private:
     // ESP NVRAM Preference API
     Preferences preferences;
 
+    bool positionSnapshotValid; // Mirrors the stored flag so invalidating only writes once
+
 public:
     // Motor configuration
     struct MotorConfig
@@ -18,8 +20,29 @@ public:
         long limitPos2;
         bool useStealthChop;
         bool freewheelAfterMove;
+        bool useTimerStepEngine; // Hardware-timer step generation (false = polled AccelStepper::run())
+        long maxJerk;            // steps/sec³ for S-curve moves (0 = trapezoidal ramps)
+        long followingErrorWindow; // Encoder vs commanded steps before a fault (0 = off)
+        bool servoMode;            // Closed-loop position correction from the encoder
+        long stallThreshold;       // TMC2209 SGTHRS for sensorless homing (stall at SG_RESULT <= 2x)
+        bool hardwareModeSwitch;   // StealthChop/SpreadCycle switched by the driver (TPWMTHRS), else by the motor loop
+        long modeHysteresis;       // Software switching: % below the threshold before StealthChop returns
+        bool adaptiveMicrosteps;   // MRES chosen per move from its speed (positions stay in 1/8 steps)
+        long limitBackoff;         // Steps backed off a tripped limit switch before re-arming it (0 = manual reset)
+        bool softLimits;           // Clip move targets to the learned limits
+        long softLimitZone;        // Steps next to each limit crossed at creep speed (0 = full speed to the end)
     } motorConfig;
 
+    // Absolute position at the last standstill: encoder multi-turn count and the
+    // step position it corresponded to. Invalidated while moving, so a power cut
+    // mid-move never restores a stale position.
+    struct PositionSnapshot
+    {
+        int64_t encoderCount;
+        long steps;
+        int8_t polarity; // Encoder counts per step direction (+1/-1, 0 = unknown)
+    };
+
     // Constructor
     Configuration();
 
@@ -35,6 +58,15 @@ public:
     // Save only limit positions (called when limits are triggered)
     void saveLimitPositions(long pos1, long pos2);
 
+    // Position snapshot (PositionSnapshotTask writes; loaded once at boot)
+    bool loadPositionSnapshot(PositionSnapshot &snapshot); // false when none is valid
+    void savePositionSnapshot(const PositionSnapshot &snapshot);
+    void invalidatePositionSnapshot();
+
+    // Encoder nonlinearity table (int16 per entry); false when none is stored
+    bool loadEncoderCalibration(int16_t *table, size_t entries);
+    void saveEncoderCalibration(const int16_t *table, size_t entries);
+
     // Get configuration values
     long getAcceleration() const { return motorConfig.acceleration; }
     long getMaxSpeed() const { return motorConfig.maxSpeed; }
@@ -44,6 +76,17 @@ public:
     long getMaxLimit() const { return max(motorConfig.limitPos1, motorConfig.limitPos2); }
     bool getUseStealthChop() const { return motorConfig.useStealthChop; }
     bool getFreewheelAfterMove() const { return motorConfig.freewheelAfterMove; }
+    bool getUseTimerStepEngine() const { return motorConfig.useTimerStepEngine; }
+    long getMaxJerk() const { return motorConfig.maxJerk; }
+    long getFollowingErrorWindow() const { return motorConfig.followingErrorWindow; }
+    bool getServoMode() const { return motorConfig.servoMode; }
+    long getStallThreshold() const { return motorConfig.stallThreshold; }
+    bool getHardwareModeSwitch() const { return motorConfig.hardwareModeSwitch; }
+    long getModeHysteresis() const { return motorConfig.modeHysteresis; }
+    bool getAdaptiveMicrosteps() const { return motorConfig.adaptiveMicrosteps; }
+    long getLimitBackoff() const { return motorConfig.limitBackoff; }
+    bool getSoftLimits() const { return motorConfig.softLimits; }
+    long getSoftLimitZone() const { return motorConfig.softLimitZone; }
 
     // Set configuration values
     void setAcceleration(long accel);
@@ -52,6 +95,17 @@ public:
     void setLimitPos2(long pos) { motorConfig.limitPos2 = pos; }
     void setUseStealthChop(bool use) { motorConfig.useStealthChop = use; }
     void setFreewheelAfterMove(bool value);
+    void setUseTimerStepEngine(bool value);
+    void setMaxJerk(long jerk);
+    void setFollowingErrorWindow(long steps);
+    void setServoMode(bool value);
+    void setStallThreshold(long value);
+    void setHardwareModeSwitch(bool value);
+    void setModeHysteresis(long percent);
+    void setAdaptiveMicrosteps(bool value);
+    void setLimitBackoff(long steps);
+    void setSoftLimits(bool value);
+    void setSoftLimitZone(long steps);
 };
 
 extern Configuration config;
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "PositionSnapshotTask.h"
+#include "../EncoderSampler/EncoderSampler.h"
+#include "../FollowingErrorMonitor/FollowingErrorMonitor.h"
+#include "../MotorController/MotorController.h"
+#include "TaskConfig.h"
+#include "util.h"
+
+static constexpr LogModule logModule = LogModule::Configuration;
+
+PositionSnapshotTask::PositionSnapshotTask(Configuration &config, EncoderSampler &encoder)
+    : config(config), encoder(encoder), task(nullptr), moving(false), pending(false), generation(0), stoppedMs(0),
+      next{0, 0, 0}, stored(false), anchor{0, 0, 0}, current{0, 0, 0}
+{
+    mux = portMUX_INITIALIZER_UNLOCKED;
+}
+
+bool PositionSnapshotTask::begin()
+{
+    // The snapshot from the last run stays valid until the first move
+    stored = config.loadPositionSnapshot(anchor);
+    current = anchor;
+
+    TaskHandle_t handle;
+    if (xTaskCreatePinnedToCore(taskEntry, "PositionTask", POSITION_TASK_STACK, this, POSITION_TASK_PRIORITY, &handle,
+                                SYSTEM_CORE) != pdPASS)
+    {
+        LOG_ERROR("Position snapshot task creation failed");
+        return false;
+    }
+    task = handle;
+    return true;
+}
+
+bool PositionSnapshotTask::invalidate()
+{
+    portENTER_CRITICAL(&mux);
+    moving = true;
+    pending = false;
+    generation++;
+    bool clear = !stored;
+    portEXIT_CRITICAL(&mux);
+    if (clear)
+        return true;
+
+    if (!task)
+    {
+        // No worker: erase it here, the motor is still at rest
+        config.invalidatePositionSnapshot();
+        portENTER_CRITICAL(&mux);
+        stored = false;
+        portEXIT_CRITICAL(&mux);
+        return true;
+    }
+
+    // The move waits for the erase: don't wait for the poll as well
+    xTaskNotifyGive(static_cast<TaskHandle_t>(task));
+    return false;
+}
+
+bool PositionSnapshotTask::isInvalidated()
+{
+    portENTER_CRITICAL(&mux);
+    bool clear = !stored;
+    portEXIT_CRITICAL(&mux);
+    return clear;
+}
+
+void PositionSnapshotTask::post(const Configuration::PositionSnapshot &snapshot)
+{
+    portENTER_CRITICAL(&mux);
+    next = snapshot;
+    moving = false;
+    pending = true;
+    generation++;
+    stoppedMs = millis();
+    portEXIT_CRITICAL(&mux);
+}
+
+long PositionSnapshotTask::stepsAt(const Configuration::PositionSnapshot &snapshot, int64_t encoderCount)
+{
+    long moved = (long)(encoderCount - snapshot.encoderCount);
+    return snapshot.steps + snapshot.polarity * (moved * FollowingErrorMonitor::DEFAULT_STEPS_PER_REV +
+                                                 (moved >= 0 ? 1 : -1) * FollowingErrorMonitor::ENCODER_COUNTS / 2) /
+                                FollowingErrorMonitor::ENCODER_COUNTS;
+}
+
+void PositionSnapshotTask::taskEntry(void *arg)
+{
+    static_cast<PositionSnapshotTask *>(arg)->run();
+}
+
+void PositionSnapshotTask::run()
+{
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POLL_MS));
+
+        portENTER_CRITICAL(&mux);
+        bool isMoving = moving;
+        bool hasPending = pending;
+        uint32_t seen = generation;
+        uint32_t since = stoppedMs;
+        Configuration::PositionSnapshot snapshot = next;
+        portEXIT_CRITICAL(&mux);
+
+        if (isMoving)
+        {
+            if (!stored)
+                continue;
+
+            // Done before the confirmation: the motor loop starts the move on it
+            config.invalidatePositionSnapshot();
+            portENTER_CRITICAL(&mux);
+            stored = false;
+            portEXIT_CRITICAL(&mux);
+        }
+        else if (hasPending)
+        {
+            if (millis() - since < SETTLE_MS)
+                continue;
+
+            // Claim it; if the motor moved again meanwhile, the next pass handles that instead.
+            // Stored from the claim on, so a move posted during the write waits for the erase.
+            portENTER_CRITICAL(&mux);
+            bool latest = generation == seen;
+            if (latest)
+            {
+                pending = false;
+                stored = true;
+            }
+            portEXIT_CRITICAL(&mux);
+            if (!latest)
+                continue;
+
+            config.savePositionSnapshot(snapshot);
+            anchor = current = snapshot;
+        }
+        else
+        {
+            followFreewheel();
+        }
+    }
+}
+
+void PositionSnapshotTask::followFreewheel()
+{
+    MotorStateSnapshot state;
+    EncoderSample sample;
+    if (!stored || !motorController.getState(state) || state.has(MotorStateSnapshot::DRIVER_ENABLED) ||
+        state.has(MotorStateSnapshot::MOVING) || !encoder.latest(sample))
+        return;
+
+    long moved = (long)(sample.position - current.encoderCount);
+    if (moved <= RESAVE_COUNTS && moved >= -RESAVE_COUNTS)
+        return;
+
+    // Without a known polarity the count can't be turned into steps
+    if (anchor.polarity == 0)
+    {
+        config.invalidatePositionSnapshot();
+        portENTER_CRITICAL(&mux);
+        stored = false;
+        portEXIT_CRITICAL(&mux);
+        LOG_WARN("Shaft turned by hand with unknown encoder polarity: saved position dropped");
+        return;
+    }
+
+    // A move waiting for the erase since the check above: the next pass does that instead
+    portENTER_CRITICAL(&mux);
+    bool idle = !moving;
+    portEXIT_CRITICAL(&mux);
+    if (!idle)
+        return;
+
+    // Mapped from the posted snapshot each time, so repeated re-saves don't accumulate rounding
+    current = {sample.position, stepsAt(anchor, sample.position), anchor.polarity};
+    config.savePositionSnapshot(current);
+    LOG_INFO("Shaft turned by hand (%ld counts): saved position now %ld steps", moved, current.steps);
+}
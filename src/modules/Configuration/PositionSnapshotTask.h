@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Configuration.h"
+
+class EncoderSampler;
+
+// Low-priority worker on core 0 that keeps the position snapshot in NVS
+// The motor loop never writes flash: it calls invalidate() before motion starts
+// and post() with the new snapshot once at rest. A flash write still turns the
+// cache off on both cores, stalling the (non-IRAM) step ISR, so a stored
+// snapshot is erased while the motor waits at rest: invalidate() returns false
+// until isInvalidated() confirms it (at most one putBool per stored snapshot).
+// A posted snapshot is written only once the motor has stayed at rest for
+// SETTLE_MS, so back-to-back short moves (calibration points, servo
+// corrections) write once at the end. With the driver off, a shaft turned by
+// hand carries the stored count along, so a restore never has to bridge more
+// than RESAVE_COUNTS of movement.
+class PositionSnapshotTask
+{
+public:
+    static constexpr uint32_t SETTLE_MS = 1000;
+    static constexpr uint32_t POLL_MS = 50;
+    static constexpr int32_t RESAVE_COUNTS = 512; // 1/32 turn
+
+private:
+    Configuration &config;
+    EncoderSampler &encoder;
+    void *task; // TaskHandle_t
+
+    // Handed over by the motor loop (mux)
+    portMUX_TYPE mux;
+    bool moving;
+    bool pending;
+    uint32_t generation; // Bumped by every hand-over
+    uint32_t stoppedMs;
+    Configuration::PositionSnapshot next;
+    bool stored; // NVS holds a valid snapshot, or one is being written (task writes)
+
+    // Task only: the snapshot the motor loop posted for what NVS holds
+    Configuration::PositionSnapshot anchor;
+    Configuration::PositionSnapshot current;
+
+    static void taskEntry(void *arg);
+    void run();
+    void followFreewheel();
+
+public:
+    PositionSnapshotTask(Configuration &config, EncoderSampler &encoder);
+
+    bool begin();
+
+    // Motor loop: non-blocking, no flash access (unless the task failed to start).
+    // invalidate() returns true when nothing stored is left to erase; otherwise
+    // motion waits for isInvalidated().
+    bool invalidate();
+    bool isInvalidated();
+    void post(const Configuration::PositionSnapshot &snapshot);
+
+    // Step position for an encoder count, from a snapshot taken elsewhere
+    // (polarity known; rounds to the nearest step)
+    static long stepsAt(const Configuration::PositionSnapshot &snapshot, int64_t encoderCount);
+};
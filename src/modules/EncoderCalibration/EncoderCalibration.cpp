@@ -0,0 +1,118 @@
+#include "EncoderCalibration.h"
+#include <math.h>
+
+// Signed shortest distance from one angle to another
+static int32_t wrapDelta(int32_t delta)
+{
+    delta &= EncoderCalibration::COUNTS_PER_REV - 1;
+    return delta >= EncoderCalibration::COUNTS_PER_REV / 2 ? delta - EncoderCalibration::COUNTS_PER_REV : delta;
+}
+
+static float wrapError(float error)
+{
+    while (error >= EncoderCalibration::COUNTS_PER_REV / 2)
+        error -= EncoderCalibration::COUNTS_PER_REV;
+    while (error < -EncoderCalibration::COUNTS_PER_REV / 2)
+        error += EncoderCalibration::COUNTS_PER_REV;
+    return error;
+}
+
+EncoderCalibration::EncoderCalibration() : valid(false)
+{
+    for (size_t i = 0; i < TABLE_SIZE; i++)
+        table[i] = 0;
+}
+
+bool EncoderCalibration::load(const int16_t *values)
+{
+    valid = false;
+    for (size_t i = 0; i < TABLE_SIZE; i++)
+    {
+        if (values[i] > MAX_ERROR || values[i] < -MAX_ERROR)
+            return false;
+    }
+    for (size_t i = 0; i < TABLE_SIZE; i++)
+        table[i] = values[i];
+    valid = true;
+    return true;
+}
+
+int16_t EncoderCalibration::getPeakError() const
+{
+    int16_t peak = 0;
+    for (size_t i = 0; i < TABLE_SIZE; i++)
+    {
+        int16_t magnitude = table[i] < 0 ? -table[i] : table[i];
+        if (magnitude > peak)
+            peak = magnitude;
+    }
+    return peak;
+}
+
+uint16_t EncoderCalibration::midpoint(uint16_t a, uint16_t b)
+{
+    return (uint16_t)((a + wrapDelta((int32_t)b - a) / 2) & (COUNTS_PER_REV - 1));
+}
+
+bool EncoderCalibration::build(const uint16_t *points, size_t count, int16_t *values)
+{
+    if (count < MIN_POINTS)
+        return false;
+
+    // The readings must go round exactly once, in one direction
+    int32_t travel = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        int32_t step = wrapDelta((int32_t)points[(i + 1) % count] - points[i]);
+        if (i + 1 < count)
+            travel += step;
+        else if (travel + step != COUNTS_PER_REV && travel + step != -COUNTS_PER_REV)
+            return false;
+    }
+    int8_t polarity = travel > 0 ? 1 : -1;
+    float spacing = (float)COUNTS_PER_REV / count;
+
+    // Error of each reading against an ideal, evenly spaced sweep; drop the mean (the zero offset)
+    float *errors = new float[count];
+    float mean = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        float expected = points[0] + polarity * spacing * i;
+        errors[i] = wrapError(points[i] - expected);
+        mean += errors[i];
+    }
+    mean /= count;
+    for (size_t i = 0; i < count; i++)
+        errors[i] -= mean;
+
+    // Sample the error at each table angle, interpolating between the readings on either side
+    bool ok = true;
+    for (size_t k = 0; k < TABLE_SIZE && ok; k++)
+    {
+        int32_t angle = (int32_t)(k << TABLE_SHIFT);
+        bool found = false;
+        for (size_t i = 0; i < count && !found; i++)
+        {
+            size_t next = (i + 1) % count;
+            int32_t span = wrapDelta((int32_t)points[next] - points[i]) * polarity;
+            int32_t offset = wrapDelta(angle - points[i]) * polarity;
+            if (span <= 0 || offset < 0 || offset >= span)
+                continue;
+
+            // The last reading pairs with the first one a turn later: same error
+            float error = errors[i] + (errors[next] - errors[i]) * offset / span;
+            if (error > MAX_ERROR || error < -MAX_ERROR)
+            {
+                ok = false;
+                break;
+            }
+            values[k] = (int16_t)lroundf(error);
+            found = true;
+        }
+        if (!found)
+            ok = false;
+    }
+
+    delete[] errors;
+    return ok;
+}
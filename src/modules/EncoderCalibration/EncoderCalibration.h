@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// MT6816 nonlinearity correction
+// A 256-entry table holds the encoder error (counts) at every 64th raw angle;
+// correct() interpolates between neighbouring entries in constant time.
+// build() derives the table from a sweep over one revolution at evenly spaced
+// commanded positions.
+class EncoderCalibration
+{
+public:
+    static constexpr int32_t COUNTS_PER_REV = 16384;
+    static constexpr size_t TABLE_SIZE = 256;
+    static constexpr uint8_t TABLE_SHIFT = 6; // COUNTS_PER_REV / TABLE_SIZE = 64 counts per entry
+    static constexpr int16_t MAX_ERROR = COUNTS_PER_REV / 32; // 11.25°: anything larger is a bad sweep, not magnet error
+    static constexpr size_t MIN_POINTS = TABLE_SIZE;           // Sweep points must be denser than the table
+
+private:
+    int16_t table[TABLE_SIZE];
+    bool valid;
+
+public:
+    EncoderCalibration();
+
+    // Sampling task: raw angle in, linearised angle out
+    uint16_t correct(uint16_t raw) const
+    {
+        if (!valid)
+            return raw;
+        uint32_t index = raw >> TABLE_SHIFT;
+        int32_t fraction = raw & ((1 << TABLE_SHIFT) - 1);
+        int32_t low = table[index];
+        int32_t high = table[(index + 1) & (TABLE_SIZE - 1)];
+        int32_t error = low + (((high - low) * fraction + (1 << (TABLE_SHIFT - 1))) >> TABLE_SHIFT);
+        return (uint16_t)((raw - error) & (COUNTS_PER_REV - 1));
+    }
+
+    // Install a stored table; false (and left uncorrected) if it is out of range
+    bool load(const int16_t *values);
+    void clear() { valid = false; }
+
+    bool isValid() const { return valid; }
+    const int16_t *getTable() const { return table; }
+    int16_t getPeakError() const; // Largest |entry|, counts
+
+    // Table from raw angles measured at 'count' commanded positions evenly spaced over
+    // exactly one revolution (either direction). The mean error is removed: the sweep
+    // defines linearity, not the zero. False if the sweep isn't one clean revolution.
+    static bool build(const uint16_t *points, size_t count, int16_t *values);
+
+    // Circular mean of two angles (forward/backward readings of one point)
+    static uint16_t midpoint(uint16_t a, uint16_t b);
+};
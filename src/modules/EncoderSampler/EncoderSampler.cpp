@@ -0,0 +1,203 @@
+#include "EncoderSampler.h"
+#include "TaskConfig.h"
+#include "util.h"
+#include <Arduino.h>
+#include <driver/spi_master.h>
+#include <esp_timer.h>
+
+static constexpr LogModule logModule = LogModule::Encoder;
+
+// Sampling task runs on the system core above InputTask, so samples keep their
+// rate while buttons, limits and the following-error check run
+static constexpr spi_host_device_t ENCODER_HOST = HSPI_HOST;
+
+EncoderSampler::EncoderSampler(int8_t clkPin, int8_t misoPin, int8_t mosiPin, int8_t csPin)
+    : clkPin(clkPin), misoPin(misoPin), mosiPin(mosiPin), csPin(csPin), running(false),
+      device(nullptr), timer(nullptr), task(nullptr), calibrationRequest(CALIBRATION_NONE), calibrated(false),
+      hasSavedCount(false), savedCount(0), parityErrors(0), busErrors(0), magnetWarnings(0)
+{
+}
+
+void EncoderSampler::setSavedCount(int64_t count)
+{
+    savedCount = count;
+    hasSavedCount = true;
+}
+
+bool EncoderSampler::setCalibration(const int16_t *table)
+{
+    // Validate here so callers get the answer now, not at the next sample
+    EncoderCalibration check;
+    if (!check.load(table))
+        return false;
+
+    // One request in flight: the sampling task copies the table out within 0.5 ms
+    while (calibrationRequest.load() != CALIBRATION_NONE)
+        delay(1);
+    memcpy(pendingTable, table, sizeof(pendingTable));
+    calibrationRequest.store(CALIBRATION_LOAD);
+    calibrated = true;
+    if (!running)
+        applyCalibrationRequest();
+    return true;
+}
+
+void EncoderSampler::clearCalibration()
+{
+    while (calibrationRequest.load() != CALIBRATION_NONE)
+        delay(1);
+    calibrationRequest.store(CALIBRATION_CLEAR);
+    calibrated = false;
+    if (!running)
+        applyCalibrationRequest();
+}
+
+void EncoderSampler::applyCalibrationRequest()
+{
+    uint8_t request = calibrationRequest.load();
+    if (request == CALIBRATION_LOAD)
+        calibration.load(pendingTable);
+    else if (request == CALIBRATION_CLEAR)
+        calibration.clear();
+    else
+        return;
+    calibrationRequest.store(CALIBRATION_NONE);
+}
+
+bool EncoderSampler::begin()
+{
+    if (running)
+        return true;
+
+    spi_bus_config_t bus = {};
+    bus.sclk_io_num = clkPin;
+    bus.miso_io_num = misoPin;
+    bus.mosi_io_num = mosiPin;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    bus.max_transfer_sz = 4;
+    if (spi_bus_initialize(ENCODER_HOST, &bus, SPI_DMA_CH_AUTO) != ESP_OK)
+    {
+        LOG_ERROR("Encoder SPI bus init failed");
+        return false;
+    }
+
+    // Hardware CS framing; the whole read is one transaction
+    spi_device_interface_config_t config = {};
+    config.mode = 3;
+    config.clock_speed_hz = SPI_CLOCK_HZ;
+    config.spics_io_num = csPin;
+    config.queue_size = 1;
+    spi_device_handle_t handle;
+    if (spi_bus_add_device(ENCODER_HOST, &config, &handle) != ESP_OK)
+    {
+        LOG_ERROR("Encoder SPI device add failed");
+        spi_bus_free(ENCODER_HOST);
+        return false;
+    }
+    device = handle;
+
+    // First sample seeds the multi-turn count before anything consumes the ring
+    EncoderSample first;
+    bool valid = false;
+    for (uint8_t attempt = 0; attempt < 3 && !valid; attempt++)
+    {
+        first.timestampUs = (uint32_t)esp_timer_get_time();
+        valid = readAngle(first.raw);
+    }
+    if (!valid)
+    {
+        LOG_ERROR("Encoder not responding");
+        return false;
+    }
+    first.angle = calibration.correct(first.raw);
+    if (hasSavedCount)
+        counter.restore(savedCount, first.angle);
+    else
+        counter.update(first.angle);
+    first.position = counter.getCount();
+    ring.push(first);
+
+    TaskHandle_t taskHandle;
+    if (xTaskCreatePinnedToCore(taskEntry, "EncoderTask", ENCODER_TASK_STACK, this,
+                                ENCODER_TASK_PRIORITY, &taskHandle, SYSTEM_CORE) != pdPASS)
+    {
+        LOG_ERROR("Encoder task creation failed");
+        return false;
+    }
+    task = taskHandle;
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = onTimer;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "encoder";
+    esp_timer_handle_t timerHandle;
+    if (esp_timer_create(&timerArgs, &timerHandle) != ESP_OK ||
+        esp_timer_start_periodic(timerHandle, 1000000 / SAMPLE_RATE_HZ) != ESP_OK)
+    {
+        LOG_ERROR("Encoder sample timer start failed");
+        return false;
+    }
+    timer = timerHandle;
+
+    running = true;
+    LOG_INFO("Encoder sampling at %u Hz, SPI %u MHz", SAMPLE_RATE_HZ, SPI_CLOCK_HZ / 1000000);
+    return true;
+}
+
+void EncoderSampler::onTimer(void *arg)
+{
+    // esp_timer task context: hand the SPI work to the sampling task
+    xTaskNotifyGive(static_cast<TaskHandle_t>(static_cast<EncoderSampler *>(arg)->task));
+}
+
+void EncoderSampler::taskEntry(void *arg)
+{
+    EncoderSampler *sampler = static_cast<EncoderSampler *>(arg);
+
+    // Only this task talks to the encoder: hold the bus so each frame skips arbitration
+    spi_device_acquire_bus(static_cast<spi_device_handle_t>(sampler->device), portMAX_DELAY);
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        sampler->sample();
+    }
+}
+
+bool EncoderSampler::readAngle(uint16_t &angle)
+{
+    // 3 bytes fit in the transaction itself: no buffers to allocate or DMA descriptors to set up
+    spi_transaction_t frame = {};
+    frame.flags = SPI_TRANS_USE_TXDATA | SPI_TRANS_USE_RXDATA;
+    frame.length = 24;
+    frame.tx_data[0] = READ_ANGLE;
+
+    if (spi_device_polling_transmit(static_cast<spi_device_handle_t>(device), &frame) != ESP_OK)
+    {
+        busErrors++;
+        return false;
+    }
+    if (!decode(frame.rx_data[1], frame.rx_data[2], angle))
+    {
+        parityErrors++;
+        return false;
+    }
+    if (frame.rx_data[2] & NO_MAGNET_BIT)
+        magnetWarnings++;
+    return true;
+}
+
+void EncoderSampler::sample()
+{
+    EncoderSample result;
+    result.timestampUs = (uint32_t)esp_timer_get_time();
+    if (!readAngle(result.raw))
+        return;
+
+    applyCalibrationRequest();
+    result.angle = calibration.correct(result.raw);
+
+    result.position = counter.update(result.angle);
+    ring.push(result);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include "../../BroadcastRing.h"
+#include "../MultiTurnCounter/MultiTurnCounter.h"
+#include "../EncoderCalibration/EncoderCalibration.h"
+
+struct EncoderSample
+{
+    uint32_t timestampUs; // esp_timer time at the start of the SPI frame
+    uint16_t angle;       // 0..16383, linearised when a calibration is loaded
+    uint16_t raw;         // 0..16383 as read from the sensor
+    int64_t position;     // Unwrapped multi-turn count
+};
+
+// Fixed-rate MT6816 sampling task
+// A periodic esp_timer wakes a dedicated task that reads the angle registers
+// (0x03/0x04) in one 3-byte burst frame on a bus it owns, unwraps every
+// sample (after the nonlinearity correction) into a 64-bit multi-turn count and publishes timestamped samples to
+// a broadcast ring. Any number of consumers (speed estimate, following error,
+// telemetry) read the ring with their own cursor, or just take the latest sample.
+class EncoderSampler
+{
+public:
+    static constexpr uint32_t SAMPLE_RATE_HZ = 2000;
+    static constexpr uint32_t SPI_CLOCK_HZ = 10000000; // MT6816 allows up to 15.6 MHz
+    static constexpr size_t RING_SIZE = 256;            // 128 ms of history at 2 kHz
+
+    typedef BroadcastRing<EncoderSample, RING_SIZE> Ring;
+
+    // Frame: command byte (read from 0x03), then registers 0x03 and 0x04
+    static constexpr uint8_t READ_ANGLE = 0x83;
+    static constexpr uint8_t NO_MAGNET_BIT = 0x02;
+
+    // Registers 0x03/0x04 carry angle[13:6], angle[5:0], no-magnet flag and an
+    // even parity bit over the whole 16-bit word
+    static bool decode(uint8_t reg3, uint8_t reg4, uint16_t &angle)
+    {
+        uint16_t word = (uint16_t)(reg3 << 8 | reg4);
+        word ^= word >> 8;
+        word ^= word >> 4;
+        word ^= word >> 2;
+        word ^= word >> 1;
+        if (word & 1)
+            return false;
+        angle = (uint16_t)(reg3 << 6 | reg4 >> 2);
+        return true;
+    }
+
+private:
+    int8_t clkPin;
+    int8_t misoPin;
+    int8_t mosiPin;
+    int8_t csPin;
+    bool running;
+
+    void *device; // spi_device_handle_t
+    void *timer;  // esp_timer_handle_t
+    void *task;   // TaskHandle_t
+
+    Ring ring;
+    MultiTurnCounter counter; // Sampling task only (and begin() before the task starts)
+    EncoderCalibration calibration; // Sampling task only, swapped in from pendingTable
+    int16_t pendingTable[EncoderCalibration::TABLE_SIZE];
+    std::atomic<uint8_t> calibrationRequest; // CalibrationRequest, taken by the sampling task
+    std::atomic<bool> calibrated;
+    bool hasSavedCount;
+    int64_t savedCount;
+    std::atomic<uint32_t> parityErrors;
+    std::atomic<uint32_t> busErrors;
+    std::atomic<uint32_t> magnetWarnings;
+
+    enum CalibrationRequest : uint8_t
+    {
+        CALIBRATION_NONE,
+        CALIBRATION_LOAD,
+        CALIBRATION_CLEAR
+    };
+
+    static void onTimer(void *arg);
+    void applyCalibrationRequest();
+    static void taskEntry(void *arg);
+    bool readAngle(uint16_t &angle);
+    void sample();
+
+public:
+    EncoderSampler(int8_t clkPin, int8_t misoPin, int8_t mosiPin, int8_t csPin);
+
+    // Continue the multi-turn count from a value saved before power-off (call before begin())
+    void setSavedCount(int64_t count);
+
+    // Nonlinearity correction (any task; takes effect from the next sample).
+    // setCalibration() is false if the table is out of range.
+    bool setCalibration(const int16_t *table);
+    void clearCalibration();
+    bool isCalibrated() const { return calibrated.load(); }
+
+    // Claim the SPI bus, take the first sample (seeds the multi-turn count),
+    // then start the sampling task and its timer
+    bool begin();
+    bool isRunning() const { return running; }
+
+    // Consumers (any task)
+    const Ring &samples() const { return ring; }
+    bool latest(EncoderSample &sample) const { return ring.latest(sample); }
+
+    uint32_t getSampleCount() const { return ring.written(); }
+    uint32_t getParityErrors() const { return parityErrors.load(); }
+    uint32_t getBusErrors() const { return busErrors.load(); }
+    uint32_t getMagnetWarnings() const { return magnetWarnings.load(); }
+};
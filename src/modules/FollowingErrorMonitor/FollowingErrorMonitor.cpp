@@ -0,0 +1,72 @@
+#include "FollowingErrorMonitor.h"
+
+FollowingErrorMonitor::FollowingErrorMonitor(long stepsPerRev)
+    : stepsPerRev(stepsPerRev), window(0), state(State::Suspended), polarity(0),
+      encoderCounts(0), countsAtSync(0), commandedAtSync(0),
+      measuredPosition(0), error(0), peakError(0), resyncRequested(false)
+{
+}
+
+void FollowingErrorMonitor::sync(long commanded)
+{
+    countsAtSync = encoderCounts;
+    commandedAtSync = commanded;
+    measuredPosition = commanded;
+    error = 0;
+    peakError = 0;
+    state = polarity ? State::Tracking : State::Learning;
+}
+
+void FollowingErrorMonitor::suspend()
+{
+    if (state != State::Fault)
+        state = State::Suspended;
+}
+
+FollowingErrorMonitor::State FollowingErrorMonitor::update(int64_t counts, long commanded)
+{
+    encoderCounts = counts;
+    if (resyncRequested.exchange(false) || state == State::Suspended)
+    {
+        sync(commanded);
+        return state;
+    }
+
+    if (state == State::Fault)
+        return state;
+
+    long commandedTravel = commanded - commandedAtSync;
+    long encoderTravel = (long)((encoderCounts - countsAtSync) * stepsPerRev / ENCODER_COUNTS);
+
+    if (state == State::Learning)
+    {
+        long commandedAbs = commandedTravel < 0 ? -commandedTravel : commandedTravel;
+        long encoderAbs = encoderTravel < 0 ? -encoderTravel : encoderTravel;
+        if (commandedAbs < POLARITY_LEARN_STEPS)
+            return state;
+
+        if (encoderAbs < commandedAbs / 2)
+        {
+            if (window == 0)
+                return state;
+            // Commanded an eighth of a turn and the shaft barely moved: stalled
+            measuredPosition = commandedAtSync + encoderAbs;
+            error = commandedTravel - (commandedTravel < 0 ? -encoderAbs : encoderAbs);
+            peakError = error;
+            state = State::Fault;
+            return state;
+        }
+        polarity = (encoderTravel < 0) == (commandedTravel < 0) ? 1 : -1;
+        state = State::Tracking;
+    }
+
+    measuredPosition = commandedAtSync + polarity * encoderTravel;
+    error = commanded - measuredPosition;
+    long errorAbs = error < 0 ? -error : error;
+    if (errorAbs > (peakError < 0 ? -peakError : peakError))
+        peakError = error;
+
+    if (window > 0 && errorAbs > window)
+        state = State::Fault;
+    return state;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+// Compares the MT6816 encoder against the commanded step position
+// Fed the sampler's unwrapped multi-turn count (EncoderSample::position), so
+// any amount of travel between updates is fine; counts are scaled to
+// microsteps. The first POLARITY_LEARN_STEPS of commanded travel after boot
+// learn which way the encoder counts; a motor that doesn't follow during that
+// travel faults as a stall. After that, a following error beyond the window
+// latches a fault until the next resync.
+class FollowingErrorMonitor
+{
+public:
+    static constexpr int32_t ENCODER_COUNTS = 16384;      // MT6816 counts per revolution
+    static constexpr long DEFAULT_STEPS_PER_REV = 1600;   // 200 full steps × 8 microsteps
+    static constexpr long POLARITY_LEARN_STEPS = 200;     // 1/8 revolution
+
+    enum class State : uint8_t
+    {
+        Suspended, // Driver disabled: the shaft is free, nothing to compare
+        Learning,  // Waiting for enough travel to learn encoder polarity
+        Tracking,
+        Fault
+    };
+
+private:
+    long stepsPerRev;
+    volatile long window; // Microsteps, 0 = never fault
+    State state;
+    int8_t polarity;      // +1/-1 once learned, 0 = unknown
+
+    int64_t encoderCounts; // Multi-turn encoder position at the last update
+    int64_t countsAtSync;
+    long commandedAtSync;
+
+    long measuredPosition;
+    long error;
+    long peakError;
+
+    std::atomic<bool> resyncRequested;
+
+    void sync(long commanded);
+
+public:
+    explicit FollowingErrorMonitor(long stepsPerRev = DEFAULT_STEPS_PER_REV);
+
+    void setWindow(long steps) { window = steps < 0 ? 0 : steps; }
+    long getWindow() const { return window; }
+
+    // Sampling task: feed the multi-turn encoder count and the commanded position at that moment
+    State update(int64_t counts, long commanded);
+    void suspend(); // Driver disabled; a latched fault is kept
+
+    // Any task: commanded position jumped or a fault was acknowledged.
+    // The next update() re-zeroes the comparison (and clears a fault).
+    void requestResync() { resyncRequested.store(true); }
+
+    State getState() const { return state; }
+    bool isFaulted() const { return state == State::Fault; }
+    long getMeasuredPosition() const { return measuredPosition; }
+    long getError() const { return error; }
+    long getPeakError() const { return peakError; }
+    int8_t getPolarity() const { return polarity; }
+    int64_t getEncoderCounts() const { return encoderCounts; }
+};
@@ -0,0 +1,78 @@
+#include "HomingSequence.h"
+
+HomingSequence::HomingSequence()
+    : phase(Phase::Idle), direction(1), maxTravel(DEFAULT_MAX_TRAVEL), fastStop(0), stopPosition(0),
+      failure("")
+{
+}
+
+HomingSequence::Move HomingSequence::fail(const char *reason)
+{
+    phase = Phase::Failed;
+    failure = reason;
+    return Move{false, 0, 0};
+}
+
+HomingSequence::Move HomingSequence::start(int8_t dir, long position, long travel)
+{
+    direction = dir < 0 ? -1 : 1;
+    maxTravel = travel > 0 ? travel : DEFAULT_MAX_TRAVEL;
+    failure = "";
+    phase = Phase::FastApproach;
+    return moveTo(position + direction * maxTravel, FAST_SPEED);
+}
+
+HomingSequence::Move HomingSequence::onStall(long position)
+{
+    switch (phase)
+    {
+    case Phase::FastApproach:
+        fastStop = position;
+        phase = Phase::BackOff;
+        return moveTo(position - direction * BACKOFF_STEPS, FAST_SPEED);
+
+    case Phase::SlowSeek:
+    {
+        // The stop doesn't move: a stall well short of the fast one was load, not the stop
+        long shortfall = (fastStop - position) * direction;
+        if (shortfall > BACKOFF_STEPS / 2)
+            return fail("slow seek stalled short of the stop");
+        stopPosition = position;
+        phase = Phase::Release;
+        return moveTo(position - direction * RELEASE_STEPS, SLOW_SPEED);
+    }
+
+    default:
+        return Move{false, 0, 0};
+    }
+}
+
+HomingSequence::Move HomingSequence::onStopped(long position)
+{
+    switch (phase)
+    {
+    case Phase::FastApproach:
+        return fail("no stall within the travel limit");
+
+    case Phase::BackOff:
+        phase = Phase::SlowSeek;
+        // Twice the back-off: reaching the target means the stop wasn't where it was
+        return moveTo(position + direction * 2 * BACKOFF_STEPS, SLOW_SPEED);
+
+    case Phase::SlowSeek:
+        return fail("no stall on the slow seek");
+
+    case Phase::Release:
+        phase = Phase::Done;
+        return Move{false, 0, 0};
+
+    default:
+        return Move{false, 0, 0};
+    }
+}
+
+void HomingSequence::abort()
+{
+    if (isActive())
+        fail("aborted");
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+
+// Sensorless homing against a hard stop
+// Fast approach until StallGuard reports a stall, back off, then re-seek the
+// stop slowly: the slow pass gives the repeatable position, the fast pass
+// keeps homing short. Finishes by releasing the stop by a margin, so the
+// motor never rests pressed against it. The caller runs the moves and
+// reports stalls and stops; this class only decides what comes next.
+class HomingSequence
+{
+public:
+    enum class Phase : uint8_t
+    {
+        Idle,
+        FastApproach,
+        BackOff,
+        SlowSeek,
+        Release,
+        Done,
+        Failed
+    };
+
+    struct Move
+    {
+        bool valid; // false: nothing to start (finished, failed or idle)
+        long target;
+        long speed; // steps/sec
+    };
+
+    static constexpr long FAST_SPEED = 1600;         // steps/sec (1 rev/s)
+    static constexpr long SLOW_SPEED = 400;          // steps/sec
+    static constexpr long BACKOFF_STEPS = 400;       // Quarter turn: room to reach SLOW_SPEED
+    static constexpr long RELEASE_STEPS = 80;        // 10 full steps clear of the stop
+    static constexpr long DEFAULT_MAX_TRAVEL = 16000; // 10 turns
+
+private:
+    Phase phase;
+    int8_t direction; // +1 towards higher positions
+    long maxTravel;
+    long fastStop;    // Where the fast approach stalled
+    long stopPosition; // Where the slow seek stalled: the home position
+    const char *failure;
+
+    Move moveTo(long target, long speed) { return Move{true, target, speed}; }
+    Move fail(const char *reason);
+
+public:
+    HomingSequence();
+
+    // Begin a run towards the stop in 'direction' from 'position'; returns the first move
+    Move start(int8_t direction, long position, long maxTravel = DEFAULT_MAX_TRAVEL);
+
+    // The current move stalled at 'position' (only while isSeeking())
+    Move onStall(long position);
+
+    // The current move ended without a stall
+    Move onStopped(long position);
+
+    void abort();
+
+    Phase getPhase() const { return phase; }
+    bool isActive() const { return phase != Phase::Idle && phase != Phase::Done && phase != Phase::Failed; }
+    bool isSeeking() const { return phase == Phase::FastApproach || phase == Phase::SlowSeek; }
+    int8_t getDirection() const { return direction; }
+    long getStopPosition() const { return stopPosition; } // Valid once Done
+    const char *getFailure() const { return failure; }     // Valid once Failed
+};
@@ -0,0 +1,52 @@
+#include "StallDetector.h"
+
+StallDetector::StallDetector()
+    : threshold(DEFAULT_THRESHOLD), minSpeed(0), armCount(0), lowCount(0), stalled(false),
+      lastResult(0), minResult(UINT16_MAX)
+{
+}
+
+void StallDetector::reset()
+{
+    armCount = 0;
+    lowCount = 0;
+    stalled = false;
+    lastResult = 0;
+    minResult = UINT16_MAX;
+}
+
+bool StallDetector::update(uint16_t sgResult, float speed)
+{
+    lastResult = sgResult;
+    if (stalled)
+        return true;
+
+    if (speed < 0)
+        speed = -speed;
+    if (speed < minSpeed)
+    {
+        // Ramping: readings mean nothing until the speed has been back up for a while
+        armCount = 0;
+        lowCount = 0;
+        return false;
+    }
+    if (armCount < ARM_SAMPLES)
+    {
+        armCount++;
+        return false;
+    }
+
+    if (sgResult < minResult)
+        minResult = sgResult;
+
+    if (sgResult <= 2 * (uint16_t)threshold)
+    {
+        if (++lowCount >= CONFIRM_SAMPLES)
+            stalled = true;
+    }
+    else
+    {
+        lowCount = 0;
+    }
+    return stalled;
+}
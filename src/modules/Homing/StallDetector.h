@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+// TMC2209 StallGuard4 stall detection from polled SG_RESULT readings
+// Same rule as the driver's DIAG output (SG_RESULT <= 2 * SGTHRS), but only
+// trusted once the motor has run at speed for a while: SG_RESULT reads low
+// while accelerating from rest and while slowing down at the end of a move.
+// A stall must persist for CONFIRM_SAMPLES readings so single dips from
+// load ripple don't stop a homing run.
+class StallDetector
+{
+public:
+    static constexpr uint8_t DEFAULT_THRESHOLD = 50; // SGTHRS: stall at SG_RESULT <= 100
+    static constexpr uint8_t ARM_SAMPLES = 8;        // Readings at speed before SG_RESULT is trusted
+    static constexpr uint8_t CONFIRM_SAMPLES = 3;    // Consecutive low readings for a stall
+
+private:
+    uint8_t threshold;
+    float minSpeed; // steps/sec
+    uint8_t armCount;
+    uint8_t lowCount;
+    bool stalled;
+    uint16_t lastResult;
+    uint16_t minResult; // Lowest armed reading since reset (threshold tuning)
+
+public:
+    StallDetector();
+
+    void setThreshold(uint8_t sgthrs) { threshold = sgthrs; }
+    uint8_t getThreshold() const { return threshold; }
+    void setMinSpeed(float stepsPerSec) { minSpeed = stepsPerSec; }
+
+    void reset();
+
+    // One SG_RESULT reading with the commanded speed at the time; true once stalled (latched)
+    bool update(uint16_t sgResult, float speed);
+
+    bool isStalled() const { return stalled; }
+    bool isArmed() const { return armCount >= ARM_SAMPLES; }
+    uint16_t getLastResult() const { return lastResult; }
+    uint16_t getMinResult() const { return minResult; }
+};
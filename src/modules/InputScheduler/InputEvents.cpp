@@ -0,0 +1,90 @@
+#include "InputEvents.h"
+#include <esp_timer.h>
+
+// Global instance
+InputScheduler inputScheduler;
+
+static TaskHandle_t eventTask = NULL;
+
+// Guards the posts (ISRs on either core) and the schedule they are handed to
+static portMUX_TYPE eventMux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t postedEvents = 0;
+static uint32_t postedTimeUs[InputScheduler::MAX_EVENTS];
+
+// Guards the scheduler's stats (InputTask updates, web server reads). A mutex:
+// the double-precision updates are soft-float and must not mask interrupts.
+static StaticSemaphore_t statsMutexBuffer;
+static SemaphoreHandle_t statsMutex = xSemaphoreCreateMutexStatic(&statsMutexBuffer);
+
+void setInputEventTask(TaskHandle_t task)
+{
+    eventTask = task;
+}
+
+void IRAM_ATTR postInputEventFromISR(InputEvent event)
+{
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    uint32_t bit = 1UL << event;
+
+    portENTER_CRITICAL_ISR(&eventMux);
+    if (!(postedEvents & bit))
+        postedTimeUs[event] = now; // Latency counts from the first post not yet taken
+    postedEvents |= bit;
+    portEXIT_CRITICAL_ISR(&eventMux);
+
+    if (eventTask)
+    {
+        BaseType_t woken = pdFALSE;
+        xTaskNotifyFromISR(eventTask, bit, eSetBits, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+void waitInputEvents(InputScheduler &scheduler, uint32_t timeoutUs)
+{
+    // Round up: waking a tick early would only find nothing due and sleep again
+    TickType_t ticks = (timeoutUs + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000);
+    uint32_t bits = 0;
+    xTaskNotifyWait(0, UINT32_MAX, &bits, ticks);
+
+    // The bits only woke us: the posts themselves are taken under the lock, so
+    // one that lands after the wait is kept for the next round, not lost
+    portENTER_CRITICAL(&eventMux);
+    uint32_t events = postedEvents;
+    postedEvents = 0;
+    for (uint8_t e = 0; e < InputScheduler::MAX_EVENTS; e++)
+    {
+        if (events & (1UL << e))
+            scheduler.post(e, postedTimeUs[e]);
+    }
+    portEXIT_CRITICAL(&eventMux);
+}
+
+uint32_t dueInputConsumers(InputScheduler &scheduler, uint32_t nowUs)
+{
+    uint32_t latencyUs[InputScheduler::MAX_CONSUMERS];
+    portENTER_CRITICAL(&eventMux);
+    uint32_t run = scheduler.take(nowUs, latencyUs);
+    portEXIT_CRITICAL(&eventMux);
+
+    xSemaphoreTake(statsMutex, portMAX_DELAY);
+    scheduler.record(run, latencyUs);
+    xSemaphoreGive(statsMutex);
+    return run;
+}
+
+uint8_t readInputStats(InputSourceStats *out, uint8_t max)
+{
+    xSemaphoreTake(statsMutex, portMAX_DELAY);
+    uint8_t count = inputScheduler.getCount() < max ? inputScheduler.getCount() : max;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const TimingStats &latency = inputScheduler.getLatency(i);
+        out[i].name = inputScheduler.getName(i);
+        out[i].runs = inputScheduler.getRuns(i);
+        out[i].meanUs = (uint32_t)latency.getMean();
+        out[i].maxUs = (uint32_t)latency.getMax();
+    }
+    xSemaphoreGive(statsMutex);
+    return count;
+}
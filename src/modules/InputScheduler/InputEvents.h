@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Arduino.h>
+#include "InputScheduler.h"
+
+// Events the input ISRs post to InputTask, as InputScheduler event indexes
+enum InputEvent : uint8_t
+{
+    INPUT_EVENT_BUTTONS = 0, // A button pin changed
+    INPUT_EVENT_LIMITS = 1   // A limit switch pin changed
+};
+
+// Latency of one InputTask consumer, copied out for the web server
+struct InputSourceStats
+{
+    const char *name;
+    uint32_t runs;
+    uint32_t meanUs;
+    uint32_t maxUs;
+};
+
+// Task the posts wake (InputTask, once it runs; posts before that are kept)
+void setInputEventTask(TaskHandle_t task);
+
+// ISR side: note the event with its time and notify the task
+void IRAM_ATTR postInputEventFromISR(InputEvent event);
+
+// Task side: sleep until a post or 'timeoutUs', then hand the posts to the scheduler
+void waitInputEvents(InputScheduler &scheduler, uint32_t timeoutUs);
+
+// Task side: take the due consumers with the posts locked out, then record
+// their latencies where readInputStats() can't see them half done
+uint32_t dueInputConsumers(InputScheduler &scheduler, uint32_t nowUs);
+
+// Any task: per-consumer latency, returns the number copied
+uint8_t readInputStats(InputSourceStats *out, uint8_t max);
+
+extern InputScheduler inputScheduler;
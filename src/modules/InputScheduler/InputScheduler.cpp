@@ -0,0 +1,137 @@
+#include "InputScheduler.h"
+
+InputScheduler::InputScheduler() : count(0), pendingEvents(0)
+{
+    for (uint8_t i = 0; i < MAX_EVENTS; i++)
+        eventTimeUs[i] = 0;
+}
+
+uint8_t InputScheduler::add(const char *name, uint32_t periodUs, uint32_t eventMask, uint32_t nowUs)
+{
+    if (count >= MAX_CONSUMERS)
+        return MAX_CONSUMERS;
+
+    Consumer &consumer = consumers[count];
+    consumer.name = name;
+    consumer.periodUs = periodUs;
+    consumer.eventMask = eventMask;
+    consumer.nextDueUs = nowUs + periodUs;
+    consumer.wakeRequested = false;
+    consumer.wakeAtUs = 0;
+    consumer.runs = 0;
+    consumer.latency.reset();
+    return count++;
+}
+
+void InputScheduler::post(uint8_t index, uint32_t timeUs)
+{
+    if (index >= MAX_EVENTS)
+        return;
+    // Keep the oldest post: latency is measured from the first one not yet handled
+    if (!(pendingEvents & (1UL << index)))
+        eventTimeUs[index] = timeUs;
+    pendingEvents |= 1UL << index;
+}
+
+void InputScheduler::wakeAt(uint8_t consumer, uint32_t atUs)
+{
+    if (consumer >= count)
+        return;
+    consumers[consumer].wakeRequested = true;
+    consumers[consumer].wakeAtUs = atUs;
+}
+
+// Run 'since' back to the earliest reason the consumer is due
+static void noteDue(bool &ready, uint32_t &since, uint32_t atUs)
+{
+    if (!ready || (int32_t)(atUs - since) < 0)
+        since = atUs;
+    ready = true;
+}
+
+uint32_t InputScheduler::take(uint32_t nowUs, uint32_t *latencyUs)
+{
+    uint32_t run = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        Consumer &consumer = consumers[i];
+        bool ready = false;
+        uint32_t since = nowUs;
+
+        uint32_t events = consumer.eventMask & pendingEvents;
+        for (uint8_t e = 0; e < MAX_EVENTS; e++)
+        {
+            if (events & (1UL << e))
+                noteDue(ready, since, eventTimeUs[e]);
+        }
+
+        if (consumer.periodUs && reached(nowUs, consumer.nextDueUs))
+        {
+            noteDue(ready, since, consumer.nextDueUs);
+            // Next period from the schedule, not from now; skip the ones missed entirely
+            consumer.nextDueUs += consumer.periodUs;
+            if (reached(nowUs, consumer.nextDueUs))
+                consumer.nextDueUs = nowUs + consumer.periodUs;
+        }
+
+        if (consumer.wakeRequested && reached(nowUs, consumer.wakeAtUs))
+        {
+            noteDue(ready, since, consumer.wakeAtUs);
+            consumer.wakeRequested = false;
+        }
+
+        if (ready)
+        {
+            run |= 1UL << i;
+            latencyUs[i] = nowUs - since;
+        }
+    }
+    pendingEvents = 0;
+    return run;
+}
+
+void InputScheduler::record(uint32_t run, const uint32_t *latencyUs)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (!(run & (1UL << i)))
+            continue;
+        consumers[i].runs++;
+        consumers[i].latency.add((int32_t)latencyUs[i]);
+    }
+}
+
+uint32_t InputScheduler::due(uint32_t nowUs)
+{
+    uint32_t latencyUs[MAX_CONSUMERS];
+    uint32_t run = take(nowUs, latencyUs);
+    record(run, latencyUs);
+    return run;
+}
+
+uint32_t InputScheduler::sleepTime(uint32_t nowUs) const
+{
+    if (pendingEvents)
+        return 0;
+
+    uint32_t sleep = MAX_SLEEP_US;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const Consumer &consumer = consumers[i];
+        if (consumer.periodUs)
+        {
+            if (reached(nowUs, consumer.nextDueUs))
+                return 0;
+            if (consumer.nextDueUs - nowUs < sleep)
+                sleep = consumer.nextDueUs - nowUs;
+        }
+        if (consumer.wakeRequested)
+        {
+            if (reached(nowUs, consumer.wakeAtUs))
+                return 0;
+            if (consumer.wakeAtUs - nowUs < sleep)
+                sleep = consumer.wakeAtUs - nowUs;
+        }
+    }
+    return sleep;
+}
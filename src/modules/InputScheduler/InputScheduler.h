@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include "../../TimingStats.h"
+
+// Decides which InputTask consumers run on each wakeup
+// Every consumer declares a period (0 = none), the event bits it reacts to
+// and may ask for a one-off wake at a deadline (debounce, long press). The
+// task sleeps until the earliest due time or until an ISR posts an event.
+// Latency per consumer: post to run for events, due time to run for periods
+// and deadlines. Times are 32-bit µs and may wrap.
+class InputScheduler
+{
+public:
+    static constexpr uint8_t MAX_CONSUMERS = 8;
+    static constexpr uint8_t MAX_EVENTS = 8;
+    static constexpr uint32_t MAX_SLEEP_US = 1000000; // Wake at least this often
+
+private:
+    struct Consumer
+    {
+        const char *name;
+        uint32_t periodUs;
+        uint32_t eventMask;
+        uint32_t nextDueUs;  // Valid with periodUs
+        bool wakeRequested;
+        uint32_t wakeAtUs;
+        uint32_t runs;
+        TimingStats latency;
+    };
+
+    Consumer consumers[MAX_CONSUMERS];
+    uint8_t count;
+    uint32_t pendingEvents;
+    uint32_t eventTimeUs[MAX_EVENTS]; // First post of each pending event
+
+    static bool reached(uint32_t nowUs, uint32_t atUs) { return (int32_t)(nowUs - atUs) >= 0; }
+
+public:
+    InputScheduler();
+
+    // Returns the consumer's index (its bit in due()), or MAX_CONSUMERS when full
+    uint8_t add(const char *name, uint32_t periodUs, uint32_t eventMask, uint32_t nowUs);
+
+    // Event 'index' (bit 1 << index) was posted at 'timeUs'
+    void post(uint8_t index, uint32_t timeUs);
+
+    // One-off wake for 'consumer' at 'atUs' (replaces an earlier request)
+    void wakeAt(uint8_t consumer, uint32_t atUs);
+
+    // Consumers to run now, as a bit mask; takes the pending events. Writes the
+    // latency of each consumer in the mask to latencyUs[consumer]. Integer only,
+    // so it can run with interrupts masked; record() does the statistics.
+    uint32_t take(uint32_t nowUs, uint32_t *latencyUs);
+    void record(uint32_t run, const uint32_t *latencyUs);
+
+    // take() and record() in one go
+    uint32_t due(uint32_t nowUs);
+
+    // µs until the next period or deadline is due (0 = something is due now)
+    uint32_t sleepTime(uint32_t nowUs) const;
+
+    uint8_t getCount() const { return count; }
+    const char *getName(uint8_t consumer) const { return consumers[consumer].name; }
+    uint32_t getRuns(uint8_t consumer) const { return consumers[consumer].runs; }
+    const TimingStats &getLatency(uint8_t consumer) const { return consumers[consumer].latency; }
+};
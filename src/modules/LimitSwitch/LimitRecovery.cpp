@@ -0,0 +1,88 @@
+#include "LimitRecovery.h"
+
+LimitRecovery::LimitRecovery()
+    : phase(Phase::Idle), side(1), limitPosition(0), backoff(DEFAULT_BACKOFF_STEPS), attempts(0), failure("")
+{
+}
+
+void LimitRecovery::setBackoff(long steps)
+{
+    if (steps < 0)
+        steps = 0;
+    if (steps > MAX_BACKOFF_STEPS)
+        steps = MAX_BACKOFF_STEPS;
+    backoff = steps;
+}
+
+LimitRecovery::Move LimitRecovery::fail(const char *reason)
+{
+    phase = Phase::Failed;
+    failure = reason;
+    return Move{false, 0, 0};
+}
+
+LimitRecovery::Move LimitRecovery::backOffFrom(long position)
+{
+    attempts++;
+    phase = Phase::BackingOff;
+    return Move{true, position - side * backoff, SPEED};
+}
+
+void LimitRecovery::latch(int8_t limitSide, long position)
+{
+    side = limitSide < 0 ? -1 : 1;
+    limitPosition = position;
+    attempts = 0;
+    failure = "";
+    phase = Phase::Latched;
+}
+
+LimitRecovery::Move LimitRecovery::start(long position)
+{
+    if (phase != Phase::Latched)
+        return Move{false, 0, 0};
+    if (backoff <= 0)
+        return fail("automatic recovery disabled");
+
+    // Count from whichever of the trip and stop positions is further from the switch
+    long from = (position - limitPosition) * side < 0 ? position : limitPosition;
+    return backOffFrom(from);
+}
+
+LimitRecovery::Move LimitRecovery::onStopped(long position, bool switchClosed)
+{
+    if (phase != Phase::BackingOff)
+        return Move{false, 0, 0};
+
+    if (!switchClosed)
+    {
+        phase = Phase::Done;
+        return Move{false, 0, 0};
+    }
+    if (attempts >= MAX_ATTEMPTS)
+        return fail("switch still closed after backing off");
+    return backOffFrom(position);
+}
+
+void LimitRecovery::abort(const char *reason)
+{
+    if (isActive())
+        fail(reason);
+}
+
+const char *LimitRecovery::getPhaseName() const
+{
+    switch (phase)
+    {
+    case Phase::Latched:
+        return "latched";
+    case Phase::BackingOff:
+        return "backingOff";
+    case Phase::Done:
+        return "done";
+    case Phase::Failed:
+        return "failed";
+    default:
+        return "idle";
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdint.h>
+
+// Automatic back-off after a limit switch stop
+// The switch latches the emergency stop; once the motor is at rest this backs
+// it off the switch at a safe speed and checks that the switch opened, then
+// the caller re-arms it. A switch that stays closed gets one more back-off
+// before the stop is left latched for the operator. The caller runs the moves
+// and reads the switch; this class only decides what comes next.
+class LimitRecovery
+{
+public:
+    enum class Phase : uint8_t
+    {
+        Idle,
+        Latched,    // Stopped on the switch, waiting for standstill
+        BackingOff,
+        Done,       // Switch open again: re-arm it
+        Failed      // Emergency stop stays latched
+    };
+
+    struct Move
+    {
+        bool valid; // false: nothing to start (finished, failed or idle)
+        long target;
+        long speed; // steps/sec
+    };
+
+    static constexpr long SPEED = 400;                // steps/sec: stops within a step or two
+    static constexpr long DEFAULT_BACKOFF_STEPS = 160; // 20 full steps
+    static constexpr long MAX_BACKOFF_STEPS = 1600;    // One turn
+    static constexpr uint8_t MAX_ATTEMPTS = 2;
+
+private:
+    Phase phase;
+    int8_t side;        // Switch end: -1 = min, +1 = max
+    long limitPosition; // Where the switch tripped
+    long backoff;
+    uint8_t attempts;
+    const char *failure;
+
+    Move backOffFrom(long position);
+    Move fail(const char *reason);
+
+public:
+    LimitRecovery();
+
+    // 0 disables automatic recovery: the stop stays latched until a reset
+    void setBackoff(long steps);
+    long getBackoff() const { return backoff; }
+    bool isEnabled() const { return backoff > 0; }
+
+    // The switch at 'side' tripped at 'position'; the motor is being stopped
+    void latch(int8_t side, long position);
+
+    // Motor at rest after the stop (only while Latched); returns the back-off move
+    Move start(long position);
+
+    // The back-off move ended at 'position'; 'switchClosed' as read now
+    Move onStopped(long position, bool switchClosed);
+
+    void abort(const char *reason);
+
+    Phase getPhase() const { return phase; }
+    bool isActive() const { return phase == Phase::Latched || phase == Phase::BackingOff; }
+    int8_t getSide() const { return side; }
+    long getLimitPosition() const { return limitPosition; }
+    uint8_t getAttempts() const { return attempts; }
+    const char *getFailure() const { return failure; } // Valid once Failed
+    const char *getPhaseName() const;
+};
@@ -1,25 +1,23 @@
 #include "LimitSwitch.h"
 #include "../MotorController/MotorController.h"
 #include "../Configuration/Configuration.h"
+#include "../InputScheduler/InputEvents.h"
 #include "util.h"
+#include <esp_timer.h>
+#include <esp_cpu.h>
+#include <soc/gpio_struct.h>
+
+static constexpr LogModule logModule = LogModule::LimitSwitch;
 
 // Global instances
 LimitSwitch minLimitSwitch(21);
 LimitSwitch maxLimitSwitch(22);
 
-// Static member initialization
-LimitSwitch* LimitSwitch::instances[2] = {nullptr, nullptr};
-uint8_t LimitSwitch::instanceCount = 0;
-
 LimitSwitch::LimitSwitch(uint8_t limitPin)
-    : pin(limitPin), storedPosition(0), triggered(false), pending(false),
-      onLimitTriggered(nullptr), instanceIndex(instanceCount++)
+    : pin(limitPin), storedPosition(0), triggered(false), pending(false), tripTimeUs(0), stopTimeUs(0),
+      latency{0, 0, 0, 0, 0}, glitches(0), tripCycles(0), releaseCycles(0), released(false), stepsCaptured(false),
+      tripSteps(0), motorWasStopped(false), onLimitTriggered(nullptr)
 {
-    // Register this instance for ISR routing
-    if (instanceIndex < 2)
-    {
-        instances[instanceIndex] = this;
-    }
 }
 
 bool LimitSwitch::begin()
@@ -27,8 +25,9 @@ bool LimitSwitch::begin()
     // Configure pin as INPUT_PULLUP (switch is active LOW)
     pinMode(pin, INPUT_PULLUP);
 
-    // Attach hardware interrupt on FALLING edge (switch closes to ground)
-    attachInterrupt(digitalPinToInterrupt(pin), onISR, FALLING);
+    // Own interrupt per pin, on both edges: closing (to ground) trips, the
+    // first opening after it tells a glitch from the switch
+    attachInterruptArg(digitalPinToInterrupt(pin), onISR, this, CHANGE);
 
     LOG_INFO("Limit switch initialized with interrupt on pin %d", pin);
     return true;
@@ -46,28 +45,54 @@ void LimitSwitch::update()
 
     if (pending)
     {
+        uint32_t handledUs = (uint32_t)esp_timer_get_time() - tripTimeUs;
+
+        // Woken straight from the closing edge: give a glitch the time to open again
+        if (!released && handledUs < GLITCH_US)
+            return;
+
+        // Open again after a very short closure: noise, nothing to learn or latch
+        uint32_t closedUs = (releaseCycles - tripCycles) / getCpuFrequencyMhz();
+        if (released && !isPressed() && closedUs < GLITCH_US)
+        {
+            ignoreGlitch(closedUs);
+            return;
+        }
+
         pending = false;
         triggered = true;
 
-        // Stop motor immediately (safe in task context)
-        motorController.emergencyStop();
-
-        // Get current position
-        long currentPos = motorController.getCurrentPosition();
+        latency.events++;
+        latency.stopUs = stopTimeUs - tripTimeUs;
+        latency.handledUs = handledUs;
+        if (latency.stopUs > latency.maxStopUs)
+            latency.maxStopUs = latency.stopUs;
+        if (handledUs > latency.maxHandledUs)
+            latency.maxHandledUs = handledUs;
+
+        // Position at the edge: exact on the timer engine, which the ISR parked
+        long currentPos = stepsCaptured ? motorController.toLogicalPosition(tripSteps)
+                                        : motorController.getCurrentPosition();
         storedPosition = currentPos;
 
+        // The ISR only parked the motor: latch the full stop, the motor loop backs
+        // off the switch once at rest
+        motorController.emergencyStopWithRecovery(currentPos, this == &minLimitSwitch ? -1 : 1);
+
         // Determine which limit switch this is and save position
         if (this == &minLimitSwitch)
         {
             config.setLimitPos1(currentPos);
             config.saveLimitPositions(currentPos, config.getLimitPos2());
-            LOG_WARN("MIN limit switch triggered at position: %ld", currentPos);
+            LOG_WARN("MIN limit switch triggered at position: %ld (stopped in %u us, handled after %u us)", currentPos,
+                     latency.stopUs, latency.handledUs);
         }
         else if (this == &maxLimitSwitch)
         {
             config.setLimitPos2(currentPos);
             config.saveLimitPositions(config.getLimitPos1(), currentPos);
-            LOG_WARN("MAX limit switch triggered at position: %ld", currentPos);
+            LOG_WARN("MAX limit switch triggered at position: %ld (stopped in %u us, handled after %u us)", currentPos,
+                     latency.stopUs, latency.handledUs);
         }
 
         // Broadcast status update to webapp (WebSocket - NOT ISR-safe)
@@ -82,26 +107,62 @@ void LimitSwitch::update()
     }
 }
 
+void LimitSwitch::ignoreGlitch(uint32_t closedUs)
+{
+    glitches++;
+    pending = false;
+
+    // The ISR parked the motor on the edge: only the segment it cut short ends,
+    // the motion queue and the commands posted meanwhile carry on
+    if (!motorWasStopped)
+        motorController.resumeAfterISRHalt();
+    LOG_WARN("Limit switch on pin %d: %u us glitch ignored (segment ended, %u so far)", pin, closedUs, glitches);
+}
+
 // Static ISR handler (IRAM_ATTR ensures it's in RAM for fast execution)
-// CRITICAL: ISR must be MINIMAL - only set flags
-void IRAM_ATTR LimitSwitch::onISR()
+// CRITICAL: ISR must be MINIMAL - stop the motor through registers, capture the
+// edge and set flags; NVS writes and broadcasts wait for update()
+void IRAM_ATTR LimitSwitch::onISR(void *arg)
 {
-    // Check which instance triggered by reading pin states
-    for (uint8_t i = 0; i < instanceCount; i++)
+    LimitSwitch *self = static_cast<LimitSwitch *>(arg);
+    uint32_t cycles = esp_cpu_get_ccount();
+    bool closed = ((GPIO.in >> self->pin) & 1) == 0; // Register read: pins 21/22
+
+    if (closed)
     {
-        if (instances[i] && digitalRead(instances[i]->pin) == LOW)
-        {
-            // Only trigger once - ignore subsequent bounces until cleared
-            if (!instances[i]->pending)
-            {
-                instances[i]->pending = true;
-            }
-        }
+        // Only trigger once - ignore subsequent bounces until cleared
+        if (self->pending || self->triggered)
+            return;
+        self->tripTimeUs = (uint32_t)esp_timer_get_time();
+        self->tripCycles = cycles;
+        self->released = false;
+        self->motorWasStopped = motorController.isEmergencyStopActive();
+        long steps = 0;
+        self->stepsCaptured = motorController.stopFromISR(steps);
+        self->tripSteps = steps;
+        self->stopTimeUs = (uint32_t)esp_timer_get_time();
+        self->pending = true;
+        postInputEventFromISR(INPUT_EVENT_LIMITS);
     }
+    else if (self->pending && !self->released)
+    {
+        self->releaseCycles = cycles;
+        self->released = true;
+        postInputEventFromISR(INPUT_EVENT_LIMITS);
+    }
+}
+
+bool LimitSwitch::nextDeadline(uint32_t &atUs) const
+{
+    if (!pending || released)
+        return false;
+    atUs = tripTimeUs + GLITCH_US;
+    return true;
 }
 
 void LimitSwitch::clearTrigger()
 {
+    // 'pending' belongs to the ISR and update(): a trip still waiting for
+    // update() must be handled, not dropped by a reset
     triggered = false;
-    pending = false;
 }
\ No newline at end of file
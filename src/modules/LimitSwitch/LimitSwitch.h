@@ -3,23 +3,46 @@
 #include <Arduino.h>
 
 class LimitSwitch {
+public:
+    // A closure that opens again within this long is noise on the line, not the switch
+    static constexpr uint32_t GLITCH_US = 20;
+
+    // Trip latencies in µs from ISR entry: 'stop' until the driver is off and
+    // the step timer parked (in the ISR), 'handled' until update() picked it up
+    struct Latency {
+        uint32_t events;
+        uint32_t stopUs;
+        uint32_t maxStopUs;
+        uint32_t handledUs;
+        uint32_t maxHandledUs;
+    };
+
 private:
     uint8_t pin;
     long storedPosition;
     volatile bool triggered;
     volatile bool pending;
+    volatile uint32_t tripTimeUs;
+    volatile uint32_t stopTimeUs;
+    Latency latency; // InputTask only
+    uint32_t glitches;
+
+    // Captured by the ISR at the closing edge
+    volatile uint32_t tripCycles;    // CPU cycle counter at the edge
+    volatile uint32_t releaseCycles; // First opening edge after it
+    volatile bool released;
+    volatile bool stepsCaptured;     // tripSteps valid (timer step engine)
+    volatile long tripSteps;         // Engine position the motor stopped at
+    volatile bool motorWasStopped;   // Emergency stop already active before the trip
 
     // Callback function type for limit switch events
     typedef void (*LimitSwitchCallback)(long position);
     LimitSwitchCallback onLimitTriggered;
 
-    // ISR handler (must be static for attachInterrupt)
-    static void IRAM_ATTR onISR();
+    // ISR handler: one per pin, both edges, 'arg' is the instance
+    static void IRAM_ATTR onISR(void *arg);
 
-    // Instance tracking for ISR routing
-    static LimitSwitch* instances[2];
-    static uint8_t instanceCount;
-    uint8_t instanceIndex;
+    void ignoreGlitch(uint32_t closedUs);
 
 public:
     // Constructor
@@ -31,14 +54,24 @@ public:
     // Set callback for limit switch events
     void setLimitCallback(LimitSwitchCallback callback);
 
-    // Update function (processes pending interrupts from main loop)
+    // Update function (processes pending interrupts from InputTask). The ISR has
+    // already stopped the motor; this does the NVS write, recovery and broadcast.
     void update();
 
+    // A trip update() is still waiting to tell from a glitch: when to call it again
+    bool nextDeadline(uint32_t &atUs) const;
+
     // Status getters
     bool isTriggered() const { return triggered; }
+    bool isPending() const { return pending; } // Tripped, not yet told from a glitch
     long getStoredPosition() const { return storedPosition; }
+    bool isPressed() const { return digitalRead(pin) == LOW; } // Live pin state
+    const Latency &getLatency() const { return latency; }
+    uint32_t getGlitchCount() const { return glitches; }
 
-    // Manual reset (for clearing after safe movement)
+    // Re-arm: a triggered switch ignores its interrupt (release bounce) until cleared.
+    // Motor loop only: limit recovery once the back-off has opened the switch,
+    // and clearing the emergency stop.
     void clearTrigger();
 
     // Save position when triggered
@@ -0,0 +1,72 @@
+#include "SoftLimits.h"
+
+SoftLimits::SoftLimits() : enabled(false), minimum(0), maximum(-1), zone(DEFAULT_ZONE)
+{
+}
+
+void SoftLimits::setRange(long limitA, long limitB)
+{
+    long low = limitA < limitB ? limitA : limitB;
+    long high = limitA < limitB ? limitB : limitA;
+    minimum = low + MARGIN;
+    maximum = high - MARGIN;
+}
+
+void SoftLimits::setZone(long steps)
+{
+    if (steps < 0)
+        steps = 0;
+    if (steps > MAX_ZONE)
+        steps = MAX_ZONE;
+    zone = steps;
+}
+
+long SoftLimits::clamp(long target) const
+{
+    if (!isActive())
+        return target;
+    if (target < minimum)
+        return minimum;
+    if (target > maximum)
+        return maximum;
+    return target;
+}
+
+uint32_t SoftLimits::stoppingDistance(uint32_t speed, uint32_t acceleration)
+{
+    if (acceleration == 0)
+        return 0;
+    return (uint32_t)((uint64_t)speed * speed / (2ULL * acceleration));
+}
+
+uint8_t SoftLimits::plan(long from, int32_t speed, long target, uint32_t maxSpeed, uint32_t acceleration,
+                         Leg legs[2]) const
+{
+    target = clamp(target);
+    legs[0] = Leg{target, maxSpeed};
+    if (!isActive() || zone == 0 || maxSpeed <= CREEP_SPEED || target == from)
+        return 1;
+
+    // Edge of the creep zone on the side the move heads for
+    int8_t direction = target > from ? 1 : -1;
+    long edge = direction > 0 ? maximum - zone : minimum + zone;
+    if (direction > 0 ? target <= edge : target >= edge)
+        return 1; // Ends before the zone
+
+    // Distance to slow from the current speed to creep speed, when heading this way
+    uint32_t current = (speed > 0) == (direction > 0) ? (uint32_t)(speed < 0 ? -speed : speed) : 0;
+    uint32_t brake = current > CREEP_SPEED ? stoppingDistance(current, acceleration) -
+                                                 stoppingDistance(CREEP_SPEED, acceleration)
+                                           : 0;
+    long toEdge = direction > 0 ? edge - from : from - edge;
+    if (toEdge <= (long)brake)
+    {
+        // In the zone already, or too close to slow down by the edge: creep from here
+        legs[0].speed = CREEP_SPEED;
+        return 1;
+    }
+
+    legs[0] = Leg{edge, maxSpeed};
+    legs[1] = Leg{target, CREEP_SPEED};
+    return 2;
+}
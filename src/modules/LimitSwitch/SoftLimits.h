@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+// Soft travel limits inside the learned limit switch positions
+// Targets are clipped to the range, which sits MARGIN inside each learned
+// limit so a move never ends on the switch. A move heading into the creep
+// zone next to a limit is split at the zone edge: requested speed up to it,
+// CREEP_SPEED inside. The split uses the stopping distance from the current
+// speed: a motor that can no longer slow to creep speed by the edge creeps
+// from where it is, so it starts braking now rather than at the edge.
+class SoftLimits
+{
+public:
+    struct Leg
+    {
+        long target;
+        uint32_t speed; // steps/sec
+    };
+
+    static constexpr long MARGIN = 8;              // One full step clear of the switch
+    static constexpr uint32_t CREEP_SPEED = 800;   // steps/sec (100 full steps/s)
+    static constexpr long DEFAULT_ZONE = 800;      // 100 full steps
+    static constexpr long MAX_ZONE = 16000;        // 10 turns
+
+private:
+    bool enabled;
+    long minimum; // Range after the margin; empty when minimum > maximum
+    long maximum;
+    long zone;
+
+public:
+    SoftLimits();
+
+    void setEnabled(bool value) { enabled = value; }
+    void setRange(long limitA, long limitB); // Learned limits, either order
+    void setZone(long steps);                // 0 = no creep zone
+
+    // Enabled with a usable range (limits learned far enough apart)
+    bool isActive() const { return enabled && minimum <= maximum; }
+    bool isEnabled() const { return enabled; }
+    long getMin() const { return minimum; }
+    long getMax() const { return maximum; }
+    long getZone() const { return zone; }
+
+    long clamp(long target) const;
+
+    // Steps to stop from 'speed' at 'acceleration' (v² / 2a)
+    static uint32_t stoppingDistance(uint32_t speed, uint32_t acceleration);
+
+    // Legs for a move from 'from' (moving at signed 'speed') to 'target' at
+    // 'maxSpeed'; returns how many (1 or 2). The last leg ends on the clipped target.
+    uint8_t plan(long from, int32_t speed, long target, uint32_t maxSpeed, uint32_t acceleration, Leg legs[2]) const;
+};
@@ -0,0 +1,44 @@
+#include "LogModules.h"
+#include <string.h>
+
+static const char *const MODULE_NAMES[LOG_MODULE_COUNT] = {
+    "system", "configuration", "motorController", "stepGenerator", "tmc",
+    "encoder", "buttons", "limitSwitch", "webServer"};
+
+static const char *const LEVEL_NAMES[] = {"error", "warn", "info", "debug"};
+
+const char *logModuleName(LogModule module)
+{
+    return (uint8_t)module < LOG_MODULE_COUNT ? MODULE_NAMES[(uint8_t)module] : "unknown";
+}
+
+bool logModuleFromName(const char *name, LogModule &module)
+{
+    for (uint8_t i = 0; name && i < LOG_MODULE_COUNT; i++)
+    {
+        if (strcmp(name, MODULE_NAMES[i]) == 0)
+        {
+            module = (LogModule)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *logLevelName(uint8_t level)
+{
+    return level <= LOG_LEVEL_DEBUG ? LEVEL_NAMES[level] : "unknown";
+}
+
+bool logLevelFromName(const char *name, uint8_t &level)
+{
+    for (uint8_t i = 0; name && i <= LOG_LEVEL_DEBUG; i++)
+    {
+        if (strcmp(name, LEVEL_NAMES[i]) == 0)
+        {
+            level = i;
+            return true;
+        }
+    }
+    return false;
+}
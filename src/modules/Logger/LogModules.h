@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+
+// Log levels
+typedef enum {
+    LOG_LEVEL_ERROR = 0,
+    LOG_LEVEL_WARN = 1,
+    LOG_LEVEL_INFO = 2,
+    LOG_LEVEL_DEBUG = 3
+} log_level_t;
+
+// Subsystems a log call belongs to. Each source file that logs names its own:
+//   static constexpr LogModule logModule = LogModule::WebServer;
+enum class LogModule : uint8_t
+{
+    System, // main.cpp, benchmarks
+    Configuration,
+    MotorController,
+    StepGenerator,
+    TMC,
+    Encoder,
+    Buttons,
+    LimitSwitch,
+    WebServer,
+    Count
+};
+
+static constexpr uint8_t LOG_MODULE_COUNT = (uint8_t)LogModule::Count;
+
+// Compile-time ceilings: levels above these compile out, arguments and all.
+// LOG_MAX_LEVEL applies to every module without its own LOG_MAX_<MODULE> flag,
+// e.g. -DLOG_MAX_WEBSERVER=LOG_LEVEL_INFO strips the web server's debug logs.
+#ifndef LOG_MAX_LEVEL
+#define LOG_MAX_LEVEL LOG_LEVEL_DEBUG
+#endif
+#ifndef LOG_MAX_SYSTEM
+#define LOG_MAX_SYSTEM LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_CONFIGURATION
+#define LOG_MAX_CONFIGURATION LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_MOTORCONTROLLER
+#define LOG_MAX_MOTORCONTROLLER LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_STEPGENERATOR
+#define LOG_MAX_STEPGENERATOR LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_TMC
+#define LOG_MAX_TMC LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_ENCODER
+#define LOG_MAX_ENCODER LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_BUTTONS
+#define LOG_MAX_BUTTONS LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_LIMITSWITCH
+#define LOG_MAX_LIMITSWITCH LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_WEBSERVER
+#define LOG_MAX_WEBSERVER LOG_MAX_LEVEL
+#endif
+
+// Level each module starts at; setLogLevel changes it up to the ceiling
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+constexpr uint8_t logMaxLevel(LogModule module)
+{
+    return module == LogModule::System          ? LOG_MAX_SYSTEM
+           : module == LogModule::Configuration   ? LOG_MAX_CONFIGURATION
+           : module == LogModule::MotorController ? LOG_MAX_MOTORCONTROLLER
+           : module == LogModule::StepGenerator   ? LOG_MAX_STEPGENERATOR
+           : module == LogModule::TMC             ? LOG_MAX_TMC
+           : module == LogModule::Encoder         ? LOG_MAX_ENCODER
+           : module == LogModule::Buttons         ? LOG_MAX_BUTTONS
+           : module == LogModule::LimitSwitch     ? LOG_MAX_LIMITSWITCH
+           : module == LogModule::WebServer       ? LOG_MAX_WEBSERVER
+                                                  : LOG_MAX_LEVEL;
+}
+
+// Names used by the setLogLevel/getLogLevels commands
+const char *logModuleName(LogModule module);
+bool logModuleFromName(const char *name, LogModule &module);
+const char *logLevelName(uint8_t level); // "error", "warn", "info", "debug"
+bool logLevelFromName(const char *name, uint8_t &level);
@@ -0,0 +1,296 @@
+#include "LogRecord.h"
+#include <stdio.h>
+#include <string.h>
+
+void LogRecord::begin(uint8_t logLevel, const char *logFunction, const char *logFormat, uint32_t nowMs)
+{
+    timeMs = nowMs;
+    format = logFormat;
+    function = logFunction;
+    level = logLevel;
+    argCount = 0;
+    textUsed = 0;
+    truncated = false;
+}
+
+void LogRecord::addInt(int64_t value)
+{
+    if (argCount == MAX_ARGS)
+    {
+        truncated = true;
+        return;
+    }
+    types[argCount] = ArgType::Int;
+    args[argCount++].i = value;
+}
+
+void LogRecord::addUint(uint64_t value)
+{
+    if (argCount == MAX_ARGS)
+    {
+        truncated = true;
+        return;
+    }
+    types[argCount] = ArgType::Uint;
+    args[argCount++].u = value;
+}
+
+void LogRecord::addDouble(double value)
+{
+    if (argCount == MAX_ARGS)
+    {
+        truncated = true;
+        return;
+    }
+    types[argCount] = ArgType::Double;
+    args[argCount++].d = value;
+}
+
+void LogRecord::addString(const char *value)
+{
+    if (argCount == MAX_ARGS)
+    {
+        truncated = true;
+        return;
+    }
+    if (!value)
+        value = "(null)";
+
+    // Copy what fits; a string that doesn't fit at all becomes empty
+    uint8_t offset = textUsed < TEXT_SIZE ? textUsed : TEXT_SIZE - 1;
+    size_t room = TEXT_SIZE - offset - 1;
+    size_t length = strnlen(value, room + 1);
+    if (length > room)
+    {
+        length = room;
+        truncated = true;
+    }
+    memcpy(text + offset, value, length);
+    text[offset + length] = '\0';
+    textUsed = (uint8_t)(offset + length + 1);
+
+    types[argCount] = ArgType::String;
+    args[argCount++].text = offset;
+}
+
+void LogRecord::addPointer(const void *value)
+{
+    if (argCount == MAX_ARGS)
+    {
+        truncated = true;
+        return;
+    }
+    types[argCount] = ArgType::Pointer;
+    args[argCount++].p = value;
+}
+
+const char *LogRecord::levelName(uint8_t level)
+{
+    switch (level)
+    {
+    case 0: return "ERROR";
+    case 1: return "WARN";
+    case 2: return "INFO";
+    case 3: return "DEBUG";
+    default: return "UNKNOWN";
+    }
+}
+
+// Bytes of the argument a length modifier names (%d alone is an int)
+static uint8_t argumentSize(const char *length)
+{
+    if (length[0] == 'h')
+        return length[1] == 'h' ? 1 : sizeof(short);
+    if (length[0] == 'l')
+        return length[1] == 'l' ? sizeof(long long) : sizeof(long);
+    if (length[0] == 'j')
+        return sizeof(long long);
+    if (length[0] == 'z')
+        return sizeof(size_t);
+    if (length[0] == 't')
+        return sizeof(ptrdiff_t);
+    return sizeof(int);
+}
+
+size_t LogRecord::formatMessage(char *out, size_t size) const
+{
+    if (size == 0)
+        return 0;
+
+    size_t used = 0;
+    uint8_t next = 0;
+    const char *p = format;
+    out[0] = '\0';
+
+    // Appends what snprintf wrote, clamped to the room left
+    auto advance = [&](int written) {
+        if (written > 0)
+            used += (size_t)written < size - used ? (size_t)written : size - used - 1;
+    };
+
+    while (*p && used < size - 1)
+    {
+        if (*p != '%')
+        {
+            out[used++] = *p++;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            out[used++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // %[flags][width][.precision][length]conversion; '*' takes an argument
+        const char *start = p++;
+        char spec[48]; // Longest: 7 flags, 20-digit width and precision, "lld"
+        size_t specLength = 0;
+        spec[specLength++] = '%';
+        while (*p && strchr("-+ #0", *p) && specLength < 8)
+            spec[specLength++] = *p++;
+        for (int part = 0; part < 2; part++)
+        {
+            if (part == 1)
+            {
+                if (*p != '.')
+                    break;
+                spec[specLength++] = *p++;
+            }
+            if (*p == '*')
+            {
+                p++;
+                long value = next < argCount ? (long)args[next].i : 0;
+                next++;
+                specLength += snprintf(spec + specLength, 12, "%ld", value);
+            }
+            while (*p >= '0' && *p <= '9' && specLength < (size_t)(20 * (part + 1)))
+                spec[specLength++] = *p++;
+        }
+        char length[3] = {0, 0, 0};
+        for (int i = 0; i < 2 && *p && strchr("hljztL", *p); i++)
+            length[i] = *p++;
+        char conversion = *p;
+        if (!conversion)
+            break;
+        p++;
+
+        if (next >= argCount)
+        {
+            // No argument for it: print the conversion as written
+            size_t raw = (size_t)(p - start);
+            if (raw > size - used - 1)
+                raw = size - used - 1;
+            memcpy(out + used, start, raw);
+            used += raw;
+            continue;
+        }
+        ArgType type = types[next];
+        const Arg &arg = args[next++];
+
+        switch (conversion)
+        {
+        case 'c':
+        {
+            spec[specLength++] = 'c';
+            spec[specLength] = '\0';
+            advance(snprintf(out + used, size - used, spec, (int)arg.i));
+            break;
+        }
+        case 'd':
+        case 'i':
+        {
+            int64_t value = type == ArgType::Double ? (int64_t)arg.d : arg.i;
+            uint8_t bits = 8 * argumentSize(length);
+            if (bits < 64)
+                value = (int64_t)((uint64_t)value << (64 - bits)) >> (64 - bits); // Wrap like the narrower type
+            spec[specLength++] = 'l';
+            spec[specLength++] = 'l';
+            spec[specLength++] = 'd';
+            spec[specLength] = '\0';
+            advance(snprintf(out + used, size - used, spec, (long long)value));
+            break;
+        }
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        {
+            uint64_t value = type == ArgType::Double ? (uint64_t)(int64_t)arg.d : arg.u;
+            uint8_t bits = 8 * argumentSize(length);
+            if (bits < 64)
+                value &= (1ULL << bits) - 1;
+            spec[specLength++] = 'l';
+            spec[specLength++] = 'l';
+            spec[specLength++] = conversion;
+            spec[specLength] = '\0';
+            advance(snprintf(out + used, size - used, spec, (unsigned long long)value));
+            break;
+        }
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+        {
+            double value = type == ArgType::Double ? arg.d : type == ArgType::Uint ? (double)arg.u : (double)arg.i;
+            spec[specLength++] = conversion;
+            spec[specLength] = '\0';
+            advance(snprintf(out + used, size - used, spec, value));
+            break;
+        }
+        case 's':
+        {
+            const char *value = type == ArgType::String ? text + arg.text : "(?)";
+            spec[specLength++] = 's';
+            spec[specLength] = '\0';
+            advance(snprintf(out + used, size - used, spec, value));
+            break;
+        }
+        case 'p':
+        {
+            spec[specLength++] = 'p';
+            spec[specLength] = '\0';
+            advance(snprintf(out + used, size - used, spec, type == ArgType::Pointer ? arg.p : (const void *)0));
+            break;
+        }
+        default:
+        {
+            // Unknown conversion: print it as written and skip its argument
+            size_t raw = (size_t)(p - start);
+            if (raw > size - used - 1)
+                raw = size - used - 1;
+            memcpy(out + used, start, raw);
+            used += raw;
+            break;
+        }
+        }
+    }
+
+    out[used] = '\0';
+    return used;
+}
+
+size_t LogRecord::formatLine(char *out, size_t size) const
+{
+    if (size == 0)
+        return 0;
+
+    // Simplified format: HH:MM:SS.mmm (no days, easier to parse)
+    uint32_t seconds = timeMs / 1000;
+    int written = snprintf(out, size, "[%02u:%02u:%02u.%03u] [%s] [%s]: ", (unsigned)((seconds / 3600) % 24),
+                           (unsigned)((seconds / 60) % 60), (unsigned)(seconds % 60), (unsigned)(timeMs % 1000),
+                           levelName(level), function);
+    size_t used = written < 0 ? 0 : (size_t)written < size ? (size_t)written : size - 1;
+    used += formatMessage(out + used, size - used);
+    if (truncated)
+    {
+        written = snprintf(out + used, size - used, " [truncated]");
+        if (written > 0)
+            used += (size_t)written < size - used ? (size_t)written : size - used - 1;
+    }
+    return used;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+// One log call, captured in binary for formatting later
+// The caller stores the format and function pointers (both must be static,
+// which string literals and __func__ are), a timestamp and the arguments;
+// %s strings are copied into the record, since the caller's buffer may be
+// gone by the time the sink formats it. Formatting walks the format string
+// and prints one conversion at a time, casting each argument to what its
+// conversion expects.
+struct LogRecord
+{
+    static constexpr uint8_t MAX_ARGS = 10;
+    static constexpr uint8_t TEXT_SIZE = 64; // Copied %s strings, NUL-terminated
+
+    enum class ArgType : uint8_t
+    {
+        Int,
+        Uint,
+        Double,
+        String, // Offset into text
+        Pointer
+    };
+
+    union Arg
+    {
+        int64_t i;
+        uint64_t u;
+        double d;
+        const void *p;
+        uint8_t text;
+    };
+
+    uint32_t timeMs;
+    const char *format;
+    const char *function;
+    uint8_t level;
+    uint8_t argCount;
+    uint8_t textUsed;
+    bool truncated; // An argument or string didn't fit
+    ArgType types[MAX_ARGS];
+    Arg args[MAX_ARGS];
+    char text[TEXT_SIZE];
+
+    void begin(uint8_t logLevel, const char *logFunction, const char *logFormat, uint32_t nowMs);
+
+    // Argument capture, in call order
+    void addInt(int64_t value);
+    void addUint(uint64_t value);
+    void addDouble(double value);
+    void addString(const char *value);
+    void addPointer(const void *value);
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type add(T value) { addInt(value); }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type add(T value) { addUint(value); }
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type add(T value) { addDouble(value); }
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type add(T value) { addInt((int64_t)value); }
+    void add(const char *value) { addString(value); }
+    void add(char *value) { addString(value); }
+    template <typename T>
+    void add(const T *value) { addPointer(value); }
+
+    void capture() {}
+    template <typename T, typename... Rest>
+    void capture(T value, Rest... rest)
+    {
+        add(value);
+        capture(rest...);
+    }
+
+    // The message alone, or "[HH:MM:SS.mmm] [LEVEL] [function]: message".
+    // Always NUL-terminated; returns the length written.
+    size_t formatMessage(char *out, size_t size) const;
+    size_t formatLine(char *out, size_t size) const;
+
+    static const char *levelName(uint8_t level);
+};
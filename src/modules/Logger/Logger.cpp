@@ -0,0 +1,80 @@
+#include "Logger.h"
+#include "TaskConfig.h"
+#include "util.h"
+
+// Debug WebSocket fan-out, linked when the WebServer module is included
+extern void broadcastDebugMessage(const char *message) __attribute__((weak));
+
+Logger logger;
+
+Logger::Logger() : dropped(0), reportedDropped(0), task(nullptr)
+{
+    for (uint8_t i = 0; i < LOG_MODULE_COUNT; i++)
+        setLevel((LogModule)i, LOG_LEVEL);
+}
+
+uint8_t Logger::setLevel(LogModule module, uint8_t level)
+{
+    uint8_t ceiling = logMaxLevel(module);
+    if (level > ceiling)
+        level = ceiling;
+    levels[(uint8_t)module].store(level, std::memory_order_relaxed);
+    return level;
+}
+
+bool Logger::begin()
+{
+    if (task)
+        return true;
+
+    if (xTaskCreatePinnedToCore(taskEntry, "LogTask", LOG_TASK_STACK, this, LOG_TASK_PRIORITY, &task,
+                                SYSTEM_CORE) != pdPASS)
+    {
+        Serial.println("Log task creation failed");
+        return false;
+    }
+    return true;
+}
+
+void Logger::taskEntry(void *arg)
+{
+    static_cast<Logger *>(arg)->run();
+}
+
+void Logger::run()
+{
+    char line[LINE_SIZE];
+    while (1)
+    {
+        // Format straight from the ring slot, then hand it back
+        const LogRecord *record;
+        while ((record = queue.front()) != nullptr)
+        {
+            record->formatLine(line, sizeof(line));
+            queue.pop();
+            write(line);
+        }
+
+        uint32_t count = dropped.load(std::memory_order_relaxed);
+        if (count != reportedDropped)
+        {
+            LogRecord notice;
+            notice.begin(LOG_LEVEL_WARN, "Logger", "%lu log messages dropped (ring full)", millis());
+            notice.capture((unsigned long)(count - reportedDropped));
+            notice.formatLine(line, sizeof(line));
+            write(line);
+            reportedDropped = count;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(POLL_MS));
+    }
+}
+
+void Logger::write(const char *line)
+{
+    Serial.println(line);
+
+    // Output to debug WebSocket if available (weak linkage)
+    if (broadcastDebugMessage)
+        broadcastDebugMessage(line);
+}
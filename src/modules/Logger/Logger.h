@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "../../MpscQueue.h"
+#include "LogRecord.h"
+#include "LogModules.h"
+
+// Asynchronous log pipeline
+// LOG_* calls capture a LogRecord into a lock-free multi-producer ring and
+// return: no formatting, no allocation, no Serial. A low-priority sink task on
+// the system core formats each record and writes it to Serial and the debug
+// WebSocket. When the ring is full the message is dropped and counted; the
+// sink logs the count once it has room again.
+// Each module has a runtime level (setLevel()), capped by its compile-time
+// ceiling (logMaxLevel()); LOG_* checks both before capturing anything.
+class Logger
+{
+public:
+    static constexpr size_t QUEUE_SIZE = 128; // Records (~170 bytes each)
+    static constexpr uint32_t POLL_MS = 10;   // Sink sleep when the ring is empty
+    static constexpr size_t LINE_SIZE = 384;
+
+private:
+    MpscQueue<LogRecord, QUEUE_SIZE> queue;
+    std::atomic<uint32_t> dropped;
+    uint32_t reportedDropped; // Sink only
+    std::atomic<uint8_t> levels[LOG_MODULE_COUNT];
+    TaskHandle_t task;
+
+    static void taskEntry(void *arg);
+    void run();
+    void write(const char *line);
+
+public:
+    Logger();
+
+    // Start the sink task; records logged before it starts wait in the ring
+    bool begin();
+
+    // Any task: capture and return
+    template <typename... Args>
+    void log(uint8_t level, const char *function, const char *format, Args... args)
+    {
+        bool queued = queue.emplace([&](LogRecord &record) {
+            record.begin(level, function, format, millis());
+            record.capture(args...);
+        });
+        if (!queued)
+            dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Runtime level per module, any task. setLevel() caps it at the module's
+    // ceiling and returns the level applied.
+    bool isEnabled(LogModule module, uint8_t level) const
+    {
+        return level <= levels[(uint8_t)module].load(std::memory_order_relaxed);
+    }
+    uint8_t setLevel(LogModule module, uint8_t level);
+    uint8_t getLevel(LogModule module) const { return levels[(uint8_t)module].load(std::memory_order_relaxed); }
+
+    // Messages lost to a full ring since boot
+    uint32_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+extern Logger logger;
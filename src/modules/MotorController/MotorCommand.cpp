@@ -0,0 +1,47 @@
+#include "MotorCommand.h"
+
+MotorCommandRouter::MotorCommandRouter() : epoch(0), emergencyStopRequested(false), dropped(0)
+{
+}
+
+bool MotorCommandRouter::post(CommandSource source, MotorCommandType type, long position, long value)
+{
+    MotorCommand command;
+    command.type = type;
+    command.epoch = epoch.load(std::memory_order_acquire);
+    command.position = position;
+    command.value = value;
+
+    if (!queues[(size_t)source].push(command))
+    {
+        dropped.fetch_add(1);
+        return false;
+    }
+    return true;
+}
+
+void MotorCommandRouter::requestEmergencyStop()
+{
+    epoch.fetch_add(1, std::memory_order_acq_rel);
+    emergencyStopRequested.store(true, std::memory_order_release);
+}
+
+bool MotorCommandRouter::takeEmergencyStop()
+{
+    return emergencyStopRequested.exchange(false, std::memory_order_acq_rel);
+}
+
+bool MotorCommandRouter::next(MotorCommand &command)
+{
+    uint32_t current = epoch.load(std::memory_order_acquire);
+    for (size_t i = 0; i < (size_t)CommandSource::COUNT; i++)
+    {
+        while (queues[i].pop(command))
+        {
+            if (command.epoch == current)
+                return true;
+            dropped.fetch_add(1); // Posted before the last emergency stop
+        }
+    }
+    return false;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include "../../SpscQueue.h"
+
+// Tasks that send motor commands; each one owns a single-producer ring
+enum class CommandSource : uint8_t
+{
+    Network, // async_tcp (WebSocket handlers)
+    Input,   // InputTask (buttons, limit switches)
+    COUNT
+};
+
+enum class MotorCommandType : uint8_t
+{
+    MoveTo,
+    QueueMove,
+    JogStop,
+    ClearEmergencyStop,
+    SetMaxSpeed,
+    SetAcceleration,
+    SetMaxJerk,
+    SetTMCMode,
+    SetTimerStepEngine,
+    SetCurrentPosition,
+    ServoCorrection,
+    SetRunCurrent,
+    Home,
+    SetFollowingErrorWindow,
+    SetServoMode,
+    SetStallThreshold,
+    SetModeHysteresis,
+    SetAdaptiveMicrosteps,
+    SetLimitBackoff,
+    SetSoftLimits,
+    SetSoftLimitZone
+};
+
+struct MotorCommand
+{
+    MotorCommandType type;
+    uint32_t epoch; // Emergency-stop epoch at post time
+    long position;
+    long value;     // Speed, acceleration, jerk, steps, percent, direction or flag depending on type
+};
+
+// Routes commands from other tasks to the motor loop without locks
+// One SPSC ring per producer task keeps each producer's commands in order;
+// the motor loop drains the rings in CommandSource order. Emergency stop
+// bypasses the rings: it sets a flag the loop checks before every command and
+// bumps an epoch so anything posted before it is discarded.
+class MotorCommandRouter
+{
+public:
+    static constexpr size_t QUEUE_SIZE = 16; // Per producer
+
+private:
+    SpscQueue<MotorCommand, QUEUE_SIZE> queues[(size_t)CommandSource::COUNT];
+    std::atomic<uint32_t> epoch;
+    std::atomic<bool> emergencyStopRequested;
+    std::atomic<uint32_t> dropped; // Rejected (ring full) or discarded (stale) commands
+
+public:
+    MotorCommandRouter();
+
+    // Producer side: only the task that owns 'source' may post to it
+    bool post(CommandSource source, MotorCommandType type, long position = 0, long value = 0);
+
+    // Any task or ISR
+    void requestEmergencyStop();
+
+    // Consumer side (motor loop)
+    bool takeEmergencyStop(); // True once per request
+    bool next(MotorCommand &command);
+
+    uint32_t getDroppedCount() const { return dropped.load(); }
+};
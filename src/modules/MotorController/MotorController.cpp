@@ -1,7 +1,16 @@
 #include "MotorController.h"
 #include "../Configuration/Configuration.h"
+#include "../Configuration/PositionSnapshotTask.h"
+#include "../FollowingErrorMonitor/FollowingErrorMonitor.h"
+#include "../ServoCorrector/ServoCorrector.h"
+#include "../Homing/StallDetector.h"
+#include "../Homing/HomingSequence.h"
+#include "../LimitSwitch/LimitSwitch.h"
 #include "util.h"
 #include <Arduino.h>
+#include <soc/gpio_struct.h>
+
+static constexpr LogModule logModule = LogModule::MotorController;
 
 // Pin definitions
 #define R_SENSE 0.11f
@@ -19,9 +28,7 @@
 #define SPI_MOSI 13
 
 // Static member initialization
-double MotorController::lastLocation = 0;
-double MotorController::currentLocation = 0;
-double MotorController::monitorSpeed = 0;
+float MotorController::monitorSpeed = 0;
 float MotorController::motorSpeed = 0;
 int8_t MotorController::direction = 1;
 
@@ -31,13 +38,72 @@ MotorController motorController;
 MotorController::MotorController()
 {
     serialDriver = &Serial1;
-    driver = new TMC2209Stepper(serialDriver, R_SENSE, DRIVER_ADDRESS);
+    driver = new TMC2209UartBus(serialDriver, R_SENSE, DRIVER_ADDRESS);
+    tmc = new TMCShadow(R_SENSE);
+    tmcTask = new TMCDriverTask(*tmc, *driver);
     stepper = new AccelStepper(AccelStepper::DRIVER, STEP_PIN, DIR_PIN);
-    mt6816 = new SPIClass(HSPI);
+    encoder = new EncoderSampler(SPI_CLK, SPI_MISO, SPI_MOSI, SPI_MT_CS);
+    velocityObserver = new VelocityObserver();
+    velocityCursor = {0, 0};
+    positionRestored = false;
+    snapshotPolarity = 0;
+    snapshotTask = new PositionSnapshotTask(config, *encoder);
+    stepGenerator = new StepGenerator(STEP_PIN, DIR_PIN);
+    ramp = new RampGenerator();
+    scurve = new SCurveProfile();
+    activeSource = ramp;
+    motionQueue = new MotionQueue();
+    microstepping = new MicrostepScale();
+    stateVersion = 0;
+    scaleMux = portMUX_INITIALIZER_UNLOCKED;
+    adaptiveMicrosteps = false;
+    microstepGridKnown = false;
+    microstepChangePending = false;
+    snapshotClearPending = false;
+    finishPending = false;
+    finishTarget = 0;
+    finishSpeed = 0;
+    canonicalMaxSpeed = 0;
+    canonicalAcceleration = 0;
+    followingError = new FollowingErrorMonitor();
+    driverEnabled = false;
+    servo = new ServoCorrector();
+    servoOffset = 0;
+    stallDetector = new StallDetector();
+    homing = new HomingSequence();
+    lastStallReading = 0;
+    needsLimitRecovery = false;
+    limitRecoveryPosition = 0;
+    limitRecoverySide = 1;
+    limitRecovery = new LimitRecovery();
+    softLimits = new SoftLimits();
+    calibrationRequested = false;
+    calibrationState = CalibrationState::Idle;
+    calibrationForward = nullptr;
+    calibrationPoints = nullptr;
+    calibrationIndex = 0;
+    calibrationBackward = false;
+    calibrationDirection = 1;
+    calibrationStart = 0;
+    calibrationTicks = 0;
+    calibrationCursor = {0, 0};
+    calibrationSum = 0;
+    calibrationFirst = 0;
+    calibrationCount = 0;
 
     targetPosition = 0;
+    useTimerEngine = false;
+    maxJerk = 0;
     emergencyStopActive = false;
+    haltedByISR = false;
+    haltedDriverEnabled = false;
+    isrHaltResumeRequested = false;
     useStealthChop = true;
+    stealthChopEnabled = true;
+    hardwareModeSwitch = false;
+    modeHysteresis = 0;
+    stealthChopThresholdSpeed = 0;
+    stealthChopReturnSpeed = 0;
 }
 
 bool MotorController::begin()
@@ -65,13 +131,37 @@ bool MotorController::begin()
     LOG_DEBUG("TMC2209 IOIN : 0X%X", text);
 
     driver->toff(5);           // Enables driver in software
-    driver->rms_current(2000); // Set motor RMS current
-    driver->microsteps(8);     // Set microsteps to 1/8th
+    driver->rms_current(RUN_CURRENT_MA); // Set motor RMS current
+    driver->microsteps(MicrostepScale::CANONICAL); // Set microsteps to 1/8th
     driver->ihold(1);
 
     driver->en_spreadCycle(true); // Toggle spreadCycle on TMC2208/2209/2224
     driver->pwm_autoscale(true);  // Needed for stealthChop
 
+    // From here on registers change through the shadow, flushed off the step core
+    tmc->seed(TMCShadow::Reg::GCONF, driver->GCONF());
+    tmc->seed(TMCShadow::Reg::CHOPCONF, driver->CHOPCONF());
+    tmc->seed(TMCShadow::Reg::IHOLD_IRUN, driver->IHOLD_IRUN());
+    tmc->seed(TMCShadow::Reg::TPWMTHRS, driver->TPWMTHRS());
+    tmc->seed(TMCShadow::Reg::TCOOLTHRS, driver->TCOOLTHRS());
+    tmc->seed(TMCShadow::Reg::SGTHRS, driver->SGTHRS());
+    if (!tmcTask->begin() || !snapshotTask->begin())
+    {
+        return false;
+    }
+
+    // Position 0 is where the driver's step table is now: adaptive MRES needs
+    // that on a full step (always after power-up; an ESP32-only reset can leave
+    // the driver anywhere)
+    uint16_t mscnt = driver->MSCNT();
+    microstepGridKnown = mscnt % 256 == 0;
+    adaptiveMicrosteps = config.getAdaptiveMicrosteps();
+    if (adaptiveMicrosteps && !microstepGridKnown)
+        LOG_WARN("Driver microstep counter off the full-step grid (MSCNT %u) - fixed 1/8 stepping until power-cycled", mscnt);
+
+    canonicalMaxSpeed = config.getMaxSpeed();
+    canonicalAcceleration = config.getAcceleration();
+
     // Initialize AccelStepper exactly like factory code
     stepper->setMaxSpeed(config.getMaxSpeed());         // 100mm/s @ 80 steps/mm
     stepper->setAcceleration(config.getAcceleration()); // 2000mm/s^2
@@ -79,7 +169,41 @@ bool MotorController::begin()
     stepper->setPinsInverted(false, false, true);
     stepper->enableOutputs();
 
-    digitalWrite(EN_PIN, HIGH); // Disable driver until movement
+    setDriverEnabled(false); // Disable driver until movement
+
+    // Ramp planner for the timer engine mirrors the AccelStepper settings
+    ramp->setMaxSpeed(config.getMaxSpeed());
+    ramp->setAcceleration(config.getAcceleration());
+    maxJerk = config.getMaxJerk();
+    followingError->setWindow(config.getFollowingErrorWindow());
+    servo->setEnabled(config.getServoMode());
+    stallDetector->setThreshold(config.getStallThreshold());
+    limitRecovery->setBackoff(config.getLimitBackoff());
+    softLimits->setEnabled(config.getSoftLimits());
+    softLimits->setZone(config.getSoftLimitZone());
+
+    // Chopper mode: TPWMTHRS (driver switches) or the motor loop, chosen at boot
+    stealthChopEnabled = config.getUseStealthChop();
+    hardwareModeSwitch = config.getHardwareModeSwitch();
+    modeHysteresis = config.getModeHysteresis();
+    computeModeThresholds();
+    applyChopperMode();
+    LOG_INFO("TMC mode switching: %s at %.0f steps/sec", hardwareModeSwitch ? "driver (TPWMTHRS)" : "software",
+             stealthChopThresholdSpeed);
+
+    if (config.getUseTimerStepEngine())
+    {
+        if (stepGenerator->begin())
+        {
+            useTimerEngine = true;
+        }
+        else
+        {
+            LOG_WARN("Step timer unavailable, falling back to polled stepping");
+        }
+    }
+    LOG_INFO("Step engine: %s, ramps: %s", useTimerEngine ? "hardware timer" : "polled",
+             useTimerEngine && maxJerk > 0 ? "S-curve" : "trapezoidal");
 
     LOG_INFO("Motor Controller initialized successfully");
     return true;
@@ -90,229 +214,1639 @@ bool MotorController::initEncoder()
 {
     LOG_INFO("Initializing MT6816 Encoder...");
 
-    mt6816->begin(SPI_CLK, SPI_MISO, SPI_MOSI, SPI_MT_CS);
-    pinMode(SPI_MT_CS, OUTPUT);
-    mt6816->setClockDivider(SPI_CLOCK_DIV4);
-    lastLocation = (double)readEncoder();
+    Configuration::PositionSnapshot snapshot;
+    bool haveSnapshot = config.loadPositionSnapshot(snapshot);
+    if (haveSnapshot)
+        encoder->setSavedCount(snapshot.encoderCount);
+
+    // Linearise from the first sample, so the saved count is continued in the same frame
+    int16_t table[EncoderCalibration::TABLE_SIZE];
+    if (config.loadEncoderCalibration(table, EncoderCalibration::TABLE_SIZE))
+    {
+        if (encoder->setCalibration(table))
+            LOG_INFO("Encoder calibration loaded");
+        else
+            LOG_WARN("Stored encoder calibration out of range - ignored");
+    }
+
+    if (!encoder->begin())
+    {
+        LOG_ERROR("MT6816 encoder sampling failed to start");
+        return false;
+    }
+    velocityCursor = encoder->samples().subscribe();
+
+    if (haveSnapshot)
+        restorePositionSnapshot();
+    else
+        LOG_INFO("No saved position - run to the limits to relearn them");
 
     LOG_INFO("MT6816 Encoder initialized successfully");
     return true;
 }
 
-void MotorController::moveTo(long position, int speed)
+void MotorController::restorePositionSnapshot()
 {
-    if (emergencyStopActive)
+    // The first sample continued the saved count, so the difference is how far
+    // the shaft turned while unpowered
+    Configuration::PositionSnapshot snapshot;
+    EncoderSample sample;
+    if (!config.loadPositionSnapshot(snapshot) || !encoder->latest(sample))
+        return;
+
+    snapshotPolarity = snapshot.polarity;
+    long moved = (long)(sample.position - snapshot.encoderCount);
+    long countsPerStep = FollowingErrorMonitor::ENCODER_COUNTS / FollowingErrorMonitor::DEFAULT_STEPS_PER_REV;
+    if (moved > RESTORE_TOLERANCE || moved < -RESTORE_TOLERANCE ||
+        (snapshot.polarity == 0 && (moved > countsPerStep || moved < -countsPerStep)))
     {
-        LOG_WARN("Cannot move - emergency stop active");
+        LOG_WARN("Saved position discarded: shaft moved %ld counts while off - run to the limits to relearn them", moved);
         return;
     }
-    digitalWrite(EN_PIN, LOW); // Enable motor
 
-    // Clamp speed to safe limits (already validated, but extra safety check)
-    if (speed < MIN_SPEED)
-        speed = MIN_SPEED;
-    if (speed > MAX_SPEED)
-        speed = MAX_SPEED;
+    long steps = PositionSnapshotTask::stepsAt(snapshot, sample.position); // polarity 0: unchanged
 
-    targetPosition = position;
-    stepper->setMaxSpeed(speed);
-    stepper->moveTo(position);
+    if (setCurrentPosition(steps, CommandSource::Input))
+    {
+        positionRestored = true;
+        LOG_INFO("Absolute position restored: %ld steps (shaft moved %ld counts while off)", steps, moved);
+    }
+}
 
-    LOG_INFO("Moving to position: %ld at speed: %d steps/sec", position, speed);
+void MotorController::savePositionSnapshot()
+{
+    EncoderSample sample;
+    if (!encoder->latest(sample))
+        return;
+
+    if (followingError->getPolarity() != 0)
+        snapshotPolarity = followingError->getPolarity();
+    Configuration::PositionSnapshot snapshot = {sample.position, getCurrentPosition(), snapshotPolarity};
+    snapshotTask->post(snapshot);
 }
 
-void MotorController::jogStop()
+// Command API: callable from any task. Each source is a single producer.
+bool MotorController::moveTo(long position, int speed, CommandSource source)
 {
-    // Stop motor movement without triggering emergency stop flag
-    // CRITICAL: Call stop() first to clear AccelStepper's internal target state
-    stepper->stop(); // This sets new target to current position with deceleration
-    // Then override with immediate stop (no deceleration ramp)
-    stepper->setCurrentPosition(stepper->currentPosition());
-    stepper->setSpeed(0);
+    return commands.post(source, MotorCommandType::MoveTo, position, speed);
+}
 
-    // Respect freewheel configuration
-    if (config.getFreewheelAfterMove())
-    {
-        digitalWrite(EN_PIN, HIGH); // Freewheel
-    }
+bool MotorController::queueMove(long position, int speed, CommandSource source)
+{
+    // Queue depth is a snapshot; executeQueueMove() rechecks on the motor loop
+    if (motionQueue->isFull())
+        return false;
+    return commands.post(source, MotorCommandType::QueueMove, position, speed);
+}
 
-    LOG_INFO("Motor jog stopped");
+bool MotorController::jogStop(CommandSource source)
+{
+    return commands.post(source, MotorCommandType::JogStop);
 }
 
 void MotorController::emergencyStop()
 {
-    // Stop motor immediately
-    stepper->stop(); // Clear AccelStepper's internal target state first
-    stepper->setCurrentPosition(stepper->currentPosition()); // Stop NOW (override deceleration)
-    stepper->setSpeed(0);
-    digitalWrite(EN_PIN, HIGH); // Disable motor => freewheel
+    // Preempts the rings: cut the step stream and the driver now, let the loop clean up
     emergencyStopActive = true;
-    LOG_WARN("EMERGENCY STOP ACTIVATED");
+    commands.requestEmergencyStop();
+    if (useTimerEngine)
+        stepGenerator->requestHalt();
+    setDriverEnabled(false); // Disable motor => freewheel
 }
 
-void MotorController::clearEmergencyStop()
+bool IRAM_ATTR MotorController::stopFromISR(long &engineSteps)
 {
-    emergencyStopActive = false;
-    LOG_INFO("Emergency stop cleared");
+    // Register writes only: this runs with the flash cache possibly disabled
+    if (!haltedByISR)
+        haltedDriverEnabled = driverEnabled;
+    GPIO.out_w1ts = (1UL << EN_PIN); // EN is active low => freewheel
+    driverEnabled = false;
+    haltedByISR = true; // update() stops polling AccelStepper and holds the commands
+    if (!useTimerEngine)
+        return false;
+    engineSteps = stepGenerator->haltFromISR();
+    return true;
 }
 
-long MotorController::getCurrentPosition() const
+void MotorController::emergencyStopWithRecovery(long limitPosition, int8_t side)
 {
-    return stepper->currentPosition();
+    emergencyStop();
+    // Set after the stop request: update() samples the flag before taking commands,
+    // so by the time it acts on the flag the stop has run
+    limitRecoveryPosition = limitPosition;
+    limitRecoverySide = side;
+    needsLimitRecovery = true;
 }
 
-int MotorController::readEncoder()
+void MotorController::resumeAfterISRHalt()
+{
+    // Not a command: the motor loop holds the rings while halted
+    isrHaltResumeRequested = true;
+}
+
+bool MotorController::clearEmergencyStop(CommandSource source)
+{
+    return commands.post(source, MotorCommandType::ClearEmergencyStop);
+}
+
+bool MotorController::setAcceleration(long accel, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetAcceleration, 0, accel);
+}
+
+bool MotorController::setMaxSpeed(long speed, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetMaxSpeed, 0, speed);
+}
+
+bool MotorController::setMaxJerk(long jerk, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetMaxJerk, 0, jerk);
+}
+
+bool MotorController::setCurrentPosition(long position, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetCurrentPosition, position);
+}
+
+bool MotorController::setTMCMode(bool stealthChop, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetTMCMode, 0, stealthChop);
+}
+
+bool MotorController::setTimerStepEngine(bool useTimer, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetTimerStepEngine, 0, useTimer);
+}
+
+bool MotorController::home(int8_t direction, long maxTravel, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::Home, maxTravel, direction);
+}
+
+bool MotorController::setFollowingErrorWindow(long steps, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetFollowingErrorWindow, 0, steps);
+}
+
+bool MotorController::setServoMode(bool enabled, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetServoMode, 0, enabled);
+}
+
+bool MotorController::setStallThreshold(uint8_t sgthrs, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetStallThreshold, 0, sgthrs);
+}
+
+bool MotorController::setModeHysteresis(long percent, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetModeHysteresis, 0, percent);
+}
+
+bool MotorController::setAdaptiveMicrosteps(bool enabled, CommandSource source)
 {
-    uint16_t temp[2];
-    digitalWrite(SPI_MT_CS, LOW);
-    mt6816->beginTransaction(SPISettings(400000, MSBFIRST, SPI_MODE3));
-    temp[0] = mt6816->transfer16(0x8300) & 0xFF;
-    mt6816->endTransaction();
-    digitalWrite(SPI_MT_CS, HIGH);
+    return commands.post(source, MotorCommandType::SetAdaptiveMicrosteps, 0, enabled);
+}
+
+bool MotorController::setLimitBackoff(long steps, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetLimitBackoff, 0, steps);
+}
 
-    digitalWrite(SPI_MT_CS, LOW);
-    mt6816->beginTransaction(SPISettings(400000, MSBFIRST, SPI_MODE3));
-    temp[1] = mt6816->transfer16(0x8400) & 0xFF;
-    mt6816->endTransaction();
-    digitalWrite(SPI_MT_CS, HIGH);
+bool MotorController::setSoftLimits(bool enabled, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetSoftLimits, 0, enabled);
+}
 
-    return (int)(temp[0] << 6 | temp[1] >> 2);
+bool MotorController::setSoftLimitZone(long steps, CommandSource source)
+{
+    return commands.post(source, MotorCommandType::SetSoftLimitZone, 0, steps);
 }
 
-double MotorController::calculateSpeed(float ms)
+void MotorController::processCommands()
 {
-    double speedT = 0;
-    currentLocation = (double)readEncoder();
+    // Emergency stop is checked before every command so it always wins
+    if (commands.takeEmergencyStop())
+        executeEmergencyStop();
 
-    if (currentLocation == lastLocation)
+    MotorCommand command;
+    while (commands.next(command))
     {
-        speedT = direction = 0;
+        executeCommand(command);
+        if (commands.takeEmergencyStop())
+            executeEmergencyStop();
     }
-    else
+}
+
+void MotorController::executeCommand(const MotorCommand &command)
+{
+    // Motion from anyone else ends a homing run
+    if (homing->isActive() && (command.type == MotorCommandType::MoveTo || command.type == MotorCommandType::QueueMove ||
+                               command.type == MotorCommandType::JogStop || command.type == MotorCommandType::Home ||
+                               command.type == MotorCommandType::SetCurrentPosition))
     {
-        double tempT = abs(currentLocation - lastLocation);
-        if (tempT < 8192)
-        {
-            speedT = (tempT * 360) / 16384;
-            direction = currentLocation > lastLocation ? 1 : -1;
-        }
-        else
+        homing->abort();
+        finishHoming();
+    }
+
+    // The switch isn't armed while backing off it: nothing else moves until that's done
+    if (limitRecovery->isActive())
+    {
+        switch (command.type)
         {
-            speedT = ((currentLocation > lastLocation ? 16384 - currentLocation + lastLocation : 16384 - lastLocation + currentLocation) * 360) / 16384;
-            direction = currentLocation > lastLocation ? -1 : 1;
+        case MotorCommandType::MoveTo:
+        case MotorCommandType::QueueMove:
+        case MotorCommandType::Home:
+        case MotorCommandType::ServoCorrection:
+        case MotorCommandType::SetCurrentPosition:
+            LOG_WARN("Command refused - backing off the limit switch");
+            return;
+        case MotorCommandType::JogStop:
+            // Operator stop: leave it stopped, latched
+            limitRecovery->abort("stopped by operator");
+            executeEmergencyStop();
+            finishLimitRecovery();
+            return;
+        case MotorCommandType::ClearEmergencyStop:
+            // Reset: the operator takes over
+            limitRecovery->abort("reset by operator");
+            break;
+        default:
+            break;
         }
     }
 
-    speedT = direction * (speedT * ms / 1000);
-    lastLocation = currentLocation;
-    return speedT;
+    switch (command.type)
+    {
+    case MotorCommandType::MoveTo:
+        executeLimitedMove(command.position, command.value, false);
+        break;
+    case MotorCommandType::QueueMove:
+        executeLimitedMove(command.position, command.value, true);
+        break;
+    case MotorCommandType::JogStop:
+        executeJogStop();
+        break;
+    case MotorCommandType::ClearEmergencyStop:
+        executeClearEmergencyStop();
+        break;
+    case MotorCommandType::SetMaxSpeed:
+        executeSetMaxSpeed(command.value);
+        break;
+    case MotorCommandType::SetAcceleration:
+        executeSetAcceleration(command.value);
+        break;
+    case MotorCommandType::SetMaxJerk:
+        executeSetMaxJerk(command.value);
+        break;
+    case MotorCommandType::SetTMCMode:
+        executeSetTMCMode(command.value != 0);
+        break;
+    case MotorCommandType::SetTimerStepEngine:
+        executeSetTimerStepEngine(command.value != 0);
+        break;
+    case MotorCommandType::SetCurrentPosition:
+        executeSetCurrentPosition(command.position);
+        break;
+    case MotorCommandType::ServoCorrection:
+        executeServoCorrection(command.value);
+        break;
+    case MotorCommandType::SetRunCurrent:
+        executeSetRunCurrent(command.value);
+        break;
+    case MotorCommandType::Home:
+        executeHome((int8_t)command.value, command.position);
+        break;
+    case MotorCommandType::SetFollowingErrorWindow:
+        executeSetFollowingErrorWindow(command.value);
+        break;
+    case MotorCommandType::SetServoMode:
+        executeSetServoMode(command.value != 0);
+        break;
+    case MotorCommandType::SetStallThreshold:
+        executeSetStallThreshold((uint8_t)command.value);
+        break;
+    case MotorCommandType::SetModeHysteresis:
+        executeSetModeHysteresis(command.value);
+        break;
+    case MotorCommandType::SetAdaptiveMicrosteps:
+        executeSetAdaptiveMicrosteps(command.value != 0);
+        break;
+    case MotorCommandType::SetLimitBackoff:
+        executeSetLimitBackoff(command.value);
+        break;
+    case MotorCommandType::SetSoftLimits:
+        executeSetSoftLimits(command.value != 0);
+        break;
+    case MotorCommandType::SetSoftLimitZone:
+        executeSetSoftLimitZone(command.value);
+        break;
+    }
 }
 
-void MotorController::updateTMCMode()
+void MotorController::executeMoveTo(long position, int speed)
 {
-    // Use commanded speed from AccelStepper (not encoder)
-    float currentSpeedPercent = abs(stepper->speed()) / (float)config.getMaxSpeed();
-    bool shouldUseStealthChop = currentSpeedPercent < STEALTH_CHOP_THRESHOLD;
+    if (emergencyStopActive)
+    {
+        LOG_WARN("Cannot move - emergency stop active");
+        return;
+    }
+    setDriverEnabled(true); // Enable motor
 
-    if (shouldUseStealthChop != useStealthChop)
+    // Clamp speed to safe limits (already validated, but extra safety check)
+    if (speed < MIN_SPEED)
+        speed = MIN_SPEED;
+    if (speed > MAX_SPEED)
+        speed = MAX_SPEED;
+
+    targetPosition = position;
+    if (useTimerEngine && activeSource == scurve && scurve->isRunning())
     {
-        useStealthChop = shouldUseStealthChop;
-        driver->en_spreadCycle(!useStealthChop);
-        LOG_DEBUG("TMC mode switched to %s (speed: %.0f steps/sec, %.0f%% of max)",
-                  useStealthChop ? "StealthChop" : "SpreadCycle",
-                  abs(stepper->speed()),
-                  currentSpeedPercent * 100);
+        // S-curve profiles run rest to rest: pick the new target up when this one completes
+        motionQueue->clearPending();
+        motionQueue->push(getPlannedPosition(), toEngineTarget(position, speed), microstepping->toEngineRate(speed));
+        LOG_INFO("S-curve move in progress - target %ld deferred", position);
+        return;
     }
+
+    if (!isMoving())
+        selectMicrosteps(position - getCurrentPosition(), speed);
+
+    motionQueue->clear();
+    motionQueue->push(getPlannedPosition(), toEngineTarget(position, speed), microstepping->toEngineRate(speed));
+    startSegment();
+
+    LOG_INFO("Moving to position: %ld at speed: %d steps/sec", position, speed);
 }
 
-void MotorController::setTMCMode(bool stealthChop)
+bool MotorController::executeQueueMove(long position, int speed)
 {
-    useStealthChop = stealthChop;
-    driver->en_spreadCycle(!stealthChop);
-    LOG_INFO("TMC mode manually set to %s", stealthChop ? "StealthChop" : "SpreadCycle");
+    if (emergencyStopActive)
+    {
+        LOG_WARN("Cannot queue move - emergency stop active");
+        return false;
+    }
+    if (motionQueue->isFull())
+    {
+        LOG_WARN("Motion queue full - move to %ld rejected", position);
+        return false;
+    }
+    setDriverEnabled(true); // Enable motor
+
+    if (speed < MIN_SPEED)
+        speed = MIN_SPEED;
+    if (speed > MAX_SPEED)
+        speed = MAX_SPEED;
+
+    bool idle = motionQueue->isEmpty();
+    if (!isMoving())
+        selectMicrosteps(position - getCurrentPosition(), speed);
+    motionQueue->push(getPlannedPosition(), toEngineTarget(position, speed), microstepping->toEngineRate(speed));
+    targetPosition = position;
+
+    if (idle)
+        startSegment();
+    else
+        replanMotionQueue();
+
+    LOG_INFO("Queued move to position: %ld at speed: %d steps/sec (%u queued)",
+             position, speed, motionQueue->size());
+    return true;
 }
 
-uint32_t MotorController::getTMCStatus()
+void MotorController::executeLimitedMove(long position, int speed, bool queued)
 {
-    return driver->IOIN();
+    // Limits may have been learned since the last move
+    softLimits->setRange(config.getLimitPos1(), config.getLimitPos2());
+    if (speed < MIN_SPEED)
+        speed = MIN_SPEED;
+    if (speed > MAX_SPEED)
+        speed = MAX_SPEED;
+
+    // Plan from where the planner is: a replacing move from the planned position
+    // and speed, a queued one from the end of the queue (where it stops)
+    long from;
+    int32_t currentSpeed = 0;
+    if (queued && !motionQueue->isEmpty())
+    {
+        from = microstepping->toCanonical(getPlannedPosition()) - servoOffset;
+    }
+    else
+    {
+        long engine = useTimerEngine ? activeSource->currentPosition() : stepper->currentPosition();
+        from = microstepping->toCanonical(engine) - servoOffset;
+        currentSpeed = (int32_t)getCommandedSpeed();
+    }
+
+    SoftLimits::Leg legs[2];
+    uint8_t count = softLimits->plan(from, currentSpeed, position, speed, canonicalAcceleration, legs);
+    if (legs[count - 1].target != position)
+        LOG_WARN("Target %ld outside the soft limits, clipped to %ld", position, legs[count - 1].target);
+
+    if (queued && motionQueue->freeSlots() < count)
+    {
+        LOG_WARN("Motion queue full - move to %ld rejected", position);
+        return;
+    }
+
+    if (queued)
+        executeQueueMove(legs[0].target, legs[0].speed);
+    else
+        executeMoveTo(legs[0].target, legs[0].speed);
+    if (count > 1 && !emergencyStopActive)
+    {
+        LOG_INFO("Creeping the last %ld steps at %u steps/sec", labs(legs[1].target - legs[0].target),
+                 legs[1].speed);
+        executeQueueMove(legs[1].target, legs[1].speed);
+    }
 }
 
-void MotorController::update()
+void MotorController::haltMotion()
 {
-    // Track movement state for completion detection
-    static bool wasMoving = false;
-    bool isMoving = (stepper->distanceToGo() != 0);
+    // CRITICAL: Call stop() first to clear AccelStepper's internal target state
+    stepper->stop(); // This sets new target to current position with deceleration
+    // Then override with immediate stop (no deceleration ramp)
+    stepper->setCurrentPosition(stepper->currentPosition());
+    stepper->setSpeed(0);
+    motionQueue->clear();
+    finishPending = false;
 
-    // Update TMC mode based on current commanded speed
-    updateTMCMode();
+    if (useTimerEngine)
+    {
+        haltTimerEngine();
+    }
+}
 
-    // Handle movement
-    if (emergencyStopActive)
+void MotorController::executeJogStop()
+{
+    // Stop motor movement without triggering emergency stop flag
+    haltMotion();
+
+    // Respect freewheel configuration
+    if (config.getFreewheelAfterMove())
     {
-        stepper->setSpeed(0);
-        digitalWrite(EN_PIN, HIGH); // Always freewheel during emergency stop
+        setDriverEnabled(false); // Freewheel
     }
-    else if (isMoving)
+
+    LOG_INFO("Motor jog stopped");
+}
+
+void MotorController::executeEmergencyStop()
+{
+    // Stop motor immediately
+    haltMotion();
+    setDriverEnabled(false); // Disable motor => freewheel
+    emergencyStopActive = true;
+    if (homing->isActive())
     {
-        // Motor is moving - call run() to step motor
-        stepper->run();
-        wasMoving = true;
+        homing->abort();
+        finishHoming();
     }
-    else if (wasMoving)
+    if (limitRecovery->isActive())
     {
-        // Motor just stopped moving
-        if (config.getFreewheelAfterMove())
-        {
-            digitalWrite(EN_PIN, HIGH); // Freewheel
-            LOG_INFO("Movement complete - freewheeling");
-        }
-        else
-        {
-            // Motor enabled but idle - holding position
-            LOG_INFO("Movement complete - holding position");
-        }
-        wasMoving = false;
+        limitRecovery->abort("emergency stop");
+        finishLimitRecovery();
     }
-    // else: motor is stopped and we've already logged it
+    LOG_WARN("EMERGENCY STOP ACTIVATED");
 }
 
-void MotorController::setAcceleration(long accel)
+void MotorController::executeClearEmergencyStop()
 {
-    // Clamp acceleration to safe limits
-    if (accel < MIN_ACCELERATION)
+    // Re-arm the limit switches here rather than in the caller: a trip after
+    // the reset was posted bumps the epoch, so this never runs past it
+    minLimitSwitch.clearTrigger();
+    maxLimitSwitch.clearTrigger();
+    emergencyStopActive = false;
+    followingError->requestResync();
+    servo->reset();
+    LOG_INFO("Emergency stop cleared");
+}
+
+bool MotorController::holdForISRHalt()
+{
+    if (!haltedByISR)
+        return false;
+
+    // A trip: the emergency stop takes over (and clears a halt left by the ISR)
+    if (emergencyStopActive)
     {
-        LOG_WARN("Acceleration %ld below minimum, clamping to %ld", accel, MIN_ACCELERATION);
-        accel = MIN_ACCELERATION;
+        haltedByISR = false;
+        isrHaltResumeRequested = false;
+        haltMotion();
+        return false;
     }
-    else if (accel > MAX_ACCELERATION)
+
+    // A glitch, once the other switch isn't telling one apart too
+    if (isrHaltResumeRequested && !minLimitSwitch.isPending() && !maxLimitSwitch.isPending())
     {
-        LOG_WARN("Acceleration %ld above maximum, clamping to %ld", accel, MAX_ACCELERATION);
-        accel = MAX_ACCELERATION;
+        haltedByISR = false;
+        isrHaltResumeRequested = false;
+        executeResumeAfterISRHalt();
+        return false;
     }
-
-    stepper->setAcceleration(accel);
-    LOG_INFO("Acceleration set to: %ld steps/sec²", accel);
+    return true;
 }
 
-void MotorController::setMaxSpeed(long speed)
+void MotorController::executeResumeAfterISRHalt()
 {
-    // Clamp speed to safe limits
-    if (speed < MIN_SPEED)
+    long stoppedAt;
+    if (useTimerEngine)
     {
-        LOG_WARN("Speed %ld below minimum, clamping to %ld", speed, MIN_SPEED);
-        speed = MIN_SPEED;
+        haltTimerEngine(); // Clears the halt the ISR left on the step generator
+        stoppedAt = stepGenerator->getPosition();
     }
-    else if (speed > MAX_SPEED)
+    else
     {
-        LOG_WARN("Speed %ld above maximum, clamping to %ld", speed, MAX_SPEED);
-        speed = MAX_SPEED;
+        stepper->setCurrentPosition(stepper->currentPosition());
+        stepper->setSpeed(0);
+        stoppedAt = stepper->currentPosition();
     }
+    finishPending = false;
 
-    stepper->setMaxSpeed(speed);
-    LOG_INFO("Max speed set to: %ld steps/sec", speed);
+    // The front segment is the one cut short, unless the lookahead had already
+    // planned past it: then no step of the front has been emitted yet
+    const MotionSegment *front = motionQueue->front();
+    if (front)
+    {
+        long moved = stoppedAt - front->start;
+        long span = front->target - front->start;
+        if ((moved > 0 && span > 0) || (moved < 0 && span < 0))
+            motionQueue->pop();
+    }
+
+    if (haltedDriverEnabled)
+        setDriverEnabled(true);
+    if (!motionQueue->isEmpty())
+        startSegment();
+    LOG_INFO("Resumed after limit switch glitch at %ld (%u queued moves kept)", getCurrentPosition(),
+             motionQueue->size());
 }
 
-void MotorController::setCurrentPosition(long position)
+long MotorController::getEnginePosition() const
 {
-    stepper->setCurrentPosition(position);
+    return useTimerEngine ? stepGenerator->getPosition() : stepper->currentPosition();
+}
+
+long MotorController::getCurrentPosition() const
+{
+    portENTER_CRITICAL(&scaleMux);
+    long position = microstepping->toCanonical(getEnginePosition()) - servoOffset;
+    portEXIT_CRITICAL(&scaleMux);
+    return position;
+}
+
+long MotorController::toLogicalPosition(long engineSteps) const
+{
+    portENTER_CRITICAL(&scaleMux);
+    long position = microstepping->toCanonical(engineSteps) - servoOffset;
+    portEXIT_CRITICAL(&scaleMux);
+    return position;
+}
+
+bool MotorController::isMoving() const
+{
+    if (!motionQueue->isEmpty())
+    {
+        return true;
+    }
+    if (useTimerEngine)
+    {
+        return activeSource->isRunning() || stepGenerator->isRunning();
+    }
+    return stepper->distanceToGo() != 0;
+}
+
+long MotorController::getPlannedPosition() const
+{
+    // Where the next queued segment starts from
+    if (!motionQueue->isEmpty())
+    {
+        return motionQueue->get(motionQueue->size() - 1)->target;
+    }
+    return useTimerEngine ? activeSource->currentPosition() : stepper->currentPosition();
+}
+
+float MotorController::getCommandedSpeed() const
+{
+    // Canonical steps/sec, like every threshold it is compared against
+    return microstepping->toCanonicalSpeed(useTimerEngine ? activeSource->getSpeed() : stepper->speed());
+}
+
+void MotorController::selectMicrosteps(long distance, int speed)
+{
+    // Back to canonical resolution when adaptive microstepping is off
+    if (adaptiveMicrosteps && microstepGridKnown)
+        changeMicrosteps(MicrostepScale::select(distance, speed));
+    else
+        changeMicrosteps(MicrostepScale::CANONICAL);
+}
+
+void MotorController::changeMicrosteps(uint16_t microsteps)
+{
+    // From rest only: the MRES write can't be lined up with a running step stream
+    if (microsteps == microstepping->getMicrosteps())
+        return;
+
+    long engine = getEnginePosition();
+    portENTER_CRITICAL(&scaleMux);
+    bool switched = microstepping->switchTo(microsteps, engine);
+    portEXIT_CRITICAL(&scaleMux);
+    if (!switched)
+        return; // Off the full-step grid (a stopped move): keep the current resolution
+
+    applyEngineRates();
+    tmc->setField(TMCShadow::Reg::CHOPCONF, TMCShadow::MRES_MASK,
+                  (uint32_t)MicrostepScale::mres(microsteps) << TMCShadow::MRES_SHIFT);
+    tmcTask->wake();
+    microstepChangePending = true; // update() starts the move once the driver has it
+    LOG_DEBUG("Microstepping 1/%u", microsteps);
+}
+
+void MotorController::applyEngineRates()
+{
+    // Planner limits in pulses at the current resolution
+    stepper->setMaxSpeed(microstepping->toEngineRate(canonicalMaxSpeed));
+    stepper->setAcceleration(microstepping->toEngineRate(canonicalAcceleration));
+    ramp->setMaxSpeed(microstepping->toEngineRate(canonicalMaxSpeed));
+    ramp->setAcceleration(microstepping->toEngineRate(canonicalAcceleration));
+}
+
+long MotorController::toEngineTarget(long position, int speed)
+{
+    // Coarse resolutions can only stop on their grid: end on the last full step
+    // and let update() finish the move at a finer one
+    long target = position + servoOffset;
+    long reachable = microstepping->reachable(microstepping->toCanonical(getPlannedPosition()), target);
+    finishPending = reachable != target;
+    finishTarget = position;
+    finishSpeed = speed;
+    return microstepping->toEngine(reachable);
+}
+
+void MotorController::executeSetAdaptiveMicrosteps(bool enabled)
+{
+    adaptiveMicrosteps = enabled;
+    LOG_INFO("Adaptive microstepping %s%s", enabled ? "enabled" : "disabled",
+             enabled && !microstepGridKnown ? " (unavailable until the driver is power-cycled)" : "");
+}
+
+int MotorController::readEncoder()
+{
+    // Newest sample from the encoder task (at most one sample period old)
+    EncoderSample sample;
+    if (!encoder->latest(sample))
+        return 0;
+    return sample.angle;
+}
+
+void MotorController::setDriverEnabled(bool enabled)
+{
+    digitalWrite(EN_PIN, enabled ? LOW : HIGH); // EN is active low
+    driverEnabled = enabled;
+}
+
+void MotorController::executeSetFollowingErrorWindow(long steps)
+{
+    followingError->setWindow(steps);
+    LOG_INFO("Following error window set to: %ld steps%s", steps, steps > 0 ? "" : " (monitor disabled)");
+}
+
+long MotorController::getFollowingError() const
+{
+    return followingError->getError();
+}
+
+long MotorController::getMeasuredPosition() const
+{
+    return followingError->getMeasuredPosition();
+}
+
+bool MotorController::isFollowingErrorFault() const
+{
+    return followingError->isFaulted();
+}
+
+void MotorController::executeSetServoMode(bool enabled)
+{
+    servo->setEnabled(enabled);
+    LOG_INFO("Servo mode %s", enabled ? "enabled" : "disabled");
+}
+
+bool MotorController::isServoModeEnabled() const
+{
+    return servo->isEnabled();
+}
+
+uint8_t MotorController::getRunCurrentPercent() const
+{
+    return servo->getCurrentPercent();
+}
+
+uint32_t MotorController::getServoCorrectionCount() const
+{
+    return servo->getCorrectionCount();
+}
+
+void MotorController::executeServoCorrection(long steps)
+{
+    // Only from rest: a move or stop that arrived since the sample owns the steps
+    if (emergencyStopActive || !driverEnabled || isMoving())
+        return;
+
+    // A few microsteps: only canonical resolution or finer can place them
+    if (microstepping->getMicrosteps() < MicrostepScale::CANONICAL)
+        changeMicrosteps(MicrostepScale::CANONICAL);
+    if (microstepping->getMicrosteps() < MicrostepScale::CANONICAL)
+        return;
+
+    long from = getPlannedPosition();
+    long to = microstepping->toEngine(microstepping->toCanonical(from) + steps);
+    motionQueue->push(from, to, microstepping->toEngineRate(SERVO_CORRECTION_SPEED));
+    servoOffset += steps;
+    startSegment();
+    LOG_DEBUG("Servo correction: %ld steps (offset %ld)", steps, servoOffset);
+}
+
+void MotorController::executeSetRunCurrent(long percent)
+{
+    if (tmc->setRunCurrent(RUN_CURRENT_MA * percent / 100))
+        tmcTask->wake();
+    LOG_DEBUG("Run current set to %ld%% (%ld mA)", percent, RUN_CURRENT_MA * percent / 100);
+}
+
+bool MotorController::isHoming() const
+{
+    return homing->isActive();
+}
+
+void MotorController::executeSetStallThreshold(uint8_t sgthrs)
+{
+    stallDetector->setThreshold(sgthrs);
+    LOG_INFO("Stall threshold (SGTHRS) set to %u: stall at SG_RESULT <= %u", sgthrs, 2 * sgthrs);
+}
+
+void MotorController::executeHome(int8_t direction, long maxTravel)
+{
+    if (emergencyStopActive || isMoving())
+    {
+        LOG_WARN("Cannot home - %s", emergencyStopActive ? "emergency stop active" : "motor moving");
+        return;
+    }
+
+    // StallGuard4: StealthChop at all speeds (no TPWMTHRS switch), threshold in SGTHRS
+    tmc->setSpreadCycle(false);
+    tmc->set(TMCShadow::Reg::TPWMTHRS, 0);
+    useStealthChop = true;
+    tmc->set(TMCShadow::Reg::TCOOLTHRS, STALLGUARD_TCOOLTHRS);
+    tmc->set(TMCShadow::Reg::SGTHRS, stallDetector->getThreshold());
+    tmcTask->setStallGuardPolling(true); // Also flushes the registers above
+
+    HomingSequence::Move move = homing->start(direction, getCurrentPosition(), maxTravel);
+    LOG_INFO("Homing towards the %s stop (up to %ld steps, SGTHRS %u)", direction < 0 ? "min" : "max",
+             maxTravel, stallDetector->getThreshold());
+    startHomingMove(move.target, move.speed);
+}
+
+void MotorController::startHomingMove(long target, long speed)
+{
+    // SG_RESULT is only meaningful once the move is up to speed
+    stallDetector->reset();
+    stallDetector->setMinSpeed(speed / 2);
+    lastStallReading = tmc->getStatusReads(TMCShadow::Status::SG_RESULT);
+    executeMoveTo(target, speed);
+}
+
+void MotorController::updateHoming()
+{
+    if (!homing->isActive())
+        return;
+
+    HomingSequence::Move next;
+    if (isMoving())
+    {
+        // One detector update per fresh SG_RESULT from the TMC task
+        uint32_t reading = tmc->getStatusReads(TMCShadow::Status::SG_RESULT);
+        uint32_t sgResult;
+        if (!homing->isSeeking() || reading == lastStallReading ||
+            !tmc->getStatus(TMCShadow::Status::SG_RESULT, sgResult))
+            return;
+        lastStallReading = reading;
+
+        if (!stallDetector->update(sgResult & 0x3FF, getCommandedSpeed()))
+            return;
+
+        haltMotion();
+        LOG_DEBUG("Stall at %ld (SG_RESULT %u)", getCurrentPosition(), stallDetector->getLastResult());
+        next = homing->onStall(getCurrentPosition());
+    }
+    else
+    {
+        next = homing->onStopped(getCurrentPosition());
+    }
+
+    if (next.valid)
+        startHomingMove(next.target, next.speed);
+    else
+        finishHoming();
+}
+
+void MotorController::finishHoming()
+{
+    // Back to normal StealthChop/SpreadCycle switching, StallGuard off
+    tmc->set(TMCShadow::Reg::TCOOLTHRS, 0);
+    applyChopperMode();
+    tmcTask->setStallGuardPolling(false);
+    followingError->requestResync();
+
+    if (homing->getPhase() != HomingSequence::Phase::Done)
+    {
+        LOG_WARN("Homing failed: %s", homing->getFailure());
+        return;
+    }
+
+    long stop = homing->getStopPosition();
+    long released = getCurrentPosition();
+    if (homing->getDirection() < 0)
+    {
+        // Min stop becomes position 0; a learned max limit keeps its place
+        long maxLimit = config.getLimitPos2() - stop;
+        executeSetCurrentPosition(released - stop);
+        config.saveLimitPositions(released - stop, maxLimit);
+    }
+    else
+    {
+        config.saveLimitPositions(config.getLimitPos1(), released);
+    }
+    LOG_INFO("Homing complete: %s stop at %ld, limit set %ld steps clear of it", homing->getDirection() < 0 ? "min" : "max",
+             homing->getDirection() < 0 ? 0 : stop, HomingSequence::RELEASE_STEPS);
+}
+
+void MotorController::executeSetLimitBackoff(long steps)
+{
+    limitRecovery->setBackoff(steps);
+}
+
+void MotorController::executeSetSoftLimits(bool enabled)
+{
+    softLimits->setEnabled(enabled);
+}
+
+void MotorController::executeSetSoftLimitZone(long steps)
+{
+    softLimits->setZone(steps);
+}
+
+void MotorController::updateLimitRecovery(bool requested)
+{
+    if (requested)
+    {
+        needsLimitRecovery = false;
+        limitRecovery->latch(limitRecoverySide, limitRecoveryPosition);
+    }
+    if (!limitRecovery->isActive() || isMoving() || finishPending)
+        return;
+
+    LimitSwitch &limitSwitch = limitRecovery->getSide() < 0 ? minLimitSwitch : maxLimitSwitch;
+    LimitRecovery::Move next;
+    if (limitRecovery->getPhase() == LimitRecovery::Phase::Latched)
+    {
+        next = limitRecovery->start(getCurrentPosition());
+        if (next.valid)
+        {
+            // Unlatch for the back-off only; commands stay refused until it's over
+            emergencyStopActive = false;
+            followingError->requestResync();
+            servo->reset();
+        }
+    }
+    else
+    {
+        next = limitRecovery->onStopped(getCurrentPosition(), limitSwitch.isPressed());
+    }
+
+    if (next.valid)
+    {
+        LOG_INFO("Backing off the %s limit switch to %ld (attempt %u)", limitRecovery->getSide() < 0 ? "min" : "max",
+                 next.target, limitRecovery->getAttempts());
+        executeMoveTo(next.target, next.speed);
+    }
+    else
+    {
+        finishLimitRecovery();
+    }
+}
+
+void MotorController::finishLimitRecovery()
+{
+    LimitSwitch &limitSwitch = limitRecovery->getSide() < 0 ? minLimitSwitch : maxLimitSwitch;
+    if (limitRecovery->getPhase() == LimitRecovery::Phase::Done)
+    {
+        limitSwitch.clearTrigger();
+        LOG_INFO("Limit recovery complete: %s switch open at %ld, re-armed", limitRecovery->getSide() < 0 ? "min" : "max",
+                 getCurrentPosition());
+        return;
+    }
+
+    // Still on (or unsure of) the switch: stay stopped until a reset
+    if (!emergencyStopActive)
+    {
+        haltMotion();
+        setDriverEnabled(false);
+        emergencyStopActive = true;
+    }
+    LOG_WARN("Limit recovery failed: %s - reset required", limitRecovery->getFailure());
+}
+
+void MotorController::checkFollowingError()
+{
+    // A disabled driver lets the shaft turn freely: resync once it is enabled again.
+    // Same without encoder samples, rather than faulting on a dead sensor reading.
+    // Homing stalls the motor on purpose: StallGuard watches it instead.
+    EncoderSample sample;
+    if (!driverEnabled || isHoming() || !encoder->latest(sample))
+    {
+        followingError->suspend();
+        return;
+    }
+
+    bool wasFaulted = followingError->isFaulted();
+    long commanded = getCurrentPosition();
+    followingError->update(sample.position, commanded);
+
+    if (followingError->getState() == FollowingErrorMonitor::State::Tracking && !isEncoderCalibrating())
+    {
+        // Corrections and current changes run on the motor loop like any other command
+        ServoCorrector::Output output = servo->update(followingError->getError(), isMoving());
+        if (output.correctionSteps)
+            commands.post(CommandSource::Input, MotorCommandType::ServoCorrection, 0, output.correctionSteps);
+        if (output.currentChanged)
+            commands.post(CommandSource::Input, MotorCommandType::SetRunCurrent, 0, output.currentPercent);
+    }
+    else
+    {
+        servo->reset();
+    }
+
+    if (followingError->isFaulted() && !wasFaulted)
+    {
+        emergencyStop();
+        LOG_ERROR("Following error fault: commanded %ld, encoder %ld (error %ld, window %ld steps)",
+                  commanded, followingError->getMeasuredPosition(), followingError->getError(),
+                  followingError->getWindow());
+    }
+}
+
+bool MotorController::requestEncoderCalibration()
+{
+    if (calibrationState != CalibrationState::Idle || emergencyStopActive || isMoving())
+        return false;
+    calibrationRequested = true;
+    return true;
+}
+
+void MotorController::updateCalibration()
+{
+    if (calibrationRequested)
+    {
+        calibrationRequested = false;
+        startCalibration();
+    }
+    if (calibrationState == CalibrationState::Idle)
+        return;
+    if (emergencyStopActive)
+    {
+        abortCalibration("emergency stop");
+        return;
+    }
+
+    const uint16_t points = FollowingErrorMonitor::DEFAULT_STEPS_PER_REV / CALIBRATION_STRIDE;
+    switch (calibrationState)
+    {
+    case CalibrationState::Moving:
+        // The move is posted to the motor loop: done once it has run and stopped there
+        if (isMoving() || getCurrentPosition() != getCalibrationTarget())
+            return;
+        if (calibrationIndex == points)
+        {
+            // Turnaround point: every backward reading now approaches from above
+            calibrationIndex--;
+            moveToCalibrationPoint();
+            return;
+        }
+        calibrationTicks = 0;
+        calibrationState = CalibrationState::Settling;
+        break;
+
+    case CalibrationState::Settling:
+        if (++calibrationTicks < CALIBRATION_SETTLE_TICKS)
+            return;
+        calibrationCursor = encoder->samples().subscribe();
+        calibrationSum = 0;
+        calibrationCount = 0;
+        calibrationState = CalibrationState::Sampling;
+        break;
+
+    case CalibrationState::Sampling:
+    {
+        EncoderSample sample;
+        while (calibrationCount < CALIBRATION_SAMPLES && encoder->samples().read(calibrationCursor, sample))
+        {
+            if (calibrationCount == 0)
+                calibrationFirst = sample.raw;
+            int32_t offset = (int32_t)sample.raw - calibrationFirst;
+            if (offset > EncoderCalibration::COUNTS_PER_REV / 2)
+                offset -= EncoderCalibration::COUNTS_PER_REV;
+            else if (offset < -EncoderCalibration::COUNTS_PER_REV / 2)
+                offset += EncoderCalibration::COUNTS_PER_REV;
+            calibrationSum += offset;
+            calibrationCount++;
+        }
+        if (calibrationCount < CALIBRATION_SAMPLES)
+            return;
+
+        int32_t rounding = (calibrationSum >= 0 ? 1 : -1) * CALIBRATION_SAMPLES / 2;
+        int32_t mean = calibrationFirst + (calibrationSum + rounding) / CALIBRATION_SAMPLES;
+        uint16_t reading = (uint16_t)(mean & (EncoderCalibration::COUNTS_PER_REV - 1));
+
+        if (!calibrationBackward)
+        {
+            calibrationForward[calibrationIndex] = reading;
+            if (++calibrationIndex == points)
+                calibrationBackward = true; // Turnaround one point past the end
+        }
+        else
+        {
+            calibrationPoints[calibrationIndex] = EncoderCalibration::midpoint(calibrationForward[calibrationIndex], reading);
+            if (calibrationIndex == 0)
+            {
+                finishCalibration();
+                return;
+            }
+            calibrationIndex--;
+        }
+        calibrationState = CalibrationState::Moving;
+        moveToCalibrationPoint();
+        break;
+    }
+
+    case CalibrationState::Idle:
+        break;
+    }
+}
+
+void MotorController::startCalibration()
+{
+    if (calibrationState != CalibrationState::Idle || emergencyStopActive || isMoving())
+    {
+        LOG_WARN("Encoder calibration rejected - motor busy");
+        return;
+    }
+
+    // One revolution of travel, plus the turnaround point, inside the limits
+    long position = getCurrentPosition();
+    long travel = FollowingErrorMonitor::DEFAULT_STEPS_PER_REV + CALIBRATION_STRIDE;
+    long margin = config.getSoftLimits() ? SoftLimits::MARGIN : 0; // Soft limits would clip the end points
+    if (position + travel <= config.getMaxLimit() - margin)
+        calibrationDirection = 1;
+    else if (position - travel >= config.getMinLimit() + margin)
+        calibrationDirection = -1;
+    else
+    {
+        LOG_WARN("Encoder calibration rejected - needs %ld steps of travel inside the limits", travel);
+        return;
+    }
+
+    const uint16_t points = FollowingErrorMonitor::DEFAULT_STEPS_PER_REV / CALIBRATION_STRIDE;
+    calibrationForward = new uint16_t[points];
+    calibrationPoints = new uint16_t[points];
+    calibrationStart = position;
+    calibrationIndex = 0;
+    calibrationBackward = false;
+
+    // Sweep raw angles: the old table would be measured against itself
+    encoder->clearCalibration();
+    followingError->requestResync();
+    servo->reset();
+
+    // Settle on the start point first, it is measured like the others
+    LOG_INFO("Encoder calibration started: %u points %s from %ld", points,
+             calibrationDirection > 0 ? "forward" : "backward", position);
+    calibrationState = CalibrationState::Moving;
+    moveToCalibrationPoint();
+}
+
+long MotorController::getCalibrationTarget() const
+{
+    return calibrationStart + calibrationDirection * (long)calibrationIndex * CALIBRATION_STRIDE;
+}
+
+void MotorController::moveToCalibrationPoint()
+{
+    if (!moveTo(getCalibrationTarget(), CALIBRATION_SPEED, CommandSource::Input))
+        abortCalibration("command ring full");
+}
+
+void MotorController::finishCalibration()
+{
+    const uint16_t points = FollowingErrorMonitor::DEFAULT_STEPS_PER_REV / CALIBRATION_STRIDE;
+    int16_t table[EncoderCalibration::TABLE_SIZE];
+    if (!EncoderCalibration::build(calibrationPoints, points, table))
+    {
+        abortCalibration("sweep did not cover one clean revolution");
+        return;
+    }
+
+    config.saveEncoderCalibration(table, EncoderCalibration::TABLE_SIZE);
+    encoder->setCalibration(table);
+    followingError->requestResync();
+
+    delete[] calibrationForward;
+    delete[] calibrationPoints;
+    calibrationForward = nullptr;
+    calibrationPoints = nullptr;
+    calibrationState = CalibrationState::Idle;
+
+    EncoderCalibration check;
+    check.load(table);
+    LOG_INFO("Encoder calibration complete: peak error %d counts (%.2f°)", check.getPeakError(),
+             check.getPeakError() * 360.0f / EncoderCalibration::COUNTS_PER_REV);
+}
+
+void MotorController::abortCalibration(const char *reason)
+{
+    // Back to the stored table, if there is one
+    int16_t table[EncoderCalibration::TABLE_SIZE];
+    if (config.loadEncoderCalibration(table, EncoderCalibration::TABLE_SIZE))
+        encoder->setCalibration(table);
+    followingError->requestResync();
+
+    delete[] calibrationForward;
+    delete[] calibrationPoints;
+    calibrationForward = nullptr;
+    calibrationPoints = nullptr;
+    calibrationState = CalibrationState::Idle;
+    LOG_WARN("Encoder calibration aborted: %s", reason);
+}
+
+void MotorController::updateVelocity()
+{
+    // Every sample since the last call, so the observer runs at the full sample rate
+    EncoderSample sample;
+    while (encoder->samples().read(velocityCursor, sample))
+    {
+        velocityObserver->update(sample.angle, sample.timestampUs);
+    }
+
+    monitorSpeed = velocityObserver->getVelocityDegPerSec();
+    direction = monitorSpeed > DIRECTION_DEADBAND ? 1 : (monitorSpeed < -DIRECTION_DEADBAND ? -1 : 0);
+}
+
+void MotorController::setVelocityBandwidth(float hz)
+{
+    velocityObserver->setBandwidth(hz);
+    LOG_INFO("Velocity observer bandwidth set to %.1f Hz", velocityObserver->getBandwidth());
+}
+
+void MotorController::computeModeThresholds()
+{
+    stealthChopThresholdSpeed = config.getMaxSpeed() * STEALTH_CHOP_THRESHOLD;
+    stealthChopReturnSpeed = stealthChopThresholdSpeed * (100 - modeHysteresis) / 100;
+}
+
+void MotorController::applyChopperMode()
+{
+    bool changed;
+    if (hardwareModeSwitch)
+    {
+        // en_SpreadCycle clear: StealthChop below TPWMTHRS, SpreadCycle above it
+        changed = tmc->setStealthChopThreshold(stealthChopThresholdSpeed * microstepping->getMicrosteps() /
+                                               MicrostepScale::CANONICAL);
+        useStealthChop = stealthChopEnabled;
+    }
+    else
+    {
+        // TPWMTHRS 0: en_SpreadCycle alone decides, set by updateTMCMode()
+        changed = tmc->set(TMCShadow::Reg::TPWMTHRS, 0);
+        useStealthChop = stealthChopEnabled && abs(getCommandedSpeed()) < stealthChopThresholdSpeed;
+    }
+    changed |= tmc->setSpreadCycle(!useStealthChop);
+    if (changed)
+        tmcTask->wake();
+}
+
+void MotorController::executeSetModeHysteresis(long percent)
+{
+    modeHysteresis = percent;
+    computeModeThresholds();
+    LOG_INFO("TMC mode hysteresis set to %ld%%", percent);
+}
+
+bool MotorController::isStealthChopActive() const
+{
+    uint32_t drvStatus;
+    if (tmc->getStatus(TMCShadow::Status::DRV_STATUS, drvStatus))
+        return (drvStatus & TMCShadow::DRV_STATUS_STEALTH) != 0;
+    return useStealthChop; // Not polled yet
+}
+
+void MotorController::updateTMCMode()
+{
+    // StallGuard4 only works in StealthChop: homing holds it.
+    // With TPWMTHRS programmed the driver switches by itself.
+    if (homing->isActive() || hardwareModeSwitch || !stealthChopEnabled)
+        return;
+
+    // Use commanded speed from the active step engine (not encoder).
+    // Compared against precomputed thresholds: no divide on every loop.
+    // Leaving SpreadCycle waits for the lower threshold, so a speed
+    // hovering at the threshold doesn't toggle the mode.
+    float currentSpeed = abs(getCommandedSpeed());
+    bool shouldUseStealthChop = currentSpeed < (useStealthChop ? stealthChopThresholdSpeed : stealthChopReturnSpeed);
+
+    if (shouldUseStealthChop != useStealthChop)
+    {
+        // Shadow write only: the TMC task does the UART transfer off this core
+        useStealthChop = shouldUseStealthChop;
+        if (tmc->setSpreadCycle(!useStealthChop))
+            tmcTask->wake();
+        LOG_DEBUG("TMC mode switched to %s (speed: %.0f steps/sec, %.0f%% of max)",
+                  useStealthChop ? "StealthChop" : "SpreadCycle",
+                  currentSpeed,
+                  currentSpeed * 100 / config.getMaxSpeed());
+    }
+}
+
+void MotorController::executeSetTMCMode(bool stealthChop)
+{
+    stealthChopEnabled = stealthChop;
+    if (!homing->isActive())
+        applyChopperMode();
+    LOG_INFO("TMC mode manually set to %s", stealthChop ? "StealthChop below threshold" : "SpreadCycle");
+}
+
+uint32_t MotorController::getTMCStatus()
+{
+    uint32_t ioin = 0;
+    tmc->getStatus(TMCShadow::Status::IOIN, ioin);
+    return ioin;
+}
+
+void MotorController::update()
+{
+    // Track movement state for completion detection
+    static bool wasMoving = false;
+
+    // A limit ISR parked the motor: nothing runs until InputTask tells a trip from a glitch
+    if (holdForISRHalt())
+    {
+        publishState();
+        return;
+    }
+
+    // Commands from other tasks run here, before anything steps. A limit trip is
+    // sampled first, so the emergency stop it follows has run when it's acted on.
+    bool limitTripped = needsLimitRecovery;
+    processCommands();
+
+    // Homing reacts to stalls and chains its moves before the movement state is taken
+    updateHoming();
+    updateLimitRecovery(limitTripped);
+
+    // A move waiting for its MRES starts once the driver has it
+    if (microstepChangePending && tmc->isApplied(TMCShadow::Reg::CHOPCONF))
+    {
+        microstepChangePending = false;
+        startSegment();
+    }
+
+    // Likewise a move waiting for PositionTask to erase the stored position
+    if (snapshotClearPending && snapshotTask->isInvalidated())
+    {
+        snapshotClearPending = false;
+        startSegment();
+    }
+
+    bool isMoving = this->isMoving();
+
+    // Update TMC mode based on current commanded speed
+    updateTMCMode();
+
+    // Handle movement
+    if (emergencyStopActive)
+    {
+        stepper->setSpeed(0);
+        setDriverEnabled(false); // Always freewheel during emergency stop
+    }
+    else if (isMoving)
+    {
+        // Motor is moving - keep the timer engine fed, or poll AccelStepper
+        if (microstepChangePending || snapshotClearPending)
+        {
+            // Nothing to step until the driver has the new MRES and the stored position is erased
+        }
+        else if (useTimerEngine)
+        {
+            feedStepGenerator();
+        }
+        else
+        {
+            if (stepper->distanceToGo() == 0)
+            {
+                advanceMotionQueue();
+            }
+            stepper->run();
+        }
+        wasMoving = true;
+    }
+    else if (wasMoving && finishPending)
+    {
+        // Coarse move ended on the last full step: the rest at a finer resolution
+        executeMoveTo(finishTarget, finishSpeed);
+        finishPending = false;
+    }
+    else if (wasMoving)
+    {
+        // Motor just stopped moving
+        savePositionSnapshot();
+        if (config.getFreewheelAfterMove() && !isEncoderCalibrating()) // The sweep needs each point held
+        {
+            setDriverEnabled(false); // Freewheel
+            LOG_INFO("Movement complete - freewheeling");
+        }
+        else
+        {
+            // Motor enabled but idle - holding position
+            LOG_INFO("Movement complete - holding position");
+        }
+        wasMoving = false;
+    }
+    // else: motor is stopped and we've already logged it
+
+    publishState();
+}
+
+void MotorController::publishState()
+{
+    MotorStateSnapshot snapshot;
+    snapshot.version = ++stateVersion;
+    snapshot.timeUs = micros();
+    snapshot.position = getCurrentPosition();
+    snapshot.target = targetPosition;
+    snapshot.speed = getCommandedSpeed();
+    EncoderSample sample;
+    snapshot.encoderAngle = encoder->latest(sample) ? sample.angle : 0;
+    snapshot.microsteps = microstepping->getMicrosteps();
+    snapshot.queueDepth = motionQueue->size();
+    snapshot.queueFree = motionQueue->freeSlots();
+
+    uint16_t flags = 0;
+    if (isMoving())
+        flags |= MotorStateSnapshot::MOVING;
+    if (emergencyStopActive)
+        flags |= MotorStateSnapshot::EMERGENCY_STOP;
+    if (minLimitSwitch.isTriggered())
+        flags |= MotorStateSnapshot::LIMIT_MIN;
+    if (maxLimitSwitch.isTriggered())
+        flags |= MotorStateSnapshot::LIMIT_MAX;
+    if (isHoming())
+        flags |= MotorStateSnapshot::HOMING;
+    if (isEncoderCalibrating())
+        flags |= MotorStateSnapshot::CALIBRATING;
+    if (isStealthChopActive())
+        flags |= MotorStateSnapshot::STEALTH_CHOP;
+    if (positionRestored)
+        flags |= MotorStateSnapshot::POSITION_RESTORED;
+    if (isEncoderCalibrated())
+        flags |= MotorStateSnapshot::ENCODER_CALIBRATED;
+    if (driverEnabled)
+        flags |= MotorStateSnapshot::DRIVER_ENABLED;
+    snapshot.flags = flags;
+
+    state.write(snapshot);
+}
+
+void MotorController::executeSetAcceleration(long accel)
+{
+    // Clamp acceleration to safe limits
+    if (accel < MIN_ACCELERATION)
+    {
+        LOG_WARN("Acceleration %ld below minimum, clamping to %ld", accel, MIN_ACCELERATION);
+        accel = MIN_ACCELERATION;
+    }
+    else if (accel > MAX_ACCELERATION)
+    {
+        LOG_WARN("Acceleration %ld above maximum, clamping to %ld", accel, MAX_ACCELERATION);
+        accel = MAX_ACCELERATION;
+    }
+
+    canonicalAcceleration = accel;
+    applyEngineRates();
+    LOG_INFO("Acceleration set to: %ld steps/sec²", accel);
+}
+
+void MotorController::executeSetMaxSpeed(long speed)
+{
+    // Clamp speed to safe limits
+    if (speed < MIN_SPEED)
+    {
+        LOG_WARN("Speed %ld below minimum, clamping to %ld", speed, MIN_SPEED);
+        speed = MIN_SPEED;
+    }
+    else if (speed > MAX_SPEED)
+    {
+        LOG_WARN("Speed %ld above maximum, clamping to %ld", speed, MAX_SPEED);
+        speed = MAX_SPEED;
+    }
+
+    canonicalMaxSpeed = speed;
+    applyEngineRates();
+    computeModeThresholds();
+    if (!homing->isActive())
+        applyChopperMode(); // New TPWMTHRS
+    LOG_INFO("Max speed set to: %ld steps/sec", speed);
+}
+
+void MotorController::executeSetMaxJerk(long jerk)
+{
+    // 0 disables S-curve moves
+    if (jerk < 0)
+    {
+        jerk = 0;
+    }
+    else if (jerk > MAX_JERK)
+    {
+        LOG_WARN("Jerk %ld above maximum, clamping to %ld", jerk, MAX_JERK);
+        jerk = MAX_JERK;
+    }
+
+    maxJerk = jerk;
+    LOG_INFO("Max jerk set to: %ld steps/sec³%s", jerk, jerk > 0 ? "" : " (S-curve disabled)");
+}
+
+void MotorController::executeSetCurrentPosition(long position)
+{
+    haltTimerEngine();
+    long engine = getEnginePosition();
+    portENTER_CRITICAL(&scaleMux);
+    engine = microstepping->setCurrentPosition(engine, position);
+    servoOffset = 0;
+    portEXIT_CRITICAL(&scaleMux);
+
+    stepper->setCurrentPosition(engine);
+    motionQueue->clear();
+    finishPending = false;
+    followingError->requestResync();
+    servo->reset();
+    stepGenerator->setPosition(engine);
+    ramp->setCurrentPosition(engine);
+    scurve->setCurrentPosition(engine);
+    if (!emergencyStopActive)
+        savePositionSnapshot(); // New step reference for the same encoder count
+}
+
+void MotorController::startSegment()
+{
+    const MotionSegment *segment = motionQueue->front();
+    if (!segment || microstepChangePending || snapshotClearPending)
+        return; // Started by update() once the driver has the new MRES / the snapshot is erased
+
+    // Nothing moves while NVS holds a position: erasing it turns the flash cache
+    // off on both cores, which the step ISR (not in IRAM) can't run through
+    if (!snapshotTask->invalidate())
+    {
+        snapshotClearPending = true;
+        return;
+    }
+
+    if (useTimerEngine)
+    {
+        startTimerMove(segment->target, segment->maxSpeed);
+    }
+    else
+    {
+        stepper->setMaxSpeed(segment->maxSpeed);
+        stepper->moveTo(segment->target);
+    }
+}
+
+void MotorController::advanceMotionQueue()
+{
+    // The front segment is done once its target is planned (timer) or reached (polled)
+    if (motionQueue->isEmpty())
+        return;
+
+    if (useTimerEngine)
+    {
+        if (activeSource == scurve)
+        {
+            if (scurve->isRunning())
+                return;
+            // S-curve fully planned: hand the planned position back to the trapezoid planner
+            ramp->setCurrentPosition(scurve->currentPosition());
+            activeSource = ramp;
+        }
+        else if (!ramp->isAtTarget() || (ramp->isRunning() && ramp->getExitSpeed() == 0))
+        {
+            return; // Still travelling, or overshooting a stop
+        }
+    }
+
+    motionQueue->pop();
+    if (!motionQueue->isEmpty())
+    {
+        startSegment();
+    }
+}
+
+void MotorController::replanMotionQueue()
+{
+    const MotionSegment *segment = motionQueue->front();
+    if (!useTimerEngine || activeSource != ramp || !segment)
+        return;
+
+    // S-curve mode keeps every segment rest to rest (exit speeds stay zero)
+    if (maxJerk == 0)
+    {
+        long speed = ramp->getSpeedStepsPerSec();
+        motionQueue->plan(ramp->currentPosition(), speed < 0 ? -speed : speed, ramp->getAcceleration());
+    }
+    ramp->setExitSpeed(segment->exitSpeed);
+}
+
+void MotorController::startTimerMove(long position, int speed)
+{
+    if (maxJerk > 0 && !ramp->isRunning() &&
+        scurve->plan(ramp->currentPosition(), position, speed, ramp->getAcceleration(), microstepping->toEngineRate(maxJerk)))
+    {
+        activeSource = scurve;
+        return;
+    }
+
+    // Trapezoid, also used to retarget a trapezoidal move already under way
+    activeSource = ramp;
+    ramp->setMaxSpeed(speed);
+    replanMotionQueue();
+    ramp->moveTo(position);
+}
+
+void MotorController::haltTimerEngine()
+{
+    // Stop the ISR first so the emitted position can't move under us
+    stepGenerator->stop();
+    long position = stepGenerator->getPosition();
+    ramp->setCurrentPosition(position);
+    scurve->setCurrentPosition(position);
+    activeSource = ramp;
+}
+
+void MotorController::feedStepGenerator()
+{
+    // Plan steps until LOOKAHEAD_US worth of motion is queued, then make sure the timer runs
+    int8_t stepDirection;
+    while (stepGenerator->needsSteps())
+    {
+        advanceMotionQueue();
+        uint32_t interval = activeSource->nextStep(stepDirection);
+        if (interval == 0)
+            break;
+        stepGenerator->push(interval, stepDirection);
+    }
+
+    stepGenerator->start();
+}
+
+bool MotorController::executeSetTimerStepEngine(bool useTimer)
+{
+    // The saved choice follows the engine actually running, so a refused switch
+    // never changes what the next boot uses. At rest here, so the write can't stall steps.
+    if (useTimer == useTimerEngine)
+    {
+        if (config.getUseTimerStepEngine() != useTimer)
+            config.setUseTimerStepEngine(useTimer);
+        return true;
+    }
+
+    if (isMoving())
+    {
+        LOG_WARN("Cannot switch step engine while moving");
+        return false;
+    }
+
+    if (useTimer && !stepGenerator->begin())
+    {
+        LOG_ERROR("Step timer unavailable, staying on polled stepping");
+        return false;
+    }
+
+    // Carry the position over so both engines agree
+    long position = getCurrentPosition();
+    long engine = getEnginePosition();
+    useTimerEngine = useTimer;
+    stepper->setCurrentPosition(engine);
+    stepGenerator->setPosition(engine);
+    executeSetCurrentPosition(position);
+    config.setUseTimerStepEngine(useTimer);
+    LOG_INFO("Step engine switched to %s", useTimer ? "hardware timer" : "polled");
+    return true;
 }
\ No newline at end of file
@@ -2,41 +2,237 @@
 
 #include <AccelStepper.h>
 #include <TMCStepper.h>
-#include <SPI.h>
+#include "../StepGenerator/StepGenerator.h"
+#include "../StepGenerator/RampGenerator.h"
+#include "../StepGenerator/SCurveProfile.h"
+#include "../StepGenerator/MotionQueue.h"
+#include "../StepGenerator/MicrostepScale.h"
+#include "../EncoderSampler/EncoderSampler.h"
+#include "../VelocityObserver/VelocityObserver.h"
+#include "../TMCShadow/TMCDriverTask.h"
+#include "../LimitSwitch/LimitRecovery.h"
+#include "../LimitSwitch/SoftLimits.h"
+#include "MotorCommand.h"
+#include "MotorState.h"
+#include "../../Seqlock.h"
+
+class FollowingErrorMonitor;
+class ServoCorrector;
+class StallDetector;
+class HomingSequence;
+class PositionSnapshotTask;
 
 class MotorController
 {
 private:
     // TMC2209 and stepper objects
     HardwareSerial *serialDriver;
-    TMC2209Stepper *driver;
+    TMC2209UartBus *driver; // Direct use only in begin(); then tmcTask owns the UART
+    TMCShadow *tmc;         // Register writes and status readbacks from the motor loop
+    TMCDriverTask *tmcTask;
     AccelStepper *stepper;
-    SPIClass *mt6816;
+    EncoderSampler *encoder; // MT6816 sampling task (owns the SPI bus)
+
+    // Hardware-timer step engine (RampGenerator/SCurveProfile plan, StepGenerator emits)
+    StepGenerator *stepGenerator;
+    RampGenerator *ramp;
+    SCurveProfile *scurve;
+    StepSource *activeSource;
+    bool useTimerEngine;
+    long maxJerk;
+
+    // Move targets; the front segment is the one executing. Same-direction
+    // segments blend through their junctions on the timer engine with
+    // trapezoidal ramps, every other mode runs them rest to rest.
+    MotionQueue *motionQueue;
+
+    // Adaptive microstepping: the engines count pulses at the driver's MRES,
+    // everything else canonical 1/8 steps (see MicrostepScale). A move started
+    // from rest picks its resolution and waits until the driver has the new
+    // MRES. Coarse moves stop on the last full step before the target and
+    // finish the remainder from there at a finer resolution.
+    MicrostepScale *microstepping;
+    mutable portMUX_TYPE scaleMux; // Scale and servoOffset, read from other tasks
+    volatile bool adaptiveMicrosteps;
+    bool microstepGridKnown;       // Driver's step table on a full step at boot
+    bool microstepChangePending;   // Front segment waits for the MRES write
+    bool snapshotClearPending;     // Front segment waits for the stored position to be erased
+    bool finishPending;
+    long finishTarget;
+    int finishSpeed;
+    long canonicalMaxSpeed;        // steps/sec
+    long canonicalAcceleration;    // steps/sec²
+    void selectMicrosteps(long distance, int speed); // Motor loop, before a move from rest
+    void changeMicrosteps(uint16_t microsteps);
+    void applyEngineRates();
+    long toEngineTarget(long position, int speed);
 
     // Position and speed tracking
-    static double lastLocation;
-    static double currentLocation;
-    static double monitorSpeed;
+    static float monitorSpeed; // Encoder speed from the observer (deg/s)
     static float motorSpeed;
     static int8_t direction;
 
+    // Encoder velocity observer, fed from the sampler ring (InputTask)
+    VelocityObserver *velocityObserver;
+    EncoderSampler::Ring::Cursor velocityCursor;
+    static constexpr float DIRECTION_DEADBAND = 1.0f; // deg/s reported as standing still
+
+    // Encoder vs commanded position (sampled from InputTask)
+    FollowingErrorMonitor *followingError;
+    volatile bool driverEnabled;
+    void setDriverEnabled(bool enabled);
+
+    // Servo mode: correction steps move the engine without moving the logical
+    // position, so engine position = logical position + servoOffset
+    ServoCorrector *servo;
+    volatile long servoOffset;
+    long getEnginePosition() const;
+
     // State management
     volatile long targetPosition;
     volatile bool emergencyStopActive;
-    bool useStealthChop;
 
-    // Limit switch recovery
+    // Set by stopFromISR(): the loop holds still and commands stay queued until
+    // InputTask calls emergencyStop() (a trip) or resumeAfterISRHalt() (a glitch)
+    volatile bool haltedByISR;
+    volatile bool haltedDriverEnabled; // Driver state the ISR found
+    volatile bool isrHaltResumeRequested;
+    bool holdForISRHalt();
+    bool useStealthChop;     // Mode the motor loop last asked for
+    bool stealthChopEnabled; // false: SpreadCycle at every speed
+
+    // Absolute position across power cycles (see Configuration::PositionSnapshot)
+    static constexpr int32_t RESTORE_TOLERANCE = 4096; // Encoder counts the shaft may move while off (1/4 turn)
+    volatile bool positionRestored;
+    int8_t snapshotPolarity; // Last known encoder polarity, kept until the monitor relearns it
+    PositionSnapshotTask *snapshotTask; // NVS writes happen there, never on the motor loop nor mid-move
+    void restorePositionSnapshot();
+    void savePositionSnapshot();
+
+    // Sensorless homing (motor loop): StallGuard stall detection from SG_RESULT
+    // polled over UART by tmcTask (DIAG isn't wired on the T-Motor) drives a
+    // fast-approach, back-off, slow-seek sequence against a hard stop
+    StallDetector *stallDetector;
+    HomingSequence *homing;
+    uint32_t lastStallReading; // Status read count of the last SG_RESULT used
+    static constexpr uint32_t STALLGUARD_TCOOLTHRS = 0xFFFFF; // StallGuard active at every speed
+    void updateHoming();
+    void startHomingMove(long target, long speed);
+    void finishHoming();
+
+    // Encoder calibration sweep (InputTask): steps one revolution forward and
+    // back, averaging the settled raw angle at every CALIBRATION_STRIDE microsteps
+    enum class CalibrationState : uint8_t
+    {
+        Idle,
+        Moving,
+        Settling,
+        Sampling
+    };
+    static constexpr uint16_t CALIBRATION_STRIDE = 4;         // Microsteps between points
+    static constexpr int CALIBRATION_SPEED = 400;             // steps/sec between points
+    static constexpr uint8_t CALIBRATION_SETTLE_TICKS = 3;    // InputTask ticks at rest before sampling
+    static constexpr uint8_t CALIBRATION_SAMPLES = 16;        // Samples averaged per point (8 ms)
+    volatile bool calibrationRequested;
+    CalibrationState calibrationState;
+    uint16_t *calibrationForward; // Forward-pass reading per point
+    uint16_t *calibrationPoints;  // Forward/backward midpoint per point
+    uint16_t calibrationIndex;
+    bool calibrationBackward;
+    int8_t calibrationDirection;
+    long calibrationStart;
+    uint8_t calibrationTicks;
+    EncoderSampler::Ring::Cursor calibrationCursor;
+    int32_t calibrationSum; // Sample offsets from the first sample of the point
+    uint16_t calibrationFirst;
+    uint8_t calibrationCount;
+    void startCalibration();
+    void finishCalibration();
+    void abortCalibration(const char *reason);
+    long getCalibrationTarget() const;
+    void moveToCalibrationPoint();
+
+    // Limit switch recovery (motor loop): the InputTask hands the trip over in
+    // these, the motor loop backs off the switch once the stop has run
     volatile bool needsLimitRecovery;
     volatile long limitRecoveryPosition;
+    volatile int8_t limitRecoverySide;
+    LimitRecovery *limitRecovery;
+    void updateLimitRecovery(bool requested);
+    void finishLimitRecovery();
 
-    // Speed threshold for TMC mode switching (percentage)
+    // Soft limits for commanded moves (motor loop): clip to the learned range
+    // and creep near its ends. Homing and limit recovery move past them.
+    SoftLimits *softLimits;
+    void executeLimitedMove(long position, int speed, bool queued);
+
+    // Speed threshold for TMC mode switching (percentage). With hardwareModeSwitch
+    // it becomes TPWMTHRS and the driver switches; otherwise updateTMCMode() does,
+    // returning to StealthChop modeHysteresis percent below the threshold.
     const float STEALTH_CHOP_THRESHOLD = 0.5;
+    bool hardwareModeSwitch;          // Fixed at boot
+    volatile long modeHysteresis;     // percent
+    volatile float stealthChopThresholdSpeed; // steps/sec, recomputed when max speed changes
+    volatile float stealthChopReturnSpeed;    // steps/sec, software switching only
+    void computeModeThresholds();
+    void applyChopperMode();
 
     // Safety limits for motor configuration (based on TMC2209 capabilities)
     static constexpr long MIN_SPEED = 100;           // steps/sec
     static constexpr long MAX_SPEED = 100000;        // steps/sec (TMC2209 practical limit)
     static constexpr long MIN_ACCELERATION = 100;    // steps/sec²
     static constexpr long MAX_ACCELERATION = 500000; // steps/sec² (TMC2209 practical limit)
+    static constexpr long MAX_JERK = 100000000;      // steps/sec³ (0 disables S-curve)
+    static constexpr uint16_t RUN_CURRENT_MA = 2000;         // TMC2209 RMS run current
+    static constexpr long SERVO_CORRECTION_SPEED = 2000;     // steps/sec for correction moves
+
+    // Step engine helpers
+    void feedStepGenerator();
+    void startTimerMove(long position, int speed);
+    void haltTimerEngine();
+    float getCommandedSpeed() const;
+    long getPlannedPosition() const;
+
+    // Motion queue helpers
+    void startSegment();
+    void advanceMotionQueue();
+    void replanMotionQueue();
+
+    // State for other tasks, published at the end of every update()
+    Seqlock<MotorStateSnapshot> state;
+    uint32_t stateVersion;
+    void publishState();
+
+    // Commands from other tasks, executed by update() on the motor loop
+    MotorCommandRouter commands;
+    void processCommands();
+    void executeCommand(const MotorCommand &command);
+
+    // Command implementations (motor loop only)
+    void haltMotion();
+    void executeMoveTo(long position, int speed);
+    bool executeQueueMove(long position, int speed);
+    void executeJogStop();
+    void executeEmergencyStop();
+    void executeClearEmergencyStop();
+    void executeResumeAfterISRHalt();
+    void executeSetAcceleration(long accel);
+    void executeSetMaxSpeed(long speed);
+    void executeSetMaxJerk(long jerk);
+    void executeSetCurrentPosition(long position);
+    void executeSetTMCMode(bool stealthChop);
+    bool executeSetTimerStepEngine(bool useTimer);
+    void executeServoCorrection(long steps);
+    void executeSetRunCurrent(long percent);
+    void executeHome(int8_t direction, long maxTravel);
+    void executeSetFollowingErrorWindow(long steps);
+    void executeSetServoMode(bool enabled);
+    void executeSetStallThreshold(uint8_t sgthrs);
+    void executeSetModeHysteresis(long percent);
+    void executeSetAdaptiveMicrosteps(bool enabled);
+    void executeSetLimitBackoff(long steps);
+    void executeSetSoftLimits(bool enabled);
+    void executeSetSoftLimitZone(long steps);
 
 public:
     // Constructor
@@ -45,45 +241,130 @@ public:
     // Initialize motor system
     bool begin();
 
-    // Initialize encoder (call from InputTask)
+    // Initialize encoder (call from InputTask). Restores the absolute position
+    // saved at the last standstill, so limits stay valid without homing.
     bool initEncoder();
+    bool isPositionRestored() const { return positionRestored; }
 
     // Motor control methods
-    void moveTo(long position, int speed);
+    // Commands are queued per calling task (source) and run at the top of update(),
+    // so other tasks never touch the steppers directly. They return false when the
+    // source's command ring is full.
+    bool moveTo(long position, int speed, CommandSource source);    // Replaces any queued moves
+    bool queueMove(long position, int speed, CommandSource source); // Appends to the motion queue, false when full
 
     // Stop methods: We have TWO distinct stop variants (no generic "stop" to avoid confusion)
-    void jogStop(); // Gentle stop without emergency flag (for ending jog operations)
-    void emergencyStop(); // Full emergency stop with flag (requires manual reset via clearEmergencyStop)
-    void emergencyStopWithRecovery(long limitPosition); // Emergency stop with return to limit position
-    void clearEmergencyStop();
+    bool jogStop(CommandSource source); // Gentle stop without emergency flag (for ending jog operations)
+    void emergencyStop(); // Full emergency stop with flag (requires manual reset via clearEmergencyStop). Any task or ISR; always wins
+    void emergencyStopWithRecovery(long limitPosition, int8_t side); // Emergency stop, then back off the switch at 'side' (-1 = min, +1 = max)
+    // From an IRAM ISR: driver off and steps parked now; follow with emergencyStop()
+    // or resumeAfterISRHalt() from a task. True with the engine position it stopped
+    // at (timer engine only: the polled engine stops at the motor loop's next pass,
+    // within a step).
+    bool IRAM_ATTR stopFromISR(long &engineSteps);
+    // The stop was for a glitch: end the segment it cut short, keep the motion
+    // queue and the commands posted meanwhile (no emergency epoch bump)
+    void resumeAfterISRHalt();
+    bool clearEmergencyStop(CommandSource source);
+
+    // Consistent copy of the motor state as of the motor loop's last pass, for
+    // other tasks (telemetry, API). False until the motor loop has run once.
+    bool getState(MotorStateSnapshot &snapshot) const { return state.read(snapshot); }
 
-    // Position and status
+    // Position and status (live; getState() for a consistent set from another task)
     long getCurrentPosition() const;
+    long toLogicalPosition(long engineSteps) const; // Engine steps (as from stopFromISR()) to position
     long getTargetPosition() const { return targetPosition; }
     double getMonitorSpeed() const { return monitorSpeed; }
     float getMotorSpeed() const { return motorSpeed; }
     int8_t getDirection() const { return direction; }
     bool isEmergencyStopped() const { return emergencyStopActive; }
-    bool isStealthChopActive() const { return useStealthChop; }
-    bool isMoving() const { return stepper->distanceToGo() != 0; }
+    bool isStealthChopActive() const; // As reported by the driver (DRV_STATUS, 100 ms)
+    uint16_t getMicrosteps() const { return microstepping->getMicrosteps(); }
+    bool isMoving() const;
     bool isEmergencyStopActive() const { return emergencyStopActive; }
+    uint8_t getQueueDepth() const { return motionQueue->size(); }
+    uint8_t getQueueFreeSlots() const { return motionQueue->freeSlots(); }
 
     // Encoder operations
-    int readEncoder();
-    double calculateSpeed(float ms);
+    int readEncoder(); // Latest sample from the encoder task
+    EncoderSampler *getEncoderSampler() const { return encoder; }
+    void updateVelocity(); // Feed new encoder samples to the observer (call from the encoder task)
+    void setVelocityBandwidth(float hz);
+    float getEncoderVelocity() const { return velocityObserver->getVelocity(); }         // counts/s
+    float getEncoderAcceleration() const { return velocityObserver->getAcceleration(); } // counts/s²
+
+    // Following error (call checkFollowingError() at a fixed rate from the encoder task).
+    // A fault triggers emergencyStop(); clearing the emergency stop resyncs the monitor.
+    void checkFollowingError();
+    bool setFollowingErrorWindow(long steps, CommandSource source); // 0 disables faults
+    long getFollowingError() const;
+    long getMeasuredPosition() const;
+    bool isFollowingErrorFault() const;
+
+    // Servo mode (closed loop inside the following-error window): corrects the
+    // position at rest and lowers run current while the error stays small
+    bool setServoMode(bool enabled, CommandSource source);
+    bool isServoModeEnabled() const;
+    uint8_t getRunCurrentPercent() const;
+    uint32_t getServoCorrectionCount() const;
+
+    // Encoder nonlinearity calibration: sweeps one revolution (within the limits)
+    // and stores the correction table. Requested from any task, runs in InputTask.
+    bool requestEncoderCalibration();
+    void updateCalibration(); // Call from InputTask every tick
+    bool isEncoderCalibrating() const { return calibrationState != CalibrationState::Idle; }
+    bool isEncoderCalibrated() const { return encoder->isCalibrated(); }
+
+    // Sensorless homing: drives into the hard stop in 'direction' (-1 = min end,
+    // +1 = max end), sets that limit just clear of it and, homing to the min
+    // end, makes the stop position 0. Any motion command or emergency stop aborts.
+    bool home(int8_t direction, long maxTravel, CommandSource source);
+    bool isHoming() const;
+    bool setStallThreshold(uint8_t sgthrs, CommandSource source);
+
+    // Limit recovery: after a limit switch stop, backs off setLimitBackoff() steps
+    // and re-arms the switch; motion commands are refused until it finishes.
+    // 0 leaves the emergency stop latched until a reset.
+    bool setLimitBackoff(long steps, CommandSource source);
+    LimitRecovery::Phase getLimitRecoveryPhase() const { return limitRecovery->getPhase(); }
+    const char *getLimitRecoveryState() const { return limitRecovery->getPhaseName(); }
+    const char *getLimitRecoveryFailure() const { return limitRecovery->getFailure(); }
+
+    // Soft limits: move and jog targets are clipped to the learned limits and
+    // slow to SoftLimits::CREEP_SPEED within 'zone' steps of either end
+    bool setSoftLimits(bool enabled, CommandSource source);
+    bool setSoftLimitZone(long steps, CommandSource source);
+    bool isSoftLimitsActive() const { return softLimits->isActive(); }
 
     // TMC2209 operations
     void updateTMCMode();
-    void setTMCMode(bool stealthChop);
-    uint32_t getTMCStatus();
+    bool setTMCMode(bool stealthChop, CommandSource source); // false: SpreadCycle at every speed
+    bool setModeHysteresis(long percent, CommandSource source);
+    bool isHardwareModeSwitch() const { return hardwareModeSwitch; }
+    uint32_t getTMCStatus(); // IOIN from the shadow (refreshed every 100 ms)
+    const TMCShadow *getTMCShadow() const { return tmc; }
 
     // Main update function (call from main loop)
     void update();
 
-    // Configuration
-    void setAcceleration(long accel);
-    void setMaxSpeed(long speed);
-    void setCurrentPosition(long position);
+    // Configuration (queued like the motion commands; so are the other setters
+    // taking a CommandSource)
+    bool setAcceleration(long accel, CommandSource source);
+    bool setMaxSpeed(long speed, CommandSource source);
+    bool setMaxJerk(long jerk, CommandSource source);
+    bool setCurrentPosition(long position, CommandSource source);
+
+    // Adaptive microstepping: MRES per move, from 1/32 for slow moves down to
+    // 1/2 at cruise (takes effect from the next move started at rest)
+    bool setAdaptiveMicrosteps(bool enabled, CommandSource source);
+
+    // Step engine selection (only switches while stopped)
+    bool setTimerStepEngine(bool useTimer, CommandSource source);
+    bool isTimerStepEngineActive() const { return useTimerEngine; }
+
+    // Commands rejected because a ring was full or discarded by an emergency stop
+    uint32_t getDroppedCommandCount() const { return commands.getDroppedCount(); }
 };
 
 extern MotorController motorController;
\ No newline at end of file
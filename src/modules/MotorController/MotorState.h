@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+// Motor state published by the motor loop once per pass (see MotorController::getState)
+// Other tasks copy it whole from a Seqlock instead of reading the engines field
+// by field while they change. Positions are canonical 1/8 steps.
+struct MotorStateSnapshot
+{
+    enum Flag : uint16_t
+    {
+        MOVING = 1 << 0,
+        EMERGENCY_STOP = 1 << 1,
+        LIMIT_MIN = 1 << 2, // Limit switch latched (LimitSwitch::isTriggered)
+        LIMIT_MAX = 1 << 3,
+        HOMING = 1 << 4,
+        CALIBRATING = 1 << 5,
+        STEALTH_CHOP = 1 << 6, // Driver's actual chopper mode
+        POSITION_RESTORED = 1 << 7,
+        ENCODER_CALIBRATED = 1 << 8,
+        DRIVER_ENABLED = 1 << 9
+    };
+
+    uint32_t version; // Publish count; unchanged means the motor loop hasn't run since
+    uint32_t timeUs;  // micros() at publish
+    int32_t position;
+    int32_t target;
+    float speed;           // Commanded, canonical steps/sec (signed)
+    uint16_t encoderAngle; // Latest MT6816 sample (0-16383)
+    uint16_t microsteps;
+    uint16_t flags;
+    uint8_t queueDepth;
+    uint8_t queueFree;
+
+    bool has(Flag flag) const { return (flags & flag) != 0; }
+};
@@ -0,0 +1,45 @@
+#include "MultiTurnCounter.h"
+
+MultiTurnCounter::MultiTurnCounter() : count(0), lastAngle(0), initialized(false)
+{
+}
+
+int32_t MultiTurnCounter::wrappedDelta(uint16_t from, uint16_t to)
+{
+    int32_t delta = ((int32_t)to - (int32_t)from) & (COUNTS_PER_REV - 1);
+    return delta >= COUNTS_PER_REV / 2 ? delta - COUNTS_PER_REV : delta;
+}
+
+int64_t MultiTurnCounter::update(uint16_t angle)
+{
+    angle &= COUNTS_PER_REV - 1;
+    if (!initialized)
+    {
+        count = angle;
+        initialized = true;
+    }
+    else
+    {
+        count += wrappedDelta(lastAngle, angle);
+    }
+    lastAngle = angle;
+    return count;
+}
+
+int32_t MultiTurnCounter::restore(int64_t savedCount, uint16_t angle)
+{
+    angle &= COUNTS_PER_REV - 1;
+    int32_t moved = wrappedDelta((uint16_t)(savedCount & (COUNTS_PER_REV - 1)), angle);
+    count = savedCount + moved;
+    lastAngle = angle;
+    initialized = true;
+    return moved;
+}
+
+int32_t MultiTurnCounter::getTurns() const
+{
+    int64_t turns = count / COUNTS_PER_REV;
+    if (count % COUNTS_PER_REV < 0)
+        turns--;
+    return (int32_t)turns;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+
+// Unwraps single-turn encoder angles into a 64-bit multi-turn count
+// Fed with every sample; consecutive samples must be less than half a turn
+// apart (the 2 kHz sampler allows over 16000 rpm). restore() continues from
+// a count saved before power-off, assuming the shaft moved less than half a
+// turn while unpowered.
+class MultiTurnCounter
+{
+public:
+    static constexpr int32_t COUNTS_PER_REV = 16384;
+
+private:
+    int64_t count;
+    uint16_t lastAngle;
+    bool initialized;
+
+    // Shortest signed distance from one angle to another, in [-COUNTS_PER_REV/2, COUNTS_PER_REV/2)
+    static int32_t wrappedDelta(uint16_t from, uint16_t to);
+
+public:
+    MultiTurnCounter();
+
+    // First call starts at the angle itself (turn 0)
+    int64_t update(uint16_t angle);
+
+    // Start from a saved count; returns how far the shaft moved since it was saved
+    int32_t restore(int64_t savedCount, uint16_t angle);
+
+    bool isInitialized() const { return initialized; }
+    int64_t getCount() const { return count; }
+    int32_t getTurns() const;                 // Floor: negative counts are in negative turns
+    uint16_t getAngle() const { return lastAngle; }
+};
@@ -0,0 +1,90 @@
+#include "ServoCorrector.h"
+
+ServoCorrector::ServoCorrector()
+    : enabled(false), currentPercent(100), outsideSamples(0), lastError(0),
+      lowErrorSamples(0), corrections(0), totalCorrection(0)
+{
+}
+
+void ServoCorrector::reset()
+{
+    outsideSamples = 0;
+    lastError = 0;
+    lowErrorSamples = 0;
+}
+
+ServoCorrector::Output ServoCorrector::update(long error, bool moving)
+{
+    Output output = {0, currentPercent, false};
+    long errorAbs = error < 0 ? -error : error;
+
+    if (!enabled)
+    {
+        // Hand back full current once when servo mode is switched off
+        reset();
+        if (currentPercent != 100)
+        {
+            currentPercent = 100;
+            output.currentPercent = 100;
+            output.currentChanged = true;
+        }
+        return output;
+    }
+
+    // Run current: restore at once, lower slowly
+    if (errorAbs >= HIGH_ERROR && currentPercent != 100)
+    {
+        currentPercent = 100;
+        lowErrorSamples = 0;
+        output.currentChanged = true;
+    }
+    else if (errorAbs <= LOW_ERROR)
+    {
+        if (++lowErrorSamples >= LOW_ERROR_SAMPLES)
+        {
+            lowErrorSamples = 0;
+            if (currentPercent > MIN_CURRENT_PERCENT)
+            {
+                currentPercent = currentPercent - CURRENT_STEP_PERCENT < MIN_CURRENT_PERCENT
+                                     ? MIN_CURRENT_PERCENT
+                                     : currentPercent - CURRENT_STEP_PERCENT;
+                output.currentChanged = true;
+            }
+        }
+    }
+    else
+    {
+        lowErrorSamples = 0;
+    }
+    output.currentPercent = currentPercent;
+
+    // Position correction only at rest; during moves the ramp owns the steps
+    if (moving || errorAbs <= DEADBAND)
+    {
+        outsideSamples = 0;
+        lastError = error;
+        return output;
+    }
+
+    // Wait for the error to stop changing (rotor settled after the last move or correction)
+    long change = error - lastError;
+    lastError = error;
+    if (change > DEADBAND || change < -DEADBAND)
+    {
+        outsideSamples = 0;
+        return output;
+    }
+    if (++outsideSamples < SETTLE_SAMPLES)
+        return output;
+
+    outsideSamples = 0;
+    long steps = error;
+    if (steps > MAX_CORRECTION)
+        steps = MAX_CORRECTION;
+    else if (steps < -MAX_CORRECTION)
+        steps = -MAX_CORRECTION;
+    output.correctionSteps = steps;
+    corrections++;
+    totalCorrection += steps;
+    return output;
+}
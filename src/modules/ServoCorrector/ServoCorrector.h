@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+
+// Closed-loop position correction ("servo mode") on top of the following-error monitor
+// Sampled at a fixed rate with the encoder error (commanded - measured, in
+// microsteps). While the motor is at rest (end of move, holding) an error that
+// stays outside the deadband for SETTLE_SAMPLES is corrected by injecting that
+// many steps. While the error stays small the run current is stepped down,
+// and restored at once when the error grows. Errors beyond the following-error
+// window still fault: corrections only cover what the monitor tolerates.
+class ServoCorrector
+{
+public:
+    static constexpr long DEADBAND = 2;                 // Microsteps left uncorrected
+    static constexpr uint8_t SETTLE_SAMPLES = 5;        // Stable samples before correcting
+    static constexpr long MAX_CORRECTION = 64;          // Steps per correction (2 electrical cycles)
+    static constexpr long LOW_ERROR = 4;                // Error small enough to lower current
+    static constexpr long HIGH_ERROR = 8;               // Error that restores full current
+    static constexpr uint16_t LOW_ERROR_SAMPLES = 100;  // Samples of low error per current step
+    static constexpr uint8_t MIN_CURRENT_PERCENT = 50;
+    static constexpr uint8_t CURRENT_STEP_PERCENT = 10;
+
+    struct Output
+    {
+        long correctionSteps;   // Steps to inject now (0 = none)
+        uint8_t currentPercent; // Run current as a percentage of the configured current
+        bool currentChanged;
+    };
+
+private:
+    volatile bool enabled;
+    uint8_t currentPercent;
+    uint8_t outsideSamples;   // Consecutive at-rest samples outside the deadband
+    long lastError;
+    uint16_t lowErrorSamples; // Consecutive samples below LOW_ERROR
+    uint32_t corrections;
+    long totalCorrection;
+
+public:
+    ServoCorrector();
+
+    void setEnabled(bool value) { enabled = value; }
+    bool isEnabled() const { return enabled; }
+
+    // Sampling task: error from FollowingErrorMonitor, moving = any motion planned or running
+    Output update(long error, bool moving);
+    void reset(); // Forget settle history (after a resync or fault)
+
+    uint8_t getCurrentPercent() const { return currentPercent; }
+    uint32_t getCorrectionCount() const { return corrections; }
+    long getTotalCorrection() const { return totalCorrection; }
+};
@@ -0,0 +1,96 @@
+#include "MicrostepScale.h"
+
+MicrostepScale::MicrostepScale()
+    : canonicalBase(0), engineBase(0), microsteps(CANONICAL), gridPhase(0)
+{
+}
+
+long MicrostepScale::floorDiv(long a, long b)
+{
+    long q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+long MicrostepScale::floorMod(long a, long b)
+{
+    return a - floorDiv(a, b) * b;
+}
+
+long MicrostepScale::toCanonical(long engine) const
+{
+    if (microsteps >= CANONICAL)
+        return canonicalBase + floorDiv(engine - engineBase, microsteps / CANONICAL);
+    return canonicalBase + (engine - engineBase) * (CANONICAL / microsteps);
+}
+
+long MicrostepScale::toEngine(long canonical) const
+{
+    if (microsteps >= CANONICAL)
+        return engineBase + (canonical - canonicalBase) * (microsteps / CANONICAL);
+    return engineBase + floorDiv(canonical - canonicalBase, CANONICAL / microsteps);
+}
+
+uint16_t MicrostepScale::select(long distance, uint32_t speed)
+{
+    uint16_t result = FINEST;
+    while (result > COARSEST && (uint64_t)speed * result > (uint64_t)MAX_PULSE_RATE * CANONICAL)
+        result /= 2;
+
+    // A coarse move would end where it started, leaving it all to the finishing move
+    if (result < CANONICAL && distance < FULL_STEP && distance > -FULL_STEP)
+        result = CANONICAL;
+    return result;
+}
+
+long MicrostepScale::reachable(long from, long target) const
+{
+    if (microsteps >= CANONICAL)
+        return target;
+
+    // Full steps are on every coarse grid; stop on the last one short of the target
+    long offset = target - gridPhase;
+    long steps = target >= from ? floorDiv(offset, FULL_STEP) : -floorDiv(-offset, FULL_STEP);
+    return gridPhase + steps * FULL_STEP;
+}
+
+bool MicrostepScale::isFullStepAligned(long engine) const
+{
+    if (microsteps > CANONICAL && floorMod(engine - engineBase, microsteps / CANONICAL) != 0)
+        return false; // Between canonical positions
+    return floorMod(toCanonical(engine) - gridPhase, FULL_STEP) == 0;
+}
+
+bool MicrostepScale::switchTo(uint16_t newMicrosteps, long engine)
+{
+    if (newMicrosteps == microsteps)
+        return true;
+    if (!isFullStepAligned(engine))
+        return false;
+
+    canonicalBase = toCanonical(engine);
+    engineBase = engine;
+    microsteps = newMicrosteps;
+    return true;
+}
+
+long MicrostepScale::setCurrentPosition(long engine, long canonical)
+{
+    gridPhase = floorMod(gridPhase + canonical - toCanonical(engine), FULL_STEP);
+
+    // Keep any fraction of a canonical unit, so the grid stays exact at fine resolutions
+    long fraction = microsteps > CANONICAL ? floorMod(engine - engineBase, microsteps / CANONICAL) : 0;
+    canonicalBase = canonical;
+    engineBase = canonical - fraction;
+    return canonical;
+}
+
+uint8_t MicrostepScale::mres(uint16_t microsteps)
+{
+    uint8_t value = 8;
+    while (microsteps > 1 && value > 0)
+    {
+        microsteps >>= 1;
+        value--;
+    }
+    return value;
+}
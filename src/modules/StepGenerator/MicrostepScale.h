@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+
+// Canonical positions against step-engine positions at an adaptive MRES
+// Everything outside the step engine (the API, Configuration limits, the
+// encoder checks) counts in canonical 1/8 microsteps. The engine counts
+// pulses at whatever resolution the driver runs: finer for slow moves,
+// coarser at cruise so the STEP rate stays low. Resolution only changes at
+// rest on the driver's full-step grid, where both counts are exact, and the
+// mapping is re-based there, so conversions never accumulate rounding.
+class MicrostepScale
+{
+public:
+    static constexpr uint16_t CANONICAL = 8;          // Microsteps per full step of a canonical position
+    static constexpr long FULL_STEP = CANONICAL;      // Canonical units per full step
+    static constexpr uint16_t FINEST = 32;
+    static constexpr uint16_t COARSEST = 2;
+    static constexpr uint32_t MAX_PULSE_RATE = 20000; // STEP pulses/s the selection aims to stay under
+
+private:
+    long canonicalBase; // Canonical position at the last re-base
+    long engineBase;    // Engine position at the same point
+    uint16_t microsteps;
+    long gridPhase;     // Canonical positions on the full-step grid, modulo FULL_STEP
+
+    static long floorDiv(long a, long b);
+    static long floorMod(long a, long b);
+
+public:
+    MicrostepScale();
+
+    uint16_t getMicrosteps() const { return microsteps; }
+
+    // Engine position <-> canonical. Fine resolutions round down to the canonical unit;
+    // coarse resolutions take canonical positions on their grid (see reachable()).
+    long toCanonical(long engine) const;
+    long toEngine(long canonical) const;
+    float toCanonicalSpeed(float engineSpeed) const { return engineSpeed * CANONICAL / microsteps; }
+    uint32_t toEngineRate(uint32_t canonicalRate) const
+    {
+        return (uint32_t)((uint64_t)canonicalRate * microsteps / CANONICAL);
+    }
+
+    // Resolution for a move: the finest one that keeps 'speed' (canonical steps/s)
+    // under MAX_PULSE_RATE. Nothing coarser than canonical for less than a full step.
+    static uint16_t select(long distance, uint32_t speed);
+
+    // Where a move towards 'target' can end at the current resolution: the target
+    // itself, or for coarse resolutions the last full step before it
+    long reachable(long from, long target) const;
+
+    bool isFullStepAligned(long engine) const;
+
+    // Re-base at the current engine position; false (nothing changes) off the full-step grid
+    bool switchTo(uint16_t newMicrosteps, long engine);
+
+    // Redefine the position without moving: returns the engine position to load
+    // into the step engines. The full-step grid moves with it.
+    long setCurrentPosition(long engine, long canonical);
+
+    // Boot: canonical 'position' sits on the full-step grid
+    void setGridOrigin(long position) { gridPhase = floorMod(position, FULL_STEP); }
+
+    // CHOPCONF MRES field for a resolution (256 -> 0 ... 1 -> 8)
+    static uint8_t mres(uint16_t microsteps);
+};
@@ -0,0 +1,97 @@
+#include "MotionQueue.h"
+#include "RampGenerator.h"
+
+MotionQueue::MotionQueue() : head(0), count(0)
+{
+}
+
+bool MotionQueue::push(long from, long target, uint32_t maxSpeed)
+{
+    if (isFull())
+        return false;
+
+    MotionSegment &segment = at(count);
+    segment.start = count ? at(count - 1).target : from;
+    segment.target = target;
+    segment.maxSpeed = maxSpeed;
+    segment.exitSpeed = 0;
+    count++;
+    return true;
+}
+
+bool MotionQueue::pop()
+{
+    if (isEmpty())
+        return false;
+
+    head = (head + 1) % CAPACITY;
+    count--;
+    return true;
+}
+
+void MotionQueue::clear()
+{
+    head = 0;
+    count = 0;
+}
+
+void MotionQueue::clearPending()
+{
+    if (count > 1)
+        count = 1;
+}
+
+uint32_t MotionQueue::reachableSpeed(uint32_t v, long distance, uint32_t acceleration)
+{
+    // v² + 2 a d (Austin/AccelStepper Equation 16 rearranged)
+    uint64_t squared = (uint64_t)v * v + 2ULL * acceleration * (uint64_t)distance;
+    return RampGenerator::isqrt64(squared);
+}
+
+void MotionQueue::plan(long position, uint32_t speed, uint32_t acceleration)
+{
+    if (isEmpty())
+        return;
+
+    // Junction limits from cruise speeds and direction changes
+    for (uint8_t i = 0; i < count; i++)
+    {
+        MotionSegment &segment = at(i);
+        segment.exitSpeed = 0;
+        if (i + 1 < count)
+        {
+            const MotionSegment &next = at(i + 1);
+            long length = segment.target - segment.start;
+            long nextLength = next.target - next.start;
+            bool sameDirection = (length > 0 && nextLength > 0) || (length < 0 && nextLength < 0);
+            if (sameDirection)
+                segment.exitSpeed = segment.maxSpeed < next.maxSpeed ? segment.maxSpeed : next.maxSpeed;
+        }
+    }
+
+    // Backward pass: every segment must be able to slow down to the next junction
+    uint32_t nextEntry = 0;
+    for (int i = count - 1; i >= 0; i--)
+    {
+        MotionSegment &segment = at(i);
+        if (segment.exitSpeed > nextEntry)
+            segment.exitSpeed = nextEntry;
+
+        long from = i == 0 ? position : segment.start;
+        long length = segment.target - from;
+        nextEntry = reachableSpeed(segment.exitSpeed, length < 0 ? -length : length, acceleration);
+    }
+
+    // Forward pass: and be able to speed up to it from the previous junction
+    uint32_t entry = speed;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        MotionSegment &segment = at(i);
+        long from = i == 0 ? position : segment.start;
+        long length = segment.target - from;
+        uint32_t reachable = reachableSpeed(entry, length < 0 ? -length : length, acceleration);
+        if (segment.exitSpeed > reachable)
+            segment.exitSpeed = reachable;
+        entry = segment.exitSpeed;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+
+struct MotionSegment
+{
+    long start;          // Position the segment starts from (steps)
+    long target;         // Position the segment ends at (steps)
+    uint32_t maxSpeed;   // Cruise limit for this segment (steps/sec)
+    uint32_t exitSpeed;  // Planned speed at the end of the segment (steps/sec)
+};
+
+// Fixed-capacity queue of move targets with lookahead junction planning
+// The front segment is the one executing. Every push replans the whole queue:
+// junctions between same-direction segments get the lower of the two cruise
+// speeds, reversals and the last segment get zero, then a backward and a
+// forward pass cap each junction at what the acceleration can reach over the
+// segment lengths. No heap use; all math is integer.
+class MotionQueue
+{
+public:
+    static constexpr uint8_t CAPACITY = 16;
+
+private:
+    MotionSegment segments[CAPACITY];
+    uint8_t head;
+    uint8_t count;
+
+    MotionSegment &at(uint8_t index) { return segments[(head + index) % CAPACITY]; }
+
+    // Highest speed reachable from v over distance at the given acceleration
+    static uint32_t reachableSpeed(uint32_t v, long distance, uint32_t acceleration);
+
+public:
+    MotionQueue();
+
+    // Appends a segment starting where the previous one ends (or at 'from' when empty)
+    bool push(long from, long target, uint32_t maxSpeed);
+    bool pop();
+    void clear();
+    void clearPending(); // Drops everything behind the executing front segment
+
+    // Recomputes junction speeds; the front segment starts at 'position' moving at 'speed'
+    void plan(long position, uint32_t speed, uint32_t acceleration);
+
+    const MotionSegment *front() const { return count ? &segments[head] : nullptr; }
+    const MotionSegment *get(uint8_t index) const
+    {
+        return index < count ? &segments[(head + index) % CAPACITY] : nullptr;
+    }
+    uint8_t size() const { return count; }
+    uint8_t freeSlots() const { return CAPACITY - count; }
+    bool isEmpty() const { return count == 0; }
+    bool isFull() const { return count == CAPACITY; }
+};
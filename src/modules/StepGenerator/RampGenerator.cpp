@@ -0,0 +1,229 @@
+#include "RampGenerator.h"
+
+// 1 second in Q24.8 microseconds
+#define ONE_SECOND_Q (1000000LL << RampGenerator::FRACTION_BITS)
+
+// c0 = 0.676 * sqrt(2 / a) seconds (AccelStepper Equation 15) => c0² * a = C0_SQUARED_TIMES_A
+// with c0 in Q24.8 µs: (0.676e6 * 256)² * 2
+#define C0_SQUARED_TIMES_A 59896758272000000ULL
+
+RampGenerator::RampGenerator()
+    : currentPos(0), targetPos(0), maxSpeed(1), acceleration(0), c0(0), cn(0),
+      cmin((int32_t)ONE_SECOND_Q), rest(0), n(0), phase(0), exitSpeed(0), exitSteps(0), direction(1), running(false)
+{
+}
+
+uint32_t RampGenerator::isqrt64(uint64_t value)
+{
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value)
+        bit >>= 2;
+    while (bit != 0)
+    {
+        if (value >= result + bit)
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+void RampGenerator::setMaxSpeed(uint32_t newSpeed)
+{
+    if (newSpeed == 0 || newSpeed == maxSpeed)
+        return;
+
+    maxSpeed = newSpeed;
+    cmin = (int32_t)(ONE_SECOND_Q / newSpeed);
+    if (cmin < 1)
+        cmin = 1;
+    // A lower limit while moving is handled in computeNewSpeed() by decelerating to it
+}
+
+void RampGenerator::setAcceleration(uint32_t newAcceleration)
+{
+    if (newAcceleration == 0 || newAcceleration == acceleration)
+        return;
+
+    // Keep the current speed: steps to stop scale with 1/a (Equation 17)
+    if (acceleration != 0 && n != 0)
+        n = (int32_t)((int64_t)n * acceleration / newAcceleration);
+
+    acceleration = newAcceleration;
+    exitSteps = (int32_t)((uint64_t)exitSpeed * exitSpeed / (2ULL * newAcceleration));
+    uint32_t first = isqrt64(C0_SQUARED_TIMES_A / newAcceleration);
+    c0 = first > INT32_MAX ? INT32_MAX : (int32_t)first;
+}
+
+void RampGenerator::setExitSpeed(uint32_t speed)
+{
+    exitSpeed = speed;
+    exitSteps = acceleration ? (int32_t)((uint64_t)speed * speed / (2ULL * acceleration)) : 0;
+}
+
+void RampGenerator::moveTo(long absolute)
+{
+    if (targetPos != absolute)
+    {
+        targetPos = absolute;
+        if (!running)
+            computeNewSpeed();
+    }
+}
+
+void RampGenerator::setCurrentPosition(long position)
+{
+    targetPos = currentPos = position;
+    exitSpeed = 0;
+    exitSteps = 0;
+    n = 0;
+    cn = 0;
+    rest = 0;
+    phase = 0;
+    running = false;
+}
+
+void RampGenerator::stop()
+{
+    setExitSpeed(0);
+    if (running)
+    {
+        long stepsToStop = (long)getStepsToStop() + 1;
+        moveTo(currentPos + (direction > 0 ? stepsToStop : -stepsToStop));
+    }
+}
+
+int32_t RampGenerator::getSpeedStepsPerSec() const
+{
+    if (!running || cn <= 0)
+        return 0;
+    int32_t speed = (int32_t)(ONE_SECOND_Q / cn);
+    return direction > 0 ? speed : -speed;
+}
+
+uint32_t RampGenerator::nextStep(int8_t &stepDirection)
+{
+    if (!running)
+        return 0;
+
+    // Emit whole µs and keep the fraction so the schedule never drifts
+    phase += (uint32_t)cn;
+    uint32_t interval = phase >> FRACTION_BITS;
+    phase &= (1UL << FRACTION_BITS) - 1;
+    if (interval == 0)
+        interval = 1;
+
+    stepDirection = direction;
+    currentPos += direction;
+    computeNewSpeed();
+    return interval;
+}
+
+void RampGenerator::applyRecurrence(int32_t index)
+{
+    // c -= (2c + rest) / (4 index + 1); negative index lengthens the interval (deceleration)
+    int32_t denominator = 4 * index + 1;
+    int32_t numerator = 2 * cn + rest;
+    cn -= numerator / denominator;
+    rest = numerator % denominator;
+}
+
+void RampGenerator::computeNewSpeed()
+{
+    if (acceleration == 0)
+        return;
+
+    long distanceTo = distanceToGo();
+    long distanceAbs = distanceTo < 0 ? -distanceTo : distanceTo;
+    int8_t wanted = distanceTo > 0 ? 1 : -1;
+    long stepsToStop = getStepsToStop();
+    long brakingSteps = stepsToStop - exitSteps; // Steps needed to slow to the exit speed
+
+    if (distanceTo == 0 && exitSteps > 0 && running)
+    {
+        // Passing through a junction: hold speed until the next target arrives
+        return;
+    }
+
+    if (distanceTo == 0 && stepsToStop <= 1)
+    {
+        // At the target and slow enough to stop
+        running = false;
+        n = 0;
+        cn = 0;
+        rest = 0;
+        phase = 0;
+        return;
+    }
+
+    if (n > 0)
+    {
+        // Accelerating or cruising: decelerate now, or heading the wrong way?
+        if (brakingSteps >= distanceAbs || direction != wanted)
+            n = -n;
+    }
+    else if (n < 0)
+    {
+        // Decelerating: accelerate again?
+        if (brakingSteps < distanceAbs && direction == wanted)
+            n = -n;
+    }
+
+    if (n == 0)
+    {
+        // First step from standstill
+        cn = c0 > cmin ? c0 : cmin;
+        rest = 0;
+        direction = wanted;
+        n = 1;
+    }
+    else if (n > 0)
+    {
+        if (cn > cmin)
+        {
+            // Accelerating
+            applyRecurrence(n);
+            n++;
+            if (cn <= cmin)
+            {
+                cn = cmin;
+                rest = 0;
+            }
+        }
+        else if (cn < cmin)
+        {
+            // Max speed was lowered: decelerate to it along the ramp
+            applyRecurrence(-n);
+            n--;
+            if (cn >= cmin || n <= 1)
+            {
+                cn = cmin;
+                rest = 0;
+            }
+        }
+        // else cruising: interval and steps to stop stay put
+    }
+    else
+    {
+        // Decelerating towards n == 0
+        applyRecurrence(n);
+        n++;
+        if (n == 0)
+        {
+            // Ramp exhausted but target not reached: restart from standstill next step
+            cn = c0 > cmin ? c0 : cmin;
+            rest = 0;
+            n = 1;
+            direction = wanted;
+        }
+    }
+
+    running = true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "StepSource.h"
+
+// Trapezoidal ramp planner producing a per-step interval stream
+// Integer-only kernel: step intervals follow David Austin's recurrence
+//   c(n) = c(n-1) - 2 c(n-1) / (4n + 1)
+// in Q24.8 microseconds with the division remainder carried to the next step
+// (Atmel AVR446 style), so nothing on the per-step path uses float or sqrt and
+// nextStep() is safe to call from an ISR. Ramps match AccelStepper's (same c0
+// correction), so both step engines produce the same motion.
+// Positions are planned positions: when the timer engine is active they run
+// ahead of the motor by whatever is still queued.
+class RampGenerator : public StepSource
+{
+public:
+    static constexpr uint8_t FRACTION_BITS = 8; // Q24.8: up to ~8 s per step
+
+private:
+    long currentPos;
+    long targetPos;
+    uint32_t maxSpeed;     // steps/sec
+    uint32_t acceleration; // steps/sec²
+    int32_t c0;            // First step interval (Q24.8 µs)
+    int32_t cn;            // Current step interval (Q24.8 µs)
+    int32_t cmin;          // Interval at max speed (Q24.8 µs)
+    int32_t rest;          // Division remainder carried between steps
+    int32_t n;             // >0: steps to stop while accelerating/cruising, <0: decelerating, 0: stopped
+    uint32_t phase;        // Sub-µs part of the schedule not yet emitted
+    uint32_t exitSpeed;    // Speed to pass the target at (steps/sec), 0 = stop there
+    int32_t exitSteps;     // Steps to stop from exitSpeed
+    int8_t direction;
+    bool running;
+
+    void computeNewSpeed();
+    void applyRecurrence(int32_t index);
+
+public:
+    RampGenerator();
+
+    void setMaxSpeed(uint32_t speed);
+    void setAcceleration(uint32_t acceleration);
+    void moveTo(long absolute);
+    void setCurrentPosition(long position); // Also resets speed to zero
+    void stop();                            // Decelerate to a stop as quickly as possible
+
+    // Blend into a following move: arrive at the target no faster than this
+    // speed and hold it there until the next moveTo(). Call moveTo() with the
+    // next target before the next nextStep(), otherwise the ramp overshoots
+    // and comes back like a stop would.
+    void setExitSpeed(uint32_t speed);
+    uint32_t getExitSpeed() const { return exitSpeed; }
+    bool isAtTarget() const { return currentPos == targetPos; }
+
+    long currentPosition() const override { return currentPos; }
+    long targetPosition() const { return targetPos; }
+    long distanceToGo() const { return targetPos - currentPos; }
+    uint32_t getMaxSpeed() const { return maxSpeed; }
+    uint32_t getAcceleration() const { return acceleration; }
+    uint32_t getStepsToStop() const { return n < 0 ? -n : n; }
+    bool isRunning() const override { return running; }
+
+    // Signed steps/sec derived from the current interval (one integer divide)
+    int32_t getSpeedStepsPerSec() const;
+    float getSpeed() const override { return (float)getSpeedStepsPerSec(); }
+
+    uint32_t nextStep(int8_t &direction) override;
+
+    // Integer square root, used once per acceleration change for c0
+    static uint32_t isqrt64(uint64_t value);
+};
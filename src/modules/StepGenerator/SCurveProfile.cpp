@@ -0,0 +1,222 @@
+#include "SCurveProfile.h"
+#include <math.h>
+
+// Newton iterations per step; converges in 1-2 away from standstill
+#define SCURVE_NEWTON_ITERATIONS 4
+
+SCurveProfile::SCurveProfile()
+    : origin(0), distance(0), direction(1), stepCount(0), segmentIndex(0), tau(0),
+      lastStepTime(0), speed(0), running(false), peakSpeed(0), peakAcceleration(0), maxJerk(0)
+{
+    for (uint8_t i = 0; i < SEGMENT_COUNT; i++)
+    {
+        segments[i] = {0, 0, 0, 0, 0, 0};
+    }
+}
+
+// Time spent accelerating from rest to velocity, returns the distance covered
+float SCurveProfile::accelerationPhase(float velocity, float maxAcceleration, float jerk, float &jerkTime)
+{
+    float accelTime;
+    if (velocity * jerk < maxAcceleration * maxAcceleration)
+    {
+        // Acceleration limit never reached: triangular acceleration profile
+        jerkTime = sqrtf(velocity / jerk);
+        accelTime = 2 * jerkTime;
+    }
+    else
+    {
+        jerkTime = maxAcceleration / jerk;
+        accelTime = jerkTime + velocity / maxAcceleration;
+    }
+    return velocity * accelTime / 2; // Symmetric ramp: average speed is v/2
+}
+
+bool SCurveProfile::plan(long from, long to, float maxSpeed, float maxAcceleration, float jerk)
+{
+    if (maxSpeed <= 0 || maxAcceleration <= 0 || jerk <= 0)
+    {
+        return false;
+    }
+
+    origin = from;
+    distance = to >= from ? to - from : from - to;
+    direction = to >= from ? 1 : -1;
+    stepCount = 0;
+    segmentIndex = 0;
+    tau = 0;
+    lastStepTime = 0;
+    speed = 0;
+    maxJerk = jerk;
+    running = distance > 0;
+    if (!running)
+    {
+        peakSpeed = peakAcceleration = 0;
+        return true;
+    }
+
+    // Highest cruise speed whose accel + decel phases fit in the distance
+    float velocity = maxSpeed;
+    float jerkTime;
+    if (2 * accelerationPhase(velocity, maxAcceleration, jerk, jerkTime) > distance)
+    {
+        float lo = 0, hi = maxSpeed;
+        for (uint8_t i = 0; i < 40; i++)
+        {
+            float mid = (lo + hi) / 2;
+            if (2 * accelerationPhase(mid, maxAcceleration, jerk, jerkTime) > distance)
+                hi = mid;
+            else
+                lo = mid;
+        }
+        velocity = lo;
+    }
+    float accelDistance = accelerationPhase(velocity, maxAcceleration, jerk, jerkTime);
+    float accelTime = 2 * accelDistance / velocity;
+    float constAccelTime = accelTime - 2 * jerkTime;
+    if (constAccelTime < 0)
+        constAccelTime = 0;
+    float cruiseTime = (distance - 2 * accelDistance) / velocity;
+    if (cruiseTime < 0)
+        cruiseTime = 0;
+
+    const float durations[SEGMENT_COUNT] = {jerkTime, constAccelTime, jerkTime, cruiseTime, jerkTime, constAccelTime, jerkTime};
+    const float jerks[SEGMENT_COUNT] = {jerk, 0, -jerk, 0, -jerk, 0, jerk};
+
+    // Integrate segment start states
+    float p = 0, v = 0, a = 0;
+    double t = 0;
+    for (uint8_t i = 0; i < SEGMENT_COUNT; i++)
+    {
+        segments[i] = {durations[i], jerks[i], p, v, a, t};
+        float d = durations[i];
+        p = positionAt(segments[i], d);
+        v = velocityAt(segments[i], d);
+        a = a + jerks[i] * d;
+        t += d;
+    }
+
+    peakSpeed = velocity;
+    peakAcceleration = jerk * jerkTime;
+    return true;
+}
+
+void SCurveProfile::setCurrentPosition(long position)
+{
+    origin = position;
+    distance = 0;
+    stepCount = 0;
+    running = false;
+    speed = 0;
+}
+
+float SCurveProfile::positionAt(const Segment &segment, float t) const
+{
+    return segment.p0 + segment.v0 * t + segment.a0 * t * t / 2 + segment.jerk * t * t * t / 6;
+}
+
+float SCurveProfile::velocityAt(const Segment &segment, float t) const
+{
+    return segment.v0 + segment.a0 * t + segment.jerk * t * t / 2;
+}
+
+float SCurveProfile::segmentEnd(uint8_t index) const
+{
+    return index + 1 < SEGMENT_COUNT ? segments[index + 1].p0 : (float)distance;
+}
+
+float SCurveProfile::solveTime(uint8_t index, float target, float guess) const
+{
+    const Segment &segment = segments[index];
+
+    // The profile starts and ends at rest, so Newton would divide by ~0 there.
+    // Both end segments are pure cubics and have closed-form inverses instead.
+    if (index == 0)
+    {
+        return cbrtf(6 * target / segment.jerk);
+    }
+    if (index == SEGMENT_COUNT - 1)
+    {
+        float remaining = distance - target;
+        return segment.duration - cbrtf(6 * (remaining > 0 ? remaining : 0) / segment.jerk);
+    }
+
+    float t = guess;
+    for (uint8_t i = 0; i < SCURVE_NEWTON_ITERATIONS; i++)
+    {
+        float error = positionAt(segment, t) - target;
+        float v = velocityAt(segment, t);
+        if (v <= 0 || fabsf(error) < 1e-3f)
+            break;
+        t -= error / v;
+        if (t < 0)
+            t = 0;
+        if (t > segment.duration)
+            t = segment.duration;
+    }
+    return t;
+}
+
+uint32_t SCurveProfile::nextStep(int8_t &stepDirection)
+{
+    if (!running)
+        return 0;
+
+    long step = stepCount + 1;
+    double stepTime;
+    if (step >= distance)
+    {
+        // Last step lands exactly at the end of the profile
+        stepTime = segments[SEGMENT_COUNT - 1].startTime + segments[SEGMENT_COUNT - 1].duration;
+        speed = 0;
+        running = false;
+    }
+    else
+    {
+        while (segmentIndex < SEGMENT_COUNT - 1 && segmentEnd(segmentIndex) < step)
+        {
+            segmentIndex++;
+            tau = 0;
+        }
+        const Segment &segment = segments[segmentIndex];
+        tau = solveTime(segmentIndex, step, tau);
+        stepTime = segment.startTime + tau;
+        speed = direction * velocityAt(segment, tau);
+    }
+
+    // Integer µs timestamps so rounding never accumulates across steps
+    int64_t stepTimeUs = (int64_t)(stepTime * 1000000.0 + 0.5);
+    int64_t interval = stepTimeUs - lastStepTime;
+    if (interval < 1)
+        interval = 1;
+    lastStepTime += interval;
+
+    stepCount = step;
+    stepDirection = direction;
+    return (uint32_t)interval;
+}
+
+float SCurveProfile::getDuration() const
+{
+    const Segment &last = segments[SEGMENT_COUNT - 1];
+    return distance > 0 ? (float)(last.startTime + last.duration) : 0;
+}
+
+void SCurveProfile::evaluate(float t, float &position, float &velocity, float &acceleration) const
+{
+    uint8_t index = 0;
+    while (index < SEGMENT_COUNT - 1 && t > segments[index].startTime + segments[index].duration)
+    {
+        index++;
+    }
+    const Segment &segment = segments[index];
+    float local = t - (float)segment.startTime;
+    if (local > segment.duration)
+        local = segment.duration;
+    if (local < 0)
+        local = 0;
+
+    position = positionAt(segment, local);
+    velocity = velocityAt(segment, local);
+    acceleration = segment.a0 + segment.jerk * local;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "StepSource.h"
+
+// Jerk-limited (7-segment S-curve) rest-to-rest move planner
+// Acceleration ramps up and down linearly at maxJerk instead of jumping, which
+// keeps the ramp start/end from exciting axis resonance. Segments:
+//   1 +jerk, 2 constant accel, 3 -jerk, 4 cruise, 5 -jerk, 6 constant decel, 7 +jerk
+// Segments 2, 4 and 6 shrink to zero when limits are not reached on short moves.
+class SCurveProfile : public StepSource
+{
+public:
+    static constexpr uint8_t SEGMENT_COUNT = 7;
+
+private:
+    struct Segment
+    {
+        float duration; // seconds
+        float jerk;     // steps/sec³
+        float p0;       // Start position relative to move origin (steps)
+        float v0;       // Start velocity (steps/sec)
+        float a0;       // Start acceleration (steps/sec²)
+        double startTime;
+    };
+
+    Segment segments[SEGMENT_COUNT];
+    long origin;
+    long distance;     // Absolute move length (steps)
+    int8_t direction;
+    long stepCount;    // Steps planned so far
+    uint8_t segmentIndex;
+    float tau;         // Time within current segment of the last planned step
+    int64_t lastStepTime; // µs since move start
+    float speed;       // Signed speed at the last planned step
+    bool running;
+    float peakSpeed;
+    float peakAcceleration;
+    float maxJerk;
+
+    float positionAt(const Segment &segment, float t) const;
+    float velocityAt(const Segment &segment, float t) const;
+    float segmentEnd(uint8_t index) const;
+    float solveTime(uint8_t index, float target, float guess) const;
+    static float accelerationPhase(float velocity, float maxAcceleration, float maxJerk, float &jerkTime);
+
+public:
+    SCurveProfile();
+
+    // Plan a move from rest to rest. Returns false for invalid limits.
+    bool plan(long from, long to, float maxSpeed, float maxAcceleration, float maxJerk);
+    void setCurrentPosition(long position); // Abort and park at position
+
+    uint32_t nextStep(int8_t &direction) override;
+    bool isRunning() const override { return running; }
+    float getSpeed() const override { return speed; }
+    long currentPosition() const override { return origin + direction * stepCount; }
+    long targetPosition() const { return origin + direction * distance; }
+
+    // Planned profile figures
+    float getDuration() const;
+    float getPeakSpeed() const { return peakSpeed; }
+    float getPeakAcceleration() const { return peakAcceleration; }
+    float getMaxJerk() const { return maxJerk; }
+
+    // Kinematic state at time t (seconds since move start), relative to the origin
+    void evaluate(float t, float &position, float &velocity, float &acceleration) const;
+};
@@ -0,0 +1,193 @@
+#include "StepGenerator.h"
+#include "util.h"
+#include <soc/gpio_struct.h>
+#include <rom/ets_sys.h>
+#ifdef TASK_BENCHMARK
+#include "../TaskBenchmark/TaskBenchmark.h"
+#endif
+
+static constexpr LogModule logModule = LogModule::StepGenerator;
+
+// TMC2209 needs >100ns STEP high time; 1µs matches AccelStepper's default
+#define STEP_PULSE_US 1
+
+StepGenerator::StepGenerator(uint8_t stepPin, uint8_t dirPin)
+    : stepPin(stepPin), dirPin(dirPin), initialized(false),
+      position(0), pendingEntry(0), currentDirection(0), running(false), haltRequested(false), queuedTime(0)
+{
+    mux = portMUX_INITIALIZER_UNLOCKED;
+}
+
+bool StepGenerator::begin()
+{
+    if (initialized)
+        return true;
+
+    timer_config_t timerConfig = {};
+    timerConfig.divider = TIMER_DIVIDER;
+    timerConfig.counter_dir = TIMER_COUNT_UP;
+    timerConfig.counter_en = TIMER_PAUSE;
+    timerConfig.alarm_en = TIMER_ALARM_EN;
+    timerConfig.auto_reload = TIMER_AUTORELOAD_EN; // Counter restarts at each alarm, so intervals don't drift
+    timerConfig.intr_type = TIMER_INTR_LEVEL;
+
+    if (timer_init(TIMER_GROUP, TIMER_INDEX, &timerConfig) != ESP_OK)
+    {
+        LOG_ERROR("Step timer init failed");
+        return false;
+    }
+
+    timer_set_counter_value(TIMER_GROUP, TIMER_INDEX, 0);
+    timer_enable_intr(TIMER_GROUP, TIMER_INDEX);
+
+    // No ESP_INTR_FLAG_IRAM: the queue code lives in flash, so steps pause during
+    // NVS writes. Those only happen on config saves and limit learning (motor stopped).
+    if (timer_isr_callback_add(TIMER_GROUP, TIMER_INDEX, onTimer, this, 0) != ESP_OK)
+    {
+        LOG_ERROR("Step timer ISR registration failed");
+        return false;
+    }
+
+    initialized = true;
+    LOG_INFO("Step generator initialized on timer group %d (STEP: %d, DIR: %d)", TIMER_GROUP, stepPin, dirPin);
+    return true;
+}
+
+bool StepGenerator::push(uint32_t intervalUs, int8_t direction)
+{
+    uint32_t entry = (intervalUs & INTERVAL_MASK) | (direction > 0 ? DIRECTION_BIT : 0);
+    if (!queue.push(entry))
+    {
+        return false;
+    }
+    queuedTime.fetch_add(intervalUs & INTERVAL_MASK);
+    return true;
+}
+
+void StepGenerator::start()
+{
+    if (!initialized || running.load() || haltRequested.load())
+        return;
+
+    portENTER_CRITICAL(&mux);
+    uint32_t entry;
+    if (!running.load() && queue.pop(entry))
+    {
+        queuedTime.fetch_sub(entry & INTERVAL_MASK);
+        pendingEntry = entry;
+        running.store(true);
+        timer_set_counter_value(TIMER_GROUP, TIMER_INDEX, 0);
+        timer_set_alarm_value(TIMER_GROUP, TIMER_INDEX, entry & INTERVAL_MASK);
+        timer_set_alarm(TIMER_GROUP, TIMER_INDEX, TIMER_ALARM_EN);
+        timer_start(TIMER_GROUP, TIMER_INDEX);
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+void StepGenerator::stop()
+{
+    if (!initialized)
+        return;
+
+    // The lock keeps the ISR out while we act as the queue's consumer
+    portENTER_CRITICAL(&mux);
+    timer_pause(TIMER_GROUP, TIMER_INDEX);
+    running.store(false);
+    queue.clear();
+    queuedTime.store(0);
+    haltRequested.store(false);
+    portEXIT_CRITICAL(&mux);
+}
+
+void StepGenerator::setPosition(long newPosition)
+{
+    portENTER_CRITICAL(&mux);
+    position = newPosition;
+    portEXIT_CRITICAL(&mux);
+}
+
+long IRAM_ATTR StepGenerator::haltFromISR()
+{
+    if (!initialized)
+        return position;
+
+    // Under the lock no step is half emitted: the position is the last pulse sent
+    portENTER_CRITICAL_ISR(&mux);
+    haltRequested.store(true);
+    if (running.load())
+    {
+        timer_group_set_counter_enable_in_isr(TIMER_GROUP, TIMER_INDEX, TIMER_PAUSE);
+        running.store(false);
+    }
+    long parked = position;
+    portEXIT_CRITICAL_ISR(&mux);
+    return parked;
+}
+
+bool IRAM_ATTR StepGenerator::onTimer(void *arg)
+{
+    return static_cast<StepGenerator *>(arg)->handleTimer();
+}
+
+bool IRAM_ATTR StepGenerator::handleTimer()
+{
+#ifdef TASK_BENCHMARK
+    // Counter restarted at the alarm: its value now is how late this ISR runs
+    uint32_t latencyUs = (uint32_t)timer_group_get_counter_value_in_isr(TIMER_GROUP, TIMER_INDEX);
+#endif
+    portENTER_CRITICAL_ISR(&mux);
+
+    if (haltRequested.load())
+    {
+        // Emergency stop from another task: drop this step and park
+        timer_group_set_counter_enable_in_isr(TIMER_GROUP, TIMER_INDEX, TIMER_PAUSE);
+        running.store(false);
+    }
+    else if (running.load())
+    {
+        emitStep(pendingEntry);
+#ifdef TASK_BENCHMARK
+        taskBenchmark.recordStepLatency(latencyUs);
+#endif
+
+        uint32_t next;
+        if (queue.pop(next))
+        {
+            // Auto-reload already restarted the counter; the new alarm applies to this period
+            queuedTime.fetch_sub(next & INTERVAL_MASK);
+            pendingEntry = next;
+            timer_group_set_alarm_value_in_isr(TIMER_GROUP, TIMER_INDEX, next & INTERVAL_MASK);
+            timer_group_enable_alarm_in_isr(TIMER_GROUP, TIMER_INDEX);
+        }
+        else
+        {
+            // Queue ran dry: park the timer until the producer calls start() again
+            timer_group_set_counter_enable_in_isr(TIMER_GROUP, TIMER_INDEX, TIMER_PAUSE);
+            running.store(false);
+        }
+    }
+
+    portEXIT_CRITICAL_ISR(&mux);
+    return false; // No task woken
+}
+
+void IRAM_ATTR StepGenerator::emitStep(uint32_t entry)
+{
+    int8_t direction = (entry & DIRECTION_BIT) ? 1 : -1;
+
+    // Direct register writes: both pins are below 32 on the T-Motor board
+    if (direction != currentDirection)
+    {
+        if (direction > 0)
+            GPIO.out_w1ts = (1UL << dirPin);
+        else
+            GPIO.out_w1tc = (1UL << dirPin);
+        currentDirection = direction;
+    }
+
+    GPIO.out_w1ts = (1UL << stepPin);
+    ets_delay_us(STEP_PULSE_US);
+    GPIO.out_w1tc = (1UL << stepPin);
+
+    position = position + direction;
+}
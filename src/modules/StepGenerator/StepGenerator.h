@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <driver/timer.h>
+#include "../../SpscQueue.h"
+
+// Hardware-timer step engine
+// The motor loop plans steps ahead (see RampGenerator) and pushes their
+// intervals into a lock-free queue. A general-purpose timer alarm fires once
+// per step; its ISR emits the STEP pulse and reloads the alarm with the next
+// interval, so step timing no longer depends on how often loop() gets the CPU.
+class StepGenerator
+{
+public:
+    // Queue depth in steps and the amount of motion (µs) the producer keeps queued.
+    // The time bound keeps retarget/stop latency low at slow speeds.
+    static constexpr size_t QUEUE_SIZE = 256;
+    static constexpr uint32_t LOOKAHEAD_US = 10000;
+
+private:
+    // Queue entry: bit 31 = forward direction, bits 0-30 = interval in µs
+    static constexpr uint32_t DIRECTION_BIT = 0x80000000UL;
+    static constexpr uint32_t INTERVAL_MASK = 0x7FFFFFFFUL;
+
+    // Timer resources (group 1 is not used by the Arduino HAL timers by default)
+    static constexpr timer_group_t TIMER_GROUP = TIMER_GROUP_1;
+    static constexpr timer_idx_t TIMER_INDEX = TIMER_0;
+    static constexpr uint32_t TIMER_DIVIDER = 80; // 80 MHz APB / 80 = 1 µs ticks
+
+    uint8_t stepPin;
+    uint8_t dirPin;
+    bool initialized;
+
+    SpscQueue<uint32_t, QUEUE_SIZE> queue;
+    portMUX_TYPE mux;
+
+    // Shared with the ISR
+    volatile long position;          // Steps actually emitted
+    volatile uint32_t pendingEntry;  // Step the armed alarm will emit
+    volatile int8_t currentDirection;
+    std::atomic<bool> running;
+    std::atomic<bool> haltRequested;  // Set from any task, honoured by the ISR
+    std::atomic<uint32_t> queuedTime; // Sum of queued intervals (µs)
+
+    static bool IRAM_ATTR onTimer(void *arg);
+    bool IRAM_ATTR handleTimer();
+    void IRAM_ATTR emitStep(uint32_t entry);
+
+public:
+    StepGenerator(uint8_t stepPin, uint8_t dirPin);
+
+    // Configure the hardware timer. Returns false if the timer is unavailable.
+    bool begin();
+    bool isInitialized() const { return initialized; }
+
+    // Producer side (motor loop)
+    bool push(uint32_t intervalUs, int8_t direction);
+    bool needsSteps() const { return !queue.isFull() && queuedTime.load() < LOOKAHEAD_US; }
+    void start(); // Arm the timer if it is idle and steps are queued
+
+    // Halt immediately and discard everything still queued
+    void stop();
+
+    // Any task: stop emitting at the next alarm without touching the queue.
+    // The producer finishes with stop(), which also clears the request.
+    void requestHalt() { haltRequested.store(true); }
+
+    // From an IRAM ISR: park the timer now, without waiting for the next alarm,
+    // and return the position it parked at. Like requestHalt(), the producer
+    // finishes with stop().
+    long IRAM_ATTR haltFromISR();
+
+    bool isRunning() const { return running.load(); }
+    size_t queuedSteps() const { return queue.size(); }
+    long getPosition() const { return position; }
+    void setPosition(long newPosition); // Only while stopped
+};
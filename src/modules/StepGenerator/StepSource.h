@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+// Producer of a per-step interval stream for the step engine
+// Each call plans exactly one step ahead of the hardware: the returned value is
+// the delay in microseconds between the previous step and this one.
+class StepSource
+{
+public:
+    virtual ~StepSource() {}
+
+    // Plan the next step. Returns 0 when no step is pending (move complete),
+    // otherwise the interval in microseconds and sets direction to +1 or -1.
+    virtual uint32_t nextStep(int8_t &direction) = 0;
+
+    // Planning state (planned position leads the motor by whatever is queued)
+    virtual bool isRunning() const = 0;
+    virtual float getSpeed() const = 0;
+    virtual long currentPosition() const = 0;
+};
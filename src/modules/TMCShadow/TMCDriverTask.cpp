@@ -0,0 +1,77 @@
+#include "TMCDriverTask.h"
+#include "TaskConfig.h"
+#include "util.h"
+#include <Arduino.h>
+
+static constexpr LogModule logModule = LogModule::TMC;
+
+// TMC_TASK_PRIORITY sits below InputTask: register writes may wait a tick,
+// sampling and buttons may not
+
+bool TMC2209UartBus::writeRegister(uint8_t address, uint32_t value)
+{
+    write(address, value);
+    return true; // Writes are not acknowledged; IFCNT would tell, at the cost of a read
+}
+
+bool TMC2209UartBus::readRegister(uint8_t address, uint32_t &value)
+{
+    value = read(address);
+    return !CRCerror;
+}
+
+TMCDriverTask::TMCDriverTask(TMCShadow &shadow, TMCBus &bus)
+    : shadow(shadow), bus(bus), task(nullptr), stallGuardPolling(false)
+{
+}
+
+bool TMCDriverTask::begin()
+{
+    TaskHandle_t handle;
+    if (xTaskCreatePinnedToCore(taskEntry, "TMCTask", TMC_TASK_STACK, this, TMC_TASK_PRIORITY, &handle, SYSTEM_CORE) != pdPASS)
+    {
+        LOG_ERROR("TMC task creation failed");
+        return false;
+    }
+    task = handle;
+    return true;
+}
+
+void TMCDriverTask::wake()
+{
+    if (task)
+        xTaskNotifyGive(static_cast<TaskHandle_t>(task));
+}
+
+void TMCDriverTask::setStallGuardPolling(bool enabled)
+{
+    stallGuardPolling = enabled;
+    wake();
+}
+
+void TMCDriverTask::taskEntry(void *arg)
+{
+    static_cast<TMCDriverTask *>(arg)->run();
+}
+
+void TMCDriverTask::run()
+{
+    uint32_t lastStatusMs = 0;
+    while (1)
+    {
+        uint32_t waitMs = stallGuardPolling ? STALLGUARD_INTERVAL_MS : STATUS_INTERVAL_MS;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+
+        shadow.flush(bus);
+
+        if (stallGuardPolling)
+            shadow.poll(bus, TMCShadow::Status::SG_RESULT);
+
+        if (millis() - lastStatusMs >= STATUS_INTERVAL_MS)
+        {
+            lastStatusMs = millis();
+            shadow.poll(bus, TMCShadow::Status::IOIN);
+            shadow.poll(bus, TMCShadow::Status::DRV_STATUS);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <TMCStepper.h>
+#include <atomic>
+#include "TMCShadow.h"
+
+// TMC2209 whose raw register access backs a TMCShadow
+// Boot-time setup still uses the TMCStepper API directly, before the worker runs.
+class TMC2209UartBus : public TMC2209Stepper, public TMCBus
+{
+public:
+    TMC2209UartBus(HardwareSerial *serial, float rsense, uint8_t address)
+        : TMC2209Stepper(serial, rsense, address) {}
+
+    bool writeRegister(uint8_t address, uint32_t value) override;
+    bool readRegister(uint8_t address, uint32_t &value) override;
+};
+
+// Low-priority worker on core 0 that owns the driver UART after boot
+// Woken when the shadow has dirty registers; otherwise refreshes the status
+// registers on its own period (SG_RESULT every 5 ms while StallGuard is watched).
+class TMCDriverTask
+{
+public:
+    static constexpr uint32_t STATUS_INTERVAL_MS = 100;   // IOIN, DRV_STATUS
+    static constexpr uint32_t STALLGUARD_INTERVAL_MS = 5; // SG_RESULT while homing
+
+private:
+    TMCShadow &shadow;
+    TMCBus &bus;
+    void *task; // TaskHandle_t
+    std::atomic<bool> stallGuardPolling;
+
+    static void taskEntry(void *arg);
+    void run();
+
+public:
+    TMCDriverTask(TMCShadow &shadow, TMCBus &bus);
+
+    bool begin();
+
+    // Any task: flush now rather than at the next poll
+    void wake();
+    void setStallGuardPolling(bool enabled);
+};
@@ -0,0 +1,139 @@
+#include "TMCShadow.h"
+
+const uint8_t TMCShadow::REG_ADDRESS[(uint8_t)Reg::COUNT] = {0x00, 0x6C, 0x10, 0x13, 0x14, 0x40};
+const uint8_t TMCShadow::STATUS_ADDRESS[(uint8_t)Status::COUNT] = {0x06, 0x41, 0x6F};
+
+TMCShadow::TMCShadow(float rsense)
+    : dirty(0), rsense(rsense), requested(0), skipped(0), issued(0), errors(0)
+{
+    for (uint8_t i = 0; i < (uint8_t)Reg::COUNT; i++)
+    {
+        values[i] = 0;
+        written[i] = 0;
+    }
+    for (uint8_t i = 0; i < (uint8_t)Status::COUNT; i++)
+    {
+        status[i] = 0;
+        statusReads[i] = 0;
+    }
+}
+
+void TMCShadow::seed(Reg reg, uint32_t value)
+{
+    values[(uint8_t)reg] = value;
+    written[(uint8_t)reg] = value;
+}
+
+bool TMCShadow::set(Reg reg, uint32_t value)
+{
+    requested++;
+    if (values[(uint8_t)reg].exchange(value) == value)
+    {
+        skipped++;
+        return false;
+    }
+    dirty.fetch_or(1ul << (uint8_t)reg);
+    return true;
+}
+
+bool TMCShadow::setField(Reg reg, uint32_t mask, uint32_t bits)
+{
+    // Only the motor loop changes a given register, so read-modify-write is safe
+    return set(reg, (get(reg) & ~mask) | (bits & mask));
+}
+
+bool TMCShadow::setSpreadCycle(bool enabled)
+{
+    return setField(Reg::GCONF, GCONF_EN_SPREADCYCLE, enabled ? GCONF_EN_SPREADCYCLE : 0);
+}
+
+uint8_t TMCShadow::currentScale(uint16_t milliamps, float rsense, bool vsense)
+{
+    float scale = 32.0f * 1.41421f * milliamps / 1000.0f * (rsense + 0.02f) / (vsense ? 0.180f : 0.325f) - 1;
+    if (scale < 0)
+        return 0;
+    return scale > 31 ? 31 : (uint8_t)scale;
+}
+
+bool TMCShadow::setRunCurrent(uint16_t milliamps)
+{
+    // Low currents use the sensitive range for resolution (same rule as TMCStepper)
+    uint8_t scale = currentScale(milliamps, rsense, false);
+    bool vsense = scale < 16;
+    if (vsense)
+        scale = currentScale(milliamps, rsense, true);
+
+    bool changed = setField(Reg::CHOPCONF, CHOPCONF_VSENSE, vsense ? CHOPCONF_VSENSE : 0);
+    changed |= setField(Reg::IHOLD_IRUN, IRUN_MASK, (uint32_t)scale << IRUN_SHIFT);
+    return changed;
+}
+
+uint16_t TMCShadow::getMicrosteps() const
+{
+    uint8_t mres = (get(Reg::CHOPCONF) & MRES_MASK) >> MRES_SHIFT;
+    return mres > 8 ? 1 : 256 >> mres; // 9..15 read as full steps
+}
+
+uint32_t TMCShadow::tstep(float stepsPerSec, uint16_t microsteps)
+{
+    // One step at this MRES is 256 / microsteps TSTEP units
+    if (stepsPerSec <= 0)
+        return TPWMTHRS_MAX;
+    float cycles = (float)CLOCK_HZ * microsteps / (256.0f * stepsPerSec) + 0.5f;
+    if (cycles >= TPWMTHRS_MAX)
+        return TPWMTHRS_MAX;
+    return cycles < 1 ? 1 : (uint32_t)cycles;
+}
+
+bool TMCShadow::setStealthChopThreshold(float stepsPerSec)
+{
+    return set(Reg::TPWMTHRS, tstep(stepsPerSec, getMicrosteps()));
+}
+
+uint8_t TMCShadow::flush(TMCBus &bus)
+{
+    uint32_t pending = dirty.exchange(0);
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < (uint8_t)Reg::COUNT && pending; i++)
+    {
+        if (!(pending & (1ul << i)))
+            continue;
+        pending &= ~(1ul << i);
+
+        // A newer set() after the exchange re-marks it: at worst one extra write
+        uint32_t value = values[i].load();
+        if (value == written[i])
+            continue; // Flapped back before we got here
+        if (!bus.writeRegister(REG_ADDRESS[i], value))
+        {
+            errors++;
+            dirty.fetch_or(1ul << i); // Retry on the next flush
+            continue;
+        }
+        written[i] = value;
+        issued++;
+        count++;
+    }
+    return count;
+}
+
+bool TMCShadow::poll(TMCBus &bus, Status reg)
+{
+    uint32_t value;
+    if (!bus.readRegister(STATUS_ADDRESS[(uint8_t)reg], value))
+    {
+        errors++;
+        return false;
+    }
+    status[(uint8_t)reg] = value;
+    statusReads[(uint8_t)reg]++;
+    return true;
+}
+
+bool TMCShadow::getStatus(Status reg, uint32_t &value) const
+{
+    if (statusReads[(uint8_t)reg].load() == 0)
+        return false;
+    value = status[(uint8_t)reg].load();
+    return true;
+}
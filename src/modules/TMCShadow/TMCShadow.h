@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+// Register-level access to the driver, implemented over the UART (or a model in tests)
+class TMCBus
+{
+public:
+    virtual ~TMCBus() {}
+    virtual bool writeRegister(uint8_t address, uint32_t value) = 0;
+    virtual bool readRegister(uint8_t address, uint32_t &value) = 0;
+};
+
+// Shadow of the TMC2209 registers changed at run time
+// The motor loop sets registers here instead of talking to the UART: a value
+// equal to the shadow is dropped, anything else only marks the register dirty.
+// A worker task flushes dirty registers to the bus and refreshes the status
+// registers, so readbacks never wait for the UART either. Writes that flap
+// back to the value last written before a flush never reach the bus.
+class TMCShadow
+{
+public:
+    // Writable registers, flushed in this order (CHOPCONF before IHOLD_IRUN: vsense
+    // has to be right before the new current scale applies)
+    enum class Reg : uint8_t
+    {
+        GCONF,
+        CHOPCONF,
+        IHOLD_IRUN,
+        TPWMTHRS,
+        TCOOLTHRS,
+        SGTHRS,
+        COUNT
+    };
+
+    // Read-only status registers, refreshed by the worker
+    enum class Status : uint8_t
+    {
+        IOIN,
+        SG_RESULT,
+        DRV_STATUS,
+        COUNT
+    };
+
+    static const uint8_t REG_ADDRESS[(uint8_t)Reg::COUNT];
+    static const uint8_t STATUS_ADDRESS[(uint8_t)Status::COUNT];
+
+    // Field layout
+    static constexpr uint32_t GCONF_EN_SPREADCYCLE = 1ul << 2;
+    static constexpr uint32_t CHOPCONF_VSENSE = 1ul << 17;
+    static constexpr uint8_t IRUN_SHIFT = 8;
+    static constexpr uint32_t IRUN_MASK = 0x1Ful << IRUN_SHIFT;
+    static constexpr uint8_t MRES_SHIFT = 24;
+    static constexpr uint32_t MRES_MASK = 0xFul << MRES_SHIFT;
+    static constexpr uint32_t DRV_STATUS_STEALTH = 1ul << 30;
+
+    // TSTEP/TPWMTHRS: time per 1/256 microstep in internal clock cycles
+    static constexpr uint32_t CLOCK_HZ = 12000000;
+    static constexpr uint32_t TPWMTHRS_MAX = 0xFFFFF;
+
+private:
+    std::atomic<uint32_t> values[(uint8_t)Reg::COUNT];  // What the chip should hold
+    std::atomic<uint32_t> written[(uint8_t)Reg::COUNT]; // What it was last given (written by the worker)
+    std::atomic<uint32_t> dirty;                        // Bit per Reg
+    std::atomic<uint32_t> status[(uint8_t)Status::COUNT];
+    std::atomic<uint32_t> statusReads[(uint8_t)Status::COUNT];
+    float rsense;
+
+    std::atomic<uint32_t> requested; // set() calls
+    std::atomic<uint32_t> skipped;   // Dropped: same as the shadow
+    std::atomic<uint32_t> issued;    // Bus writes
+    std::atomic<uint32_t> errors;    // Failed bus reads and writes
+
+public:
+    explicit TMCShadow(float rsense);
+
+    // Boot: the value the chip holds now (not written back)
+    void seed(Reg reg, uint32_t value);
+
+    // Any task: false when the value is already the shadow (nothing to write)
+    bool set(Reg reg, uint32_t value);
+    bool setField(Reg reg, uint32_t mask, uint32_t bits);
+    uint32_t get(Reg reg) const { return values[(uint8_t)reg].load(); }
+    bool isPending() const { return dirty.load() != 0; }
+    bool isApplied(Reg reg) const { return written[(uint8_t)reg].load() == get(reg); } // On the chip
+
+    // Field helpers
+    bool setSpreadCycle(bool enabled);
+    bool setRunCurrent(uint16_t milliamps); // IRUN, plus vsense when the range changes
+    uint16_t getMicrosteps() const;         // From MRES in the CHOPCONF shadow
+
+    // TPWMTHRS for a step rate: SpreadCycle above it, StealthChop below, switched
+    // by the driver (with en_SpreadCycle clear). Converted at the shadowed MRES.
+    bool setStealthChopThreshold(float stepsPerSec);
+    static uint32_t tstep(float stepsPerSec, uint16_t microsteps);
+
+    // Current scale (IRUN/IHOLD 0..31) for an RMS current, as TMCStepper's rms_current() computes it
+    static uint8_t currentScale(uint16_t milliamps, float rsense, bool vsense);
+
+    // Worker: write every dirty register, returns the number of bus writes
+    uint8_t flush(TMCBus &bus);
+    bool poll(TMCBus &bus, Status reg);
+
+    // Any task: last polled status value; false before the first successful read
+    bool getStatus(Status reg, uint32_t &value) const;
+    uint32_t getStatusReads(Status reg) const { return statusReads[(uint8_t)reg].load(); }
+
+    uint32_t getRequestedCount() const { return requested.load(); }
+    uint32_t getSkippedCount() const { return skipped.load(); }
+    uint32_t getWriteCount() const { return issued.load(); }
+    uint32_t getErrorCount() const { return errors.load(); }
+};
@@ -0,0 +1,98 @@
+#ifdef TASK_BENCHMARK
+
+#include "TaskBenchmark.h"
+#include "TaskConfig.h"
+#include "util.h"
+
+static constexpr LogModule logModule = LogModule::System;
+
+TaskBenchmark taskBenchmark;
+
+TaskBenchmark::TaskBenchmark()
+    : droppedSteps(0), droppedLoops(0), lastLoopCycles(0), cyclesPerUs(240), task(nullptr)
+{
+}
+
+bool TaskBenchmark::begin()
+{
+    if (task)
+        return true;
+
+    cyclesPerUs = getCpuFrequencyMhz();
+    if (xTaskCreatePinnedToCore(taskEntry, "BenchmarkTask", BENCHMARK_TASK_STACK, this,
+                                BENCHMARK_TASK_PRIORITY, &task, SYSTEM_CORE) != pdPASS)
+    {
+        LOG_ERROR("Benchmark task creation failed");
+        return false;
+    }
+
+    LOG_INFO("Benchmark mode: %s layout, reporting every %lu ms", TASK_LAYOUT_NAME, REPORT_MS);
+    return true;
+}
+
+void TaskBenchmark::recordLoop()
+{
+    uint32_t now = ESP.getCycleCount();
+    if (lastLoopCycles != 0)
+    {
+        // Cycle counter wraps every ~18 s at 240 MHz; unsigned subtraction handles it
+        uint32_t ns = (now - lastLoopCycles) * 1000UL / cyclesPerUs;
+        if (!loopPeriod.push(ns))
+            droppedLoops.fetch_add(1, std::memory_order_relaxed);
+    }
+    lastLoopCycles = now;
+}
+
+void TaskBenchmark::taskEntry(void *arg)
+{
+    static_cast<TaskBenchmark *>(arg)->run();
+}
+
+void TaskBenchmark::run()
+{
+    TickType_t lastReport = xTaskGetTickCount();
+    while (1)
+    {
+        // Drain often: the motor loop fills its queue in a few ms
+        vTaskDelay(pdMS_TO_TICKS(DRAIN_MS));
+        drain();
+
+        if (xTaskGetTickCount() - lastReport < pdMS_TO_TICKS(REPORT_MS))
+            continue;
+        lastReport = xTaskGetTickCount();
+
+        report("Step latency", "us", stepStats, droppedSteps.exchange(0));
+        report("Motor loop period", "ns", loopStats, droppedLoops.exchange(0));
+        stepStats.reset();
+        loopStats.reset();
+    }
+}
+
+void TaskBenchmark::drain()
+{
+    uint16_t latency;
+    while (stepLatency.pop(latency))
+        stepStats.add(latency);
+
+    uint32_t period;
+    while (loopPeriod.pop(period))
+        loopStats.add(period > INT32_MAX ? INT32_MAX : (int32_t)period);
+}
+
+void TaskBenchmark::report(const char *name, const char *unit, const TimingStats &stats, uint32_t dropped)
+{
+    LOG_INFO("[%s] %s: n=%lu min=%ld mean=%.1f max=%ld sd=%.1f %s (dropped %lu)", TASK_LAYOUT_NAME, name,
+             stats.getCount(), stats.getMin(), stats.getMean(), stats.getMax(), stats.getStdDev(), unit, dropped);
+
+    for (uint8_t i = 0; i < TimingStats::HISTOGRAM_BUCKETS; i++)
+    {
+        if (stats.getBucket(i) == 0)
+            continue;
+        if (i == TimingStats::HISTOGRAM_BUCKETS - 1)
+            LOG_INFO("  >= %lu %s: %lu", TimingStats::bucketLimit(i - 1), unit, stats.getBucket(i));
+        else
+            LOG_INFO("  < %lu %s: %lu", TimingStats::bucketLimit(i), unit, stats.getBucket(i));
+    }
+}
+
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "../../SpscQueue.h"
+#include "../../TimingStats.h"
+
+// Task layout benchmark (-DTASK_BENCHMARK builds only)
+// The step ISR records how late it ran: auto-reload restarts the timer counter
+// at each alarm, so the counter on entry is the interrupt latency in µs. The
+// motor loop records its own period. Both go through lock-free queues to a
+// reporter task on the system core, which logs min/mean/max/stddev and the
+// histogram every REPORT_MS. Flash pico32_benchmark and pico32_benchmark_legacy
+// and run the same moves to compare the two layouts.
+class TaskBenchmark
+{
+public:
+    static constexpr uint32_t REPORT_MS = 10000;
+    static constexpr uint32_t DRAIN_MS = 2;
+
+private:
+    SpscQueue<uint16_t, 512> stepLatency; // µs, from the step ISR
+    SpscQueue<uint32_t, 2048> loopPeriod; // ns, from the motor loop
+    std::atomic<uint32_t> droppedSteps;
+    std::atomic<uint32_t> droppedLoops;
+    uint32_t lastLoopCycles;
+    uint32_t cyclesPerUs;
+
+    // Reporter side
+    TimingStats stepStats;
+    TimingStats loopStats;
+    TaskHandle_t task;
+
+    static void taskEntry(void *arg);
+    void run();
+    void drain();
+    void report(const char *name, const char *unit, const TimingStats &stats, uint32_t dropped);
+
+public:
+    TaskBenchmark();
+
+    // Start the reporter task
+    bool begin();
+
+    // Step timer ISR, once per emitted step
+    void IRAM_ATTR recordStepLatency(uint32_t latencyUs)
+    {
+        if (!stepLatency.push(latencyUs > 0xFFFF ? 0xFFFF : (uint16_t)latencyUs))
+            droppedSteps.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Motor loop, once per pass
+    void recordLoop();
+};
+
+extern TaskBenchmark taskBenchmark;
@@ -0,0 +1,61 @@
+#include "VelocityObserver.h"
+
+VelocityObserver::VelocityObserver()
+    : kp(0), ki(0), kii(0), bandwidthHz(0), angle(0), turns(0), velocity(0), acceleration(0),
+      lastTimestampUs(0), initialized(false)
+{
+    setBandwidth(DEFAULT_BANDWIDTH_HZ);
+}
+
+void VelocityObserver::setBandwidth(float hz)
+{
+    if (hz < MIN_BANDWIDTH_HZ)
+        hz = MIN_BANDWIDTH_HZ;
+    if (hz > MAX_BANDWIDTH_HZ)
+        hz = MAX_BANDWIDTH_HZ;
+
+    float w = 2.0f * 3.14159265f * hz;
+    bandwidthHz = hz;
+    kp = 3.0f * w;
+    ki = 3.0f * w * w;
+    kii = w * w * w;
+}
+
+void VelocityObserver::update(uint16_t raw, uint32_t timestampUs)
+{
+    uint32_t elapsedUs = timestampUs - lastTimestampUs;
+    lastTimestampUs = timestampUs;
+
+    if (!initialized || elapsedUs == 0 || elapsedUs > MAX_GAP_US)
+    {
+        // Start (or restart after a gap) at rest on the measurement
+        angle = raw;
+        velocity = 0;
+        acceleration = 0;
+        initialized = true;
+        return;
+    }
+
+    float dt = elapsedUs * 1e-6f;
+
+    // Phase error between measurement and prediction, wrapped to half a turn
+    float predicted = angle + (velocity + 0.5f * acceleration * dt) * dt;
+    float error = (float)raw - predicted;
+    error -= COUNTS_PER_REV * (float)(int32_t)(error / COUNTS_PER_REV + (error >= 0 ? 0.5f : -0.5f));
+
+    angle = predicted + kp * dt * error;
+    velocity += (acceleration + ki * error) * dt;
+    acceleration += kii * error * dt;
+
+    // Keep the angle inside one turn so float precision doesn't degrade with distance
+    while (angle >= COUNTS_PER_REV)
+    {
+        angle -= COUNTS_PER_REV;
+        turns++;
+    }
+    while (angle < 0)
+    {
+        angle += COUNTS_PER_REV;
+        turns--;
+    }
+}
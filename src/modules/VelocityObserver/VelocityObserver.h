@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+
+// Tracking-loop (PLL) observer for encoder angle, velocity and acceleration
+// Fed with timestamped single-turn samples at a high rate. Each sample
+// predicts the angle forward, takes the wrapped phase error against the
+// measurement and corrects angle, velocity and acceleration with gains that
+// place all three loop poles at -bandwidth. A type-3 loop: constant velocity
+// and constant acceleration are tracked without steady-state lag.
+class VelocityObserver
+{
+public:
+    static constexpr int32_t COUNTS_PER_REV = 16384;
+    static constexpr float DEFAULT_BANDWIDTH_HZ = 20.0f;
+    static constexpr float MIN_BANDWIDTH_HZ = 1.0f;
+    static constexpr float MAX_BANDWIDTH_HZ = 200.0f; // Keep bandwidth * dt well below 1 at 2 kHz
+    static constexpr uint32_t MAX_GAP_US = 50000;      // Longer gaps restart the loop from the sample
+
+private:
+    // Gains: s^3 + kp s^2 + ki s + kii = (s + w)^3
+    float kp;
+    float ki;
+    float kii;
+    float bandwidthHz;
+
+    float angle;        // Estimated angle within the turn [0, COUNTS_PER_REV)
+    int32_t turns;      // Whole turns of the estimate
+    float velocity;     // counts/s
+    float acceleration; // counts/s²
+    uint32_t lastTimestampUs;
+    bool initialized;
+
+public:
+    VelocityObserver();
+
+    void setBandwidth(float hz);
+    float getBandwidth() const { return bandwidthHz; }
+
+    // Feed one sample; timestamps must increase (wraps of the 32-bit µs clock are fine)
+    void update(uint16_t raw, uint32_t timestampUs);
+    void reset() { initialized = false; }
+
+    bool isInitialized() const { return initialized; }
+    float getAngle() const { return angle; }
+    long getPosition() const { return (long)turns * COUNTS_PER_REV + (long)angle; } // Multi-turn counts
+    float getVelocity() const { return velocity; }                                  // counts/s
+    float getAcceleration() const { return acceleration; }                          // counts/s²
+    float getVelocityDegPerSec() const { return velocity * (360.0f / COUNTS_PER_REV); }
+};
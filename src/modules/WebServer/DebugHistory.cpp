@@ -0,0 +1,168 @@
+#include "DebugHistory.h"
+#include <stdio.h>
+#include <string.h>
+
+// JSON string escape for one byte; UTF-8 sequences pass through unchanged
+static size_t escapeChar(char c, char *out)
+{
+    switch (c)
+    {
+    case '"':
+    case '\\':
+        out[0] = '\\';
+        out[1] = c;
+        return 2;
+    case '\n':
+        memcpy(out, "\\n", 2);
+        return 2;
+    case '\r':
+        memcpy(out, "\\r", 2);
+        return 2;
+    case '\t':
+        memcpy(out, "\\t", 2);
+        return 2;
+    default:
+        if ((uint8_t)c < 0x20)
+            return snprintf(out, 7, "\\u%04x", (unsigned)(uint8_t)c);
+        out[0] = c;
+        return 1;
+    }
+}
+
+DebugHistory::DebugHistory() : tail(0), used(0), firstSeq(0), nextSeq(0)
+{
+}
+
+void DebugHistory::copyIn(size_t offset, const void *src, size_t length)
+{
+    size_t first = length < ARENA_SIZE - offset ? length : ARENA_SIZE - offset;
+    memcpy(arena + offset, src, first);
+    memcpy(arena, (const uint8_t *)src + first, length - first);
+}
+
+void DebugHistory::copyOut(size_t offset, void *dst, size_t length) const
+{
+    size_t first = length < ARENA_SIZE - offset ? length : ARENA_SIZE - offset;
+    memcpy(dst, arena + offset, first);
+    memcpy((uint8_t *)dst + first, arena, length - first);
+}
+
+size_t DebugHistory::lineLength(size_t offset) const
+{
+    uint16_t length;
+    copyOut(offset, &length, sizeof(length));
+    return length;
+}
+
+void DebugHistory::evictOldest()
+{
+    size_t record = sizeof(uint16_t) + lineLength(tail);
+    tail = (tail + record) % ARENA_SIZE;
+    used -= record;
+    firstSeq++;
+}
+
+uint32_t DebugHistory::add(const char *line)
+{
+    uint16_t length = line ? strnlen(line, MAX_LINE) : 0;
+    while (ARENA_SIZE - used < sizeof(length) + length)
+        evictOldest();
+
+    size_t head = (tail + used) % ARENA_SIZE;
+    copyIn(head, &length, sizeof(length));
+    copyIn((head + sizeof(length)) % ARENA_SIZE, line, length);
+    used += sizeof(length) + length;
+    return nextSeq++;
+}
+
+void DebugHistory::clear()
+{
+    // Sequence numbers keep counting and the ring restarts where it stands, so
+    // connected clients see a gap, not a rewind, and a caught-up cursor stays valid
+    tail = (tail + used) % ARENA_SIZE;
+    used = 0;
+    firstSeq = nextSeq;
+}
+
+DebugHistory::Cursor DebugHistory::seek(uint32_t seq) const
+{
+    if (seq > nextSeq)
+        return oldest();
+    if (seq < firstSeq)
+        return {seq, tail}; // readFrame() reports the gap
+
+    size_t offset = tail;
+    for (uint32_t s = firstSeq; s < seq; s++)
+        offset = (offset + sizeof(uint16_t) + lineLength(offset)) % ARENA_SIZE;
+    return {seq, offset};
+}
+
+size_t DebugHistory::readFrame(Cursor &cursor, char *out, size_t size) const
+{
+    if (cursor.seq > nextSeq)
+        cursor = oldest();
+    if (cursor.seq == nextSeq)
+        return 0;
+
+    int length;
+    if (cursor.seq < firstSeq)
+    {
+        length = snprintf(out, size, "{\"type\":\"gap\",\"from\":%lu,\"to\":%lu}",
+                          (unsigned long)cursor.seq, (unsigned long)firstSeq);
+        if (length < 0 || (size_t)length >= size)
+            return 0;
+        cursor = oldest();
+        return length;
+    }
+
+    // Room for at least an empty first line, "]}" and the terminator
+    length = snprintf(out, size, "{\"type\":\"log\",\"seq\":%lu,\"lines\":[", (unsigned long)cursor.seq);
+    if (length < 0 || (size_t)length + 5 > size)
+        return 0;
+
+    size_t offset = cursor.offset;
+    size_t pos = length;
+    size_t end = size - 3; // "]}" and the terminator follow the last line
+    char line[MAX_LINE];
+    uint32_t seq = cursor.seq;
+    for (; seq < nextSeq; seq++)
+    {
+        bool first = seq == cursor.seq;
+        if (!first && pos + 3 > end)
+            break;
+
+        size_t start = pos;
+        size_t lineLen = lineLength(offset);
+        copyOut((offset + sizeof(uint16_t)) % ARENA_SIZE, line, lineLen);
+
+        if (!first)
+            out[pos++] = ',';
+        out[pos++] = '"';
+        size_t i = 0;
+        for (; i < lineLen; i++)
+        {
+            char escaped[7];
+            size_t n = escapeChar(line[i], escaped);
+            if (pos + n + 1 > end)
+                break;
+            memcpy(out + pos, escaped, n);
+            pos += n;
+        }
+
+        // A line that does not fit waits for the next frame, unless it is the
+        // first: then it could never fit and is sent cut short
+        if (i < lineLen && !first)
+        {
+            pos = start;
+            break;
+        }
+        out[pos++] = '"';
+        offset = (offset + sizeof(uint16_t) + lineLen) % ARENA_SIZE;
+    }
+
+    out[pos++] = ']';
+    out[pos++] = '}';
+    out[pos] = '\0';
+    cursor = {seq, offset};
+    return pos;
+}
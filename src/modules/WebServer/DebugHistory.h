@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed arena of recent debug log lines for replay to /debug clients
+// Lines are stored back to back in a byte ring as [length:2][text], so short
+// lines cost little and nothing touches the heap. Adding a line evicts the
+// oldest ones until it fits. Every line gets the next sequence number; a
+// client keeps a Cursor (the sequence it wants next, and where that line
+// starts in the arena, so reads never walk the ring) and reads frames from it:
+//   {"type":"log","seq":41,"lines":["...","..."]}  lines 41, 42, ...
+//   {"type":"gap","from":12,"to":41}                lines 12..40 were evicted
+// A client that reconnects with its cursor gets neither gaps nor duplicates
+// while the lines it missed are still in the arena.
+// Not thread-safe; the caller serialises add() and readFrame().
+class DebugHistory
+{
+public:
+    static constexpr size_t ARENA_SIZE = 16384;
+    static constexpr size_t MAX_LINE = 512; // Longer lines are truncated
+
+    struct Cursor
+    {
+        uint32_t seq;  // Next line to send
+        size_t offset; // Where that line starts; valid while seq >= firstSequence()
+    };
+
+private:
+    uint8_t arena[ARENA_SIZE];
+    size_t tail;       // Offset of the oldest line
+    size_t used;       // Bytes in use, headers included
+    uint32_t firstSeq; // Sequence number of the oldest line
+    uint32_t nextSeq;  // Sequence number the next line gets
+
+    void copyIn(size_t offset, const void *src, size_t length);
+    void copyOut(size_t offset, void *dst, size_t length) const;
+    size_t lineLength(size_t offset) const;
+    void evictOldest();
+
+public:
+    DebugHistory();
+
+    // Stores a line and returns its sequence number
+    uint32_t add(const char *line);
+    void clear();
+
+    // Cursor at the oldest line, or at 'seq' for a client resuming (walks the
+    // ring once). A sequence number ahead of the newest line (a client from
+    // before a reboot) starts at the oldest line.
+    Cursor oldest() const { return {firstSeq, tail}; }
+    Cursor seek(uint32_t seq) const;
+
+    // Writes the next frame for 'cursor' into 'out' and advances the cursor
+    // past what it covers. Returns the frame length, or 0 when caught up.
+    size_t readFrame(Cursor &cursor, char *out, size_t size) const;
+
+    uint32_t firstSequence() const { return firstSeq; }
+    uint32_t nextSequence() const { return nextSeq; }
+    uint32_t lineCount() const { return nextSeq - firstSeq; }
+    size_t bytesUsed() const { return used; }
+};
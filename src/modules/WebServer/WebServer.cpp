@@ -2,54 +2,17 @@
 #include "../Configuration/Configuration.h"
 #include "../MotorController/MotorController.h"
 #include "../LimitSwitch/LimitSwitch.h"
+#include "../InputScheduler/InputEvents.h"
 #include "util.h"
 #include <Arduino.h>
 
+static constexpr LogModule logModule = LogModule::WebServer;
+
 // Global instance
 WebServerClass webServer;
 
-// DebugBuffer implementation
-DebugBuffer::DebugBuffer() : head(0), tail(0), full(false) {}
-
-void DebugBuffer::add(const String &message)
-{
-    buffer[head] = message;
-    head = (head + 1) % DEBUG_BUFFER_SIZE;
-
-    if (full)
-    {
-        tail = (tail + 1) % DEBUG_BUFFER_SIZE;
-    }
-
-    if (head == tail)
-    {
-        full = true;
-    }
-}
-
-void DebugBuffer::sendHistoryTo(AsyncWebSocketClient *client)
-{
-    if (isEmpty())
-    {
-        return;
-    }
-
-    int start = full ? tail : 0;
-    int end = head;
-
-    for (int i = start; i != end; i = (i + 1) % DEBUG_BUFFER_SIZE)
-    {
-        client->text(buffer[i]);
-    }
-}
-
-bool DebugBuffer::isEmpty() const
-{
-    return (!full && (head == tail));
-}
-
-// Global function for util.cpp weak linkage
-void broadcastDebugMessage(const String &message)
+// Global function for the log task's weak linkage (see Logger)
+void broadcastDebugMessage(const char *message)
 {
     webServer.broadcastDebugMessage(message);
 }
@@ -59,6 +22,11 @@ WebServerClass::WebServerClass() : server(80), ws("/ws"), debugWs("/debug"), ini
     lastPositionBroadcast = 0;
     lastStatusBroadcast = 0;
     wasMovingLastUpdate = false;
+    lastLimitRecoveryPhase = 0;
+    lastTimerStepEngine = false;
+    debugMutex = xSemaphoreCreateMutexStatic(&debugMutexBuffer); // Static: usable before begin(), logging starts early
+    for (uint8_t i = 0; i < DEBUG_MAX_CLIENTS; i++)
+        debugClients[i].active = false;
 }
 
 bool WebServerClass::begin()
@@ -104,6 +72,7 @@ bool WebServerClass::begin()
     server.begin();
     LOG_INFO("Web server started. URLs: http://%s/ and http://%s.local/", WiFi.localIP().toString().c_str(), DEVICE_HOSTNAME);
 
+    lastTimerStepEngine = motorController.isTimerStepEngineActive();
     initialized = true;
     return true;
 }
@@ -143,6 +112,17 @@ void WebServerClass::setupRoutes()
         doc["maxLimit"] = config.getMaxLimit();
         doc["useStealthChop"] = config.getUseStealthChop();
         doc["freewheelAfterMove"] = config.getFreewheelAfterMove();
+        doc["useTimerStepEngine"] = config.getUseTimerStepEngine();
+        doc["maxJerk"] = config.getMaxJerk();
+        doc["followingErrorWindow"] = config.getFollowingErrorWindow();
+        doc["servoMode"] = config.getServoMode();
+        doc["stallThreshold"] = config.getStallThreshold();
+        doc["hardwareModeSwitch"] = config.getHardwareModeSwitch();
+        doc["modeHysteresis"] = config.getModeHysteresis();
+        doc["adaptiveMicrosteps"] = config.getAdaptiveMicrosteps();
+        doc["limitBackoff"] = config.getLimitBackoff();
+        doc["softLimits"] = config.getSoftLimits();
+        doc["softLimitZone"] = config.getSoftLimitZone();
 
         String response;
         serializeJson(doc, response);
@@ -224,7 +204,11 @@ void WebServerClass::handleMoveCommand(JsonDocument& doc)
         if (!motorController.isEmergencyStopActive())
         {
             LOG_INFO("Move command: position=%ld, speed=%d", position, speed);
-            motorController.moveTo(position, speed);
+            if (!motorController.moveTo(position, speed, CommandSource::Network))
+            {
+                ws.textAll("{\"type\":\"error\",\"message\":\"Motor busy, command dropped\"}");
+                return;
+            }
 
             // Immediate status broadcast on movement start
             broadcastStatus();
@@ -245,6 +229,40 @@ void WebServerClass::handleMoveCommand(JsonDocument& doc)
     }
 }
 
+void WebServerClass::handleQueueMoveCommand(JsonDocument& doc)
+{
+    bool hasPosition = doc["position"].is<long>();
+    bool hasSpeed = doc["speed"].is<int>() || doc["speed"].is<float>() || doc["speed"].is<double>();
+
+    if (!hasPosition || !hasSpeed)
+    {
+        LOG_WARN("Invalid queueMove command - position: %s, speed: %s",
+                 hasPosition ? "ok" : "missing",
+                 hasSpeed ? "ok" : "missing");
+        ws.textAll("{\"type\":\"error\",\"message\":\"Invalid move parameters\"}");
+        return;
+    }
+
+    if (motorController.isEmergencyStopActive())
+    {
+        ws.textAll("{\"error\":\"limit switch triggered\"}");
+        return;
+    }
+
+    long position = doc["position"];
+    int speed = doc["speed"].as<int>();
+    if (!motorController.queueMove(position, speed, CommandSource::Network))
+    {
+        ws.textAll("{\"type\":\"error\",\"message\":\"Motion queue full\"}");
+        return;
+    }
+
+    // Status carries the new queue depth
+    broadcastStatus();
+    lastPositionBroadcast = millis();
+    lastStatusBroadcast = millis();
+}
+
 void WebServerClass::handleJogStartCommand(JsonDocument& doc)
 {
     bool hasDirection = doc["direction"].is<const char *>() || doc["direction"].is<String>();
@@ -260,13 +278,13 @@ void WebServerClass::handleJogStartCommand(JsonDocument& doc)
             if (direction == "forward")
             {
                 long targetPosition = config.getMaxLimit();
-                motorController.moveTo(targetPosition, jogSpeed);
+                motorController.moveTo(targetPosition, jogSpeed, CommandSource::Network);
                 LOG_INFO("Jog started: forward to %ld at speed %d", targetPosition, jogSpeed);
             }
             else if (direction == "backward")
             {
                 long targetPosition = config.getMinLimit();
-                motorController.moveTo(targetPosition, jogSpeed);
+                motorController.moveTo(targetPosition, jogSpeed, CommandSource::Network);
                 LOG_INFO("Jog started: backward to %ld at speed %d", targetPosition, jogSpeed);
             }
 
@@ -290,7 +308,7 @@ void WebServerClass::handleJogStartCommand(JsonDocument& doc)
 
 void WebServerClass::handleJogStopCommand(JsonDocument& doc)
 {
-    motorController.jogStop();
+    motorController.jogStop(CommandSource::Network);
     LOG_INFO("Jog stopped");
     broadcastStatus();
 }
@@ -304,9 +322,7 @@ void WebServerClass::handleEmergencyStopCommand(JsonDocument& doc)
 
 void WebServerClass::handleResetCommand(JsonDocument& doc)
 {
-    minLimitSwitch.clearTrigger();
-    maxLimitSwitch.clearTrigger();
-    motorController.clearEmergencyStop();
+    motorController.clearEmergencyStop(CommandSource::Network); // Also re-arms the limit switches
     LOG_INFO("System reset");
     broadcastStatus();
 }
@@ -321,6 +337,80 @@ void WebServerClass::handleGetConfigCommand(JsonDocument& doc)
     broadcastConfig();
 }
 
+void WebServerClass::handleGetInputStatsCommand(JsonDocument& doc)
+{
+    // Latency per InputTask consumer: ISR post (or due time) to the consumer running
+    InputSourceStats stats[InputScheduler::MAX_CONSUMERS];
+    uint8_t count = readInputStats(stats, InputScheduler::MAX_CONSUMERS);
+
+    JsonDocument reply;
+    reply["type"] = "inputStats";
+    JsonArray sources = reply["sources"].to<JsonArray>();
+    for (uint8_t i = 0; i < count; i++)
+    {
+        JsonObject source = sources.add<JsonObject>();
+        source["name"] = stats[i].name;
+        source["runs"] = stats[i].runs;
+        source["meanUs"] = stats[i].meanUs;
+        source["maxUs"] = stats[i].maxUs;
+    }
+
+    String message;
+    serializeJson(reply, message);
+    ws.textAll(message);
+}
+
+void WebServerClass::handleSetLogLevelCommand(JsonDocument& doc)
+{
+    // Not persisted: every module is back at LOG_LEVEL after a reboot
+    String moduleName = doc["module"].as<String>();
+    String levelName = doc["level"].as<String>();
+    uint8_t level;
+    if (!logLevelFromName(levelName.c_str(), level))
+    {
+        ws.textAll("{\"type\":\"error\",\"message\":\"Unknown log level\"}");
+        return;
+    }
+
+    LogModule module;
+    if (moduleName == "all")
+    {
+        for (uint8_t i = 0; i < LOG_MODULE_COUNT; i++)
+            logger.setLevel((LogModule)i, level);
+    }
+    else if (logModuleFromName(moduleName.c_str(), module))
+    {
+        level = logger.setLevel(module, level);
+    }
+    else
+    {
+        ws.textAll("{\"type\":\"error\",\"message\":\"Unknown log module\"}");
+        return;
+    }
+
+    LOG_INFO("Log level for %s set to %s", moduleName.c_str(), logLevelName(level));
+    handleGetLogLevelsCommand(doc);
+}
+
+void WebServerClass::handleGetLogLevelsCommand(JsonDocument& doc)
+{
+    // Runtime level and compile-time ceiling per module
+    JsonDocument reply;
+    reply["type"] = "logLevels";
+    JsonObject levels = reply["levels"].to<JsonObject>();
+    JsonObject max = reply["max"].to<JsonObject>();
+    for (uint8_t i = 0; i < LOG_MODULE_COUNT; i++)
+    {
+        LogModule module = (LogModule)i;
+        levels[logModuleName(module)] = logLevelName(logger.getLevel(module));
+        max[logModuleName(module)] = logLevelName(logMaxLevel(module));
+    }
+
+    String message;
+    serializeJson(reply, message);
+    ws.textAll(message);
+}
+
 void WebServerClass::handleSetConfigCommand(JsonDocument& doc)
 {
     bool updated = false;
@@ -328,14 +418,14 @@ void WebServerClass::handleSetConfigCommand(JsonDocument& doc)
     if (doc["maxSpeed"].is<long>())
     {
         config.setMaxSpeed(doc["maxSpeed"]);
-        motorController.setMaxSpeed(doc["maxSpeed"]);
+        motorController.setMaxSpeed(doc["maxSpeed"], CommandSource::Network);
         updated = true;
     }
 
     if (doc["acceleration"].is<long>())
     {
         config.setAcceleration(doc["acceleration"]);
-        motorController.setAcceleration(doc["acceleration"]);
+        motorController.setAcceleration(doc["acceleration"], CommandSource::Network);
         updated = true;
     }
 
@@ -354,7 +444,7 @@ void WebServerClass::handleSetConfigCommand(JsonDocument& doc)
     if (doc["useStealthChop"].is<bool>())
     {
         config.setUseStealthChop(doc["useStealthChop"]);
-        motorController.setTMCMode(doc["useStealthChop"]);
+        motorController.setTMCMode(doc["useStealthChop"], CommandSource::Network);
         updated = true;
     }
 
@@ -364,6 +454,85 @@ void WebServerClass::handleSetConfigCommand(JsonDocument& doc)
         updated = true;
     }
 
+    if (doc["maxJerk"].is<long>())
+    {
+        config.setMaxJerk(doc["maxJerk"]);
+        motorController.setMaxJerk(doc["maxJerk"], CommandSource::Network);
+        updated = true;
+    }
+
+    if (doc["followingErrorWindow"].is<long>())
+    {
+        config.setFollowingErrorWindow(doc["followingErrorWindow"]);
+        motorController.setFollowingErrorWindow(doc["followingErrorWindow"], CommandSource::Network);
+        updated = true;
+    }
+
+    if (doc["servoMode"].is<bool>())
+    {
+        config.setServoMode(doc["servoMode"]);
+        motorController.setServoMode(doc["servoMode"], CommandSource::Network);
+        updated = true;
+    }
+
+    if (doc["stallThreshold"].is<long>())
+    {
+        config.setStallThreshold(doc["stallThreshold"]);
+        motorController.setStallThreshold(config.getStallThreshold(), CommandSource::Network);
+        updated = true;
+    }
+
+    if (doc["hardwareModeSwitch"].is<bool>())
+    {
+        // Applies at next boot
+        config.setHardwareModeSwitch(doc["hardwareModeSwitch"]);
+        updated = true;
+    }
+
+    if (doc["modeHysteresis"].is<long>())
+    {
+        config.setModeHysteresis(doc["modeHysteresis"]);
+        motorController.setModeHysteresis(config.getModeHysteresis(), CommandSource::Network);
+        updated = true;
+    }
+
+    if (doc["adaptiveMicrosteps"].is<bool>())
+    {
+        config.setAdaptiveMicrosteps(doc["adaptiveMicrosteps"]);
+        motorController.setAdaptiveMicrosteps(doc["adaptiveMicrosteps"], CommandSource::Network);
+        updated = true;
+    }
+
+    if (doc["limitBackoff"].is<long>())
+    {
+        config.setLimitBackoff(doc["limitBackoff"]);
+        motorController.setLimitBackoff(config.getLimitBackoff(), CommandSource::Network);
+        updated = true;
+    }
+
+    if (doc["softLimits"].is<bool>())
+    {
+        config.setSoftLimits(doc["softLimits"]);
+        motorController.setSoftLimits(config.getSoftLimits(), CommandSource::Network);
+        updated = true;
+    }
+
+    if (doc["softLimitZone"].is<long>())
+    {
+        config.setSoftLimitZone(doc["softLimitZone"]);
+        motorController.setSoftLimitZone(config.getSoftLimitZone(), CommandSource::Network);
+        updated = true;
+    }
+
+    if (doc["useTimerStepEngine"].is<bool>())
+    {
+        // The motor loop saves it once switched (only while stopped); update() reports the change
+        if (motorController.setTimerStepEngine(doc["useTimerStepEngine"], CommandSource::Network))
+            updated = true;
+        else
+            ws.textAll("{\"type\":\"error\",\"message\":\"Command queue full: step engine not switched\"}");
+    }
+
     if (updated)
     {
         config.saveConfiguration();
@@ -376,6 +545,48 @@ void WebServerClass::handleSetConfigCommand(JsonDocument& doc)
     }
 }
 
+void WebServerClass::handleCalibrateEncoderCommand(JsonDocument& doc)
+{
+    // Sweeps one revolution from the current position; status reports encoderCalibrating until done
+    if (!motorController.requestEncoderCalibration())
+    {
+        ws.textAll("{\"type\":\"error\",\"message\":\"Cannot calibrate: motor moving or emergency stop active\"}");
+        return;
+    }
+    LOG_INFO("Encoder calibration requested");
+    broadcastStatus();
+}
+
+void WebServerClass::handleHomeCommand(JsonDocument& doc)
+{
+    String direction = doc["direction"].as<String>();
+    int8_t towards = 0;
+    if (direction == "min")
+        towards = -1;
+    else if (direction == "max")
+        towards = 1;
+    if (towards == 0)
+    {
+        ws.textAll("{\"type\":\"error\",\"message\":\"Invalid home direction\"}");
+        return;
+    }
+    if (motorController.isEmergencyStopActive())
+    {
+        ws.textAll("{\"type\":\"error\",\"message\":\"Cannot home: emergency stop active\"}");
+        return;
+    }
+
+    // Optional travel limit for the fast approach (0 = default, 10 turns)
+    long maxTravel = doc["maxTravel"].is<long>() ? doc["maxTravel"].as<long>() : 0;
+    if (!motorController.home(towards, maxTravel, CommandSource::Network))
+    {
+        ws.textAll("{\"type\":\"error\",\"message\":\"Motor busy, command dropped\"}");
+        return;
+    }
+    LOG_INFO("Sensorless homing requested towards %s", direction.c_str());
+    broadcastStatus();
+}
+
 void WebServerClass::handleWebSocketMessage(void *arg, uint8_t *data, size_t len)
 {
     AwsFrameInfo *info = (AwsFrameInfo *)arg;
@@ -418,6 +629,10 @@ void WebServerClass::handleWebSocketMessage(void *arg, uint8_t *data, size_t len
         {
             handleMoveCommand(doc);
         }
+        else if (command == "queueMove")
+        {
+            handleQueueMoveCommand(doc);
+        }
         else if (command == "jogStart")
         {
             handleJogStartCommand(doc);
@@ -446,6 +661,26 @@ void WebServerClass::handleWebSocketMessage(void *arg, uint8_t *data, size_t len
         {
             handleSetConfigCommand(doc);
         }
+        else if (command == "calibrateEncoder")
+        {
+            handleCalibrateEncoderCommand(doc);
+        }
+        else if (command == "home")
+        {
+            handleHomeCommand(doc);
+        }
+        else if (command == "getInputStats")
+        {
+            handleGetInputStatsCommand(doc);
+        }
+        else if (command == "setLogLevel")
+        {
+            handleSetLogLevelCommand(doc);
+        }
+        else if (command == "getLogLevels")
+        {
+            handleGetLogLevelsCommand(doc);
+        }
         else
         {
             LOG_WARN("Unknown WebSocket command: %s", command.c_str());
@@ -454,15 +689,30 @@ void WebServerClass::handleWebSocketMessage(void *arg, uint8_t *data, size_t len
     }
 }
 
+// Fields shared by /api/status and the status broadcast, all from one snapshot
+void WebServerClass::addMotorState(JsonDocument &doc, const MotorStateSnapshot &state)
+{
+    bool limitMin = state.has(MotorStateSnapshot::LIMIT_MIN);
+    bool limitMax = state.has(MotorStateSnapshot::LIMIT_MAX);
+    doc["position"] = state.position;
+    doc["isMoving"] = state.has(MotorStateSnapshot::MOVING);
+    doc["emergencyStop"] = state.has(MotorStateSnapshot::EMERGENCY_STOP);
+    doc["limitSwitches"]["min"] = limitMin;
+    doc["limitSwitches"]["max"] = limitMax;
+    doc["limitSwitches"]["any"] = limitMin || limitMax;
+}
+
 void WebServerClass::handleAPI(AsyncWebServerRequest *request)
 {
+    MotorStateSnapshot state;
+    if (!motorController.getState(state))
+    {
+        request->send(503, "application/json", "{\"error\":\"Motor not running yet\"}");
+        return;
+    }
+
     JsonDocument doc;
-    doc["position"] = motorController.getCurrentPosition();
-    doc["isMoving"] = motorController.isMoving();
-    doc["emergencyStop"] = motorController.isEmergencyStopActive();
-    doc["limitSwitches"]["min"] = minLimitSwitch.isTriggered();
-    doc["limitSwitches"]["max"] = maxLimitSwitch.isTriggered();
-    doc["limitSwitches"]["any"] = minLimitSwitch.isTriggered() || maxLimitSwitch.isTriggered();
+    addMotorState(doc, state);
 
     String response;
     serializeJson(doc, response);
@@ -478,14 +728,36 @@ void WebServerClass::broadcastStatus()
     if (!initialized)
         return;
 
+    MotorStateSnapshot state;
+    if (!motorController.getState(state))
+        return;
+
     JsonDocument doc;
     doc["type"] = "status";
-    doc["position"] = motorController.getCurrentPosition();
-    doc["isMoving"] = motorController.isMoving();
-    doc["emergencyStop"] = motorController.isEmergencyStopActive();
-    doc["limitSwitches"]["min"] = minLimitSwitch.isTriggered();
-    doc["limitSwitches"]["max"] = maxLimitSwitch.isTriggered();
-    doc["limitSwitches"]["any"] = minLimitSwitch.isTriggered() || maxLimitSwitch.isTriggered();
+    addMotorState(doc, state);
+    doc["target"] = state.target;
+    doc["queueDepth"] = state.queueDepth;
+    doc["queueFree"] = state.queueFree;
+    doc["followingError"] = motorController.getFollowingError();
+    doc["followingErrorFault"] = motorController.isFollowingErrorFault();
+    doc["runCurrentPercent"] = motorController.getRunCurrentPercent();
+    doc["servoCorrections"] = motorController.getServoCorrectionCount();
+    doc["encoderSpeed"] = motorController.getMonitorSpeed(); // deg/s from the velocity observer
+    doc["encoderAngle"] = state.encoderAngle;
+    doc["positionRestored"] = state.has(MotorStateSnapshot::POSITION_RESTORED);
+    doc["encoderCalibrated"] = state.has(MotorStateSnapshot::ENCODER_CALIBRATED);
+    doc["encoderCalibrating"] = state.has(MotorStateSnapshot::CALIBRATING);
+    doc["homing"] = state.has(MotorStateSnapshot::HOMING);
+    doc["stealthChop"] = state.has(MotorStateSnapshot::STEALTH_CHOP); // Driver's actual chopper mode
+    doc["microsteps"] = state.microsteps;
+    doc["limitRecovery"] = motorController.getLimitRecoveryState();
+    // Worst trip latencies since boot, µs from the switch interrupt
+    doc["limitStopUs"] = max(minLimitSwitch.getLatency().maxStopUs, maxLimitSwitch.getLatency().maxStopUs);
+    doc["limitHandledUs"] = max(minLimitSwitch.getLatency().maxHandledUs, maxLimitSwitch.getLatency().maxHandledUs);
+    doc["limitGlitches"] = minLimitSwitch.getGlitchCount() + maxLimitSwitch.getGlitchCount();
+    doc["logDropped"] = logger.getDroppedCount();
+    if (motorController.getLimitRecoveryPhase() == LimitRecovery::Phase::Failed)
+        doc["limitRecoveryFailure"] = motorController.getLimitRecoveryFailure();
 
     String message;
     serializeJson(doc, message);
@@ -509,6 +781,17 @@ void WebServerClass::broadcastConfig()
     doc["maxLimit"] = config.getMaxLimit();
     doc["useStealthChop"] = config.getUseStealthChop();
     doc["freewheelAfterMove"] = config.getFreewheelAfterMove();
+    doc["useTimerStepEngine"] = config.getUseTimerStepEngine();
+    doc["maxJerk"] = config.getMaxJerk();
+    doc["followingErrorWindow"] = config.getFollowingErrorWindow();
+    doc["servoMode"] = config.getServoMode();
+    doc["stallThreshold"] = config.getStallThreshold();
+    doc["hardwareModeSwitch"] = config.getHardwareModeSwitch();
+    doc["modeHysteresis"] = config.getModeHysteresis();
+    doc["adaptiveMicrosteps"] = config.getAdaptiveMicrosteps();
+    doc["limitBackoff"] = config.getLimitBackoff();
+    doc["softLimits"] = config.getSoftLimits();
+    doc["softLimitZone"] = config.getSoftLimitZone();
 
     String message;
     serializeJson(doc, message);
@@ -543,10 +826,42 @@ void WebServerClass::onDebugWebSocketEvent(AsyncWebSocket *server, AsyncWebSocke
     switch (type)
     {
     case WS_EVT_CONNECT:
+    {
+        // /debug?since=N resumes at line N; without it the client gets all history
+        AsyncWebServerRequest *request = (AsyncWebServerRequest *)arg;
+        bool resume = request && request->hasParam("since");
+        uint32_t since = resume ? strtoul(request->getParam("since")->value().c_str(), nullptr, 10) : 0;
+
+        bool registered = false;
+        xSemaphoreTake(debugMutex, portMAX_DELAY);
+        for (uint8_t i = 0; i < DEBUG_MAX_CLIENTS; i++)
+        {
+            if (debugClients[i].active)
+                continue;
+            debugClients[i] = {client->id(), resume ? debugHistory.seek(since) : debugHistory.oldest(), true};
+            registered = true;
+            break;
+        }
+        xSemaphoreGive(debugMutex);
+
+        if (!registered)
+        {
+            LOG_WARN("Debug WebSocket client #%u rejected: %u clients connected", client->id(), DEBUG_MAX_CLIENTS);
+            client->close();
+            break;
+        }
         LOG_INFO("Debug WebSocket client #%u connected from %s", client->id(), client->remoteIP().toString().c_str());
         break;
+    }
 
     case WS_EVT_DISCONNECT:
+        xSemaphoreTake(debugMutex, portMAX_DELAY);
+        for (uint8_t i = 0; i < DEBUG_MAX_CLIENTS; i++)
+        {
+            if (debugClients[i].active && debugClients[i].id == client->id())
+                debugClients[i].active = false;
+        }
+        xSemaphoreGive(debugMutex);
         LOG_INFO("Debug WebSocket client #%u disconnected", client->id());
         break;
 
@@ -560,15 +875,37 @@ void WebServerClass::onDebugWebSocketEvent(AsyncWebSocket *server, AsyncWebSocke
     }
 }
 
-void WebServerClass::broadcastDebugMessage(const String &message)
+void WebServerClass::broadcastDebugMessage(const char *message)
 {
-    // Skip circular buffer entirely to prevent flooding
-    // debugBuffer.add(message);
+    // Log task: store only. sendDebugHistory() delivers it from the web server
+    // task, so live lines and replay share one path and one sequence.
+    xSemaphoreTake(debugMutex, portMAX_DELAY);
+    debugHistory.add(message);
+    xSemaphoreGive(debugMutex);
+}
 
-    // Simple real-time broadcast only
-    if (debugWs.count() > 0)
+void WebServerClass::sendDebugHistory()
+{
+    for (uint8_t i = 0; i < DEBUG_MAX_CLIENTS; i++)
     {
-        debugWs.textAll(message);
+        DebugClient &slot = debugClients[i];
+        if (!slot.active)
+            continue;
+
+        AsyncWebSocketClient *client = debugWs.client(slot.id);
+        if (!client)
+            continue; // Disconnect event pending
+
+        // Rate limit: a few frames per update, none while the client is backed up
+        for (uint8_t frame = 0; frame < DEBUG_FRAMES_PER_UPDATE && client->canSend(); frame++)
+        {
+            xSemaphoreTake(debugMutex, portMAX_DELAY);
+            size_t length = slot.active ? debugHistory.readFrame(slot.cursor, debugFrame, sizeof(debugFrame)) : 0;
+            xSemaphoreGive(debugMutex);
+            if (length == 0)
+                break;
+            client->text(debugFrame, length);
+        }
     }
 }
 
@@ -583,10 +920,31 @@ void WebServerClass::update()
     // Cleanup disconnected WebSocket clients
     ws.cleanupClients();
     debugWs.cleanupClients();
+    sendDebugHistory();
+
+    // Limit recovery runs on the motor loop: report each step of it from here
+    uint8_t limitRecoveryPhase = (uint8_t)motorController.getLimitRecoveryPhase();
+    if (limitRecoveryPhase != lastLimitRecoveryPhase)
+    {
+        lastLimitRecoveryPhase = limitRecoveryPhase;
+        broadcastStatus();
+    }
+
+    // So is a step engine switch: the config clients see follows the engine running
+    bool timerStepEngine = motorController.isTimerStepEngineActive();
+    if (timerStepEngine != lastTimerStepEngine)
+    {
+        lastTimerStepEngine = timerStepEngine;
+        broadcastConfig();
+    }
+
+    MotorStateSnapshot state;
+    if (!motorController.getState(state))
+        return; // Motor loop not running yet
 
     // Automatic status broadcasting during movement
     // Only broadcast if actually moving (not stopped by emergency stop)
-    bool isCurrentlyMoving = motorController.isMoving() && !motorController.isEmergencyStopActive();
+    bool isCurrentlyMoving = state.has(MotorStateSnapshot::MOVING) && !state.has(MotorStateSnapshot::EMERGENCY_STOP);
     unsigned long currentMillis = millis();
 
     if (isCurrentlyMoving)
@@ -594,8 +952,8 @@ void WebServerClass::update()
         // Send position updates every 100ms during movement
         if (currentMillis - lastPositionBroadcast >= POSITION_BROADCAST_INTERVAL_MS)
         {
-            LOG_DEBUG("Broadcasting position update: %ld", motorController.getCurrentPosition());
-            broadcastPosition(motorController.getCurrentPosition());
+            LOG_DEBUG("Broadcasting position update: %ld", (long)state.position);
+            broadcastPosition(state.position);
             lastPositionBroadcast = currentMillis;
         }
 
@@ -7,27 +7,18 @@
 #include <ElegantOTA.h>
 #include <ArduinoJson.h>
 #include <mdns.h>
-
-// Simple circular buffer for debug messages
-#define DEBUG_BUFFER_SIZE 100
+#include "../MotorController/MotorState.h"
+#include "DebugHistory.h"
 
 // Broadcast timing intervals (milliseconds)
 #define POSITION_BROADCAST_INTERVAL_MS 100
 #define STATUS_BROADCAST_INTERVAL_MS 500
 
-class DebugBuffer {
-private:
-    String buffer[DEBUG_BUFFER_SIZE];
-    int head;
-    int tail;
-    bool full;
-
-public:
-    DebugBuffer();
-    void add(const String& message);
-    void sendHistoryTo(AsyncWebSocketClient* client);
-    bool isEmpty() const;
-};
+// /debug replay: frames of at most DEBUG_FRAME_SIZE bytes, DEBUG_FRAMES_PER_UPDATE
+// per client per update(), and only while the client's send queue has room
+#define DEBUG_MAX_CLIENTS 4
+#define DEBUG_FRAME_SIZE 2048
+#define DEBUG_FRAMES_PER_UPDATE 2
 
 class WebServerClass
 {
@@ -37,12 +28,28 @@ private:
     AsyncWebSocket debugWs;      // Debug WebSocket at /debug
     WiFiManager wm;
     bool initialized;
-    DebugBuffer debugBuffer;
+
+    // Debug history, shared by the log task (add) and the web server task (replay).
+    // Both sides are tasks and a frame takes a while to encode, so a mutex rather
+    // than a spinlock: interrupts stay enabled and the other core never spins.
+    struct DebugClient
+    {
+        uint32_t id;
+        DebugHistory::Cursor cursor; // Next line this client gets
+        bool active;
+    };
+    DebugHistory debugHistory;
+    DebugClient debugClients[DEBUG_MAX_CLIENTS];
+    char debugFrame[DEBUG_FRAME_SIZE];
+    StaticSemaphore_t debugMutexBuffer;
+    SemaphoreHandle_t debugMutex;
 
     // Broadcast timing state
     unsigned long lastPositionBroadcast;
     unsigned long lastStatusBroadcast;
     bool wasMovingLastUpdate;
+    uint8_t lastLimitRecoveryPhase; // LimitRecovery::Phase, broadcast on every change
+    bool lastTimerStepEngine;       // Config re-broadcast once the motor loop switches engines
 
     // WebSocket handlers
     void handleWebSocketMessage(void *arg, uint8_t *data, size_t len);
@@ -51,6 +58,7 @@ private:
 
     // Command handlers (dispatch table pattern)
     void handleMoveCommand(JsonDocument& doc);
+    void handleQueueMoveCommand(JsonDocument& doc);
     void handleJogStartCommand(JsonDocument& doc);
     void handleJogStopCommand(JsonDocument& doc);
     void handleEmergencyStopCommand(JsonDocument& doc);
@@ -58,14 +66,21 @@ private:
     void handleStatusCommand(JsonDocument& doc);
     void handleGetConfigCommand(JsonDocument& doc);
     void handleSetConfigCommand(JsonDocument& doc);
+    void handleCalibrateEncoderCommand(JsonDocument& doc);
+    void handleHomeCommand(JsonDocument& doc);
+    void handleGetInputStatsCommand(JsonDocument& doc);
+    void handleSetLogLevelCommand(JsonDocument& doc);
+    void handleGetLogLevelsCommand(JsonDocument& doc);
 
     // Debug WebSocket handlers
     void onDebugWebSocketEvent(AsyncWebSocket *server, AsyncWebSocketClient *client,
                                AwsEventType type, void *arg, uint8_t *data, size_t len);
+    void sendDebugHistory();
 
     // HTTP handlers
     void handleRoot(AsyncWebServerRequest *request);
     void handleAPI(AsyncWebServerRequest *request);
+    void addMotorState(JsonDocument &doc, const MotorStateSnapshot &state);
 
     // Configuration
     void setupRoutes();
@@ -81,10 +96,10 @@ public:
     void broadcastStatus();
     void broadcastConfig();
     void broadcastPosition(long position);
-    void broadcastDebugMessage(const String& message);
+    void broadcastDebugMessage(const char *message);
 };
 
 extern WebServerClass webServer;
 
-// Global function for util.cpp weak linkage
-void broadcastDebugMessage(const String& message);
\ No newline at end of file
+// Global function for the log task's weak linkage (see Logger)
+void broadcastDebugMessage(const char *message);
\ No newline at end of file
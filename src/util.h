@@ -1,33 +1,32 @@
 #ifndef UTIL_H
 #define UTIL_H
 #include <Arduino.h>
+#include "modules/Logger/Logger.h"
 
 // Device naming configuration
 #define DEVICE_NAME "LilyGo-MotionController"
 #define DEVICE_HOSTNAME "lilygo-motioncontroller"
 
-// Log levels
-typedef enum {
-    LOG_LEVEL_ERROR = 0,
-    LOG_LEVEL_WARN = 1,
-    LOG_LEVEL_INFO = 2,
-    LOG_LEVEL_DEBUG = 3
-} log_level_t;
+// Log levels, modules and their build flags are in modules/Logger/LogModules.h
 
-// Default log level (can be overridden with build flags)
-#ifndef LOG_LEVEL
-#define LOG_LEVEL LOG_LEVEL_INFO
-#endif
+// Logging macros: captured into the log ring and formatted later by the log
+// task (see Logger). Formats and function names must be static; %s strings are copied.
+// Each call checks its file's logModule: above the module's compile-time ceiling
+// the call compiles out, arguments and all; below it, one load of the module's
+// runtime level decides before any argument is evaluated.
+#define LOG_ERROR(fmt, ...) LOG_AT(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...)  LOG_AT(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...)  LOG_AT(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
 
-// Logging macros
-#define LOG_ERROR(fmt, ...) logPrint(LOG_LEVEL_ERROR, __func__, fmt, ##__VA_ARGS__)
-#define LOG_WARN(fmt, ...)  logPrint(LOG_LEVEL_WARN, __func__, fmt, ##__VA_ARGS__)
-#define LOG_INFO(fmt, ...)  logPrint(LOG_LEVEL_INFO, __func__, fmt, ##__VA_ARGS__)
-#define LOG_DEBUG(fmt, ...) logPrint(LOG_LEVEL_DEBUG, __func__, fmt, ##__VA_ARGS__)
+#define LOG_AT(level, fmt, ...)                                                      \
+    do                                                                               \
+    {                                                                                \
+        if ((level) <= logMaxLevel(logModule) && logger.isEnabled(logModule, level)) \
+            logger.log(level, __func__, fmt, ##__VA_ARGS__);                         \
+    } while (0)
 
 // Functions
-std::string timeToString();
 float fmap(float x, float a, float b, float c, float d);
-void logPrint(log_level_t level, const char* function, const char* format, ...);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <chrono>
+
+#include "../../../src/MpscQueue.h"
+#include "../../../src/modules/Logger/LogRecord.cpp"
+
+// Benchmark: cost of a LOG_* call on the calling task, deferred capture vs the
+// synchronous vsnprintf formatting it replaced (Serial and WebSocket output not
+// included, which made the old path far slower still)
+// Run with: pio test -e native-bench -v
+
+static constexpr uint32_t CALLS = 1000000;
+static MpscQueue<LogRecord, 128> ring;
+static volatile size_t sink;
+
+template <typename... Args>
+static bool capture(const char *function, const char *format, Args... args)
+{
+    return ring.emplace([&](LogRecord &record) {
+        record.begin(2, function, format, 0);
+        record.capture(args...);
+    });
+}
+
+static void formatNow(const char *function, const char *format, ...)
+{
+    // What logPrint() used to do before returning
+    char message[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    char line[512];
+    sink = snprintf(line, sizeof(line), "[%s] [%s] [%s]: %s", "00:00:00.000", "INFO", function, message);
+}
+
+void test_benchmark_log_call_cost(void) {
+    const LogRecord *record;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < CALLS; i++)
+    {
+        capture(__func__, "Moving to position %ld at speed %d", (long)i, 8000);
+        ring.pop(); // Keep the ring from filling; the sink's side of the cost
+    }
+    double captureNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CALLS;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < CALLS; i++)
+        formatNow(__func__, "Moving to position %ld at speed %d", (long)i, 8000);
+    double formatNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CALLS;
+
+    char line[384];
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < CALLS / 10; i++)
+    {
+        capture(__func__, "Moving to position %ld at speed %d", (long)i, 8000);
+        record = ring.front();
+        sink = record->formatLine(line, sizeof(line));
+        ring.pop();
+    }
+    double sinkNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (CALLS / 10);
+
+    printf("\n%-28s %10s\n", "path", "ns/call");
+    printf("%-28s %10.1f\n", "capture (caller)", captureNs);
+    printf("%-28s %10.1f\n", "capture + format (sink)", sinkNs);
+    printf("%-28s %10.1f\n", "vsnprintf (old caller)", formatNs);
+
+    TEST_ASSERT_TRUE(captureNs < formatNs);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_benchmark_log_call_cost);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
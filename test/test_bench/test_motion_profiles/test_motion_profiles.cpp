@@ -0,0 +1,103 @@
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+
+#include "../../../src/modules/StepGenerator/RampGenerator.cpp"
+#include "../../../src/modules/StepGenerator/SCurveProfile.cpp"
+#include "../../test_native/test_scurve_profile/motion_metrics.h"
+
+// Benchmark: trapezoid (RampGenerator) vs jerk-limited S-curve for the same move
+// Run with: pio test -e native-bench -v
+
+static constexpr float MAX_SPEED = 180 * 80;
+static constexpr float ACCELERATION = 1000 * 80;
+
+// Wall-clock planning cost per step on the host (ns)
+static double nsPerStep(StepSource &source)
+{
+    auto start = std::chrono::steady_clock::now();
+    int8_t direction;
+    uint32_t steps = 0;
+    volatile uint32_t sink = 0;
+    uint32_t interval;
+    while ((interval = source.nextStep(direction)) != 0)
+    {
+        sink += interval;
+        steps++;
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return steps ? elapsed / steps : 0;
+}
+
+void test_benchmark_trapezoid_vs_scurve(void) {
+    const long distances[] = {200, 2000, 20000, 100000};
+    const float jerkTimes[] = {0.02f, 0.05f, 0.1f}; // seconds to reach full acceleration
+
+    printf("\n%9s %8s | %10s %12s | %10s %12s %8s\n",
+           "distance", "a/j (ms)", "trap (ms)", "trap jerk", "scurve(ms)", "scurve jerk", "penalty");
+
+    for (long distance : distances)
+    {
+        RampGenerator ramp;
+        ramp.setMaxSpeed(MAX_SPEED);
+        ramp.setAcceleration(ACCELERATION);
+        ramp.moveTo(distance);
+        MotionMetrics trapezoid = measureMotion(ramp);
+
+        for (float jerkTime : jerkTimes)
+        {
+            SCurveProfile profile;
+            profile.plan(0, distance, MAX_SPEED, ACCELERATION, ACCELERATION / jerkTime);
+            MotionMetrics scurve = measureMotion(profile);
+
+            printf("%9ld %8.0f | %10.1f %12.3g | %10.1f %12.3g %7.1f%%\n",
+                   distance, jerkTime * 1000,
+                   trapezoid.moveTime * 1000, trapezoid.peakJerk,
+                   scurve.moveTime * 1000, scurve.peakJerk,
+                   100 * (scurve.moveTime - trapezoid.moveTime) / trapezoid.moveTime);
+
+            TEST_ASSERT_EQUAL_UINT32(distance, scurve.steps);
+            TEST_ASSERT_LESS_THAN_DOUBLE(trapezoid.peakJerk, scurve.peakJerk);
+        }
+    }
+}
+
+void test_benchmark_planning_cost(void) {
+    RampGenerator ramp;
+    ramp.setMaxSpeed(MAX_SPEED);
+    ramp.setAcceleration(ACCELERATION);
+    ramp.moveTo(1000000);
+
+    SCurveProfile profile;
+    profile.plan(0, 1000000, MAX_SPEED, ACCELERATION, ACCELERATION / 0.05f);
+
+    printf("\nPlanning cost per step (host): trapezoid %.1f ns, S-curve %.1f ns\n",
+           nsPerStep(ramp), nsPerStep(profile));
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_benchmark_trapezoid_vs_scurve);
+    RUN_TEST(test_benchmark_planning_cost);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
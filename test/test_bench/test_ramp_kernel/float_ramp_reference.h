@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+// The float ramp kernel RampGenerator used before the integer rewrite
+// (a straight port of AccelStepper::computeNewSpeed()), kept as the
+// reference the integer kernel is timed and compared against.
+class FloatRampReference
+{
+    long currentPos = 0;
+    long targetPos = 0;
+    float speed = 0;
+    float acceleration = 0;
+    float c0 = 0;
+    float cn = 0;
+    float cmin = 1000000.0f;
+    long n = 0;
+    uint32_t stepInterval = 0;
+    int8_t direction = 1;
+
+    void computeNewSpeed()
+    {
+        long distanceTo = targetPos - currentPos;
+        long stepsToStop = (long)((speed * speed) / (2.0f * acceleration));
+
+        if (distanceTo == 0 && stepsToStop <= 1)
+        {
+            stepInterval = 0;
+            speed = 0;
+            n = 0;
+            return;
+        }
+
+        long distanceAbs = distanceTo < 0 ? -distanceTo : distanceTo;
+        int8_t wanted = distanceTo > 0 ? 1 : -1;
+        if (n > 0)
+        {
+            if (stepsToStop >= distanceAbs || direction != wanted)
+                n = -stepsToStop;
+        }
+        else if (n < 0)
+        {
+            if (stepsToStop < distanceAbs && direction == wanted)
+                n = -n;
+        }
+
+        if (n == 0)
+        {
+            cn = c0;
+            direction = wanted;
+        }
+        else
+        {
+            cn = cn - ((2.0f * cn) / ((4.0f * n) + 1));
+            if (cn < cmin)
+                cn = cmin;
+        }
+        n++;
+
+        stepInterval = (uint32_t)cn;
+        if (stepInterval == 0)
+            stepInterval = 1;
+        speed = 1000000.0f / cn;
+        if (direction < 0)
+            speed = -speed;
+    }
+
+public:
+    void setMaxSpeed(float newSpeed) { cmin = 1000000.0f / newSpeed; }
+
+    void setAcceleration(float newAcceleration)
+    {
+        c0 = 0.676f * sqrtf(2.0f / newAcceleration) * 1000000.0f;
+        acceleration = newAcceleration;
+    }
+
+    void moveTo(long absolute)
+    {
+        targetPos = absolute;
+        computeNewSpeed();
+    }
+
+    uint32_t nextStep(int8_t &stepDirection)
+    {
+        if (stepInterval == 0)
+            return 0;
+
+        uint32_t interval = stepInterval;
+        stepDirection = direction;
+        currentPos += direction;
+        computeNewSpeed();
+        return interval;
+    }
+};
@@ -0,0 +1,151 @@
+#include <unity.h>
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLE_COUNTER 1
+#endif
+
+#include "../../../src/modules/StepGenerator/RampGenerator.cpp"
+#include "float_ramp_reference.h"
+
+// Benchmark: integer ramp kernel vs the float kernel it replaced
+// Run with: pio test -e native-bench -v
+// Host numbers say little about the target: x86 divides floats in hardware,
+// while the ESP32 FPU has no divide (three libgcc float divides per step in the
+// float kernel) and divides 32-bit integers natively.
+
+static constexpr uint32_t MAX_SPEED = 180 * 80;
+static constexpr uint32_t ACCELERATION = 1000 * 80;
+static constexpr long DISTANCE = 2000000;
+
+struct KernelCost
+{
+    uint32_t steps;
+    double nsPerStep;
+    double cyclesPerStep;
+    uint64_t totalUs;
+};
+
+template <typename Kernel>
+static KernelCost measure(Kernel &kernel)
+{
+    KernelCost cost = {0, 0, 0, 0};
+    int8_t direction;
+    uint32_t interval;
+
+    auto start = std::chrono::steady_clock::now();
+#ifdef HAVE_CYCLE_COUNTER
+    uint64_t startCycles = __rdtsc();
+#endif
+    while ((interval = kernel.nextStep(direction)) != 0)
+    {
+        cost.totalUs += interval;
+        cost.steps++;
+    }
+#ifdef HAVE_CYCLE_COUNTER
+    cost.cyclesPerStep = cost.steps ? (double)(__rdtsc() - startCycles) / cost.steps : 0;
+#endif
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    cost.nsPerStep = cost.steps ? elapsed / cost.steps : 0;
+    return cost;
+}
+
+void test_benchmark_per_step_cost(void) {
+    FloatRampReference reference;
+    reference.setMaxSpeed(MAX_SPEED);
+    reference.setAcceleration(ACCELERATION);
+    reference.moveTo(DISTANCE);
+    KernelCost floatCost = measure(reference);
+
+    RampGenerator ramp;
+    ramp.setMaxSpeed(MAX_SPEED);
+    ramp.setAcceleration(ACCELERATION);
+    ramp.moveTo(DISTANCE);
+    KernelCost intCost = measure(ramp);
+
+    printf("\n%-8s %10s %10s %12s %12s\n", "kernel", "steps", "ns/step", "cycles/step", "move (ms)");
+    printf("%-8s %10u %10.2f %12.1f %12.1f\n", "float", floatCost.steps, floatCost.nsPerStep,
+           floatCost.cyclesPerStep, floatCost.totalUs / 1000.0);
+    printf("%-8s %10u %10.2f %12.1f %12.1f\n", "integer", intCost.steps, intCost.nsPerStep,
+           intCost.cyclesPerStep, intCost.totalUs / 1000.0);
+
+    TEST_ASSERT_EQUAL_UINT32(DISTANCE, floatCost.steps);
+    TEST_ASSERT_EQUAL_UINT32(DISTANCE, intCost.steps);
+}
+
+void test_benchmark_profile_agreement(void) {
+    // Same move through both kernels: per-step intervals and move time should agree.
+    // The largest per-step gap is the last deceleration step, where the float
+    // kernel's truncated steps-to-stop ends the ramp early.
+    const long distances[] = {100, 1000, 10000, 100000};
+
+    printf("\n%9s | %12s %12s %12s | %14s\n", "distance", "float (ms)", "int (ms)", "ideal (ms)", "max diff (us)");
+
+    for (long distance : distances)
+    {
+        FloatRampReference reference;
+        reference.setMaxSpeed(MAX_SPEED);
+        reference.setAcceleration(ACCELERATION);
+        reference.moveTo(distance);
+
+        RampGenerator ramp;
+        ramp.setMaxSpeed(MAX_SPEED);
+        ramp.setAcceleration(ACCELERATION);
+        ramp.moveTo(distance);
+
+        int8_t direction;
+        uint64_t floatUs = 0, intUs = 0;
+        int32_t maxDiff = 0;
+        for (long i = 0; i < distance; i++)
+        {
+            uint32_t a = reference.nextStep(direction);
+            uint32_t b = ramp.nextStep(direction);
+            floatUs += a;
+            intUs += b;
+            // Skip the first steps, where the c0 approximation dominates
+            int32_t diff = (int32_t)a - (int32_t)b;
+            if (i > 10 && abs(diff) > maxDiff)
+                maxDiff = abs(diff);
+        }
+
+        double v = MAX_SPEED, a = ACCELERATION;
+        double ideal = distance >= v * v / a ? distance / v + v / a : 2 * sqrt(distance / a);
+
+        printf("%9ld | %12.2f %12.2f %12.2f | %14d\n", distance, floatUs / 1000.0, intUs / 1000.0,
+               ideal * 1000, maxDiff);
+
+        // The remainder carry keeps the integer kernel at least as close to the ideal ramp
+        double idealUs = ideal * 1e6;
+        TEST_ASSERT_DOUBLE_WITHIN(idealUs * 0.05, idealUs, (double)intUs);
+        TEST_ASSERT_TRUE(fabs(intUs - idealUs) <= fabs(floatUs - idealUs));
+    }
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_benchmark_per_step_cost);
+    RUN_TEST(test_benchmark_profile_agreement);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// The speed estimate VelocityObserver replaced: MotorController::calculateSpeed(ms),
+// called every 'ms' with the latest encoder angle. Kept verbatim for the benchmark.
+class FiniteDifferenceReference
+{
+    double lastLocation = 0;
+    int8_t direction = 1;
+
+public:
+    explicit FiniteDifferenceReference(double initial) : lastLocation(initial) {}
+
+    double calculateSpeed(double currentLocation, float ms)
+    {
+        double speedT = 0;
+
+        if (currentLocation == lastLocation)
+        {
+            speedT = direction = 0;
+        }
+        else
+        {
+            double tempT = abs(currentLocation - lastLocation);
+            if (tempT < 8192)
+            {
+                speedT = (tempT * 360) / 16384;
+                direction = currentLocation > lastLocation ? 1 : -1;
+            }
+            else
+            {
+                speedT = ((currentLocation > lastLocation ? 16384 - currentLocation + lastLocation : 16384 - lastLocation + currentLocation) * 360) / 16384;
+                direction = currentLocation > lastLocation ? -1 : 1;
+            }
+        }
+
+        speedT = direction * (speedT * ms / 1000);
+        lastLocation = currentLocation;
+        return speedT;
+    }
+
+    // calculateSpeed() returns degrees moved scaled by ms/1000; as degrees per second
+    static double toDegPerSec(double speedT, float ms) { return speedT * 1000.0 / ms * 1000.0 / ms; }
+};
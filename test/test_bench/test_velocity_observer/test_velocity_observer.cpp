@@ -0,0 +1,233 @@
+#include <unity.h>
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+
+#include "../../../src/modules/VelocityObserver/VelocityObserver.cpp"
+#include "finite_difference_reference.h"
+
+// Benchmark: VelocityObserver at the 2 kHz sample rate vs the 100 ms
+// finite difference it replaced, on simulated MT6816 readings
+// Run with: pio test -e native-bench -v
+
+static constexpr uint32_t SAMPLE_US = 500;
+static constexpr float LEGACY_MS = 100;
+static constexpr int LEGACY_EVERY = (int)(LEGACY_MS * 1000 / SAMPLE_US);
+static constexpr double DEG_PER_COUNT = 360.0 / VelocityObserver::COUNTS_PER_REV;
+
+// Deterministic gaussian noise (LCG + Box-Muller)
+static uint32_t seed = 12345;
+static double gaussian()
+{
+    seed = seed * 1664525u + 1013904223u;
+    double u1 = (seed + 1.0) / 4294967297.0;
+    seed = seed * 1664525u + 1013904223u;
+    double u2 = (seed + 1.0) / 4294967297.0;
+    return sqrt(-2.0 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+static uint16_t encoderReading(double position, double noiseCounts)
+{
+    long counts = (long)floor(position + noiseCounts * gaussian()) % VelocityObserver::COUNTS_PER_REV;
+    return (uint16_t)(counts < 0 ? counts + VelocityObserver::COUNTS_PER_REV : counts);
+}
+
+// Speed profile (counts/s) as a function of time; returns the true speed
+typedef double (*Profile)(double t, double &position);
+
+struct Estimate
+{
+    double observerRms; // deg/s, against the true speed at each evaluation
+    double legacyRms;
+    double observerMax;
+    double legacyMax;
+};
+
+// Run a profile through both estimators; errors are taken after 'settle' seconds
+static Estimate run(Profile profile, double seconds, double settle, double noiseCounts, float bandwidth)
+{
+    VelocityObserver observer;
+    observer.setBandwidth(bandwidth);
+    double position = 0;
+    profile(0, position);
+    FiniteDifferenceReference legacy(encoderReading(position, 0));
+
+    Estimate e = {0, 0, 0, 0};
+    int observerN = 0, legacyN = 0;
+    int samples = (int)(seconds * 1e6 / SAMPLE_US);
+    for (int i = 0; i <= samples; i++)
+    {
+        double t = i * SAMPLE_US * 1e-6;
+        double speed = profile(t, position) * DEG_PER_COUNT;
+        uint16_t raw = encoderReading(position, noiseCounts);
+        observer.update(raw, (uint32_t)(i * SAMPLE_US));
+        if (t < settle)
+        {
+            if (i % LEGACY_EVERY == 0)
+                legacy.calculateSpeed(raw, LEGACY_MS);
+            continue;
+        }
+
+        // Observer read at the InputTask rate, legacy at its own 100 ms rate
+        if (i % 20 == 0)
+        {
+            double err = observer.getVelocityDegPerSec() - speed;
+            e.observerRms += err * err;
+            e.observerMax = fmax(e.observerMax, fabs(err));
+            observerN++;
+        }
+        if (i % LEGACY_EVERY == 0)
+        {
+            double err = FiniteDifferenceReference::toDegPerSec(legacy.calculateSpeed(raw, LEGACY_MS), LEGACY_MS) - speed;
+            e.legacyRms += err * err;
+            e.legacyMax = fmax(e.legacyMax, fabs(err));
+            legacyN++;
+        }
+    }
+    e.observerRms = sqrt(e.observerRms / observerN);
+    e.legacyRms = sqrt(e.legacyRms / legacyN);
+    return e;
+}
+
+static void print(const char *name, const Estimate &e)
+{
+    printf("%-28s %12.2f %12.2f %12.2f %12.2f\n", name, e.observerRms, e.observerMax, e.legacyRms, e.legacyMax);
+}
+
+static double constantSpeed(double t, double &position)
+{
+    position = 1000 + 2.0 * VelocityObserver::COUNTS_PER_REV * t;
+    return 2.0 * VelocityObserver::COUNTS_PER_REV;
+}
+
+static double slowSpeed(double t, double &position)
+{
+    position = 1000 + 300 * t; // ~6.6 deg/s: a few counts per legacy interval
+    return 300;
+}
+
+static double rampSpeed(double t, double &position)
+{
+    const double accel = 80000; // Default acceleration in counts/s² at 1600 steps/rev
+    position = 0.5 * accel * t * t;
+    return accel * t;
+}
+
+static double fastSpeed(double t, double &position)
+{
+    position = 6.0 * VelocityObserver::COUNTS_PER_REV * t; // > 8192 counts per 100 ms
+    return 6.0 * VelocityObserver::COUNTS_PER_REV;
+}
+
+void test_benchmark_noise_and_lag(void) {
+    // Noise rises with bandwidth; the 100 ms difference is roughly a 4.4 Hz filter
+    // that is also read only every 100 ms, so it is compared at 5 Hz and at the default
+    const float bandwidths[2] = {5.0f, VelocityObserver::DEFAULT_BANDWIDTH_HZ};
+    Estimate results[2][5];
+    for (int b = 0; b < 2; b++)
+    {
+        printf("\nobserver at %.0f Hz, error (deg/s) %10s %12s %12s %12s\n", bandwidths[b], "observer rms", "observer max", "legacy rms", "legacy max");
+        seed = 12345;
+        results[b][0] = run(constantSpeed, 3.0, 0.5, 0.0, bandwidths[b]);
+        print("2 rev/s, quantised", results[b][0]);
+        results[b][1] = run(constantSpeed, 3.0, 0.5, 2.0, bandwidths[b]);
+        print("2 rev/s, 2 count noise", results[b][1]);
+        results[b][2] = run(slowSpeed, 3.0, 0.5, 1.0, bandwidths[b]);
+        print("300 counts/s, 1 count noise", results[b][2]);
+        results[b][3] = run(rampSpeed, 0.5, 0.25, 1.0, bandwidths[b]);
+        print("80000 counts/s² ramp", results[b][3]);
+        results[b][4] = run(fastSpeed, 2.0, 0.5, 0.0, bandwidths[b]);
+        print("6 rev/s (legacy aliases)", results[b][4]);
+    }
+
+    // Matched bandwidth: no noisier than the finite difference
+    TEST_ASSERT_TRUE(results[0][1].observerRms < results[0][1].legacyRms);
+    TEST_ASSERT_TRUE(results[0][2].observerRms < results[0][2].legacyRms);
+    // Any bandwidth: no ramp lag, no aliasing above 8192 counts per interval
+    for (int b = 0; b < 2; b++)
+    {
+        TEST_ASSERT_TRUE(results[b][3].observerRms < results[b][3].legacyRms);
+        TEST_ASSERT_TRUE(results[b][4].observerRms < results[b][4].legacyRms);
+    }
+}
+
+void test_benchmark_step_response(void) {
+    // Time from a 0 -> 2 rev/s velocity step until the estimate stays within 10%
+    const double speed = 2.0 * VelocityObserver::COUNTS_PER_REV;
+    VelocityObserver observer;
+    FiniteDifferenceReference legacy(0);
+    double observerSettle = -1, legacySettle = -1;
+    double position = 0;
+    for (int i = 0; i < 2000; i++)
+    {
+        double t = i * SAMPLE_US * 1e-6;
+        uint16_t raw = encoderReading(position, 0);
+        observer.update(raw, (uint32_t)(i * SAMPLE_US));
+        bool observerOk = fabs(observer.getVelocity() - speed) < speed * 0.1;
+        if (observerOk && observerSettle < 0)
+            observerSettle = t;
+        else if (!observerOk)
+            observerSettle = -1;
+        if (i % LEGACY_EVERY == 0)
+        {
+            double legacySpeed = FiniteDifferenceReference::toDegPerSec(legacy.calculateSpeed(raw, LEGACY_MS), LEGACY_MS) / DEG_PER_COUNT;
+            bool legacyOk = fabs(legacySpeed - speed) < speed * 0.1;
+            if (legacyOk && legacySettle < 0)
+                legacySettle = t;
+            else if (!legacyOk)
+                legacySettle = -1;
+        }
+        position += speed * SAMPLE_US * 1e-6;
+    }
+    printf("\nstep response to 10%%: observer %.1f ms (%.0f Hz), legacy %.1f ms\n",
+           observerSettle * 1000, observer.getBandwidth(), legacySettle * 1000);
+    TEST_ASSERT_TRUE(observerSettle >= 0 && legacySettle >= 0);
+    TEST_ASSERT_TRUE(observerSettle < legacySettle);
+}
+
+void test_benchmark_update_cost(void) {
+    VelocityObserver observer;
+    const int updates = 2000000;
+    double position = 0;
+    uint16_t raws[1024];
+    for (int i = 0; i < 1024; i++)
+    {
+        raws[i] = encoderReading(position, 1.0);
+        position += 20;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < updates; i++)
+        observer.update(raws[i & 1023], (uint32_t)(i * SAMPLE_US));
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    printf("\nobserver update: %.1f ns (host), %.3f%% of a 500 us sample period\n",
+           ns / updates, ns / updates / 5000.0);
+    TEST_ASSERT_TRUE(observer.isInitialized());
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_benchmark_noise_and_lag);
+    RUN_TEST(test_benchmark_step_response);
+    RUN_TEST(test_benchmark_update_cost);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -2,10 +2,15 @@
 
 #include <map>
 #include <string>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
 
 // Global storage for mock preferences (persists across instances)
 static std::map<std::string, long> globalLongValues;
 static std::map<std::string, bool> globalBoolValues;
+static std::map<std::string, int64_t> globalLong64Values;
+static std::map<std::string, std::vector<uint8_t>> globalBytesValues;
 
 // Mock Preferences class for testing (replaces ESP32 Preferences)
 class Preferences {
@@ -38,22 +43,58 @@ public:
         return defaultValue;
     }
 
+    int64_t getLong64(const char* key, int64_t defaultValue = 0) {
+        auto it = globalLong64Values.find(key);
+        if (it != globalLong64Values.end()) {
+            return it->second;
+        }
+        return defaultValue;
+    }
+
+    size_t getBytesLength(const char* key) {
+        auto it = globalBytesValues.find(key);
+        return it != globalBytesValues.end() ? it->second.size() : 0;
+    }
+
+    size_t getBytes(const char* key, void* buf, size_t maxLen) {
+        auto it = globalBytesValues.find(key);
+        if (it == globalBytesValues.end() || it->second.size() > maxLen) {
+            return 0;
+        }
+        memcpy(buf, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+
     void putLong(const char* key, long value) {
         globalLongValues[key] = value;
     }
 
+    void putLong64(const char* key, int64_t value) {
+        globalLong64Values[key] = value;
+    }
+
     void putBool(const char* key, bool value) {
         globalBoolValues[key] = value;
     }
 
+    size_t putBytes(const char* key, const void* value, size_t len) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(value);
+        globalBytesValues[key] = std::vector<uint8_t>(bytes, bytes + len);
+        return len;
+    }
+
     void clear() {
         globalLongValues.clear();
         globalBoolValues.clear();
+        globalLong64Values.clear();
+        globalBytesValues.clear();
     }
 
     // Test helpers
     bool hasKey(const char* key) {
         return globalLongValues.find(key) != globalLongValues.end() ||
-               globalBoolValues.find(key) != globalBoolValues.end();
+               globalBoolValues.find(key) != globalBoolValues.end() ||
+               globalLong64Values.find(key) != globalLong64Values.end() ||
+               globalBytesValues.find(key) != globalBytesValues.end();
     }
 };
@@ -2,13 +2,8 @@
 
 #include <string>
 
-// Log levels (must match real util.h)
-typedef enum {
-    LOG_LEVEL_ERROR = 0,
-    LOG_LEVEL_WARN = 1,
-    LOG_LEVEL_INFO = 2,
-    LOG_LEVEL_DEBUG = 3
-} log_level_t;
+// Log levels and modules (shared with the real util.h)
+#include "../../../../src/modules/Logger/LogModules.h"
 
 // Mock log function (no-op for tests)
 inline void logPrint(log_level_t level, const char* function, const char* format, ...) {
@@ -22,6 +22,8 @@ void setUp(void) {
     // Clear mock preferences storage before each test
     globalLongValues.clear();
     globalBoolValues.clear();
+    globalLong64Values.clear();
+    globalBytesValues.clear();
 
     // Reset to defaults before each test
     testConfig = Configuration();
@@ -214,6 +216,151 @@ void test_loadConfiguration_restores_defaults(void) {
     TEST_ASSERT_TRUE(freshConfig.getUseStealthChop());
 }
 
+// ============================================================================
+// Position Snapshot Tests (3 tests)
+// ============================================================================
+
+void test_positionSnapshot_absent_on_fresh_nvram(void) {
+    testConfig.begin();
+
+    Configuration::PositionSnapshot snapshot;
+    TEST_ASSERT_FALSE(testConfig.loadPositionSnapshot(snapshot));
+}
+
+void test_positionSnapshot_survives_reboot(void) {
+    testConfig.begin();
+
+    // Beyond 32 bits: a long-running axis
+    Configuration::PositionSnapshot saved = {5000000000LL, 123456, -1};
+    testConfig.savePositionSnapshot(saved);
+
+    Configuration rebooted;
+    rebooted.begin();
+    Configuration::PositionSnapshot loaded;
+    TEST_ASSERT_TRUE(rebooted.loadPositionSnapshot(loaded));
+    TEST_ASSERT_TRUE(loaded.encoderCount == 5000000000LL);
+    TEST_ASSERT_EQUAL_INT32(123456, loaded.steps);
+    TEST_ASSERT_EQUAL_INT8(-1, loaded.polarity);
+}
+
+void test_positionSnapshot_invalidated_by_motion(void) {
+    testConfig.begin();
+
+    Configuration::PositionSnapshot saved = {100, 10, 1};
+    testConfig.savePositionSnapshot(saved);
+    testConfig.invalidatePositionSnapshot();
+
+    // Power cut while moving: nothing to restore after reboot
+    Configuration rebooted;
+    rebooted.begin();
+    Configuration::PositionSnapshot loaded;
+    TEST_ASSERT_FALSE(rebooted.loadPositionSnapshot(loaded));
+}
+
+// ============================================================================
+// Stall Threshold Tests (1 test)
+// ============================================================================
+
+void test_setStallThreshold_clamps_to_register(void) {
+    testConfig.setStallThreshold(80);
+    TEST_ASSERT_EQUAL_INT32(80, testConfig.getStallThreshold());
+    TEST_ASSERT_EQUAL_INT32(80, globalLongValues["stallThr"]);
+
+    // SGTHRS is 8 bits
+    testConfig.setStallThreshold(300);
+    TEST_ASSERT_EQUAL_INT32(255, testConfig.getStallThreshold());
+    testConfig.setStallThreshold(-5);
+    TEST_ASSERT_EQUAL_INT32(0, testConfig.getStallThreshold());
+}
+
+// ============================================================================
+// TMC Mode Switching Tests (1 test)
+// ============================================================================
+
+void test_modeSwitch_settings_persist_and_clamp(void) {
+    TEST_ASSERT_TRUE(testConfig.getHardwareModeSwitch());
+    TEST_ASSERT_EQUAL_INT32(10, testConfig.getModeHysteresis());
+
+    testConfig.setHardwareModeSwitch(false);
+    testConfig.setModeHysteresis(20);
+    Configuration rebooted;
+    rebooted.begin();
+    TEST_ASSERT_FALSE(rebooted.getHardwareModeSwitch());
+    TEST_ASSERT_EQUAL_INT32(20, rebooted.getModeHysteresis());
+
+    testConfig.setModeHysteresis(80);
+    TEST_ASSERT_EQUAL_INT32(50, testConfig.getModeHysteresis());
+    testConfig.setModeHysteresis(-1);
+    TEST_ASSERT_EQUAL_INT32(0, testConfig.getModeHysteresis());
+}
+
+// ============================================================================
+// Limit Recovery Tests (1 test)
+// ============================================================================
+
+void test_limitBackoff_persists_and_clamps(void) {
+    TEST_ASSERT_EQUAL_INT32(160, testConfig.getLimitBackoff());
+
+    testConfig.setLimitBackoff(400);
+    TEST_ASSERT_EQUAL_INT32(400, globalLongValues["limBackoff"]);
+
+    // 0 keeps the manual reset; more than a turn is capped
+    testConfig.setLimitBackoff(5000);
+    TEST_ASSERT_EQUAL_INT32(1600, testConfig.getLimitBackoff());
+    testConfig.setLimitBackoff(-10);
+    TEST_ASSERT_EQUAL_INT32(0, testConfig.getLimitBackoff());
+}
+
+// ============================================================================
+// Soft Limits Tests (1 test)
+// ============================================================================
+
+void test_softLimits_persist_and_clamp(void) {
+    // Off by default: the switches have to be found first
+    TEST_ASSERT_FALSE(testConfig.getSoftLimits());
+    TEST_ASSERT_EQUAL_INT32(800, testConfig.getSoftLimitZone());
+
+    testConfig.setSoftLimits(true);
+    testConfig.setSoftLimitZone(1200);
+    TEST_ASSERT_TRUE(globalBoolValues["softLimits"]);
+    TEST_ASSERT_EQUAL_INT32(1200, globalLongValues["softZone"]);
+
+    testConfig.setSoftLimitZone(100000);
+    TEST_ASSERT_EQUAL_INT32(16000, testConfig.getSoftLimitZone());
+    testConfig.setSoftLimitZone(-5);
+    TEST_ASSERT_EQUAL_INT32(0, testConfig.getSoftLimitZone());
+}
+
+// ============================================================================
+// Encoder Calibration Tests (2 tests)
+// ============================================================================
+
+void test_encoderCalibration_absent_on_fresh_nvram(void) {
+    testConfig.begin();
+
+    int16_t table[256];
+    TEST_ASSERT_FALSE(testConfig.loadEncoderCalibration(table, 256));
+}
+
+void test_encoderCalibration_survives_reboot(void) {
+    testConfig.begin();
+
+    int16_t saved[256];
+    for (int i = 0; i < 256; i++) {
+        saved[i] = (int16_t)(i * 3 - 400);
+    }
+    testConfig.saveEncoderCalibration(saved, 256);
+
+    Configuration rebooted;
+    rebooted.begin();
+    int16_t loaded[256] = {0};
+    TEST_ASSERT_TRUE(rebooted.loadEncoderCalibration(loaded, 256));
+    TEST_ASSERT_EQUAL_INT16_ARRAY(saved, loaded, 256);
+
+    // A table of another size is not mistaken for this one
+    TEST_ASSERT_FALSE(rebooted.loadEncoderCalibration(loaded, 128));
+}
+
 // ============================================================================
 // Test Runner
 // ============================================================================
@@ -244,6 +391,27 @@ void setup() {
     RUN_TEST(test_saveConfiguration_persists_values);
     RUN_TEST(test_loadConfiguration_restores_defaults);
 
+    // Position Snapshot (3 tests)
+    RUN_TEST(test_positionSnapshot_absent_on_fresh_nvram);
+    RUN_TEST(test_positionSnapshot_survives_reboot);
+    RUN_TEST(test_positionSnapshot_invalidated_by_motion);
+
+    // Stall Threshold (1 test)
+    RUN_TEST(test_setStallThreshold_clamps_to_register);
+
+    // TMC Mode Switching (1 test)
+    RUN_TEST(test_modeSwitch_settings_persist_and_clamp);
+
+    // Limit Recovery (1 test)
+    RUN_TEST(test_limitBackoff_persists_and_clamps);
+
+    // Soft Limits (1 test)
+    RUN_TEST(test_softLimits_persist_and_clamp);
+
+    // Encoder Calibration (2 tests)
+    RUN_TEST(test_encoderCalibration_absent_on_fresh_nvram);
+    RUN_TEST(test_encoderCalibration_survives_reboot);
+
     UNITY_END();
 }
 
@@ -0,0 +1,327 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "../../../src/modules/WebServer/DebugHistory.cpp"
+
+// What a client ends up with after reading frames until caught up
+struct Received
+{
+    std::vector<uint32_t> seqs;
+    std::vector<std::string> lines;
+    std::vector<uint32_t> gaps; // "from" of each gap frame
+    size_t frames = 0;
+    size_t longestFrame = 0;
+};
+
+// Decodes one JSON string starting at the opening quote; returns the end
+static const char *decodeString(const char *p, std::string &out)
+{
+    for (p++; *p != '"'; p++)
+    {
+        if (*p != '\\')
+        {
+            out += *p;
+            continue;
+        }
+        p++;
+        if (*p == 'n') out += '\n';
+        else if (*p == 'r') out += '\r';
+        else if (*p == 't') out += '\t';
+        else if (*p == 'u') { out += (char)strtoul(std::string(p + 1, 4).c_str(), nullptr, 16); p += 4; }
+        else out += *p;
+    }
+    return p + 1;
+}
+
+static void receive(const DebugHistory &history, DebugHistory::Cursor &cursor, size_t frameSize, Received &received)
+{
+    std::vector<char> frame(frameSize);
+    size_t length;
+    while ((length = history.readFrame(cursor, frame.data(), frameSize)) != 0)
+    {
+        TEST_ASSERT_EQUAL(strlen(frame.data()), length);
+        TEST_ASSERT_TRUE(length < frameSize);
+        received.frames++;
+        if (length > received.longestFrame)
+            received.longestFrame = length;
+
+        const char *p = frame.data();
+        if (strncmp(p, "{\"type\":\"gap\"", 13) == 0)
+        {
+            received.gaps.push_back(strtoul(strstr(p, "\"from\":") + 7, nullptr, 10));
+            continue;
+        }
+        uint32_t seq = strtoul(strstr(p, "\"seq\":") + 6, nullptr, 10);
+        p = strstr(p, "\"lines\":[") + 9;
+        while (*p == '"')
+        {
+            std::string line;
+            p = decodeString(p, line);
+            received.seqs.push_back(seq++);
+            received.lines.push_back(line);
+            if (*p == ',')
+                p++;
+        }
+        TEST_ASSERT_EQUAL_STRING("]}", p);
+    }
+}
+
+// ============================================================================
+// Replay Tests (9 tests)
+// ============================================================================
+
+void test_empty_history_sends_nothing(void) {
+    DebugHistory history;
+    char frame[128];
+    DebugHistory::Cursor cursor = history.oldest();
+    TEST_ASSERT_EQUAL(0, history.readFrame(cursor, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT32(0, cursor.seq);
+    TEST_ASSERT_EQUAL_UINT32(0, history.lineCount());
+}
+
+void test_lines_replay_in_order_with_sequence_numbers(void) {
+    DebugHistory history;
+    TEST_ASSERT_EQUAL_UINT32(0, history.add("first"));
+    TEST_ASSERT_EQUAL_UINT32(1, history.add("second"));
+
+    char frame[128];
+    DebugHistory::Cursor cursor = history.oldest();
+    size_t length = history.readFrame(cursor, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"log\",\"seq\":0,\"lines\":[\"first\",\"second\"]}", frame);
+    TEST_ASSERT_EQUAL(strlen(frame), length);
+    TEST_ASSERT_EQUAL_UINT32(2, cursor.seq);
+    TEST_ASSERT_EQUAL(0, history.readFrame(cursor, frame, sizeof(frame)));
+
+    // Live lines continue from the same cursor
+    history.add("third");
+    history.readFrame(cursor, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_STRING("{\"type\":\"log\",\"seq\":2,\"lines\":[\"third\"]}", frame);
+}
+
+void test_frames_are_bounded_and_cover_every_line_once(void) {
+    DebugHistory history;
+    char line[64];
+    for (int i = 0; i < 200; i++) {
+        snprintf(line, sizeof(line), "[00:00:%02d.000] [INFO] [update]: line %d", i % 60, i);
+        history.add(line);
+    }
+
+    Received received;
+    DebugHistory::Cursor cursor = history.oldest();
+    receive(history, cursor, 256, received);
+
+    TEST_ASSERT_TRUE(received.frames > 20);
+    TEST_ASSERT_TRUE(received.longestFrame < 256);
+    TEST_ASSERT_EQUAL(200, received.lines.size());
+    for (uint32_t i = 0; i < 200; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, received.seqs[i]);
+        snprintf(line, sizeof(line), "[00:00:%02d.000] [INFO] [update]: line %d", (int)(i % 60), (int)i);
+        TEST_ASSERT_EQUAL_STRING(line, received.lines[i].c_str());
+    }
+    TEST_ASSERT_EQUAL_UINT32(200, cursor.seq);
+}
+
+void test_full_arena_keeps_the_newest_lines_intact(void) {
+    DebugHistory history;
+    char line[96];
+    // Line lengths vary so records straddle the end of the arena at odd offsets
+    for (int i = 0; i < 3000; i++) {
+        snprintf(line, sizeof(line), "line %d %.*s", i, i % 61, "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghij");
+        history.add(line);
+    }
+    TEST_ASSERT_TRUE(history.bytesUsed() <= DebugHistory::ARENA_SIZE);
+    TEST_ASSERT_TRUE(history.bytesUsed() > DebugHistory::ARENA_SIZE - 80);
+    TEST_ASSERT_EQUAL_UINT32(3000, history.nextSequence());
+    TEST_ASSERT_TRUE(history.firstSequence() > 2500);
+
+    Received received;
+    DebugHistory::Cursor cursor = history.oldest();
+    receive(history, cursor, 2048, received);
+    TEST_ASSERT_EQUAL(0, received.gaps.size());
+    TEST_ASSERT_EQUAL(history.lineCount(), received.lines.size());
+    for (size_t i = 0; i < received.lines.size(); i++) {
+        int n = (int)received.seqs[i];
+        snprintf(line, sizeof(line), "line %d %.*s", n, n % 61, "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghij");
+        TEST_ASSERT_EQUAL_STRING(line, received.lines[i].c_str());
+    }
+}
+
+void test_evicted_cursor_gets_a_gap_then_the_oldest_line(void) {
+    DebugHistory history;
+    char line[256];
+    memset(line, 'x', 200);
+    line[200] = '\0';
+    for (int i = 0; i < 100; i++)
+        history.add(line);
+    uint32_t first = history.firstSequence();
+    TEST_ASSERT_TRUE(first > 0);
+
+    char frame[512];
+    DebugHistory::Cursor cursor = history.seek(3);
+    history.readFrame(cursor, frame, sizeof(frame));
+    char expected[64];
+    snprintf(expected, sizeof(expected), "{\"type\":\"gap\",\"from\":3,\"to\":%lu}", (unsigned long)first);
+    TEST_ASSERT_EQUAL_STRING(expected, frame);
+    TEST_ASSERT_EQUAL_UINT32(first, cursor.seq);
+
+    // A client that falls behind mid-replay sees the same
+    Received received;
+    cursor = history.seek(3);
+    receive(history, cursor, 512, received);
+    TEST_ASSERT_EQUAL(1, received.gaps.size());
+    TEST_ASSERT_EQUAL_UINT32(first, received.seqs.front());
+    TEST_ASSERT_EQUAL_UINT32(99, received.seqs.back());
+}
+
+void test_reconnect_resumes_without_gaps_or_duplicates(void) {
+    DebugHistory history;
+    char line[32];
+    for (int i = 0; i < 50; i++) {
+        snprintf(line, sizeof(line), "before %d", i);
+        history.add(line);
+    }
+
+    // First connection reads a few frames, then drops
+    char frame[128];
+    DebugHistory::Cursor cursor = history.oldest();
+    history.readFrame(cursor, frame, sizeof(frame));
+    history.readFrame(cursor, frame, sizeof(frame));
+    uint32_t resumeAt = cursor.seq;
+    TEST_ASSERT_TRUE(resumeAt > 0 && resumeAt < 50);
+
+    for (int i = 0; i < 20; i++) {
+        snprintf(line, sizeof(line), "after %d", i);
+        history.add(line);
+    }
+
+    // Reconnect with ?since=resumeAt
+    Received received;
+    DebugHistory::Cursor resumed = history.seek(resumeAt);
+    receive(history, resumed, 128, received);
+    TEST_ASSERT_EQUAL(0, received.gaps.size());
+    TEST_ASSERT_EQUAL(70 - resumeAt, received.lines.size());
+    TEST_ASSERT_EQUAL_UINT32(resumeAt, received.seqs.front());
+    TEST_ASSERT_EQUAL_STRING("after 19", received.lines.back().c_str());
+
+    // A cursor from before a reboot is ahead of everything: start over
+    DebugHistory::Cursor stale = history.seek(5000);
+    Received restarted;
+    receive(history, stale, 128, restarted);
+    TEST_ASSERT_EQUAL(70, restarted.lines.size());
+    TEST_ASSERT_EQUAL_UINT32(0, restarted.seqs.front());
+}
+
+void test_special_characters_are_escaped(void) {
+    DebugHistory history;
+    history.add("say \"hi\"\\path\tx\n\x01");
+
+    char frame[128];
+    DebugHistory::Cursor cursor = history.oldest();
+    history.readFrame(cursor, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"type\":\"log\",\"seq\":0,\"lines\":[\"say \\\"hi\\\"\\\\path\\tx\\n\\u0001\"]}", frame);
+
+    Received received;
+    cursor = history.oldest();
+    receive(history, cursor, 128, received);
+    TEST_ASSERT_EQUAL_STRING("say \"hi\"\\path\tx\n\x01", received.lines[0].c_str());
+}
+
+void test_long_lines_are_truncated_not_stuck(void) {
+    DebugHistory history;
+    std::string longLine(1000, 'y');
+    history.add(longLine.c_str());
+    history.add("next");
+    TEST_ASSERT_EQUAL(2 * sizeof(uint16_t) + DebugHistory::MAX_LINE + 4, history.bytesUsed());
+
+    // A frame too small for the stored line cuts it short and moves on
+    Received received;
+    DebugHistory::Cursor cursor = history.oldest();
+    receive(history, cursor, 200, received);
+    TEST_ASSERT_EQUAL(2, received.lines.size());
+    TEST_ASSERT_TRUE(received.lines[0].size() > 100 && received.lines[0].size() < 200);
+    TEST_ASSERT_EQUAL_STRING("next", received.lines[1].c_str());
+
+    // A large frame gets the whole stored line
+    Received whole;
+    cursor = history.oldest();
+    receive(history, cursor, 2048, whole);
+    TEST_ASSERT_EQUAL(DebugHistory::MAX_LINE, whole.lines[0].size());
+}
+
+void test_live_cursor_survives_eviction_and_clear(void) {
+    DebugHistory history;
+    char line[96];
+    Received received;
+    DebugHistory::Cursor cursor = history.oldest();
+
+    // A client that keeps up reads from its own offset while the ring wraps many times
+    for (int i = 0; i < 2000; i++) {
+        snprintf(line, sizeof(line), "live %d %.*s", i, i % 53, "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz");
+        history.add(line);
+        if (i % 7 == 0)
+            receive(history, cursor, 256, received);
+    }
+    receive(history, cursor, 256, received);
+    TEST_ASSERT_EQUAL(0, received.gaps.size());
+    TEST_ASSERT_EQUAL(2000, received.lines.size());
+    for (uint32_t i = 0; i < 2000; i += 97) {
+        snprintf(line, sizeof(line), "live %d %.*s", (int)i, (int)(i % 53), "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz");
+        TEST_ASSERT_EQUAL_STRING(line, received.lines[i].c_str());
+    }
+
+    // A caught-up cursor stays valid across clear(); one behind it sees a gap
+    DebugHistory::Cursor behind = history.seek(1990);
+    history.clear();
+    history.add("after clear");
+    Received afterClear;
+    receive(history, cursor, 256, afterClear);
+    TEST_ASSERT_EQUAL(0, afterClear.gaps.size());
+    TEST_ASSERT_EQUAL(1, afterClear.lines.size());
+    TEST_ASSERT_EQUAL_STRING("after clear", afterClear.lines[0].c_str());
+
+    Received lagging;
+    receive(history, behind, 256, lagging);
+    TEST_ASSERT_EQUAL(1, lagging.gaps.size());
+    TEST_ASSERT_EQUAL_UINT32(1990, lagging.gaps[0]);
+    TEST_ASSERT_EQUAL_STRING("after clear", lagging.lines[0].c_str());
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    // Replay (9 tests)
+    RUN_TEST(test_empty_history_sends_nothing);
+    RUN_TEST(test_lines_replay_in_order_with_sequence_numbers);
+    RUN_TEST(test_frames_are_bounded_and_cover_every_line_once);
+    RUN_TEST(test_full_arena_keeps_the_newest_lines_intact);
+    RUN_TEST(test_evicted_cursor_gets_a_gap_then_the_oldest_line);
+    RUN_TEST(test_reconnect_resumes_without_gaps_or_duplicates);
+    RUN_TEST(test_special_characters_are_escaped);
+    RUN_TEST(test_long_lines_are_truncated_not_stuck);
+    RUN_TEST(test_live_cursor_survives_eviction_and_clear);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
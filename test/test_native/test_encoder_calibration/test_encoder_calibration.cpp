@@ -0,0 +1,173 @@
+#include <unity.h>
+#include <math.h>
+
+#include "../../../src/modules/EncoderCalibration/EncoderCalibration.cpp"
+
+static constexpr int32_t REV = EncoderCalibration::COUNTS_PER_REV;
+static constexpr size_t POINTS = 400; // 1600 microsteps per rev, every 4th
+
+// Synthetic magnet misalignment: once- and twice-per-rev error, ~0.4° peak
+static double magnetError(double angle)
+{
+    double theta = 2 * M_PI * angle / REV;
+    return 14.0 * sin(theta + 0.7) + 6.0 * sin(2 * theta + 2.1);
+}
+
+static uint16_t rawReading(double trueAngle)
+{
+    long raw = lround(trueAngle + magnetError(trueAngle)) % REV;
+    return (uint16_t)(raw < 0 ? raw + REV : raw);
+}
+
+static void sweep(uint16_t *points, double start, int direction)
+{
+    for (size_t i = 0; i < POINTS; i++)
+        points[i] = rawReading(start + direction * (double)REV * i / POINTS);
+}
+
+// Largest deviation of corrected angles from the true angle, after removing the constant offset
+static double residual(const EncoderCalibration &calibration)
+{
+    double offset = 0, peak = 0;
+    int n = 0;
+    for (double angle = 0; angle < REV; angle += 7.3, n++)
+    {
+        int32_t d = calibration.correct(rawReading(angle)) - (int32_t)lround(angle);
+        d = ((d % REV) + REV + REV / 2) % REV - REV / 2;
+        offset += d;
+    }
+    offset /= n;
+    for (double angle = 0; angle < REV; angle += 7.3)
+    {
+        int32_t d = calibration.correct(rawReading(angle)) - (int32_t)lround(angle);
+        d = ((d % REV) + REV + REV / 2) % REV - REV / 2;
+        peak = fmax(peak, fabs(d - offset));
+    }
+    return peak;
+}
+
+// ============================================================================
+// EncoderCalibration Tests
+// ============================================================================
+
+void test_uncalibrated_passes_raw_through(void) {
+    EncoderCalibration calibration;
+    TEST_ASSERT_FALSE(calibration.isValid());
+    TEST_ASSERT_EQUAL_UINT16(1234, calibration.correct(1234));
+    TEST_ASSERT_TRUE(residual(calibration) > 18); // The synthetic error is there to remove
+}
+
+void test_forward_sweep_removes_periodic_error(void) {
+    uint16_t points[POINTS];
+    int16_t table[EncoderCalibration::TABLE_SIZE];
+    sweep(points, 1000.5, 1);
+    TEST_ASSERT_TRUE(EncoderCalibration::build(points, POINTS, table));
+
+    EncoderCalibration calibration;
+    TEST_ASSERT_TRUE(calibration.load(table));
+    TEST_ASSERT_INT32_WITHIN(2, 20, calibration.getPeakError());
+    TEST_ASSERT_TRUE(residual(calibration) <= 1.5);
+}
+
+void test_reverse_sweep_across_zero(void) {
+    // Encoder counting against the step direction, starting just past the wrap
+    uint16_t points[POINTS];
+    int16_t table[EncoderCalibration::TABLE_SIZE];
+    sweep(points, 50, -1);
+    TEST_ASSERT_TRUE(EncoderCalibration::build(points, POINTS, table));
+
+    EncoderCalibration calibration;
+    TEST_ASSERT_TRUE(calibration.load(table));
+    TEST_ASSERT_TRUE(residual(calibration) <= 1.5);
+}
+
+void test_forward_backward_midpoint_cancels_lag(void) {
+    // Rotor lags 5 counts behind in each sweep direction; the midpoint cancels it
+    uint16_t forward[POINTS], backward[POINTS], points[POINTS];
+    for (size_t i = 0; i < POINTS; i++)
+    {
+        double angle = (double)REV * i / POINTS;
+        forward[i] = rawReading(angle - 5);
+        backward[i] = rawReading(angle + 5);
+        points[i] = EncoderCalibration::midpoint(forward[i], backward[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT16(REV - 2, EncoderCalibration::midpoint(REV - 10, 6));
+
+    int16_t table[EncoderCalibration::TABLE_SIZE];
+    TEST_ASSERT_TRUE(EncoderCalibration::build(points, POINTS, table));
+    EncoderCalibration calibration;
+    calibration.load(table);
+    TEST_ASSERT_TRUE(residual(calibration) <= 1.5);
+}
+
+void test_bad_sweeps_are_rejected(void) {
+    uint16_t points[POINTS];
+    int16_t table[EncoderCalibration::TABLE_SIZE];
+
+    // Too few points for the table
+    sweep(points, 0, 1);
+    TEST_ASSERT_FALSE(EncoderCalibration::build(points, EncoderCalibration::MIN_POINTS - 1, table));
+
+    // Only half a turn (motor slipped or stalled)
+    for (size_t i = 0; i < POINTS; i++)
+        points[i] = rawReading((double)REV / 2 * i / POINTS);
+    TEST_ASSERT_FALSE(EncoderCalibration::build(points, POINTS, table));
+
+    // Shaft stuck for a stretch: error far beyond magnet misalignment
+    sweep(points, 0, 1);
+    for (size_t i = 100; i < 160; i++)
+        points[i] = points[100];
+    TEST_ASSERT_FALSE(EncoderCalibration::build(points, POINTS, table));
+}
+
+void test_load_rejects_out_of_range_table(void) {
+    int16_t table[EncoderCalibration::TABLE_SIZE] = {0};
+    table[17] = EncoderCalibration::MAX_ERROR + 1;
+    EncoderCalibration calibration;
+    TEST_ASSERT_FALSE(calibration.load(table));
+    TEST_ASSERT_FALSE(calibration.isValid());
+    TEST_ASSERT_EQUAL_UINT16(500, calibration.correct(500));
+}
+
+void test_correct_wraps_at_table_end(void) {
+    // Constant +10 error: every reading maps back 10 counts, including across zero
+    int16_t table[EncoderCalibration::TABLE_SIZE];
+    for (size_t i = 0; i < EncoderCalibration::TABLE_SIZE; i++)
+        table[i] = 10;
+    EncoderCalibration calibration;
+    calibration.load(table);
+    TEST_ASSERT_EQUAL_UINT16(REV - 5, calibration.correct(5));
+    TEST_ASSERT_EQUAL_UINT16(REV - 11, calibration.correct(REV - 1));
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_uncalibrated_passes_raw_through);
+    RUN_TEST(test_forward_sweep_removes_periodic_error);
+    RUN_TEST(test_reverse_sweep_across_zero);
+    RUN_TEST(test_forward_backward_midpoint_cancels_lag);
+    RUN_TEST(test_bad_sweeps_are_rejected);
+    RUN_TEST(test_load_rejects_out_of_range_table);
+    RUN_TEST(test_correct_wraps_at_table_end);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
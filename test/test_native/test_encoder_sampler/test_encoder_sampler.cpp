@@ -0,0 +1,175 @@
+#include <unity.h>
+#include <thread>
+#include <atomic>
+
+#include "../../../src/modules/EncoderSampler/EncoderSampler.h"
+
+// Build registers 0x03/0x04 for an angle with correct even parity
+static void encodeFrame(uint16_t angle, bool noMagnet, uint8_t &reg3, uint8_t &reg4)
+{
+    reg3 = (uint8_t)(angle >> 6);
+    reg4 = (uint8_t)((angle & 0x3F) << 2 | (noMagnet ? EncoderSampler::NO_MAGNET_BIT : 0));
+    uint16_t word = (uint16_t)(reg3 << 8 | reg4);
+    uint8_t ones = 0;
+    for (; word; word >>= 1)
+        ones += word & 1;
+    reg4 |= ones & 1;
+}
+
+// ============================================================================
+// MT6816 frame decode Tests
+// ============================================================================
+
+void test_decode_recovers_every_angle(void) {
+    for (uint16_t angle = 0; angle < 16384; angle++)
+    {
+        uint8_t reg3, reg4;
+        encodeFrame(angle, angle % 7 == 0, reg3, reg4);
+        uint16_t decoded = 0xFFFF;
+        TEST_ASSERT_TRUE(EncoderSampler::decode(reg3, reg4, decoded));
+        TEST_ASSERT_EQUAL_UINT16(angle, decoded);
+    }
+}
+
+void test_decode_rejects_single_bit_errors(void) {
+    uint8_t reg3, reg4;
+    encodeFrame(12345, false, reg3, reg4);
+    for (int bit = 0; bit < 16; bit++)
+    {
+        uint16_t word = (uint16_t)(reg3 << 8 | reg4) ^ (1 << bit);
+        uint16_t decoded;
+        TEST_ASSERT_FALSE(EncoderSampler::decode(word >> 8, word & 0xFF, decoded));
+    }
+}
+
+// ============================================================================
+// BroadcastRing Tests
+// ============================================================================
+
+void test_every_reader_sees_every_record(void) {
+    BroadcastRing<uint32_t, 8> ring;
+    BroadcastRing<uint32_t, 8>::Cursor a = ring.subscribe();
+    BroadcastRing<uint32_t, 8>::Cursor b = ring.subscribe();
+
+    for (uint32_t i = 0; i < 5; i++)
+        ring.push(i);
+
+    uint32_t value;
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        TEST_ASSERT_TRUE(ring.read(a, value));
+        TEST_ASSERT_EQUAL_UINT32(i, value);
+    }
+    TEST_ASSERT_FALSE(ring.read(a, value));
+
+    // The second reader is independent of the first
+    TEST_ASSERT_TRUE(ring.read(b, value));
+    TEST_ASSERT_EQUAL_UINT32(0, value);
+    TEST_ASSERT_EQUAL_UINT32(0, a.lost);
+}
+
+void test_slow_reader_skips_overwritten_records(void) {
+    BroadcastRing<uint32_t, 8> ring;
+    BroadcastRing<uint32_t, 8>::Cursor cursor = ring.subscribe();
+
+    for (uint32_t i = 0; i < 20; i++)
+        ring.push(i);
+
+    uint32_t value;
+    TEST_ASSERT_TRUE(ring.read(cursor, value));
+    TEST_ASSERT_EQUAL_UINT32(13, value); // Oldest record the producer can't be writing over
+    TEST_ASSERT_EQUAL_UINT32(13, cursor.lost);
+}
+
+void test_latest_and_late_subscriber(void) {
+    BroadcastRing<uint32_t, 8> ring;
+    uint32_t value;
+    TEST_ASSERT_FALSE(ring.latest(value));
+
+    ring.push(1);
+    ring.push(2);
+    TEST_ASSERT_TRUE(ring.latest(value));
+    TEST_ASSERT_EQUAL_UINT32(2, value);
+
+    // Subscribing starts after what is already there
+    BroadcastRing<uint32_t, 8>::Cursor cursor = ring.subscribe();
+    TEST_ASSERT_FALSE(ring.read(cursor, value));
+    ring.push(3);
+    TEST_ASSERT_TRUE(ring.read(cursor, value));
+    TEST_ASSERT_EQUAL_UINT32(3, value);
+}
+
+void test_concurrent_readers_never_see_torn_records(void) {
+    // Sample angle and timestamp are derived from the same counter, so a record
+    // mixed from two writes shows up as a mismatch
+    static EncoderSampler::Ring ring;
+    const uint32_t count = 1000000;
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> torn(0);
+    std::atomic<uint32_t> outOfOrder(0);
+
+    auto reader = [&]() {
+        EncoderSampler::Ring::Cursor cursor = ring.subscribe();
+        uint32_t last = 0;
+        bool first = true;
+        EncoderSample sample;
+        while (true)
+        {
+            bool finished = done.load();
+            if (!ring.read(cursor, sample))
+            {
+                if (finished)
+                    break;
+                continue;
+            }
+            if (sample.angle != (sample.timestampUs & 0x3FFF))
+                torn++;
+            if (!first && sample.timestampUs <= last)
+                outOfOrder++;
+            last = sample.timestampUs;
+            first = false;
+        }
+    };
+
+    std::thread r1(reader);
+    std::thread r2(reader);
+    for (uint32_t i = 1; i <= count; i++)
+        ring.push(EncoderSample{i, (uint16_t)(i & 0x3FFF)});
+    done = true;
+    r1.join();
+    r2.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, torn.load());
+    TEST_ASSERT_EQUAL_UINT32(0, outOfOrder.load());
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_decode_recovers_every_angle);
+    RUN_TEST(test_decode_rejects_single_bit_errors);
+    RUN_TEST(test_every_reader_sees_every_record);
+    RUN_TEST(test_slow_reader_skips_overwritten_records);
+    RUN_TEST(test_latest_and_late_subscriber);
+    RUN_TEST(test_concurrent_readers_never_see_torn_records);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
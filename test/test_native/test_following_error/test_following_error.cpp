@@ -0,0 +1,206 @@
+#include <unity.h>
+
+#include "../../../src/modules/FollowingErrorMonitor/FollowingErrorMonitor.cpp"
+
+using State = FollowingErrorMonitor::State;
+
+static constexpr long STEPS_PER_REV = FollowingErrorMonitor::DEFAULT_STEPS_PER_REV;
+static constexpr int32_t COUNTS = FollowingErrorMonitor::ENCODER_COUNTS;
+
+// Multi-turn encoder count for a shaft at 'steps' microsteps (offset = mounting angle)
+static int64_t encoderAt(long steps, int8_t polarity = 1, int32_t offset = 5000)
+{
+    return (int64_t)steps * COUNTS / STEPS_PER_REV * polarity + offset;
+}
+
+// Move commanded and actual position together in 10-step samples
+static State runTo(FollowingErrorMonitor &monitor, long &commanded, long target,
+                   long lostSteps = 0, int8_t polarity = 1)
+{
+    State state = monitor.getState();
+    while (commanded != target)
+    {
+        long step = target > commanded ? 10 : -10;
+        if (labs(target - commanded) < 10)
+            step = target - commanded;
+        commanded += step;
+        state = monitor.update(encoderAt(commanded - lostSteps, polarity), commanded);
+    }
+    return state;
+}
+
+// ============================================================================
+// FollowingErrorMonitor Tests (9 tests)
+// ============================================================================
+
+void test_tracks_multi_turn_motion_without_fault(void) {
+    FollowingErrorMonitor monitor;
+    monitor.setWindow(24);
+    long commanded = 0;
+    monitor.update(encoderAt(0), 0);
+
+    TEST_ASSERT_TRUE(runTo(monitor, commanded, 50 * STEPS_PER_REV) == State::Tracking);
+    TEST_ASSERT_INT32_WITHIN(1, 50 * STEPS_PER_REV, monitor.getMeasuredPosition());
+
+    // Back past the start, across the encoder wrap in the other direction
+    TEST_ASSERT_TRUE(runTo(monitor, commanded, -3 * STEPS_PER_REV) == State::Tracking);
+    TEST_ASSERT_INT32_WITHIN(1, -3 * STEPS_PER_REV, monitor.getMeasuredPosition());
+    TEST_ASSERT_INT32_WITHIN(1, 0, monitor.getError());
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(1, labs(monitor.getPeakError()));
+}
+
+void test_learns_inverted_encoder(void) {
+    FollowingErrorMonitor monitor;
+    monitor.setWindow(24);
+    long commanded = 0;
+    monitor.update(encoderAt(0, -1), 0);
+    TEST_ASSERT_TRUE(monitor.getState() == State::Learning);
+
+    TEST_ASSERT_TRUE(runTo(monitor, commanded, 4000, 0, -1) == State::Tracking);
+    TEST_ASSERT_EQUAL_INT8(-1, monitor.getPolarity());
+    TEST_ASSERT_INT32_WITHIN(1, 4000, monitor.getMeasuredPosition());
+}
+
+void test_lost_steps_fault_outside_window(void) {
+    FollowingErrorMonitor monitor;
+    monitor.setWindow(24);
+    long commanded = 0;
+    monitor.update(encoderAt(0), 0);
+    runTo(monitor, commanded, 2000);
+
+    // One lost electrical cycle: 4 full steps = 32 microsteps behind
+    TEST_ASSERT_TRUE(runTo(monitor, commanded, 4000, 32) == State::Fault);
+    TEST_ASSERT_INT32_WITHIN(1, 32, monitor.getError());
+
+    // Latched: following again doesn't clear it, a resync does
+    TEST_ASSERT_TRUE(runTo(monitor, commanded, 5000) == State::Fault);
+    monitor.requestResync();
+    TEST_ASSERT_TRUE(monitor.update(encoderAt(commanded), commanded) == State::Tracking);
+    TEST_ASSERT_EQUAL_INT32(0, monitor.getError());
+}
+
+void test_error_inside_window_does_not_fault(void) {
+    FollowingErrorMonitor monitor;
+    monitor.setWindow(24);
+    long commanded = 0;
+    monitor.update(encoderAt(0), 0);
+    runTo(monitor, commanded, 2000);
+
+    // Load angle lag under torque stays inside the window
+    TEST_ASSERT_TRUE(runTo(monitor, commanded, 6000, 16) == State::Tracking);
+    TEST_ASSERT_INT32_WITHIN(1, 16, monitor.getError());
+}
+
+void test_disabled_window_never_faults(void) {
+    FollowingErrorMonitor monitor;
+    monitor.setWindow(0);
+    long commanded = 0;
+    monitor.update(encoderAt(0), 0);
+    runTo(monitor, commanded, 2000);
+
+    TEST_ASSERT_TRUE(runTo(monitor, commanded, 8000, 400) == State::Tracking);
+    TEST_ASSERT_INT32_WITHIN(1, 400, monitor.getError());
+}
+
+void test_stall_while_learning_faults(void) {
+    FollowingErrorMonitor monitor;
+    monitor.setWindow(24);
+    monitor.update(encoderAt(0), 0);
+
+    // Commanded position advances, shaft stays put
+    State state = State::Learning;
+    for (long commanded = 10; commanded <= 400 && state != State::Fault; commanded += 10)
+        state = monitor.update(encoderAt(0), commanded);
+
+    TEST_ASSERT_TRUE(state == State::Fault);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT32(FollowingErrorMonitor::POLARITY_LEARN_STEPS, monitor.getError());
+}
+
+void test_suspend_resyncs_after_free_movement(void) {
+    FollowingErrorMonitor monitor;
+    monitor.setWindow(24);
+    long commanded = 0;
+    monitor.update(encoderAt(0), 0);
+    runTo(monitor, commanded, 2000);
+
+    // Driver disabled, shaft turned by hand half a turn
+    monitor.suspend();
+    TEST_ASSERT_TRUE(monitor.getState() == State::Suspended);
+    TEST_ASSERT_TRUE(monitor.update(encoderAt(2800), commanded) == State::Tracking);
+
+    // Re-enabled: the new shaft angle is the reference for the commanded position
+    for (long c = commanded + 10; c <= commanded + 1000; c += 10)
+        TEST_ASSERT_TRUE(monitor.update(encoderAt(c + 800), c) == State::Tracking);
+    TEST_ASSERT_INT32_WITHIN(1, 0, monitor.getError());
+}
+
+void test_suspend_keeps_latched_fault(void) {
+    FollowingErrorMonitor monitor;
+    monitor.setWindow(24);
+    long commanded = 0;
+    monitor.update(encoderAt(0), 0);
+    runTo(monitor, commanded, 2000);
+    runTo(monitor, commanded, 3000, 100);
+    TEST_ASSERT_TRUE(monitor.isFaulted());
+
+    // Emergency stop disables the driver; the fault stays visible
+    monitor.suspend();
+    TEST_ASSERT_TRUE(monitor.isFaulted());
+}
+
+void test_fast_travel_between_updates_keeps_its_sign(void) {
+    FollowingErrorMonitor monitor;
+    monitor.setWindow(24);
+    long commanded = 0;
+    monitor.update(encoderAt(0), 0);
+    runTo(monitor, commanded, 400);
+
+    // A late update after 0.75, then 3 turns of travel (over half a turn of
+    // single-turn angle: an angle unwrap would see it go the wrong way)
+    commanded += 3 * STEPS_PER_REV / 4;
+    TEST_ASSERT_TRUE(monitor.update(encoderAt(commanded), commanded) == State::Tracking);
+    TEST_ASSERT_INT32_WITHIN(1, 0, monitor.getError());
+
+    commanded += 3 * STEPS_PER_REV;
+    TEST_ASSERT_TRUE(monitor.update(encoderAt(commanded), commanded) == State::Tracking);
+    TEST_ASSERT_INT32_WITHIN(1, 0, monitor.getError());
+
+    commanded -= 5 * STEPS_PER_REV / 2;
+    TEST_ASSERT_TRUE(monitor.update(encoderAt(commanded), commanded) == State::Tracking);
+    TEST_ASSERT_INT32_WITHIN(1, 0, monitor.getError());
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(1, labs(monitor.getPeakError()));
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_tracks_multi_turn_motion_without_fault);
+    RUN_TEST(test_learns_inverted_encoder);
+    RUN_TEST(test_lost_steps_fault_outside_window);
+    RUN_TEST(test_error_inside_window_does_not_fault);
+    RUN_TEST(test_disabled_window_never_faults);
+    RUN_TEST(test_stall_while_learning_faults);
+    RUN_TEST(test_suspend_resyncs_after_free_movement);
+    RUN_TEST(test_suspend_keeps_latched_fault);
+    RUN_TEST(test_fast_travel_between_updates_keeps_its_sign);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -0,0 +1,254 @@
+#include <unity.h>
+
+#include "../../../src/TimingStats.cpp"
+#include "../../../src/modules/InputScheduler/InputScheduler.cpp"
+#include "../../../src/modules/ButtonController/DebouncedButton.cpp"
+
+typedef DebouncedButton::Event Event;
+
+// Feed a bouncing press: 'count' edges alternating pressed/released, 'gapUs' apart,
+// ending on 'pressed'. Returns the events the edges produced, in order.
+static int bounce(DebouncedButton &button, bool pressed, uint32_t startUs, int count, uint32_t gapUs,
+                  Event *events)
+{
+    int produced = 0;
+    for (int i = 0; i < count; i++)
+    {
+        bool level = ((count - 1 - i) % 2 == 0) ? pressed : !pressed;
+        uint32_t t = startUs + i * gapUs;
+        Event e;
+        while ((e = button.poll(t)) != Event::None)
+            events[produced++] = e;
+        if ((e = button.onEdge(level, t)) != Event::None)
+            events[produced++] = e;
+    }
+    return produced;
+}
+
+// ============================================================================
+// Scheduler Tests (7 tests)
+// ============================================================================
+
+void test_periodic_consumers_run_on_their_own_period(void) {
+    InputScheduler scheduler;
+    uint8_t fast = scheduler.add("fast", 10000, 0, 0);
+    uint8_t slow = scheduler.add("slow", 50000, 0, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(10000, scheduler.sleepTime(0));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.due(9999));
+
+    int fastRuns = 0, slowRuns = 0;
+    for (uint32_t t = 10000; t <= 100000; t += 10000)
+    {
+        uint32_t run = scheduler.due(t);
+        fastRuns += (run >> fast) & 1;
+        slowRuns += (run >> slow) & 1;
+    }
+    TEST_ASSERT_EQUAL(10, fastRuns);
+    TEST_ASSERT_EQUAL(2, slowRuns);
+    TEST_ASSERT_EQUAL_UINT32(10, scheduler.getRuns(fast));
+}
+
+void test_event_runs_only_its_consumers(void) {
+    InputScheduler scheduler;
+    uint8_t buttons = scheduler.add("buttons", 0, 1UL << 0, 0);
+    uint8_t limits = scheduler.add("limits", 0, 1UL << 1, 0);
+
+    // Nothing periodic: sleep the longest allowed
+    TEST_ASSERT_EQUAL_UINT32(InputScheduler::MAX_SLEEP_US, scheduler.sleepTime(0));
+
+    scheduler.post(1, 1000);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.sleepTime(1000));
+    TEST_ASSERT_EQUAL_UINT32(1UL << limits, scheduler.due(1250));
+    TEST_ASSERT_EQUAL_INT32(250, scheduler.getLatency(limits).getMax());
+
+    // Taken: the next round has nothing
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.due(1300));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getRuns(buttons));
+}
+
+void test_latency_counts_from_first_post(void) {
+    InputScheduler scheduler;
+    uint8_t buttons = scheduler.add("buttons", 0, 1UL << 0, 0);
+
+    scheduler.post(0, 500);
+    scheduler.post(0, 900); // Same event again before the task ran
+    scheduler.due(1000);
+    TEST_ASSERT_EQUAL_INT32(500, scheduler.getLatency(buttons).getMax());
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.getRuns(buttons));
+}
+
+void test_wake_at_deadline(void) {
+    InputScheduler scheduler;
+    uint8_t buttons = scheduler.add("buttons", 0, 1UL << 0, 0);
+
+    scheduler.wakeAt(buttons, 20000);
+    TEST_ASSERT_EQUAL_UINT32(15000, scheduler.sleepTime(5000));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.due(19999));
+    TEST_ASSERT_EQUAL_UINT32(1UL << buttons, scheduler.due(20300));
+    TEST_ASSERT_EQUAL_INT32(300, scheduler.getLatency(buttons).getMax());
+
+    // One-off: gone once it ran
+    TEST_ASSERT_EQUAL_UINT32(InputScheduler::MAX_SLEEP_US, scheduler.sleepTime(20300));
+}
+
+void test_late_run_skips_missed_periods(void) {
+    InputScheduler scheduler;
+    uint8_t velocity = scheduler.add("velocity", 10000, 0, 0);
+
+    // Task held up for 3.5 periods: one late run, then back on a period from now
+    TEST_ASSERT_EQUAL_UINT32(1UL << velocity, scheduler.due(35000));
+    TEST_ASSERT_EQUAL_INT32(25000, scheduler.getLatency(velocity).getMax());
+    TEST_ASSERT_EQUAL_UINT32(10000, scheduler.sleepTime(35000));
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.getRuns(velocity));
+}
+
+void test_schedule_survives_timer_wrap(void) {
+    InputScheduler scheduler;
+    uint32_t start = 0xFFFFF000UL;
+    uint8_t fast = scheduler.add("fast", 10000, 0, start);
+
+    TEST_ASSERT_EQUAL_UINT32(10000, scheduler.sleepTime(start));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.due(start + 9999));
+    TEST_ASSERT_EQUAL_UINT32(1UL << fast, scheduler.due(start + 10000));
+    TEST_ASSERT_EQUAL_UINT32(10000, scheduler.sleepTime(start + 10000));
+}
+
+void test_take_leaves_statistics_to_record(void) {
+    InputScheduler scheduler;
+    uint8_t buttons = scheduler.add("buttons", 0, 1UL << 0, 0);
+    uint8_t velocity = scheduler.add("velocity", 10000, 0, 0);
+
+    uint32_t latencyUs[InputScheduler::MAX_CONSUMERS];
+    scheduler.post(0, 10100);
+    uint32_t run = scheduler.take(10400, latencyUs);
+    TEST_ASSERT_EQUAL_UINT32((1UL << buttons) | (1UL << velocity), run);
+    TEST_ASSERT_EQUAL_UINT32(300, latencyUs[buttons]);
+    TEST_ASSERT_EQUAL_UINT32(400, latencyUs[velocity]);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getRuns(buttons));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getLatency(velocity).getCount());
+
+    scheduler.record(run, latencyUs);
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler.getRuns(buttons));
+    TEST_ASSERT_EQUAL_INT32(400, scheduler.getLatency(velocity).getMax());
+}
+
+// ============================================================================
+// Debounce Tests (5 tests)
+// ============================================================================
+
+void test_press_acts_on_first_edge(void) {
+    DebouncedButton button;
+    button.reset(false);
+
+    TEST_ASSERT_TRUE(button.onEdge(true, 1000) == Event::Press);
+    TEST_ASSERT_TRUE(button.isPressed());
+    TEST_ASSERT_EQUAL_UINT32(1000, button.getEventTime());
+}
+
+void test_contact_bounce_gives_one_press_and_one_release(void) {
+    DebouncedButton button;
+    button.reset(false);
+    Event events[16];
+
+    // Press bouncing for 2 ms, held, then a release bouncing for 2 ms
+    int n = bounce(button, true, 1000, 5, 500, events);
+    TEST_ASSERT_EQUAL(1, n);
+    TEST_ASSERT_TRUE(events[0] == Event::Press);
+
+    n = bounce(button, false, 200000, 5, 500, events);
+    TEST_ASSERT_EQUAL(1, n);
+    TEST_ASSERT_TRUE(events[0] == Event::Release);
+    TEST_ASSERT_EQUAL_UINT32(200000, button.getEventTime());
+    TEST_ASSERT_FALSE(button.isPressed());
+
+    uint32_t deadline;
+    TEST_ASSERT_FALSE(button.nextDeadline(deadline));
+}
+
+void test_change_inside_window_is_taken_when_it_ends(void) {
+    DebouncedButton button;
+    button.reset(false);
+
+    TEST_ASSERT_TRUE(button.onEdge(true, 0) == Event::Press);
+    // Short tap: released 5 ms later, inside the window
+    TEST_ASSERT_TRUE(button.onEdge(false, 5000) == Event::None);
+    TEST_ASSERT_TRUE(button.isPressed());
+
+    uint32_t deadline;
+    TEST_ASSERT_TRUE(button.nextDeadline(deadline));
+    TEST_ASSERT_EQUAL_UINT32(DebouncedButton::DEBOUNCE_US, deadline);
+    TEST_ASSERT_TRUE(button.poll(deadline - 1) == Event::None);
+    TEST_ASSERT_TRUE(button.poll(deadline) == Event::Release);
+    TEST_ASSERT_FALSE(button.isPressed());
+}
+
+void test_long_press_start_and_stop(void) {
+    DebouncedButton button(100000);
+    button.reset(false);
+
+    TEST_ASSERT_TRUE(button.onEdge(true, 1000) == Event::Press);
+    uint32_t deadline;
+    TEST_ASSERT_TRUE(button.nextDeadline(deadline));
+    TEST_ASSERT_EQUAL_UINT32(101000, deadline);
+    TEST_ASSERT_TRUE(button.poll(100999) == Event::None);
+    TEST_ASSERT_TRUE(button.poll(101000) == Event::LongPressStart);
+    TEST_ASSERT_TRUE(button.poll(150000) == Event::None);
+    TEST_ASSERT_FALSE(button.nextDeadline(deadline));
+
+    TEST_ASSERT_TRUE(button.onEdge(false, 300000) == Event::LongPressStop);
+
+    // A short press on the same button is a plain release
+    TEST_ASSERT_TRUE(button.onEdge(true, 400000) == Event::Press);
+    TEST_ASSERT_TRUE(button.onEdge(false, 450000) == Event::Release);
+}
+
+void test_held_at_start_up_starts_no_long_press(void) {
+    DebouncedButton button(100000);
+    button.reset(true);
+
+    uint32_t deadline;
+    TEST_ASSERT_FALSE(button.nextDeadline(deadline));
+    TEST_ASSERT_TRUE(button.poll(500000) == Event::None);
+    TEST_ASSERT_TRUE(button.onEdge(false, 600000) == Event::LongPressStop);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    // Scheduler (7 tests)
+    RUN_TEST(test_periodic_consumers_run_on_their_own_period);
+    RUN_TEST(test_event_runs_only_its_consumers);
+    RUN_TEST(test_latency_counts_from_first_post);
+    RUN_TEST(test_wake_at_deadline);
+    RUN_TEST(test_late_run_skips_missed_periods);
+    RUN_TEST(test_schedule_survives_timer_wrap);
+    RUN_TEST(test_take_leaves_statistics_to_record);
+
+    // Debounce (5 tests)
+    RUN_TEST(test_press_acts_on_first_edge);
+    RUN_TEST(test_contact_bounce_gives_one_press_and_one_release);
+    RUN_TEST(test_change_inside_window_is_taken_when_it_ends);
+    RUN_TEST(test_long_press_start_and_stop);
+    RUN_TEST(test_held_at_start_up_starts_no_long_press);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
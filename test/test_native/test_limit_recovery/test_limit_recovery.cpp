@@ -0,0 +1,237 @@
+#include <unity.h>
+
+#include "../../../src/modules/LimitSwitch/LimitRecovery.cpp"
+
+// Axis with a lever switch at one end, stepped one step at a time. The switch
+// closes at 'closeAt', opens again 'hysteresis' steps back from it and
+// chatters for a few steps on the way out. Like LimitSwitch, a trip latches
+// the switch: edges are ignored until the recovery re-arms it.
+struct SwitchSim
+{
+    static constexpr long BOUNCE_STEPS = 3;
+
+    int8_t side;
+    long closeAt;
+    long hysteresis;
+    bool stuck = false; // Welded contacts: never opens
+    long position;
+    bool closed = false;
+    bool armed = true;
+    int trips = 0;
+    long tripPosition = 0;
+    long coast; // Steps the motor runs on after the trip before it is stopped
+
+    SwitchSim(int8_t switchSide, long close, long hyst, long start, long coastSteps = 4)
+        : side(switchSide), closeAt(close), hysteresis(hyst), position(start), coast(coastSteps) {}
+
+    long pastClose() const { return (position - closeAt) * side; }
+
+    void step(long direction)
+    {
+        position += direction;
+        bool wasClosed = closed;
+        if (pastClose() >= 0)
+            closed = true;
+        else if (!stuck && -pastClose() >= hysteresis + BOUNCE_STEPS)
+            closed = false;
+        else if (!stuck && -pastClose() >= hysteresis && direction == -side)
+            closed = (-pastClose() - hysteresis) % 2 == 0; // Chatter on release
+        if (closed && !wasClosed && armed)
+        {
+            armed = false;
+            trips++;
+            tripPosition = position;
+        }
+    }
+
+    // Drive towards the switch until it trips, then coast to a stop
+    void driveIntoSwitch()
+    {
+        int before = trips;
+        while (trips == before && pastClose() < 100)
+            step(side);
+        for (long i = 0; i < coast; i++)
+            step(side);
+    }
+
+    // One recovery move, stepped to its target
+    void run(const LimitRecovery::Move &move)
+    {
+        while (position != move.target)
+            step(move.target > position ? 1 : -1);
+    }
+
+    // Full recovery after a trip; re-arms on success like MotorController
+    LimitRecovery::Phase recover(LimitRecovery &recovery)
+    {
+        recovery.latch(side, tripPosition);
+        LimitRecovery::Move move = recovery.start(position);
+        while (move.valid)
+        {
+            run(move);
+            move = recovery.onStopped(position, closed);
+        }
+        if (recovery.getPhase() == LimitRecovery::Phase::Done)
+            armed = true;
+        return recovery.getPhase();
+    }
+};
+
+// ============================================================================
+// Back-off Tests (4 tests)
+// ============================================================================
+
+void test_max_switch_backs_off_and_rearms(void) {
+    SwitchSim sim(1, 1000, 20, 500);
+    sim.driveIntoSwitch();
+    TEST_ASSERT_EQUAL(1, sim.trips);
+    TEST_ASSERT_EQUAL_INT32(1004, sim.position);
+
+    LimitRecovery recovery;
+    TEST_ASSERT_EQUAL(LimitRecovery::Phase::Done, sim.recover(recovery));
+    TEST_ASSERT_EQUAL_UINT8(1, recovery.getAttempts());
+
+    // Counted from the trip point, not from where the coast ended
+    TEST_ASSERT_EQUAL_INT32(1000 - LimitRecovery::DEFAULT_BACKOFF_STEPS, sim.position);
+    TEST_ASSERT_FALSE(sim.closed);
+    TEST_ASSERT_TRUE(sim.armed);
+
+    // Re-armed: the next run into the switch trips it again
+    sim.driveIntoSwitch();
+    TEST_ASSERT_EQUAL(2, sim.trips);
+}
+
+void test_min_switch_backs_off_upwards(void) {
+    SwitchSim sim(-1, -2000, 20, 0);
+    sim.driveIntoSwitch();
+
+    LimitRecovery recovery;
+    TEST_ASSERT_EQUAL(LimitRecovery::Phase::Done, sim.recover(recovery));
+    TEST_ASSERT_EQUAL_INT8(-1, recovery.getSide());
+    TEST_ASSERT_EQUAL_INT32(-2000 + LimitRecovery::DEFAULT_BACKOFF_STEPS, sim.position);
+}
+
+void test_release_chatter_does_not_retrip(void) {
+    // Switch opens just inside the back-off: every bounce happens on the way out
+    SwitchSim sim(1, 1000, LimitRecovery::DEFAULT_BACKOFF_STEPS - SwitchSim::BOUNCE_STEPS - 1, 900);
+    sim.driveIntoSwitch();
+
+    LimitRecovery recovery;
+    TEST_ASSERT_EQUAL(LimitRecovery::Phase::Done, sim.recover(recovery));
+    TEST_ASSERT_EQUAL(1, sim.trips);
+}
+
+void test_stop_short_of_the_trip_counts_from_the_stop(void) {
+    // Stopped before the trip point (position read late): still a full back-off clear of it
+    LimitRecovery recovery;
+    recovery.latch(1, 1000);
+    LimitRecovery::Move move = recovery.start(990);
+    TEST_ASSERT_TRUE(move.valid);
+    TEST_ASSERT_EQUAL_INT32(990 - LimitRecovery::DEFAULT_BACKOFF_STEPS, move.target);
+    TEST_ASSERT_EQUAL_INT32(LimitRecovery::SPEED, move.speed);
+}
+
+// ============================================================================
+// Failure Tests (4 tests)
+// ============================================================================
+
+void test_wide_hysteresis_takes_a_second_back_off(void) {
+    SwitchSim sim(1, 1000, 200, 500);
+    sim.driveIntoSwitch();
+
+    LimitRecovery recovery;
+    TEST_ASSERT_EQUAL(LimitRecovery::Phase::Done, sim.recover(recovery));
+    TEST_ASSERT_EQUAL_UINT8(2, recovery.getAttempts());
+    TEST_ASSERT_EQUAL_INT32(1000 - 2 * LimitRecovery::DEFAULT_BACKOFF_STEPS, sim.position);
+}
+
+void test_stuck_switch_stays_latched(void) {
+    SwitchSim sim(1, 1000, 20, 500);
+    sim.stuck = true;
+    sim.driveIntoSwitch();
+
+    LimitRecovery recovery;
+    TEST_ASSERT_EQUAL(LimitRecovery::Phase::Failed, sim.recover(recovery));
+    TEST_ASSERT_EQUAL_UINT8(LimitRecovery::MAX_ATTEMPTS, recovery.getAttempts());
+    TEST_ASSERT_EQUAL_STRING("switch still closed after backing off", recovery.getFailure());
+    TEST_ASSERT_FALSE(sim.armed);
+}
+
+void test_zero_backoff_leaves_the_stop_latched(void) {
+    LimitRecovery recovery;
+    recovery.setBackoff(0);
+    TEST_ASSERT_FALSE(recovery.isEnabled());
+
+    recovery.latch(-1, 0);
+    TEST_ASSERT_FALSE(recovery.start(-4).valid);
+    TEST_ASSERT_EQUAL(LimitRecovery::Phase::Failed, recovery.getPhase());
+}
+
+void test_abort_ends_the_back_off(void) {
+    LimitRecovery recovery;
+    recovery.latch(1, 1000);
+    TEST_ASSERT_TRUE(recovery.start(1004).valid);
+    TEST_ASSERT_TRUE(recovery.isActive());
+
+    recovery.abort("emergency stop");
+    TEST_ASSERT_EQUAL(LimitRecovery::Phase::Failed, recovery.getPhase());
+    TEST_ASSERT_EQUAL_STRING("emergency stop", recovery.getFailure());
+    TEST_ASSERT_EQUAL_STRING("failed", recovery.getPhaseName());
+    TEST_ASSERT_FALSE(recovery.onStopped(950, false).valid);
+
+    // A new trip starts over
+    recovery.latch(1, 1000);
+    TEST_ASSERT_EQUAL_UINT8(0, recovery.getAttempts());
+    TEST_ASSERT_EQUAL_STRING("latched", recovery.getPhaseName());
+}
+
+// ============================================================================
+// Configuration Tests (1 test)
+// ============================================================================
+
+void test_backoff_is_clamped(void) {
+    LimitRecovery recovery;
+    recovery.setBackoff(5000);
+    TEST_ASSERT_EQUAL_INT32(LimitRecovery::MAX_BACKOFF_STEPS, recovery.getBackoff());
+    recovery.setBackoff(-1);
+    TEST_ASSERT_EQUAL_INT32(0, recovery.getBackoff());
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    // Back-off (4 tests)
+    RUN_TEST(test_max_switch_backs_off_and_rearms);
+    RUN_TEST(test_min_switch_backs_off_upwards);
+    RUN_TEST(test_release_chatter_does_not_retrip);
+    RUN_TEST(test_stop_short_of_the_trip_counts_from_the_stop);
+
+    // Failures (4 tests)
+    RUN_TEST(test_wide_hysteresis_takes_a_second_back_off);
+    RUN_TEST(test_stuck_switch_stays_latched);
+    RUN_TEST(test_zero_backoff_leaves_the_stop_latched);
+    RUN_TEST(test_abort_ends_the_back_off);
+
+    // Configuration (1 test)
+    RUN_TEST(test_backoff_is_clamped);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
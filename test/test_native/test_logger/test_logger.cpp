@@ -0,0 +1,282 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <atomic>
+
+#include "../../../src/MpscQueue.h"
+#include "../../../src/modules/Logger/LogRecord.cpp"
+#include "../../../src/modules/Logger/LogModules.cpp"
+
+// Capture a call the way Logger::log() does and format its message
+template <typename... Args>
+static const char *format(const char *fmt, Args... args)
+{
+    static char out[256];
+    LogRecord record;
+    record.begin(2, "test", fmt, 0);
+    record.capture(args...);
+    record.formatMessage(out, sizeof(out));
+    return out;
+}
+
+// Same call through snprintf, for comparison
+template <typename... Args>
+static const char *reference(const char *fmt, Args... args)
+{
+    static char out[256];
+    snprintf(out, sizeof(out), fmt, args...);
+    return out;
+}
+
+// ============================================================================
+// Record Formatting Tests (7 tests)
+// ============================================================================
+
+void test_formats_like_printf(void) {
+    TEST_ASSERT_EQUAL_STRING(reference("Move to %ld at %d steps/s", 12345L, -800),
+                             format("Move to %ld at %d steps/s", 12345L, -800));
+    TEST_ASSERT_EQUAL_STRING(reference("%u %lu 0x%X %o", 7u, 4000000000UL, 0xBEEFu, 8u),
+                             format("%u %lu 0x%X %o", 7u, 4000000000UL, 0xBEEFu, 8u));
+    TEST_ASSERT_EQUAL_STRING(reference("%.1f %.0f %8.3f %e", 3.14159, 2.5f, -1.0, 1e-7),
+                             format("%.1f %.0f %8.3f %e", 3.14159, 2.5f, -1.0, 1e-7));
+    TEST_ASSERT_EQUAL_STRING(reference("[%02d:%03d] %-6s| %5s %c 100%%", 7, 42, "ab", "cd", 'x'),
+                             format("[%02d:%03d] %-6s| %5s %c 100%%", 7, 42, "ab", "cd", 'x'));
+}
+
+void test_width_and_precision_from_arguments(void) {
+    TEST_ASSERT_EQUAL_STRING(reference("%*d|%.*f|%-*s|", 6, 42, 2, 1.23456, 4, "x"),
+                             format("%*d|%.*f|%-*s|", 6, 42, 2, 1.23456, 4, "x"));
+}
+
+void test_strings_are_copied_at_capture(void) {
+    char buffer[16];
+    strcpy(buffer, "before");
+    LogRecord record;
+    record.begin(2, "test", "%s/%s", 0);
+    record.capture((const char *)buffer, "literal");
+    strcpy(buffer, "after"); // Caller's buffer reused before the sink runs
+
+    char out[64];
+    record.formatMessage(out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("before/literal", out);
+    TEST_ASSERT_FALSE(record.truncated);
+}
+
+void test_conversions_wrap_like_the_type_they_name(void) {
+    // %u/%x of a negative int and %d of an unsigned past INT_MAX print as printf would
+    TEST_ASSERT_EQUAL_STRING(reference("%u %x %d %hhu", (unsigned)-1, (unsigned)-2, (int)3000000000u, 300),
+                             format("%u %x %d %hhu", -1, -2, 3000000000u, 300));
+    // Mismatched kinds are converted rather than reinterpreted
+    TEST_ASSERT_EQUAL_STRING("2.0 3", format("%.1f %d", 2, 3.7));
+    TEST_ASSERT_EQUAL_STRING("(?)", format("%s", 5));
+}
+
+void test_missing_and_extra_arguments(void) {
+    TEST_ASSERT_EQUAL_STRING("a=1 b=%ld", format("a=%d b=%ld", 1));
+    TEST_ASSERT_EQUAL_STRING("only 1", format("only %d", 1, 2, 3));
+    TEST_ASSERT_EQUAL_STRING("(null)", format("%s", (const char *)nullptr));
+}
+
+void test_overflow_is_truncated_and_marked(void) {
+    char longString[100];
+    memset(longString, 'x', sizeof(longString) - 1);
+    longString[sizeof(longString) - 1] = '\0';
+
+    LogRecord record;
+    record.begin(1, "fn", "%s|%s", 0);
+    record.capture((const char *)longString, "tail");
+    TEST_ASSERT_TRUE(record.truncated);
+
+    char out[256];
+    record.formatMessage(out, sizeof(out));
+    TEST_ASSERT_EQUAL(LogRecord::TEXT_SIZE - 1 + 1, (int)strlen(out)); // Clipped string, '|', empty tail
+
+    // More arguments than slots
+    record.begin(1, "fn", "%d %d %d %d %d %d %d %d %d %d %d", 0);
+    record.capture(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11);
+    TEST_ASSERT_TRUE(record.truncated);
+    record.formatMessage(out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("1 2 3 4 5 6 7 8 9 10 %d", out);
+
+    // Output buffer too small: clipped and terminated
+    record.formatMessage(out, 6);
+    TEST_ASSERT_EQUAL_STRING("1 2 3", out);
+}
+
+void test_line_has_time_level_and_function(void) {
+    LogRecord record;
+    record.begin(1, "update", "Stopped at %ld", 3723004); // 01:02:03.004
+    record.capture(-5L);
+
+    char out[128];
+    size_t length = record.formatLine(out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("[01:02:03.004] [WARN] [update]: Stopped at -5", out);
+    TEST_ASSERT_EQUAL(strlen(out), length);
+}
+
+// ============================================================================
+// Ring Tests (3 tests)
+// ============================================================================
+
+void test_ring_is_fifo_and_bounded(void) {
+    MpscQueue<uint32_t, 4> ring;
+    for (uint32_t i = 1; i <= 4; i++)
+        TEST_ASSERT_TRUE(ring.push(i));
+    TEST_ASSERT_FALSE(ring.push(5));
+
+    uint32_t value;
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL_UINT32(1, value);
+    TEST_ASSERT_TRUE(ring.push(5)); // Room again after a pop
+
+    for (uint32_t expected = 2; expected <= 5; expected++)
+    {
+        TEST_ASSERT_TRUE(ring.pop(value));
+        TEST_ASSERT_EQUAL_UINT32(expected, value);
+    }
+    TEST_ASSERT_FALSE(ring.pop(value));
+    TEST_ASSERT_NULL(ring.front());
+}
+
+void test_records_are_formatted_in_place(void) {
+    static MpscQueue<LogRecord, 8> ring;
+    TEST_ASSERT_TRUE(ring.emplace([](LogRecord &record) {
+        record.begin(2, "fn", "n=%d", 0);
+        record.capture(7);
+    }));
+
+    const LogRecord *record = ring.front();
+    TEST_ASSERT_NOT_NULL(record);
+    char out[32];
+    record->formatMessage(out, sizeof(out));
+    ring.pop();
+    TEST_ASSERT_EQUAL_STRING("n=7", out);
+    TEST_ASSERT_NULL(ring.front());
+}
+
+void test_concurrent_producers_lose_and_reorder_nothing(void) {
+    // Each producer tags its values; the consumer checks every producer's
+    // sequence arrives complete and in order
+    static MpscQueue<uint32_t, 64> ring;
+    const uint32_t producers = 4;
+    const uint32_t perProducer = 200000;
+    std::atomic<uint32_t> finished(0);
+
+    auto producer = [&](uint32_t id) {
+        for (uint32_t i = 0; i < perProducer; i++)
+        {
+            while (!ring.push(id << 24 | i))
+                std::this_thread::yield();
+        }
+        finished++;
+    };
+
+    std::thread threads[producers];
+    for (uint32_t id = 0; id < producers; id++)
+        threads[id] = std::thread(producer, id);
+
+    uint32_t next[producers] = {0, 0, 0, 0};
+    uint32_t received = 0, outOfOrder = 0;
+    uint32_t value;
+    while (received < producers * perProducer)
+    {
+        if (!ring.pop(value))
+            continue;
+        uint32_t id = value >> 24;
+        if ((value & 0xFFFFFF) != next[id])
+            outOfOrder++;
+        next[id] = (value & 0xFFFFFF) + 1;
+        received++;
+    }
+    for (uint32_t id = 0; id < producers; id++)
+        threads[id].join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, outOfOrder);
+    TEST_ASSERT_EQUAL_UINT32(producers, finished.load());
+    TEST_ASSERT_FALSE(ring.pop(value));
+}
+
+// ============================================================================
+// Module Level Tests (3 tests)
+// ============================================================================
+
+void test_module_and_level_names_round_trip(void) {
+    for (uint8_t i = 0; i < LOG_MODULE_COUNT; i++) {
+        LogModule module = LogModule::Count;
+        TEST_ASSERT_TRUE(logModuleFromName(logModuleName((LogModule)i), module));
+        TEST_ASSERT_EQUAL_UINT8(i, (uint8_t)module);
+    }
+    for (uint8_t level = LOG_LEVEL_ERROR; level <= LOG_LEVEL_DEBUG; level++) {
+        uint8_t parsed = 0xFF;
+        TEST_ASSERT_TRUE(logLevelFromName(logLevelName(level), parsed));
+        TEST_ASSERT_EQUAL_UINT8(level, parsed);
+    }
+    TEST_ASSERT_EQUAL_STRING("webServer", logModuleName(LogModule::WebServer));
+    TEST_ASSERT_EQUAL_STRING("warn", logLevelName(LOG_LEVEL_WARN));
+}
+
+void test_unknown_names_are_rejected(void) {
+    LogModule module = LogModule::System;
+    uint8_t level = LOG_LEVEL_INFO;
+    TEST_ASSERT_FALSE(logModuleFromName("WebServer", module));
+    TEST_ASSERT_FALSE(logModuleFromName("all", module));
+    TEST_ASSERT_FALSE(logModuleFromName(nullptr, module));
+    TEST_ASSERT_FALSE(logLevelFromName("verbose", level));
+    TEST_ASSERT_FALSE(logLevelFromName("", level));
+    TEST_ASSERT_EQUAL((int)LogModule::System, (int)module);
+    TEST_ASSERT_EQUAL_UINT8(LOG_LEVEL_INFO, level);
+    TEST_ASSERT_EQUAL_STRING("unknown", logModuleName(LogModule::Count));
+    TEST_ASSERT_EQUAL_STRING("unknown", logLevelName(7));
+}
+
+void test_ceiling_defaults_to_debug_at_compile_time(void) {
+    // Usable in a constant expression, which is what lets LOG_* fold away
+    static_assert(logMaxLevel(LogModule::MotorController) == LOG_LEVEL_DEBUG, "default ceiling");
+    for (uint8_t i = 0; i < LOG_MODULE_COUNT; i++)
+        TEST_ASSERT_EQUAL_UINT8(LOG_MAX_LEVEL, logMaxLevel((LogModule)i));
+    TEST_ASSERT_TRUE(LOG_LEVEL <= LOG_MAX_LEVEL);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    // Record formatting (7 tests)
+    RUN_TEST(test_formats_like_printf);
+    RUN_TEST(test_width_and_precision_from_arguments);
+    RUN_TEST(test_strings_are_copied_at_capture);
+    RUN_TEST(test_conversions_wrap_like_the_type_they_name);
+    RUN_TEST(test_missing_and_extra_arguments);
+    RUN_TEST(test_overflow_is_truncated_and_marked);
+    RUN_TEST(test_line_has_time_level_and_function);
+
+    // Ring (3 tests)
+    RUN_TEST(test_ring_is_fifo_and_bounded);
+    RUN_TEST(test_records_are_formatted_in_place);
+    RUN_TEST(test_concurrent_producers_lose_and_reorder_nothing);
+
+    // Module levels (3 tests)
+    RUN_TEST(test_module_and_level_names_round_trip);
+    RUN_TEST(test_unknown_names_are_rejected);
+    RUN_TEST(test_ceiling_defaults_to_debug_at_compile_time);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -0,0 +1,155 @@
+#include <unity.h>
+
+#include "../../../src/modules/StepGenerator/MicrostepScale.cpp"
+
+// ============================================================================
+// Resolution Selection Tests
+// ============================================================================
+
+void test_select_keeps_pulse_rate_down(void) {
+    TEST_ASSERT_EQUAL_UINT16(32, MicrostepScale::select(1600, 400));    // Slow: 1600 pulses/s
+    TEST_ASSERT_EQUAL_UINT16(16, MicrostepScale::select(1600, 8000));   // 16000 pulses/s
+    TEST_ASSERT_EQUAL_UINT16(8, MicrostepScale::select(16000, 14400));  // Default max speed
+    TEST_ASSERT_EQUAL_UINT16(4, MicrostepScale::select(16000, 40000));
+    TEST_ASSERT_EQUAL_UINT16(2, MicrostepScale::select(-16000, 100000)); // Coarsest, even if still over
+}
+
+void test_select_never_coarse_under_a_full_step(void) {
+    TEST_ASSERT_EQUAL_UINT16(8, MicrostepScale::select(7, 100000));
+    TEST_ASSERT_EQUAL_UINT16(8, MicrostepScale::select(-3, 100000));
+    TEST_ASSERT_EQUAL_UINT16(2, MicrostepScale::select(8, 100000));
+}
+
+void test_mres_encoding(void) {
+    TEST_ASSERT_EQUAL_UINT8(3, MicrostepScale::mres(32));
+    TEST_ASSERT_EQUAL_UINT8(5, MicrostepScale::mres(8));
+    TEST_ASSERT_EQUAL_UINT8(7, MicrostepScale::mres(2));
+}
+
+// ============================================================================
+// Position Bookkeeping Tests
+// ============================================================================
+
+void test_identity_at_canonical_resolution(void) {
+    MicrostepScale scale;
+    TEST_ASSERT_EQUAL_INT32(1234, scale.toCanonical(1234));
+    TEST_ASSERT_EQUAL_INT32(-77, scale.toEngine(-77));
+    TEST_ASSERT_EQUAL_UINT32(14400, scale.toEngineRate(14400));
+}
+
+void test_switch_only_on_the_full_step_grid(void) {
+    MicrostepScale scale;
+    TEST_ASSERT_FALSE(scale.switchTo(2, 13));
+    TEST_ASSERT_EQUAL_UINT16(8, scale.getMicrosteps());
+    TEST_ASSERT_TRUE(scale.switchTo(2, 16));
+    TEST_ASSERT_EQUAL_UINT16(2, scale.getMicrosteps());
+
+    // Half steps from there: one pulse is 4 canonical units
+    TEST_ASSERT_EQUAL_INT32(16 + 4 * 100, scale.toCanonical(16 + 100));
+    TEST_ASSERT_EQUAL_INT32(16 + 100, scale.toEngine(16 + 4 * 100));
+    TEST_ASSERT_EQUAL_UINT32(3600, scale.toEngineRate(14400));
+
+    // A half step is not a full step
+    TEST_ASSERT_FALSE(scale.isFullStepAligned(16 + 101));
+    TEST_ASSERT_TRUE(scale.isFullStepAligned(16 + 102));
+}
+
+void test_round_trips_are_exact(void) {
+    // Random walk of moves and resolution changes: the canonical position tracked
+    // from pulses always equals the one tracked directly
+    MicrostepScale scale;
+    long engine = 0;
+    long canonical = 0;
+    const uint16_t resolutions[] = {32, 2, 16, 4, 8, 32, 4, 2, 16};
+    uint32_t seed = 12345;
+    for (int move = 0; move < 500; move++)
+    {
+        seed = seed * 1103515245 + 12345;
+        long distance = (long)((seed >> 8) % 4001) - 2000;
+        long target = scale.reachable(canonical, canonical + distance);
+        long pulses = scale.toEngine(target) - engine;
+        engine += pulses;
+        canonical = target;
+        TEST_ASSERT_EQUAL_INT32(canonical, scale.toCanonical(engine));
+
+        if (scale.isFullStepAligned(engine))
+            TEST_ASSERT_TRUE(scale.switchTo(resolutions[move % 9], engine));
+        TEST_ASSERT_EQUAL_INT32(canonical, scale.toCanonical(engine));
+    }
+}
+
+void test_coarse_moves_stop_on_the_last_full_step(void) {
+    MicrostepScale scale;
+    scale.setGridOrigin(0);
+    TEST_ASSERT_TRUE(scale.switchTo(4, 800));
+
+    TEST_ASSERT_EQUAL_INT32(1000, scale.reachable(800, 1003)); // Remainder of 3 finished at 1/8
+    TEST_ASSERT_EQUAL_INT32(1000, scale.reachable(800, 1000));
+    TEST_ASSERT_EQUAL_INT32(608, scale.reachable(800, 603));   // Backwards stops short too
+    TEST_ASSERT_EQUAL_INT32(1000 - 800, (scale.toEngine(1000) - scale.toEngine(800)) * 2);
+}
+
+void test_fine_resolution_keeps_fractions(void) {
+    MicrostepScale scale;
+    TEST_ASSERT_TRUE(scale.switchTo(32, 0));
+    TEST_ASSERT_EQUAL_INT32(10, scale.toCanonical(41)); // 10.25 canonical
+    TEST_ASSERT_EQUAL_INT32(-1, scale.toCanonical(-1)); // Rounds down, not towards zero
+    TEST_ASSERT_FALSE(scale.isFullStepAligned(41));
+    TEST_ASSERT_FALSE(scale.switchTo(8, 41)); // Stopped between canonical positions
+
+    // Redefining the position keeps the quarter unit, so the grid stays exact
+    long engine = scale.setCurrentPosition(41, 5000);
+    TEST_ASSERT_EQUAL_INT32(5000, scale.toCanonical(engine));
+    TEST_ASSERT_FALSE(scale.isFullStepAligned(engine));
+    TEST_ASSERT_TRUE(scale.isFullStepAligned(engine + 23)); // Old canonical 16: 0.75 + 5 units on
+}
+
+void test_set_current_position_moves_the_grid(void) {
+    MicrostepScale scale;
+    scale.setGridOrigin(0);
+    long engine = scale.setCurrentPosition(0, 1003); // Shaft still on a full step
+    TEST_ASSERT_TRUE(scale.isFullStepAligned(engine));
+    TEST_ASSERT_FALSE(scale.isFullStepAligned(engine + 5));
+    TEST_ASSERT_TRUE(scale.isFullStepAligned(engine - 8));
+
+    // Coarse moves now stop on the shifted grid
+    TEST_ASSERT_TRUE(scale.switchTo(2, engine));
+    TEST_ASSERT_EQUAL_INT32(1011, scale.reachable(1003, 1017));
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    // Resolution selection (3 tests)
+    RUN_TEST(test_select_keeps_pulse_rate_down);
+    RUN_TEST(test_select_never_coarse_under_a_full_step);
+    RUN_TEST(test_mres_encoding);
+
+    // Position bookkeeping (6 tests)
+    RUN_TEST(test_identity_at_canonical_resolution);
+    RUN_TEST(test_switch_only_on_the_full_step_grid);
+    RUN_TEST(test_round_trips_are_exact);
+    RUN_TEST(test_coarse_moves_stop_on_the_last_full_step);
+    RUN_TEST(test_fine_resolution_keeps_fractions);
+    RUN_TEST(test_set_current_position_moves_the_grid);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
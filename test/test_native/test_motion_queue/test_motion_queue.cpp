@@ -0,0 +1,225 @@
+#include <unity.h>
+#include <stdio.h>
+
+#include "../../../src/modules/StepGenerator/RampGenerator.cpp"
+#include "../../../src/modules/StepGenerator/MotionQueue.cpp"
+
+// Production defaults (Configuration.cpp)
+static constexpr uint32_t MAX_SPEED = 180 * 80;
+static constexpr uint32_t ACCELERATION = 1000 * 80;
+
+struct SequenceResult
+{
+    uint64_t moveTimeUs;
+    long finalPosition;
+    uint32_t minJunctionSpeed; // Lowest speed seen passing an intermediate target
+};
+
+// Mirrors MotorController::feedStepGenerator()/advanceMotionQueue() for the trapezoid planner
+static SequenceResult runSequence(const long *targets, int count, bool blend)
+{
+    RampGenerator ramp;
+    ramp.setMaxSpeed(MAX_SPEED);
+    ramp.setAcceleration(ACCELERATION);
+    MotionQueue queue;
+
+    auto startSegment = [&]() {
+        const MotionSegment *segment = queue.front();
+        ramp.setMaxSpeed(segment->maxSpeed);
+        if (blend)
+        {
+            long speed = ramp.getSpeedStepsPerSec();
+            queue.plan(ramp.currentPosition(), speed < 0 ? -speed : speed, ACCELERATION);
+        }
+        ramp.setExitSpeed(segment->exitSpeed);
+        ramp.moveTo(segment->target);
+    };
+
+    for (int i = 0; i < count; i++)
+        queue.push(0, targets[i], MAX_SPEED);
+    startSegment();
+
+    SequenceResult result = {0, 0, UINT32_MAX};
+    int8_t direction;
+    while (!queue.isEmpty())
+    {
+        if (ramp.isAtTarget() && (!ramp.isRunning() || ramp.getExitSpeed() > 0))
+        {
+            if (queue.size() > 1)
+            {
+                long speed = ramp.getSpeedStepsPerSec();
+                uint32_t junction = speed < 0 ? -speed : speed;
+                if (junction < result.minJunctionSpeed)
+                    result.minJunctionSpeed = junction;
+            }
+            queue.pop();
+            if (!queue.isEmpty())
+                startSegment();
+        }
+
+        uint32_t interval = ramp.nextStep(direction);
+        result.moveTimeUs += interval;
+    }
+
+    result.finalPosition = ramp.currentPosition();
+    return result;
+}
+
+// ============================================================================
+// Queue Tests
+// ============================================================================
+
+void test_queue_push_pop_and_capacity(void) {
+    MotionQueue queue;
+    TEST_ASSERT_TRUE(queue.isEmpty());
+    TEST_ASSERT_EQUAL_UINT8(MotionQueue::CAPACITY, queue.freeSlots());
+
+    for (int i = 0; i < MotionQueue::CAPACITY; i++)
+        TEST_ASSERT_TRUE(queue.push(0, (i + 1) * 100, MAX_SPEED));
+    TEST_ASSERT_TRUE(queue.isFull());
+    TEST_ASSERT_FALSE(queue.push(0, 99999, MAX_SPEED));
+
+    // Segments chain: each starts where the previous one ends
+    TEST_ASSERT_EQUAL_INT32(0, queue.get(0)->start);
+    TEST_ASSERT_EQUAL_INT32(100, queue.get(1)->start);
+
+    TEST_ASSERT_TRUE(queue.pop());
+    TEST_ASSERT_EQUAL_INT32(200, queue.front()->target);
+    TEST_ASSERT_EQUAL_UINT8(1, queue.freeSlots());
+
+    queue.clearPending();
+    TEST_ASSERT_EQUAL_UINT8(1, queue.size());
+    queue.clear();
+    TEST_ASSERT_NULL(queue.front());
+}
+
+void test_plan_same_direction_junction_uses_lower_speed(void) {
+    MotionQueue queue;
+    queue.push(0, 20000, 10000);
+    queue.push(0, 40000, 6000);
+    queue.push(0, 60000, 8000);
+    queue.plan(0, 0, ACCELERATION);
+
+    TEST_ASSERT_EQUAL_UINT32(6000, queue.get(0)->exitSpeed);
+    TEST_ASSERT_EQUAL_UINT32(6000, queue.get(1)->exitSpeed);
+    TEST_ASSERT_EQUAL_UINT32(0, queue.get(2)->exitSpeed); // Last segment always stops
+}
+
+void test_plan_reversal_stops_at_junction(void) {
+    MotionQueue queue;
+    queue.push(0, 20000, MAX_SPEED);
+    queue.push(0, 5000, MAX_SPEED);
+    queue.plan(0, 0, ACCELERATION);
+
+    TEST_ASSERT_EQUAL_UINT32(0, queue.get(0)->exitSpeed);
+}
+
+void test_plan_short_segments_limited_by_acceleration(void) {
+    MotionQueue queue;
+    queue.push(0, 20000, MAX_SPEED);
+    queue.push(0, 20100, MAX_SPEED); // Too short to stop from full speed
+    queue.plan(0, 0, ACCELERATION);
+
+    // Backward pass: sqrt(2 a d) to stop within the last 100 steps
+    uint32_t expected = RampGenerator::isqrt64(2ULL * ACCELERATION * 100);
+    TEST_ASSERT_UINT32_WITHIN(1, expected, queue.get(0)->exitSpeed);
+
+    // Forward pass: a short first segment can't reach the junction limit
+    MotionQueue shortFirst;
+    shortFirst.push(0, 50, MAX_SPEED);
+    shortFirst.push(0, 20000, MAX_SPEED);
+    shortFirst.plan(0, 0, ACCELERATION);
+    TEST_ASSERT_UINT32_WITHIN(1, RampGenerator::isqrt64(2ULL * ACCELERATION * 50), shortFirst.get(0)->exitSpeed);
+}
+
+// ============================================================================
+// Execution with RampGenerator
+// ============================================================================
+
+void test_blended_sequence_does_not_stop_between_points(void) {
+    const long targets[] = {5000, 10000, 15000, 20000};
+    SequenceResult stopped = runSequence(targets, 4, false);
+    SequenceResult blended = runSequence(targets, 4, true);
+
+    char line[160];
+    snprintf(line, sizeof(line), "4 stops: rest-to-rest %.1f ms, blended %.1f ms",
+             stopped.moveTimeUs / 1000.0, blended.moveTimeUs / 1000.0);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_EQUAL_INT32(20000, stopped.finalPosition);
+    TEST_ASSERT_EQUAL_INT32(20000, blended.finalPosition);
+    TEST_ASSERT_GREATER_THAN_UINT32(MAX_SPEED * 9 / 10, blended.minJunctionSpeed);
+    // Same as one 20000 step move, well under the rest-to-rest time
+    double single = (20000.0 / MAX_SPEED + (double)MAX_SPEED / ACCELERATION) * 1e6;
+    TEST_ASSERT_DOUBLE_WITHIN(single * 0.02, single, (double)blended.moveTimeUs);
+    TEST_ASSERT_LESS_THAN_DOUBLE(stopped.moveTimeUs * 0.75, (double)blended.moveTimeUs);
+}
+
+void test_blended_sequence_with_reversal_stops_once(void) {
+    const long targets[] = {8000, 16000, 4000};
+    SequenceResult blended = runSequence(targets, 3, true);
+
+    TEST_ASSERT_EQUAL_INT32(4000, blended.finalPosition);
+    TEST_ASSERT_EQUAL_UINT32(0, blended.minJunctionSpeed); // The reversal at 16000
+}
+
+void test_queue_appended_while_decelerating_raises_exit_speed(void) {
+    RampGenerator ramp;
+    ramp.setMaxSpeed(MAX_SPEED);
+    ramp.setAcceleration(ACCELERATION);
+    MotionQueue queue;
+    queue.push(0, 10000, MAX_SPEED);
+    ramp.moveTo(10000);
+
+    // Run into the deceleration phase of the only segment
+    int8_t direction;
+    while (ramp.distanceToGo() > 1000)
+        ramp.nextStep(direction);
+    uint32_t slowed = ramp.getSpeedStepsPerSec();
+    TEST_ASSERT_LESS_THAN_UINT32(MAX_SPEED, slowed);
+
+    // A new same-direction point arrives: replan and the ramp speeds back up
+    queue.push(0, 30000, MAX_SPEED);
+    queue.plan(ramp.currentPosition(), slowed, ACCELERATION);
+    ramp.setExitSpeed(queue.front()->exitSpeed);
+    TEST_ASSERT_GREATER_THAN_UINT32(slowed, queue.front()->exitSpeed);
+
+    for (int i = 0; i < 200; i++)
+        ramp.nextStep(direction);
+    TEST_ASSERT_GREATER_THAN_UINT32(slowed, (uint32_t)ramp.getSpeedStepsPerSec());
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    // Queue
+    RUN_TEST(test_queue_push_pop_and_capacity);
+    RUN_TEST(test_plan_same_direction_junction_uses_lower_speed);
+    RUN_TEST(test_plan_reversal_stops_at_junction);
+    RUN_TEST(test_plan_short_segments_limited_by_acceleration);
+
+    // Execution
+    RUN_TEST(test_blended_sequence_does_not_stop_between_points);
+    RUN_TEST(test_blended_sequence_with_reversal_stops_once);
+    RUN_TEST(test_queue_appended_while_decelerating_raises_exit_speed);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -0,0 +1,132 @@
+#include <unity.h>
+#include <thread>
+
+#include "../../../src/modules/MotorController/MotorCommand.cpp"
+
+// ============================================================================
+// MotorCommandRouter Tests
+// ============================================================================
+
+void test_commands_keep_producer_order(void) {
+    MotorCommandRouter router;
+    router.post(CommandSource::Network, MotorCommandType::MoveTo, 100, 500);
+    router.post(CommandSource::Network, MotorCommandType::JogStop);
+    router.post(CommandSource::Network, MotorCommandType::MoveTo, 200, 500);
+
+    MotorCommand command;
+    TEST_ASSERT_TRUE(router.next(command));
+    TEST_ASSERT_EQUAL_INT32(100, command.position);
+    TEST_ASSERT_TRUE(router.next(command));
+    TEST_ASSERT_TRUE(command.type == MotorCommandType::JogStop);
+    TEST_ASSERT_TRUE(router.next(command));
+    TEST_ASSERT_EQUAL_INT32(200, command.position);
+    TEST_ASSERT_FALSE(router.next(command));
+}
+
+void test_sources_drain_in_fixed_order(void) {
+    MotorCommandRouter router;
+    router.post(CommandSource::Input, MotorCommandType::JogStop);
+    router.post(CommandSource::Network, MotorCommandType::MoveTo, 1, 500);
+
+    MotorCommand command;
+    TEST_ASSERT_TRUE(router.next(command));
+    TEST_ASSERT_TRUE(command.type == MotorCommandType::MoveTo);
+    TEST_ASSERT_TRUE(router.next(command));
+    TEST_ASSERT_TRUE(command.type == MotorCommandType::JogStop);
+}
+
+void test_full_ring_rejects_and_counts(void) {
+    MotorCommandRouter router;
+    for (size_t i = 0; i < MotorCommandRouter::QUEUE_SIZE; i++)
+        TEST_ASSERT_TRUE(router.post(CommandSource::Input, MotorCommandType::MoveTo, i, 500));
+
+    TEST_ASSERT_FALSE(router.post(CommandSource::Input, MotorCommandType::MoveTo, 99, 500));
+    TEST_ASSERT_EQUAL_UINT32(1, router.getDroppedCount());
+    // Other producers are unaffected
+    TEST_ASSERT_TRUE(router.post(CommandSource::Network, MotorCommandType::JogStop));
+}
+
+void test_emergency_stop_discards_earlier_commands(void) {
+    MotorCommandRouter router;
+    router.post(CommandSource::Network, MotorCommandType::MoveTo, 1000, 500);
+    router.post(CommandSource::Input, MotorCommandType::MoveTo, 2000, 500);
+
+    router.requestEmergencyStop();
+    router.post(CommandSource::Network, MotorCommandType::ClearEmergencyStop);
+
+    TEST_ASSERT_TRUE(router.takeEmergencyStop());
+    TEST_ASSERT_FALSE(router.takeEmergencyStop()); // Once per request
+
+    MotorCommand command;
+    TEST_ASSERT_TRUE(router.next(command));
+    TEST_ASSERT_TRUE(command.type == MotorCommandType::ClearEmergencyStop);
+    TEST_ASSERT_FALSE(router.next(command));
+    TEST_ASSERT_EQUAL_UINT32(2, router.getDroppedCount());
+}
+
+void test_concurrent_producers_lose_nothing(void) {
+    static constexpr long COUNT = 200000;
+    MotorCommandRouter router;
+
+    auto producer = [&router](CommandSource source) {
+        for (long i = 0; i < COUNT; i++)
+        {
+            while (!router.post(source, MotorCommandType::MoveTo, i, (long)source))
+                std::this_thread::yield();
+        }
+    };
+
+    std::thread network(producer, CommandSource::Network);
+    std::thread input(producer, CommandSource::Input);
+
+    long expected[2] = {0, 0};
+    bool ordered = true;
+    MotorCommand command;
+    while (expected[0] < COUNT || expected[1] < COUNT)
+    {
+        if (!router.next(command))
+            continue;
+        // value carries the source; positions must arrive in order per source
+        long &next = expected[command.value];
+        if (command.position != next)
+            ordered = false;
+        next = command.position + 1;
+    }
+
+    network.join();
+    input.join();
+
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL_INT32(COUNT, expected[0]);
+    TEST_ASSERT_EQUAL_INT32(COUNT, expected[1]);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_commands_keep_producer_order);
+    RUN_TEST(test_sources_drain_in_fixed_order);
+    RUN_TEST(test_full_ring_rejects_and_counts);
+    RUN_TEST(test_emergency_stop_discards_earlier_commands);
+    RUN_TEST(test_concurrent_producers_lose_nothing);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -0,0 +1,130 @@
+#include <unity.h>
+#include <thread>
+#include <atomic>
+
+#include "../../../src/Seqlock.h"
+#include "../../../src/modules/MotorController/MotorState.h"
+
+// Snapshot whose fields all follow from one counter, so a copy mixed from
+// two writes shows up as a mismatch
+static MotorStateSnapshot makeSnapshot(uint32_t i)
+{
+    MotorStateSnapshot snapshot = {};
+    snapshot.version = i;
+    snapshot.timeUs = i * 3;
+    snapshot.position = (int32_t)i;
+    snapshot.target = -(int32_t)i;
+    snapshot.speed = (float)(i & 0xFFFF);
+    snapshot.encoderAngle = (uint16_t)(i & 0x3FFF);
+    snapshot.microsteps = (uint16_t)(i & 0xFF);
+    snapshot.flags = (uint16_t)(i >> 4);
+    snapshot.queueDepth = (uint8_t)i;
+    snapshot.queueFree = (uint8_t)~i;
+    return snapshot;
+}
+
+static bool isConsistent(const MotorStateSnapshot &s)
+{
+    MotorStateSnapshot expected = makeSnapshot(s.version);
+    return s.timeUs == expected.timeUs && s.position == expected.position && s.target == expected.target &&
+           s.speed == expected.speed && s.encoderAngle == expected.encoderAngle &&
+           s.microsteps == expected.microsteps && s.flags == expected.flags &&
+           s.queueDepth == expected.queueDepth && s.queueFree == expected.queueFree;
+}
+
+// ============================================================================
+// Seqlock Tests (4 tests)
+// ============================================================================
+
+void test_read_fails_before_first_write(void) {
+    Seqlock<MotorStateSnapshot> lock;
+    MotorStateSnapshot snapshot;
+    TEST_ASSERT_FALSE(lock.read(snapshot));
+    TEST_ASSERT_EQUAL_UINT32(0, lock.written());
+}
+
+void test_read_returns_last_write(void) {
+    Seqlock<MotorStateSnapshot> lock;
+    lock.write(makeSnapshot(1));
+    lock.write(makeSnapshot(2));
+
+    MotorStateSnapshot snapshot;
+    TEST_ASSERT_TRUE(lock.read(snapshot));
+    TEST_ASSERT_EQUAL_UINT32(2, snapshot.version);
+    TEST_ASSERT_TRUE(isConsistent(snapshot));
+    TEST_ASSERT_EQUAL_UINT32(2, lock.written());
+}
+
+void test_flags(void) {
+    MotorStateSnapshot snapshot = {};
+    snapshot.flags = MotorStateSnapshot::MOVING | MotorStateSnapshot::LIMIT_MAX;
+    TEST_ASSERT_TRUE(snapshot.has(MotorStateSnapshot::MOVING));
+    TEST_ASSERT_TRUE(snapshot.has(MotorStateSnapshot::LIMIT_MAX));
+    TEST_ASSERT_FALSE(snapshot.has(MotorStateSnapshot::LIMIT_MIN));
+    TEST_ASSERT_FALSE(snapshot.has(MotorStateSnapshot::EMERGENCY_STOP));
+}
+
+void test_concurrent_readers_never_see_torn_snapshots(void) {
+    static Seqlock<MotorStateSnapshot> lock;
+    const uint32_t count = 1000000;
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> torn(0);
+    std::atomic<uint32_t> backwards(0);
+
+    auto reader = [&]() {
+        uint32_t last = 0;
+        MotorStateSnapshot snapshot;
+        while (!done.load())
+        {
+            if (!lock.read(snapshot))
+                continue;
+            if (!isConsistent(snapshot))
+                torn++;
+            if (snapshot.version < last)
+                backwards++;
+            last = snapshot.version;
+        }
+    };
+
+    std::thread r1(reader);
+    std::thread r2(reader);
+    for (uint32_t i = 1; i <= count; i++)
+        lock.write(makeSnapshot(i));
+    done = true;
+    r1.join();
+    r2.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, torn.load());
+    TEST_ASSERT_EQUAL_UINT32(0, backwards.load());
+    TEST_ASSERT_EQUAL_UINT32(count, lock.written());
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    // Seqlock (4 tests)
+    RUN_TEST(test_read_fails_before_first_write);
+    RUN_TEST(test_read_returns_last_write);
+    RUN_TEST(test_flags);
+    RUN_TEST(test_concurrent_readers_never_see_torn_snapshots);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
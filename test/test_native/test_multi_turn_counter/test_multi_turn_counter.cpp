@@ -0,0 +1,104 @@
+#include <unity.h>
+
+#include "../../../src/modules/MultiTurnCounter/MultiTurnCounter.cpp"
+
+static constexpr int32_t REV = MultiTurnCounter::COUNTS_PER_REV;
+
+// Feed a true multi-turn position as the encoder would see it
+static int64_t feed(MultiTurnCounter &counter, int64_t position)
+{
+    int32_t angle = (int32_t)(position % REV);
+    return counter.update((uint16_t)(angle < 0 ? angle + REV : angle));
+}
+
+// ============================================================================
+// MultiTurnCounter Tests
+// ============================================================================
+
+void test_first_sample_starts_in_turn_zero(void) {
+    MultiTurnCounter counter;
+    TEST_ASSERT_FALSE(counter.isInitialized());
+    TEST_ASSERT_TRUE(counter.update(12000) == 12000);
+    TEST_ASSERT_EQUAL_INT32(0, counter.getTurns());
+}
+
+void test_unwraps_forward_and_backward(void) {
+    MultiTurnCounter counter;
+    int64_t position = 16000;
+    feed(counter, position);
+
+    // 50 turns forward at 3000 counts per sample, then 60 turns back
+    for (int i = 0; i < 50 * REV / 3000; i++)
+    {
+        position += 3000;
+        TEST_ASSERT_TRUE(feed(counter, position) == position);
+    }
+    for (int i = 0; i < 60 * REV / 3000; i++)
+    {
+        position -= 3000;
+        TEST_ASSERT_TRUE(feed(counter, position) == position);
+    }
+    TEST_ASSERT_TRUE(counter.getCount() < 0);
+    TEST_ASSERT_EQUAL_INT32((int32_t)((position - (REV - 1)) / REV), counter.getTurns()); // Floors below zero
+}
+
+void test_count_goes_beyond_32_bits(void) {
+    MultiTurnCounter counter;
+    int64_t position = 0;
+    feed(counter, position);
+    counter.restore((int64_t)1 << 40, 0);
+    position = (int64_t)1 << 40;
+    for (int i = 0; i < 100; i++)
+    {
+        position += 8000;
+        feed(counter, position);
+    }
+    TEST_ASSERT_TRUE(counter.getCount() == position);
+    TEST_ASSERT_EQUAL_INT32((int32_t)(position / REV), counter.getTurns());
+}
+
+void test_restore_continues_saved_count(void) {
+    // Saved 1000 turns plus 100 counts; at boot the shaft reads 40 counts further on
+    int64_t saved = 1000LL * REV + 100;
+    MultiTurnCounter counter;
+    TEST_ASSERT_EQUAL_INT32(40, counter.restore(saved, 140));
+    TEST_ASSERT_TRUE(counter.getCount() == saved + 40);
+
+    // Moved backwards across the turn boundary while unpowered
+    MultiTurnCounter other;
+    TEST_ASSERT_EQUAL_INT32(-150, other.restore(saved, (uint16_t)(REV - 50)));
+    TEST_ASSERT_TRUE(other.getCount() == saved - 150);
+    TEST_ASSERT_EQUAL_INT32(999, other.getTurns());
+
+    // Sampling carries on from the restored count
+    TEST_ASSERT_TRUE(other.update(10) == saved - 90);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_first_sample_starts_in_turn_zero);
+    RUN_TEST(test_unwraps_forward_and_backward);
+    RUN_TEST(test_count_goes_beyond_32_bits);
+    RUN_TEST(test_restore_continues_saved_count);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+
+// Kinematic figures measured from a per-step interval stream
+//
+// Position is reconstructed on a uniform time grid (linear between steps) and
+// differentiated with central differences, so the figures describe what the
+// motor actually receives rather than what the planner intended. The grid
+// bounds what can be resolved: a true acceleration step shows up as ~a/grid.
+
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+#include "../../../src/modules/StepGenerator/StepSource.h"
+
+struct MotionMetrics
+{
+    uint32_t steps = 0;
+    double moveTime = 0;     // seconds
+    double peakSpeed = 0;    // steps/sec
+    double peakAcceleration = 0;
+    double peakJerk = 0;     // steps/sec³
+};
+
+static std::vector<double> stepTimes(StepSource &source)
+{
+    std::vector<double> times;
+    double t = 0;
+    int8_t direction;
+    uint32_t interval;
+    while ((interval = source.nextStep(direction)) != 0)
+    {
+        t += interval / 1000000.0;
+        times.push_back(t);
+    }
+    return times;
+}
+
+// Position (steps) at time t, linear between step instants
+static double positionAt(const std::vector<double> &times, double t, size_t &cursor)
+{
+    while (cursor < times.size() && times[cursor] <= t)
+        cursor++;
+    if (cursor == 0)
+        return t / times[0];
+    if (cursor >= times.size())
+        return (double)times.size();
+    double t0 = times[cursor - 1];
+    double t1 = times[cursor];
+    return cursor + (t - t0) / (t1 - t0);
+}
+
+static MotionMetrics measureMotion(StepSource &source, double gridSeconds = 0.01)
+{
+    MotionMetrics metrics;
+    std::vector<double> times = stepTimes(source);
+    metrics.steps = times.size();
+    if (times.empty())
+        return metrics;
+    metrics.moveTime = times.back();
+
+    std::vector<double> p;
+    size_t cursor = 0;
+    for (double t = 0; t <= metrics.moveTime + gridSeconds; t += gridSeconds)
+    {
+        p.push_back(positionAt(times, t, cursor));
+    }
+
+    const double h = gridSeconds;
+    for (size_t i = 2; i + 2 < p.size(); i++)
+    {
+        double v = (p[i + 1] - p[i - 1]) / (2 * h);
+        double a = (p[i + 1] - 2 * p[i] + p[i - 1]) / (h * h);
+        double j = (p[i + 2] - 2 * p[i + 1] + 2 * p[i - 1] - p[i - 2]) / (2 * h * h * h);
+        metrics.peakSpeed = fmax(metrics.peakSpeed, fabs(v));
+        metrics.peakAcceleration = fmax(metrics.peakAcceleration, fabs(a));
+        metrics.peakJerk = fmax(metrics.peakJerk, fabs(j));
+    }
+    return metrics;
+}
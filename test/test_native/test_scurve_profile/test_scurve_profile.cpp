@@ -0,0 +1,186 @@
+#include <unity.h>
+#include <stdio.h>
+
+#include "../../../src/modules/StepGenerator/RampGenerator.cpp"
+#include "../../../src/modules/StepGenerator/SCurveProfile.cpp"
+#include "motion_metrics.h"
+
+// Production defaults (Configuration.cpp) and a jerk giving 50ms jerk phases
+static constexpr float MAX_SPEED = 180 * 80;
+static constexpr float ACCELERATION = 1000 * 80;
+static constexpr float JERK = ACCELERATION / 0.05f;
+
+static MotionMetrics measureTrapezoid(long distance)
+{
+    RampGenerator ramp;
+    ramp.setMaxSpeed(MAX_SPEED);
+    ramp.setAcceleration(ACCELERATION);
+    ramp.moveTo(distance);
+    return measureMotion(ramp);
+}
+
+static MotionMetrics measureSCurve(long distance)
+{
+    SCurveProfile profile;
+    profile.plan(0, distance, MAX_SPEED, ACCELERATION, JERK);
+    return measureMotion(profile);
+}
+
+// ============================================================================
+// Planning Tests
+// ============================================================================
+
+void test_plan_rejects_invalid_limits(void) {
+    SCurveProfile profile;
+    TEST_ASSERT_FALSE(profile.plan(0, 1000, MAX_SPEED, ACCELERATION, 0));
+    TEST_ASSERT_FALSE(profile.plan(0, 1000, 0, ACCELERATION, JERK));
+    TEST_ASSERT_FALSE(profile.isRunning());
+}
+
+void test_plan_zero_distance_is_idle(void) {
+    SCurveProfile profile;
+    TEST_ASSERT_TRUE(profile.plan(500, 500, MAX_SPEED, ACCELERATION, JERK));
+    TEST_ASSERT_FALSE(profile.isRunning());
+
+    int8_t direction;
+    TEST_ASSERT_EQUAL_UINT32(0, profile.nextStep(direction));
+}
+
+void test_plan_respects_limits(void) {
+    SCurveProfile profile;
+    profile.plan(0, 100000, MAX_SPEED, ACCELERATION, JERK);
+
+    TEST_ASSERT_FLOAT_WITHIN(1, MAX_SPEED, profile.getPeakSpeed());
+    TEST_ASSERT_FLOAT_WITHIN(1, ACCELERATION, profile.getPeakAcceleration());
+}
+
+void test_plan_short_move_lowers_peak_speed(void) {
+    SCurveProfile profile;
+    profile.plan(0, 200, MAX_SPEED, ACCELERATION, JERK);
+
+    TEST_ASSERT_LESS_THAN_FLOAT(MAX_SPEED, profile.getPeakSpeed());
+    TEST_ASSERT_LESS_THAN_FLOAT(ACCELERATION, profile.getPeakAcceleration());
+
+    // Profile must still cover exactly the requested distance
+    float p, v, a;
+    profile.evaluate(profile.getDuration(), p, v, a);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 200, p);
+    TEST_ASSERT_FLOAT_WITHIN(1, 0, v);
+}
+
+// ============================================================================
+// Step Stream Tests
+// ============================================================================
+
+void test_steps_cover_exact_distance(void) {
+    const long distances[] = {1, 2, 7, 150, 2000, 100000};
+    for (long distance : distances)
+    {
+        SCurveProfile profile;
+        profile.plan(1000, 1000 + distance, MAX_SPEED, ACCELERATION, JERK);
+        std::vector<double> times = stepTimes(profile);
+
+        TEST_ASSERT_EQUAL_UINT32(distance, times.size());
+        TEST_ASSERT_EQUAL_INT32(1000 + distance, profile.currentPosition());
+        TEST_ASSERT_FALSE(profile.isRunning());
+    }
+}
+
+void test_steps_negative_direction(void) {
+    SCurveProfile profile;
+    profile.plan(0, -500, MAX_SPEED, ACCELERATION, JERK);
+
+    int8_t direction = 0;
+    profile.nextStep(direction);
+    TEST_ASSERT_EQUAL_INT8(-1, direction);
+    TEST_ASSERT_LESS_THAN_FLOAT(0, profile.getSpeed());
+
+    stepTimes(profile);
+    TEST_ASSERT_EQUAL_INT32(-500, profile.currentPosition());
+}
+
+void test_step_times_match_planned_duration(void) {
+    SCurveProfile profile;
+    profile.plan(0, 30000, MAX_SPEED, ACCELERATION, JERK);
+    std::vector<double> times = stepTimes(profile);
+
+    TEST_ASSERT_DOUBLE_WITHIN(1e-5, profile.getDuration(), times.back());
+}
+
+void test_abort_parks_profile(void) {
+    SCurveProfile profile;
+    profile.plan(0, 10000, MAX_SPEED, ACCELERATION, JERK);
+    int8_t direction;
+    for (int i = 0; i < 100; i++)
+        profile.nextStep(direction);
+
+    profile.setCurrentPosition(profile.currentPosition());
+    TEST_ASSERT_FALSE(profile.isRunning());
+    TEST_ASSERT_EQUAL_INT32(100, profile.currentPosition());
+    TEST_ASSERT_EQUAL_UINT32(0, profile.nextStep(direction));
+}
+
+// ============================================================================
+// S-curve vs Trapezoid
+// ============================================================================
+
+void test_peak_jerk_bounded_unlike_trapezoid(void) {
+    MotionMetrics trapezoid = measureTrapezoid(50000);
+    MotionMetrics scurve = measureSCurve(50000);
+
+    // Measured from the step stream, so allow for step quantisation noise at low speed
+    TEST_ASSERT_LESS_THAN_DOUBLE(JERK * 1.5, scurve.peakJerk);
+    TEST_ASSERT_GREATER_THAN_DOUBLE(scurve.peakJerk * 2, trapezoid.peakJerk);
+}
+
+void test_move_time_penalty_is_one_jerk_phase(void) {
+    // With cruise reached, an ideal trapezoid takes D/v + v/a and the S-curve adds a/j.
+    // AccelStepper's ramp approximation lands within about 1% of the ideal trapezoid.
+    MotionMetrics trapezoid = measureTrapezoid(50000);
+    MotionMetrics scurve = measureSCurve(50000);
+
+    double idealTrapezoid = 50000 / MAX_SPEED + MAX_SPEED / ACCELERATION;
+    double jerkTime = ACCELERATION / JERK;
+    TEST_ASSERT_DOUBLE_WITHIN(0.005, idealTrapezoid + jerkTime, scurve.moveTime);
+    TEST_ASSERT_DOUBLE_WITHIN(idealTrapezoid * 0.01, idealTrapezoid, trapezoid.moveTime);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    // Planning
+    RUN_TEST(test_plan_rejects_invalid_limits);
+    RUN_TEST(test_plan_zero_distance_is_idle);
+    RUN_TEST(test_plan_respects_limits);
+    RUN_TEST(test_plan_short_move_lowers_peak_speed);
+
+    // Step stream
+    RUN_TEST(test_steps_cover_exact_distance);
+    RUN_TEST(test_steps_negative_direction);
+    RUN_TEST(test_step_times_match_planned_duration);
+    RUN_TEST(test_abort_parks_profile);
+
+    // S-curve vs trapezoid
+    RUN_TEST(test_peak_jerk_bounded_unlike_trapezoid);
+    RUN_TEST(test_move_time_penalty_is_one_jerk_phase);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <math.h>
+#include "../../../src/modules/FollowingErrorMonitor/FollowingErrorMonitor.cpp"
+#include "../../../src/modules/ServoCorrector/ServoCorrector.cpp"
+
+// Quasi-static stepper + encoder model driving FollowingErrorMonitor and ServoCorrector
+// at the InputTask rate. The rotor lags the driver's electrical position by the
+// load angle asin(load / torque); when the load exceeds the available torque it
+// slips back one electrical cycle (4 full steps = 32 microsteps) per sample.
+// Correction steps run at CORRECTION_SPEED like MotorController's correction moves.
+struct ServoSim
+{
+    static constexpr long STEPS_PER_CYCLE = 32;         // One electrical cycle at 1/8 microstepping
+    static constexpr double SAMPLE_SECONDS = 0.01;      // InputTask tick
+    static constexpr long CORRECTION_SPEED = 2000;      // steps/sec
+
+    FollowingErrorMonitor monitor;
+    ServoCorrector servo;
+
+    long electrical = 0;   // Steps emitted to the driver
+    long offset = 0;       // Correction steps injected (electrical - logical)
+    long pending = 0;      // Correction steps still to emit
+    long slip = 0;         // Rotor position lost to slips
+    double load = 0;       // Load torque as a fraction of full-current holding torque
+    uint8_t currentPercent = 100;
+    uint32_t slips = 0;
+
+    ServoSim(long window)
+    {
+        monitor.setWindow(window);
+        servo.setEnabled(true);
+        monitor.update(encoder(), logical());
+    }
+
+    double rotor()
+    {
+        double ratio = load / (currentPercent / 100.0);
+        if (ratio >= 1.0)
+        {
+            slip -= STEPS_PER_CYCLE;
+            slips++;
+            ratio = 1.0;
+        }
+        double lag = asin(ratio) * STEPS_PER_CYCLE / (2 * M_PI);
+        return electrical - lag + slip;
+    }
+
+    // Multi-turn count, as the encoder sampler publishes it
+    int64_t encoder()
+    {
+        return llround(rotor() * FollowingErrorMonitor::ENCODER_COUNTS / FollowingErrorMonitor::DEFAULT_STEPS_PER_REV);
+    }
+
+    long logical() const { return electrical - offset; }
+
+    // One sample; 'move' steps of commanded travel happen during it
+    ServoCorrector::Output tick(long move = 0)
+    {
+        long perTick = (long)(CORRECTION_SPEED * SAMPLE_SECONDS);
+        long correction = pending > perTick ? perTick : (pending < -perTick ? -perTick : pending);
+        pending -= correction;
+        electrical += move + correction;
+
+        monitor.update(encoder(), logical());
+        ServoCorrector::Output output = servo.update(monitor.getError(), move != 0 || pending != 0);
+        if (output.correctionSteps)
+        {
+            pending += output.correctionSteps;
+            offset += output.correctionSteps;
+        }
+        if (output.currentChanged)
+            currentPercent = output.currentPercent;
+        return output;
+    }
+
+    // Samples until |error| stays within the deadband for 'hold' samples (-1 if never)
+    int settle(int maxSamples, int hold = 20)
+    {
+        int inside = 0;
+        for (int i = 1; i <= maxSamples; i++)
+        {
+            tick();
+            long error = monitor.getError();
+            inside = (error >= -ServoCorrector::DEADBAND && error <= ServoCorrector::DEADBAND && pending == 0) ? inside + 1 : 0;
+            if (inside >= hold)
+                return i - hold + 1;
+        }
+        return -1;
+    }
+};
@@ -0,0 +1,148 @@
+#include <unity.h>
+#include <stdio.h>
+
+#include "servo_sim.h"
+
+static void learnPolarity(ServoSim &sim)
+{
+    for (int i = 0; i < 40; i++)
+        sim.tick(10);
+    TEST_ASSERT_TRUE(sim.monitor.getState() == FollowingErrorMonitor::State::Tracking);
+}
+
+static void report(const char *name, int settleSamples, const ServoSim &sim)
+{
+    char line[160];
+    snprintf(line, sizeof(line), "%s: settled in %d ms, final error %ld steps, %u corrections (%ld steps), current %u%%",
+             name, settleSamples * 10, sim.monitor.getError(), sim.servo.getCorrectionCount(),
+             sim.servo.getTotalCorrection(), sim.currentPercent);
+    TEST_MESSAGE(line);
+}
+
+// ============================================================================
+// Closed-loop simulation Tests
+// ============================================================================
+
+void test_static_load_lag_is_corrected(void) {
+    ServoSim sim(24);
+    learnPolarity(sim);
+    TEST_ASSERT_INT32_WITHIN(ServoCorrector::DEADBAND, 0, sim.monitor.getError());
+
+    // Load applied while holding: the rotor sags ~4 steps behind the commanded position
+    sim.load = 0.7;
+    sim.tick();
+    TEST_ASSERT_GREATER_THAN_INT32(ServoCorrector::DEADBAND, sim.monitor.getError());
+
+    int settled = sim.settle(100);
+    report("static load", settled, sim);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT32(0, settled);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(15, settled); // 150 ms
+    TEST_ASSERT_INT32_WITHIN(1, 0, sim.monitor.getError());
+    TEST_ASSERT_EQUAL_UINT32(1, sim.servo.getCorrectionCount());
+}
+
+void test_end_of_move_error_is_corrected(void) {
+    ServoSim sim(24);
+    learnPolarity(sim);
+
+    // Move under load, then stop: correction only starts once at rest
+    sim.load = 0.8;
+    for (int i = 0; i < 50; i++)
+    {
+        ServoCorrector::Output output = sim.tick(20);
+        TEST_ASSERT_EQUAL_INT32(0, output.correctionSteps);
+    }
+    TEST_ASSERT_GREATER_THAN_INT32(ServoCorrector::DEADBAND, sim.monitor.getError());
+
+    int settled = sim.settle(100);
+    report("end of move", settled, sim);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT32(0, settled);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(15, settled);
+    TEST_ASSERT_INT32_WITHIN(1, 0, sim.monitor.getError());
+}
+
+void test_current_lowered_while_holding(void) {
+    ServoSim sim(24);
+    learnPolarity(sim);
+
+    // 5 s of quiet holding walks the current down to the minimum
+    for (int i = 0; i < 500; i++)
+        sim.tick();
+    TEST_ASSERT_EQUAL_UINT8(ServoCorrector::MIN_CURRENT_PERCENT, sim.currentPercent);
+
+    // A moderate load at half current: larger lag, still corrected without raising current
+    sim.load = 0.4;
+    int settled = sim.settle(100);
+    report("half current", settled, sim);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT32(0, settled);
+    TEST_ASSERT_INT32_WITHIN(1, 0, sim.monitor.getError());
+    TEST_ASSERT_EQUAL_UINT8(ServoCorrector::MIN_CURRENT_PERCENT, sim.currentPercent);
+    TEST_ASSERT_EQUAL_UINT32(0, sim.slips);
+}
+
+void test_slip_restores_current_and_recovers_position(void) {
+    // A window wider than one electrical cycle lets servo mode recover slipped steps
+    ServoSim sim(100);
+    learnPolarity(sim);
+    for (int i = 0; i < 500; i++)
+        sim.tick();
+    TEST_ASSERT_EQUAL_UINT8(ServoCorrector::MIN_CURRENT_PERCENT, sim.currentPercent);
+
+    // Load above what half current can hold: one slip, full current back, position recovered
+    sim.load = 0.6;
+    int settled = sim.settle(200);
+    report("slip", settled, sim);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.slips);
+    TEST_ASSERT_EQUAL_UINT8(100, sim.currentPercent);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT32(0, settled);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(30, settled);
+    TEST_ASSERT_INT32_WITHIN(1, 0, sim.monitor.getError());
+    TEST_ASSERT_FALSE(sim.monitor.isFaulted());
+}
+
+void test_disabled_servo_leaves_error_and_restores_current(void) {
+    ServoSim sim(24);
+    learnPolarity(sim);
+    for (int i = 0; i < 300; i++)
+        sim.tick();
+    TEST_ASSERT_LESS_THAN_UINT8(100, sim.currentPercent);
+
+    sim.servo.setEnabled(false);
+    sim.load = 0.7;
+    ServoCorrector::Output output = sim.tick();
+    TEST_ASSERT_TRUE(output.currentChanged);
+    TEST_ASSERT_EQUAL_UINT8(100, sim.currentPercent);
+
+    TEST_ASSERT_EQUAL_INT32(-1, sim.settle(100));
+    TEST_ASSERT_GREATER_THAN_INT32(ServoCorrector::DEADBAND, sim.monitor.getError());
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_static_load_lag_is_corrected);
+    RUN_TEST(test_end_of_move_error_is_corrected);
+    RUN_TEST(test_current_lowered_while_holding);
+    RUN_TEST(test_slip_restores_current_and_recovers_position);
+    RUN_TEST(test_disabled_servo_leaves_error_and_restores_current);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -0,0 +1,271 @@
+#include <unity.h>
+
+#include "../../../src/modules/LimitSwitch/SoftLimits.cpp"
+#include "../../../src/modules/StepGenerator/RampGenerator.cpp"
+#include "../../../src/modules/StepGenerator/MotionQueue.cpp"
+
+// Production defaults (Configuration.cpp)
+static constexpr uint32_t MAX_SPEED = 180 * 80;
+static constexpr uint32_t ACCELERATION = 1000 * 80;
+
+static SoftLimits makeLimits(long minLimit, long maxLimit, long zone = SoftLimits::DEFAULT_ZONE)
+{
+    SoftLimits limits;
+    limits.setEnabled(true);
+    limits.setRange(minLimit, maxLimit);
+    limits.setZone(zone);
+    return limits;
+}
+
+struct RunResult
+{
+    long finalPosition;
+    long furthest;          // Furthest position in the direction of travel
+    uint32_t maxZoneSpeed;  // Fastest step inside the creep zone
+};
+
+// Runs planned legs on the trapezoid planner with junction blending, like
+// MotorController's timer engine, starting from the ramp's current state
+static RunResult runLegs(RampGenerator &ramp, const SoftLimits::Leg *legs, uint8_t count, long zoneEdge, int8_t towards)
+{
+    MotionQueue queue;
+    for (uint8_t i = 0; i < count; i++)
+        queue.push(ramp.currentPosition(), legs[i].target, legs[i].speed);
+
+    auto startSegment = [&]() {
+        const MotionSegment *segment = queue.front();
+        long speed = ramp.getSpeedStepsPerSec();
+        ramp.setMaxSpeed(segment->maxSpeed);
+        queue.plan(ramp.currentPosition(), speed < 0 ? -speed : speed, ACCELERATION);
+        ramp.setExitSpeed(segment->exitSpeed);
+        ramp.moveTo(segment->target);
+    };
+    startSegment();
+
+    RunResult result = {0, ramp.currentPosition(), 0};
+    int8_t direction;
+    while (!queue.isEmpty())
+    {
+        if (ramp.isAtTarget() && (!ramp.isRunning() || ramp.getExitSpeed() > 0))
+        {
+            queue.pop();
+            if (!queue.isEmpty())
+                startSegment();
+            continue;
+        }
+        if (ramp.nextStep(direction) == 0)
+            break;
+
+        long position = ramp.currentPosition();
+        if ((position - result.furthest) * towards > 0)
+            result.furthest = position;
+        if ((position - zoneEdge) * towards > 0)
+        {
+            long speed = ramp.getSpeedStepsPerSec();
+            uint32_t magnitude = speed < 0 ? -speed : speed;
+            if (magnitude > result.maxZoneSpeed)
+                result.maxZoneSpeed = magnitude;
+        }
+    }
+    result.finalPosition = ramp.currentPosition();
+    return result;
+}
+
+// ============================================================================
+// Range Tests (3 tests)
+// ============================================================================
+
+void test_targets_clipped_inside_the_learned_limits(void) {
+    SoftLimits limits = makeLimits(10000, -2000); // Either order
+    TEST_ASSERT_TRUE(limits.isActive());
+    TEST_ASSERT_EQUAL_INT32(-2000 + SoftLimits::MARGIN, limits.getMin());
+    TEST_ASSERT_EQUAL_INT32(10000 - SoftLimits::MARGIN, limits.getMax());
+
+    TEST_ASSERT_EQUAL_INT32(limits.getMax(), limits.clamp(50000));
+    TEST_ASSERT_EQUAL_INT32(limits.getMin(), limits.clamp(-50000));
+    TEST_ASSERT_EQUAL_INT32(1234, limits.clamp(1234));
+}
+
+void test_disabled_or_unlearned_limits_pass_targets_through(void) {
+    SoftLimits limits = makeLimits(0, 10000);
+    limits.setEnabled(false);
+    TEST_ASSERT_FALSE(limits.isActive());
+    TEST_ASSERT_EQUAL_INT32(50000, limits.clamp(50000));
+
+    // Limits closer than the two margins leave no range to clip to
+    SoftLimits tight = makeLimits(100, 110);
+    TEST_ASSERT_FALSE(tight.isActive());
+
+    SoftLimits::Leg legs[2];
+    TEST_ASSERT_EQUAL(1, limits.plan(0, 0, 50000, MAX_SPEED, ACCELERATION, legs));
+    TEST_ASSERT_EQUAL_INT32(50000, legs[0].target);
+    TEST_ASSERT_EQUAL_UINT32(MAX_SPEED, legs[0].speed);
+}
+
+void test_zone_is_clamped(void) {
+    SoftLimits limits;
+    limits.setZone(-1);
+    TEST_ASSERT_EQUAL_INT32(0, limits.getZone());
+    limits.setZone(1000000);
+    TEST_ASSERT_EQUAL_INT32(SoftLimits::MAX_ZONE, limits.getZone());
+}
+
+// ============================================================================
+// Planning Tests (5 tests)
+// ============================================================================
+
+void test_move_into_the_zone_is_split_at_its_edge(void) {
+    SoftLimits limits = makeLimits(0, 20000, 800);
+    SoftLimits::Leg legs[2];
+
+    TEST_ASSERT_EQUAL(2, limits.plan(0, 0, 99999, MAX_SPEED, ACCELERATION, legs));
+    TEST_ASSERT_EQUAL_INT32(20000 - SoftLimits::MARGIN - 800, legs[0].target);
+    TEST_ASSERT_EQUAL_UINT32(MAX_SPEED, legs[0].speed);
+    TEST_ASSERT_EQUAL_INT32(20000 - SoftLimits::MARGIN, legs[1].target);
+    TEST_ASSERT_EQUAL_UINT32(SoftLimits::CREEP_SPEED, legs[1].speed);
+
+    // Same towards the min end
+    TEST_ASSERT_EQUAL(2, limits.plan(15000, 0, -99999, MAX_SPEED, ACCELERATION, legs));
+    TEST_ASSERT_EQUAL_INT32(SoftLimits::MARGIN + 800, legs[0].target);
+    TEST_ASSERT_EQUAL_INT32(SoftLimits::MARGIN, legs[1].target);
+}
+
+void test_moves_clear_of_the_zone_are_not_split(void) {
+    SoftLimits limits = makeLimits(0, 20000, 800);
+    SoftLimits::Leg legs[2];
+
+    // Ends before the zone
+    TEST_ASSERT_EQUAL(1, limits.plan(0, 0, 10000, MAX_SPEED, ACCELERATION, legs));
+    TEST_ASSERT_EQUAL_UINT32(MAX_SPEED, legs[0].speed);
+
+    // Starts in the max zone but heads away from it
+    TEST_ASSERT_EQUAL(1, limits.plan(19900, 0, 10000, MAX_SPEED, ACCELERATION, legs));
+    TEST_ASSERT_EQUAL_UINT32(MAX_SPEED, legs[0].speed);
+
+    // Already at creep speed or slower
+    TEST_ASSERT_EQUAL(1, limits.plan(0, 0, 99999, 400, ACCELERATION, legs));
+    TEST_ASSERT_EQUAL_UINT32(400, legs[0].speed);
+    TEST_ASSERT_EQUAL_INT32(limits.getMax(), legs[0].target);
+
+    // No zone: full speed to the soft limit
+    limits.setZone(0);
+    TEST_ASSERT_EQUAL(1, limits.plan(0, 0, 99999, MAX_SPEED, ACCELERATION, legs));
+    TEST_ASSERT_EQUAL_UINT32(MAX_SPEED, legs[0].speed);
+}
+
+void test_move_inside_the_zone_creeps(void) {
+    SoftLimits limits = makeLimits(0, 20000, 800);
+    SoftLimits::Leg legs[2];
+
+    TEST_ASSERT_EQUAL(1, limits.plan(19500, 0, 99999, MAX_SPEED, ACCELERATION, legs));
+    TEST_ASSERT_EQUAL_INT32(limits.getMax(), legs[0].target);
+    TEST_ASSERT_EQUAL_UINT32(SoftLimits::CREEP_SPEED, legs[0].speed);
+}
+
+void test_too_fast_to_slow_by_the_edge_creeps_from_here(void) {
+    SoftLimits limits = makeLimits(0, 20000, 800);
+    SoftLimits::Leg legs[2];
+    long edge = limits.getMax() - 800;
+    uint32_t brake = SoftLimits::stoppingDistance(MAX_SPEED, ACCELERATION) -
+                     SoftLimits::stoppingDistance(SoftLimits::CREEP_SPEED, ACCELERATION);
+
+    // Just outside the braking distance: still split
+    TEST_ASSERT_EQUAL(2, limits.plan(edge - brake - 1, MAX_SPEED, 99999, MAX_SPEED, ACCELERATION, legs));
+
+    // Inside it: slow down now
+    TEST_ASSERT_EQUAL(1, limits.plan(edge - brake + 10, MAX_SPEED, 99999, MAX_SPEED, ACCELERATION, legs));
+    TEST_ASSERT_EQUAL_UINT32(SoftLimits::CREEP_SPEED, legs[0].speed);
+
+    // The same spot while moving the other way is far enough
+    TEST_ASSERT_EQUAL(2, limits.plan(edge - brake + 10, -(int32_t)MAX_SPEED, 99999, MAX_SPEED, ACCELERATION, legs));
+}
+
+void test_stopping_distance(void) {
+    TEST_ASSERT_EQUAL_UINT32(1296, SoftLimits::stoppingDistance(MAX_SPEED, ACCELERATION));
+    TEST_ASSERT_EQUAL_UINT32(0, SoftLimits::stoppingDistance(0, ACCELERATION));
+    TEST_ASSERT_EQUAL_UINT32(0, SoftLimits::stoppingDistance(MAX_SPEED, 0));
+}
+
+// ============================================================================
+// Motion Tests (2 tests)
+// ============================================================================
+
+void test_full_speed_jog_reaches_the_limit_at_creep_speed(void) {
+    SoftLimits limits = makeLimits(0, 20000, 800);
+    RampGenerator ramp;
+    ramp.setMaxSpeed(MAX_SPEED);
+    ramp.setAcceleration(ACCELERATION);
+
+    SoftLimits::Leg legs[2];
+    uint8_t count = limits.plan(0, 0, 20000, MAX_SPEED, ACCELERATION, legs);
+    RunResult result = runLegs(ramp, legs, count, limits.getMax() - 800, 1);
+
+    TEST_ASSERT_EQUAL_INT32(limits.getMax(), result.finalPosition);
+    TEST_ASSERT_EQUAL_INT32(limits.getMax(), result.furthest);
+    // Blended into the zone at creep speed (a step of ramp quantisation)
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(SoftLimits::CREEP_SPEED + 50, result.maxZoneSpeed);
+}
+
+void test_retarget_at_speed_never_passes_the_limit(void) {
+    SoftLimits limits = makeLimits(0, 20000, 800);
+    RampGenerator ramp;
+    ramp.setMaxSpeed(MAX_SPEED);
+    ramp.setAcceleration(ACCELERATION);
+
+    // Cruising on a move planned without the limits, retargeted inside the braking distance
+    long edge = limits.getMax() - 800;
+    ramp.moveTo(30000);
+    int8_t direction;
+    while (ramp.currentPosition() < edge - 1296 + 100)
+        ramp.nextStep(direction);
+    TEST_ASSERT_EQUAL_INT32(MAX_SPEED, ramp.getSpeedStepsPerSec());
+
+    SoftLimits::Leg legs[2];
+    uint8_t count = limits.plan(ramp.currentPosition(), ramp.getSpeedStepsPerSec(), 99999, MAX_SPEED,
+                                ACCELERATION, legs);
+    TEST_ASSERT_EQUAL(1, count);
+    RunResult result = runLegs(ramp, legs, count, edge, 1);
+
+    TEST_ASSERT_EQUAL_INT32(limits.getMax(), result.finalPosition);
+    TEST_ASSERT_EQUAL_INT32(limits.getMax(), result.furthest);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    // Range (3 tests)
+    RUN_TEST(test_targets_clipped_inside_the_learned_limits);
+    RUN_TEST(test_disabled_or_unlearned_limits_pass_targets_through);
+    RUN_TEST(test_zone_is_clamped);
+
+    // Planning (5 tests)
+    RUN_TEST(test_move_into_the_zone_is_split_at_its_edge);
+    RUN_TEST(test_moves_clear_of_the_zone_are_not_split);
+    RUN_TEST(test_move_inside_the_zone_creeps);
+    RUN_TEST(test_too_fast_to_slow_by_the_edge_creeps_from_here);
+    RUN_TEST(test_stopping_distance);
+
+    // Motion (2 tests)
+    RUN_TEST(test_full_speed_jog_reaches_the_limit_at_creep_speed);
+    RUN_TEST(test_retarget_at_speed_never_passes_the_limit);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+
+// SG_RESULT traces as MotorController polls them while homing: one reading
+// every 5 ms with the commanded speed, StealthChop, 1/8 microstepping.
+// Synthetic, following typical StallGuard4 behaviour: SG_RESULT reads near
+// zero at standstill, climbs through the acceleration ramp, settles with
+// load ripple at cruise and falls to zero within a few full steps of hitting
+// a hard stop.
+
+struct SgReading
+{
+    uint16_t sgResult;
+    uint16_t speed; // Commanded steps/sec
+};
+
+// Fast approach (1600 steps/s) into a hard stop: ramp, cruise, stall
+static const SgReading FAST_HARD_STOP[] = {
+    {0, 0}, {26, 177}, {53, 355}, {80, 533}, {106, 711}, {133, 888},
+    {160, 1066}, {186, 1244}, {213, 1422}, {240, 1600}, {242, 1600}, {262, 1600},
+    {256, 1600}, {254, 1600}, {271, 1600}, {260, 1600}, {256, 1600}, {281, 1600},
+    {254, 1600}, {244, 1600}, {243, 1600}, {253, 1600}, {267, 1600}, {270, 1600},
+    {273, 1600}, {282, 1600}, {280, 1600}, {268, 1600}, {276, 1600}, {268, 1600},
+    {253, 1600}, {270, 1600}, {261, 1600}, {258, 1600}, {284, 1600}, {269, 1600},
+    {254, 1600}, {259, 1600}, {288, 1600}, {257, 1600}, {269, 1600}, {268, 1600},
+    {266, 1600}, {267, 1600}, {254, 1600}, {255, 1600}, {258, 1600}, {256, 1600},
+    {270, 1600}, {279, 1600}, {190, 1600}, {95, 1600}, {40, 1600}, {8, 1600},
+    {0, 1600}, {0, 1600}, {0, 1600},
+};
+
+// Cruise with one- and two-reading dips from load ripple: never a stall
+static const SgReading LOAD_RIPPLE[] = {
+    {0, 0}, {26, 177}, {53, 355}, {80, 533}, {106, 711}, {133, 888},
+    {160, 1066}, {186, 1244}, {213, 1422}, {240, 1600}, {239, 1600}, {257, 1600},
+    {238, 1600}, {242, 1600}, {247, 1600}, {251, 1600}, {245, 1600}, {218, 1600},
+    {267, 1600}, {247, 1600}, {242, 1600}, {258, 1600}, {243, 1600}, {233, 1600},
+    {256, 1600}, {255, 1600}, {240, 1600}, {260, 1600}, {255, 1600}, {236, 1600},
+    {92, 1600}, {240, 1600}, {271, 1600}, {253, 1600}, {236, 1600}, {256, 1600},
+    {252, 1600}, {262, 1600}, {234, 1600}, {263, 1600}, {262, 1600}, {259, 1600},
+    {85, 1600}, {98, 1600}, {255, 1600}, {258, 1600}, {266, 1600}, {259, 1600},
+    {252, 1600}, {240, 1600}, {264, 1600}, {262, 1600}, {254, 1600}, {252, 1600},
+    {259, 1600}, {220, 1600}, {254, 1600}, {220, 1600}, {253, 1600}, {263, 1600},
+};
+
+// Ordinary end of move: SG_RESULT collapses as the ramp slows, not a stall
+static const SgReading DECELERATION[] = {
+    {0, 0}, {26, 177}, {53, 355}, {80, 533}, {106, 711}, {133, 888},
+    {160, 1066}, {186, 1244}, {213, 1422}, {240, 1600}, {278, 1600}, {249, 1600},
+    {260, 1600}, {254, 1600}, {228, 1600}, {264, 1600}, {255, 1600}, {256, 1600},
+    {244, 1600}, {255, 1600}, {256, 1600}, {271, 1600}, {259, 1600}, {298, 1600},
+    {250, 1600}, {252, 1600}, {254, 1600}, {245, 1600}, {273, 1600}, {263, 1600},
+    {240, 1600}, {256, 1600}, {269, 1600}, {238, 1600}, {257, 1600}, {252, 1600},
+    {283, 1600}, {260, 1600}, {250, 1600}, {248, 1600}, {255, 1600}, {238, 1493},
+    {222, 1386}, {206, 1280}, {189, 1173}, {173, 1066}, {157, 960}, {140, 853},
+    {124, 746}, {108, 640}, {91, 533}, {75, 426}, {59, 320}, {42, 213},
+    {26, 106}, {10, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0},
+    {0, 0},
+};
+
+// Slow seek (400 steps/s): lower SG_RESULT at cruise, same stall rule
+static const SgReading SLOW_SEEK_STOP[] = {
+    {0, 0}, {28, 80}, {56, 160}, {84, 240}, {112, 320}, {140, 400},
+    {165, 400}, {146, 400}, {168, 400}, {137, 400}, {148, 400}, {148, 400},
+    {144, 400}, {148, 400}, {155, 400}, {144, 400}, {138, 400}, {161, 400},
+    {162, 400}, {144, 400}, {152, 400}, {129, 400}, {158, 400}, {139, 400},
+    {145, 400}, {167, 400}, {140, 400}, {150, 400}, {141, 400}, {135, 400},
+    {140, 400}, {152, 400}, {139, 400}, {145, 400}, {156, 400}, {149, 400},
+    {150, 400}, {120, 400}, {70, 400}, {70, 400}, {45, 400}, {20, 400},
+    {20, 400},
+};
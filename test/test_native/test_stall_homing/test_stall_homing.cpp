@@ -0,0 +1,235 @@
+#include <unity.h>
+#include <stdio.h>
+
+#include "../../../src/modules/Homing/StallDetector.cpp"
+#include "../../../src/modules/Homing/HomingSequence.cpp"
+#include "sg_traces.h"
+
+#define TRACE_LENGTH(trace) (sizeof(trace) / sizeof(trace[0]))
+
+// Index of the reading that reports the stall, -1 if none
+static int replay(StallDetector &detector, const SgReading *trace, size_t length)
+{
+    detector.reset();
+    for (size_t i = 0; i < length; i++)
+    {
+        if (detector.update(trace[i].sgResult, trace[i].speed))
+            return (int)i;
+    }
+    return -1;
+}
+
+static StallDetector homingDetector(long seekSpeed)
+{
+    // Armed above half the seek speed, like MotorController does
+    StallDetector detector;
+    detector.setMinSpeed(seekSpeed / 2);
+    return detector;
+}
+
+// Motor driving into a hard stop at 'stop', polled every 5 ms. Past the stop the
+// rotor stays put while steps keep going out; SG_RESULT follows the rotor.
+struct HardStopSim
+{
+    static constexpr double POLL_SECONDS = 0.005;
+
+    long stop;
+    double commanded;
+    HomingSequence sequence;
+    StallDetector detector;
+    long maxOvershoot = 0; // Steps commanded past the stop before the move was halted
+
+    HardStopSim(long stopPosition, long start) : stop(stopPosition), commanded(start) {}
+
+    double rotor() const { return commanded < stop ? commanded : stop; }
+
+    uint16_t sgResult(double speed) const
+    {
+        if (commanded >= stop)
+            return 0;
+        return (uint16_t)(speed >= 1000 ? 260 : 150);
+    }
+
+    // Runs one move to completion or stall; false if the sequence stopped issuing moves
+    bool run(HomingSequence::Move move)
+    {
+        if (!move.valid)
+            return false;
+        detector.reset();
+        detector.setMinSpeed(move.speed / 2);
+        double direction = move.target > commanded ? 1 : -1;
+        double speed = 0;
+        for (int poll = 0; poll < 100000; poll++)
+        {
+            speed = speed + 20000 * POLL_SECONDS < move.speed ? speed + 20000 * POLL_SECONDS : move.speed;
+            commanded += direction * speed * POLL_SECONDS;
+            if ((commanded - move.target) * direction >= 0)
+            {
+                commanded = move.target;
+                return run(sequence.onStopped((long)commanded));
+            }
+            if (sequence.isSeeking() && detector.update(sgResult(speed), speed))
+            {
+                long overshoot = (long)(commanded - stop);
+                if (overshoot > maxOvershoot)
+                    maxOvershoot = overshoot;
+                // Halted on the stall: the driver position is where the steps stopped
+                return run(sequence.onStall((long)commanded));
+            }
+        }
+        return false;
+    }
+};
+
+// ============================================================================
+// StallDetector Tests (trace replay)
+// ============================================================================
+
+void test_hard_stop_detected_within_a_few_full_steps(void) {
+    StallDetector detector = homingDetector(HomingSequence::FAST_SPEED);
+    int index = replay(detector, FAST_HARD_STOP, TRACE_LENGTH(FAST_HARD_STOP));
+
+    // Third reading at or below 2 * SGTHRS after the drop; 15 ms at 1600 steps/s = 3 full steps
+    TEST_ASSERT_EQUAL_INT(53, index);
+    TEST_ASSERT_TRUE(detector.isStalled());
+}
+
+void test_ramp_readings_are_ignored(void) {
+    // Readings below the threshold while accelerating never count
+    StallDetector detector = homingDetector(HomingSequence::FAST_SPEED);
+    int index = replay(detector, FAST_HARD_STOP, 20);
+    TEST_ASSERT_EQUAL_INT(-1, index);
+    TEST_ASSERT_TRUE(detector.isArmed());
+    TEST_ASSERT_TRUE(detector.getMinResult() > 2 * StallDetector::DEFAULT_THRESHOLD);
+}
+
+void test_load_ripple_is_not_a_stall(void) {
+    StallDetector detector = homingDetector(HomingSequence::FAST_SPEED);
+    TEST_ASSERT_EQUAL_INT(-1, replay(detector, LOAD_RIPPLE, TRACE_LENGTH(LOAD_RIPPLE)));
+    TEST_ASSERT_TRUE(detector.getMinResult() <= 2 * StallDetector::DEFAULT_THRESHOLD); // The dips were seen
+}
+
+void test_deceleration_is_not_a_stall(void) {
+    StallDetector detector = homingDetector(HomingSequence::FAST_SPEED);
+    TEST_ASSERT_EQUAL_INT(-1, replay(detector, DECELERATION, TRACE_LENGTH(DECELERATION)));
+    TEST_ASSERT_FALSE(detector.isArmed());
+}
+
+void test_threshold_scales_with_sgthrs(void) {
+    // Slow seek reads lower at cruise: the default threshold still separates it
+    StallDetector detector = homingDetector(HomingSequence::SLOW_SPEED);
+    TEST_ASSERT_EQUAL_INT(40, replay(detector, SLOW_SEEK_STOP, TRACE_LENGTH(SLOW_SEEK_STOP)));
+
+    // Too sensitive a threshold stalls on the cruise readings themselves
+    detector.setThreshold(80);
+    TEST_ASSERT_TRUE(replay(detector, SLOW_SEEK_STOP, TRACE_LENGTH(SLOW_SEEK_STOP)) < 40);
+}
+
+// ============================================================================
+// HomingSequence Tests
+// ============================================================================
+
+void test_fast_then_slow_homing_finds_the_stop(void) {
+    HardStopSim sim(5000, 0);
+    sim.run(sim.sequence.start(1, 0));
+
+    TEST_ASSERT_TRUE(sim.sequence.getPhase() == HomingSequence::Phase::Done);
+    // Slow pass: within one full step (8 microsteps) of the stop
+    TEST_ASSERT_INT32_WITHIN(8, 5000, sim.sequence.getStopPosition());
+    // Never drove more than 5 full steps into it, even on the fast pass
+    TEST_ASSERT_TRUE(sim.maxOvershoot <= 40);
+    // Rests released from the stop
+    TEST_ASSERT_EQUAL_INT32(sim.sequence.getStopPosition() - HomingSequence::RELEASE_STEPS, (long)sim.commanded);
+
+    char line[120];
+    snprintf(line, sizeof(line), "stop found at %ld (true 5000), worst overshoot %ld steps",
+             sim.sequence.getStopPosition(), sim.maxOvershoot);
+    TEST_MESSAGE(line);
+}
+
+void test_homing_towards_negative_direction(void) {
+    // Mirror image: stop below the start
+    HomingSequence sequence;
+    HomingSequence::Move move = sequence.start(-1, 1000);
+    TEST_ASSERT_TRUE(move.valid);
+    TEST_ASSERT_EQUAL_INT32(1000 - HomingSequence::DEFAULT_MAX_TRAVEL, move.target);
+    TEST_ASSERT_EQUAL_INT32(HomingSequence::FAST_SPEED, move.speed);
+
+    move = sequence.onStall(-200);
+    TEST_ASSERT_EQUAL_INT32(-200 + HomingSequence::BACKOFF_STEPS, move.target);
+    move = sequence.onStopped(move.target);
+    TEST_ASSERT_EQUAL_INT32(-200 - HomingSequence::BACKOFF_STEPS, move.target);
+    TEST_ASSERT_EQUAL_INT32(HomingSequence::SLOW_SPEED, move.speed);
+    move = sequence.onStall(-198);
+    TEST_ASSERT_EQUAL_INT32(-198 + HomingSequence::RELEASE_STEPS, move.target);
+    move = sequence.onStopped(move.target);
+    TEST_ASSERT_FALSE(move.valid);
+    TEST_ASSERT_TRUE(sequence.getPhase() == HomingSequence::Phase::Done);
+    TEST_ASSERT_EQUAL_INT32(-198, sequence.getStopPosition());
+}
+
+void test_homing_fails_without_a_stop(void) {
+    // Stop beyond the travel limit
+    HardStopSim sim(50000, 0);
+    sim.run(sim.sequence.start(1, 0, 4000));
+    TEST_ASSERT_TRUE(sim.sequence.getPhase() == HomingSequence::Phase::Failed);
+    TEST_ASSERT_EQUAL_INT32(4000, (long)sim.commanded);
+}
+
+void test_early_slow_stall_is_rejected(void) {
+    // A stall half a back-off short of the fast one is load, not the stop
+    HomingSequence sequence;
+    sequence.start(1, 0);
+    HomingSequence::Move move = sequence.onStall(3000);
+    move = sequence.onStopped(move.target);
+    move = sequence.onStall(3000 - HomingSequence::BACKOFF_STEPS / 2 - 1);
+    TEST_ASSERT_FALSE(move.valid);
+    TEST_ASSERT_TRUE(sequence.getPhase() == HomingSequence::Phase::Failed);
+}
+
+void test_abort_stops_the_sequence(void) {
+    HomingSequence sequence;
+    sequence.start(1, 0);
+    TEST_ASSERT_TRUE(sequence.isActive());
+    sequence.abort();
+    TEST_ASSERT_FALSE(sequence.isActive());
+    TEST_ASSERT_FALSE(sequence.onStall(100).valid);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    // StallDetector (5 tests)
+    RUN_TEST(test_hard_stop_detected_within_a_few_full_steps);
+    RUN_TEST(test_ramp_readings_are_ignored);
+    RUN_TEST(test_load_ripple_is_not_a_stall);
+    RUN_TEST(test_deceleration_is_not_a_stall);
+    RUN_TEST(test_threshold_scales_with_sgthrs);
+
+    // HomingSequence (5 tests)
+    RUN_TEST(test_fast_then_slow_homing_finds_the_stop);
+    RUN_TEST(test_homing_towards_negative_direction);
+    RUN_TEST(test_homing_fails_without_a_stop);
+    RUN_TEST(test_early_slow_stall_is_rejected);
+    RUN_TEST(test_abort_stops_the_sequence);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -0,0 +1,182 @@
+#pragma once
+
+// Host-side model of the two step engines
+//
+// Both engines consume the same ideal per-step interval stream (from RampGenerator
+// or any other StepSource). The model replays it against a simulated core 1 timeline
+// and records how far each emitted interval deviates from the planned one.
+//
+// Polled engine (AccelStepper::run() from loop()):
+//   A step is emitted at the first loop iteration at or after it is due, and the next
+//   interval is measured from that late step, so every delay adds to the move time.
+//   Loop iterations cost LOOP_COST_US, and interference sources (WebServerTask time
+//   slices, async_tcp bursts, blocking logPrint) take the CPU away periodically.
+//
+// Timer engine (StepGenerator ISR):
+//   The hardware alarm reloads from the previous alarm, so the schedule never drifts.
+//   Each step only sees ISR entry latency. The producer (motor loop) keeps
+//   StepGenerator::LOOKAHEAD_US queued; if interference starves it for longer than
+//   that, the queue runs dry and the timer restarts from the producer's next poll.
+
+#include <stdint.h>
+#include <vector>
+#include "../../../src/TimingStats.h"
+#include "../../../src/modules/StepGenerator/StepSource.h"
+
+struct InterferenceSource
+{
+    const char *name;
+    double periodUs;
+    double minLengthUs;
+    double maxLengthUs;
+};
+
+struct EngineResult
+{
+    TimingStats intervalError; // Emitted interval minus planned interval (µs)
+    double moveTimeUs;
+    double idealMoveTimeUs;
+    uint32_t steps;
+    uint32_t underruns;        // Timer engine only: queue ran dry
+};
+
+class StepEngineModel
+{
+public:
+    double loopCostUs = 4.0;        // One polled update() iteration
+    double isrLatencyMinUs = 0.8;   // Timer alarm to STEP edge
+    double isrLatencyMaxUs = 2.5;
+    double lookaheadUs = 10000.0;   // StepGenerator::LOOKAHEAD_US
+
+    explicit StepEngineModel(uint32_t seed = 12345) : rng(seed) {}
+
+    void addInterference(const InterferenceSource &source) { sources.push_back(source); }
+
+    // Drain a step source into an interval list (µs)
+    static std::vector<uint32_t> collect(StepSource &source)
+    {
+        std::vector<uint32_t> intervals;
+        int8_t direction;
+        uint32_t interval;
+        while ((interval = source.nextStep(direction)) != 0)
+        {
+            intervals.push_back(interval);
+        }
+        return intervals;
+    }
+
+    EngineResult runPolled(const std::vector<uint32_t> &intervals)
+    {
+        resetTimeline();
+        EngineResult result = emptyResult(intervals);
+
+        double lastStep = 0;
+        for (size_t i = 0; i < intervals.size(); i++)
+        {
+            double stepTime = pollAtOrAfter(lastStep + intervals[i]);
+            if (i > 0)
+            {
+                result.intervalError.add(roundUs(stepTime - lastStep - intervals[i]));
+            }
+            lastStep = stepTime;
+        }
+        result.moveTimeUs = lastStep;
+        return result;
+    }
+
+    EngineResult runTimer(const std::vector<uint32_t> &intervals)
+    {
+        resetTimeline();
+        EngineResult result = emptyResult(intervals);
+
+        double alarm = 0;     // Hardware schedule
+        double lastEmit = 0;
+        for (size_t i = 0; i < intervals.size(); i++)
+        {
+            double due = alarm + intervals[i];
+
+            // The producer must have queued this step before its alarm fires
+            double queuedAt = pollAtOrAfter(due - lookaheadUs > 0 ? due - lookaheadUs : 0);
+            if (queuedAt > due)
+            {
+                // Queue ran dry: start() re-arms the timer with this interval
+                result.underruns++;
+                due = queuedAt + intervals[i];
+            }
+
+            alarm = due;
+            double emit = due + uniform(isrLatencyMinUs, isrLatencyMaxUs);
+            if (i > 0)
+            {
+                result.intervalError.add(roundUs(emit - lastEmit - intervals[i]));
+            }
+            lastEmit = emit;
+        }
+        result.moveTimeUs = lastEmit;
+        return result;
+    }
+
+private:
+    struct SourceState
+    {
+        double nextStart;
+    };
+
+    std::vector<InterferenceSource> sources;
+    std::vector<SourceState> states;
+    double now = 0;
+    uint32_t rng;
+
+    static int32_t roundUs(double value) { return (int32_t)(value < 0 ? value - 0.5 : value + 0.5); }
+
+    // xorshift32: deterministic so results are comparable between runs
+    double uniform(double lo, double hi)
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return lo + (hi - lo) * (rng / 4294967296.0);
+    }
+
+    void resetTimeline()
+    {
+        now = 0;
+        states.clear();
+        for (const InterferenceSource &source : sources)
+        {
+            states.push_back({uniform(0, source.periodUs)});
+        }
+    }
+
+    static EngineResult emptyResult(const std::vector<uint32_t> &intervals)
+    {
+        EngineResult result;
+        result.moveTimeUs = 0;
+        result.idealMoveTimeUs = 0;
+        result.steps = intervals.size();
+        result.underruns = 0;
+        for (uint32_t interval : intervals)
+        {
+            result.idealMoveTimeUs += interval;
+        }
+        return result;
+    }
+
+    // Time of the first motor loop iteration at or after t
+    double pollAtOrAfter(double t)
+    {
+        while (now < t)
+        {
+            now += loopCostUs;
+            for (size_t i = 0; i < sources.size(); i++)
+            {
+                if (now >= states[i].nextStart)
+                {
+                    now += uniform(sources[i].minLengthUs, sources[i].maxLengthUs);
+                    states[i].nextStart += sources[i].periodUs;
+                }
+            }
+        }
+        return now;
+    }
+};
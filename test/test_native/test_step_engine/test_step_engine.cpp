@@ -0,0 +1,250 @@
+#include <unity.h>
+#include <stdio.h>
+
+#include "../../../src/TimingStats.cpp"
+#include "../../../src/modules/StepGenerator/RampGenerator.cpp"
+#include "step_engine_model.h"
+
+// Production defaults (Configuration.cpp)
+static constexpr float DEFAULT_MAX_SPEED = 180 * 80;
+static constexpr float DEFAULT_ACCELERATION = 1000 * 80;
+
+static RampGenerator makeRamp(uint32_t maxSpeed, uint32_t acceleration)
+{
+    RampGenerator ramp;
+    ramp.setMaxSpeed(maxSpeed);
+    ramp.setAcceleration(acceleration);
+    return ramp;
+}
+
+static void addTypicalInterference(StepEngineModel &model)
+{
+    // Sources sharing core 1 with loop() today
+    model.addInterference({"WebServerTask slice", 50000, 300, 1000});
+    model.addInterference({"async_tcp burst", 100000, 150, 600});
+    model.addInterference({"logPrint Serial", 250000, 500, 2500});
+}
+
+static void printResult(const char *engine, const EngineResult &result)
+{
+    char line[200];
+    snprintf(line, sizeof(line),
+             "%-6s steps=%u move=%.1fms (ideal %.1fms) jitter mean=%.2fus sd=%.2fus max=%dus underruns=%u",
+             engine, result.steps, result.moveTimeUs / 1000, result.idealMoveTimeUs / 1000,
+             result.intervalError.getMean(), result.intervalError.getStdDev(),
+             result.intervalError.getMaxAbs(), result.underruns);
+    TEST_MESSAGE(line);
+}
+
+// ============================================================================
+// RampGenerator Tests
+// ============================================================================
+
+void test_ramp_emits_exact_distance(void) {
+    RampGenerator ramp = makeRamp(DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION);
+    ramp.moveTo(5000);
+
+    std::vector<uint32_t> intervals = StepEngineModel::collect(ramp);
+
+    TEST_ASSERT_EQUAL_UINT32(5000, intervals.size());
+    TEST_ASSERT_EQUAL_INT32(5000, ramp.currentPosition());
+    TEST_ASSERT_FALSE(ramp.isRunning());
+}
+
+void test_ramp_reverse_direction(void) {
+    RampGenerator ramp = makeRamp(DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION);
+    ramp.setCurrentPosition(1000);
+    ramp.moveTo(-500);
+
+    int8_t direction = 0;
+    TEST_ASSERT_GREATER_THAN_UINT32(0, ramp.nextStep(direction));
+    TEST_ASSERT_EQUAL_INT8(-1, direction);
+
+    StepEngineModel::collect(ramp);
+    TEST_ASSERT_EQUAL_INT32(-500, ramp.currentPosition());
+}
+
+void test_ramp_respects_max_speed(void) {
+    RampGenerator ramp = makeRamp(4000, DEFAULT_ACCELERATION);
+    ramp.moveTo(20000);
+
+    std::vector<uint32_t> intervals = StepEngineModel::collect(ramp);
+
+    uint32_t shortest = UINT32_MAX;
+    for (uint32_t interval : intervals)
+    {
+        if (interval < shortest)
+            shortest = interval;
+    }
+    // 4000 steps/sec = 250µs per step
+    TEST_ASSERT_EQUAL_UINT32(250, shortest);
+}
+
+void test_ramp_stop_decelerates(void) {
+    RampGenerator ramp = makeRamp(DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION);
+    ramp.moveTo(100000);
+
+    int8_t direction;
+    for (int i = 0; i < 3000; i++)
+    {
+        ramp.nextStep(direction);
+    }
+    float speedAtStop = ramp.getSpeed();
+    long positionAtStop = ramp.currentPosition();
+    ramp.stop();
+    StepEngineModel::collect(ramp);
+
+    // Stopping distance v²/2a (+1 step rounding)
+    long expected = (long)(speedAtStop * speedAtStop / (2 * DEFAULT_ACCELERATION));
+    TEST_ASSERT_INT32_WITHIN(2, expected, ramp.currentPosition() - positionAtStop);
+}
+
+void test_ramp_move_time_matches_ideal_trapezoid(void) {
+    // The remainder carry keeps the integer kernel on the continuous ramp
+    RampGenerator ramp = makeRamp(DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION);
+    ramp.moveTo(40000);
+
+    int8_t direction;
+    uint64_t total = 0;
+    uint32_t interval;
+    while ((interval = ramp.nextStep(direction)) != 0)
+        total += interval;
+
+    double v = DEFAULT_MAX_SPEED, a = DEFAULT_ACCELERATION;
+    double idealUs = (40000 / v + v / a) * 1e6;
+    TEST_ASSERT_DOUBLE_WITHIN(idealUs * 0.01, idealUs, (double)total);
+}
+
+void test_ramp_lowering_max_speed_decelerates(void) {
+    RampGenerator ramp = makeRamp(DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION);
+    ramp.moveTo(100000);
+
+    int8_t direction;
+    uint32_t interval = 0;
+    for (int i = 0; i < 5000; i++)
+        interval = ramp.nextStep(direction);
+    TEST_ASSERT_UINT32_WITHIN(1, 1000000 / (uint32_t)DEFAULT_MAX_SPEED, interval);
+
+    // Halving the limit must ramp down, not jump straight to the new interval
+    ramp.setMaxSpeed(DEFAULT_MAX_SPEED / 2);
+    uint32_t previous = ramp.nextStep(direction);
+    uint32_t slowdownSteps = 1;
+    while ((interval = ramp.nextStep(direction)) < 2 * 1000000 / (uint32_t)DEFAULT_MAX_SPEED - 1)
+    {
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(previous, interval + 1);
+        TEST_ASSERT_LESS_THAN_UINT32(previous + 3, interval);
+        previous = interval;
+        slowdownSteps++;
+    }
+
+    // v² - (v/2)² over 2a
+    long expected = (long)(0.75 * DEFAULT_MAX_SPEED * DEFAULT_MAX_SPEED / (2 * DEFAULT_ACCELERATION));
+    TEST_ASSERT_INT32_WITHIN(expected / 10 + 2, expected, slowdownSteps);
+}
+
+// ============================================================================
+// Step Engine Model (jitter comparison)
+// ============================================================================
+
+void test_model_without_interference_is_exact_for_timer(void) {
+    RampGenerator ramp = makeRamp(DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION);
+    ramp.moveTo(10000);
+    std::vector<uint32_t> intervals = StepEngineModel::collect(ramp);
+
+    StepEngineModel model;
+    EngineResult timer = model.runTimer(intervals);
+
+    TEST_ASSERT_EQUAL_UINT32(0, timer.underruns);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(2, timer.intervalError.getMaxAbs());
+}
+
+void test_model_default_profile_timer_beats_polled(void) {
+    RampGenerator ramp = makeRamp(DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION);
+    ramp.moveTo(40000);
+    std::vector<uint32_t> intervals = StepEngineModel::collect(ramp);
+
+    StepEngineModel model;
+    addTypicalInterference(model);
+    EngineResult polled = model.runPolled(intervals);
+    EngineResult timer = model.runTimer(intervals);
+
+    printResult("polled", polled);
+    printResult("timer", timer);
+
+    TEST_ASSERT_EQUAL_UINT32(0, timer.underruns);
+    TEST_ASSERT_LESS_THAN_INT32(polled.intervalError.getMaxAbs(), timer.intervalError.getMaxAbs());
+    TEST_ASSERT_LESS_THAN_DOUBLE(polled.intervalError.getStdDev(), timer.intervalError.getStdDev());
+    // Polled delays accumulate into the move time, the timer schedule does not drift
+    TEST_ASSERT_GREATER_THAN_DOUBLE(timer.moveTimeUs, polled.moveTimeUs);
+    TEST_ASSERT_DOUBLE_WITHIN(10, timer.idealMoveTimeUs, timer.moveTimeUs);
+}
+
+void test_model_high_speed_polled_loses_time(void) {
+    // Near MAX_SPEED the 10µs step interval is only a few loop iterations long,
+    // so every polled step is late and the lateness adds up
+    RampGenerator ramp = makeRamp(100000, 500000);
+    ramp.moveTo(50000);
+    std::vector<uint32_t> intervals = StepEngineModel::collect(ramp);
+
+    StepEngineModel model;
+    EngineResult polled = model.runPolled(intervals);
+    EngineResult timer = model.runTimer(intervals);
+
+    printResult("polled", polled);
+    printResult("timer", timer);
+
+    TEST_ASSERT_GREATER_THAN_DOUBLE(polled.idealMoveTimeUs * 1.05, polled.moveTimeUs);
+    TEST_ASSERT_DOUBLE_WITHIN(10, timer.idealMoveTimeUs, timer.moveTimeUs);
+}
+
+void test_model_long_stall_underruns_timer_queue(void) {
+    RampGenerator ramp = makeRamp(DEFAULT_MAX_SPEED, DEFAULT_ACCELERATION);
+    ramp.moveTo(40000);
+    std::vector<uint32_t> intervals = StepEngineModel::collect(ramp);
+
+    // A stall longer than the lookahead must show up as an underrun, not be hidden
+    StepEngineModel model;
+    model.addInterference({"flash write", 500000, 15000, 15000});
+    EngineResult timer = model.runTimer(intervals);
+
+    printResult("timer", timer);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, timer.underruns);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    // RampGenerator
+    RUN_TEST(test_ramp_emits_exact_distance);
+    RUN_TEST(test_ramp_reverse_direction);
+    RUN_TEST(test_ramp_respects_max_speed);
+    RUN_TEST(test_ramp_stop_decelerates);
+    RUN_TEST(test_ramp_move_time_matches_ideal_trapezoid);
+    RUN_TEST(test_ramp_lowering_max_speed_decelerates);
+
+    // Step engine model
+    RUN_TEST(test_model_without_interference_is_exact_for_timer);
+    RUN_TEST(test_model_default_profile_timer_beats_polled);
+    RUN_TEST(test_model_high_speed_polled_loses_time);
+    RUN_TEST(test_model_long_stall_underruns_timer_queue);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
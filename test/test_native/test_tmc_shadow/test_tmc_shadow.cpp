@@ -0,0 +1,299 @@
+#include <unity.h>
+#include <stdio.h>
+
+#include "tmc2209_uart_model.h"
+
+static constexpr float R_SENSE = 0.11f;
+
+// Chip and shadow as MotorController leaves them after begin(): SpreadCycle, 2 A
+static void boot(Tmc2209Model &chip, TMCShadow &shadow)
+{
+    chip.registers[0x00] = 0x000001C4; // GCONF: pdn_disable, mstep_reg_select, en_SpreadCycle
+    chip.registers[0x6C] = 0x15000053; // CHOPCONF: 1/8 microstepping, toff 3
+    chip.registers[0x10] = 0x00001F01; // IHOLD_IRUN: IRUN 31, IHOLD 1
+    shadow.seed(TMCShadow::Reg::GCONF, chip.registers[0x00]);
+    shadow.seed(TMCShadow::Reg::CHOPCONF, chip.registers[0x6C]);
+    shadow.seed(TMCShadow::Reg::IHOLD_IRUN, chip.registers[0x10]);
+}
+
+// ============================================================================
+// UART Model Tests
+// ============================================================================
+
+void test_model_accepts_valid_datagrams_only(void) {
+    Tmc2209Model chip;
+    UartModelBus bus(chip);
+
+    TEST_ASSERT_TRUE(bus.writeRegister(0x13, 0x12345));
+    TEST_ASSERT_EQUAL_UINT32(0x12345, chip.registers[0x13]);
+    TEST_ASSERT_EQUAL_UINT32(1, chip.registers[Tmc2209Model::IFCNT]);
+
+    bus.failNextWrites = 1;
+    TEST_ASSERT_FALSE(bus.writeRegister(0x13, 0x777));
+    TEST_ASSERT_EQUAL_UINT32(0x12345, chip.registers[0x13]);
+    TEST_ASSERT_EQUAL_UINT32(1, chip.crcErrors);
+
+    uint32_t value = 0;
+    TEST_ASSERT_TRUE(bus.readRegister(0x13, value));
+    TEST_ASSERT_EQUAL_UINT32(0x12345, value);
+    TEST_ASSERT_EQUAL_UINT32(8 + 8 + 4 + 8, bus.bytes);
+}
+
+// ============================================================================
+// TMCShadow Tests
+// ============================================================================
+
+void test_redundant_writes_never_reach_the_uart(void) {
+    Tmc2209Model chip;
+    UartModelBus bus(chip);
+    TMCShadow shadow(R_SENSE);
+    boot(chip, shadow);
+
+    // Motor loop asking for the mode it already has, every iteration
+    for (int i = 0; i < 1000; i++)
+        TEST_ASSERT_FALSE(shadow.setSpreadCycle(true));
+    TEST_ASSERT_FALSE(shadow.isPending());
+    TEST_ASSERT_EQUAL_UINT8(0, shadow.flush(bus));
+    TEST_ASSERT_EQUAL_UINT32(0, bus.bytes);
+    TEST_ASSERT_EQUAL_UINT32(1000, shadow.getSkippedCount());
+}
+
+void test_changes_are_written_by_the_worker(void) {
+    Tmc2209Model chip;
+    UartModelBus bus(chip);
+    TMCShadow shadow(R_SENSE);
+    boot(chip, shadow);
+
+    TEST_ASSERT_TRUE(shadow.setSpreadCycle(false));
+    TEST_ASSERT_EQUAL_UINT32(0, bus.bytes); // Nothing on the wire from the setter
+    TEST_ASSERT_EQUAL_UINT32(0x000001C4, chip.registers[0x00]);
+
+    TEST_ASSERT_EQUAL_UINT8(1, shadow.flush(bus));
+    TEST_ASSERT_EQUAL_UINT32(0x000001C0, chip.registers[0x00]); // Only en_SpreadCycle cleared
+    TEST_ASSERT_FALSE(shadow.isPending());
+}
+
+void test_flapping_between_flushes_coalesces(void) {
+    Tmc2209Model chip;
+    UartModelBus bus(chip);
+    TMCShadow shadow(R_SENSE);
+    boot(chip, shadow);
+
+    // Back where the chip already is: no write at all
+    shadow.setSpreadCycle(false);
+    shadow.setSpreadCycle(true);
+    TEST_ASSERT_EQUAL_UINT8(0, shadow.flush(bus));
+
+    // Odd number of flips: one write of the final value
+    shadow.setSpreadCycle(false);
+    shadow.setSpreadCycle(true);
+    shadow.setSpreadCycle(false);
+    TEST_ASSERT_EQUAL_UINT8(1, shadow.flush(bus));
+    TEST_ASSERT_EQUAL_UINT32(1, bus.writes);
+    TEST_ASSERT_EQUAL_UINT32(0x000001C0, chip.registers[0x00]);
+}
+
+void test_threshold_crossings_cost_the_motor_loop_nothing(void) {
+    // Speed profile crossing the StealthChop/SpreadCycle threshold on every move,
+    // with ripple around it. Direct writes block the motor loop on the UART;
+    // through the shadow the loop only touches memory.
+    Tmc2209Model directChip, chip;
+    UartModelBus directBus(directChip), bus(chip);
+    TMCShadow shadow(R_SENSE);
+    boot(chip, shadow);
+
+    bool directSpreadCycle = true;
+    double loopBusySeconds = 0;
+    const double threshold = 7200;
+    for (int move = 0; move < 20; move++)
+    {
+        for (int i = 0; i < 2000; i++)
+        {
+            // Up to 1.5x threshold and back, with ±2% ripple on the plateau
+            double phase = i < 1000 ? i / 1000.0 : (2000 - i) / 1000.0;
+            double speed = threshold * 1.5 * phase * (1 + 0.02 * ((i % 7) - 3) / 3.0);
+            bool spreadCycle = speed >= threshold;
+
+            // Old path: en_spreadCycle() on the motor loop whenever the mode changes
+            if (spreadCycle != directSpreadCycle)
+            {
+                double before = directBus.busySeconds;
+                directBus.writeRegister(0x00, spreadCycle ? 0x1C4 : 0x1C0);
+                loopBusySeconds += directBus.busySeconds - before;
+                directSpreadCycle = spreadCycle;
+            }
+
+            // New path: shadow on the loop, worker flushing every 5 ms (every 50 iterations)
+            uint32_t wireBytes = bus.bytes;
+            shadow.setSpreadCycle(spreadCycle);
+            TEST_ASSERT_EQUAL_UINT32(wireBytes, bus.bytes);
+            if (i % 50 == 0)
+                shadow.flush(bus);
+        }
+    }
+    shadow.flush(bus);
+
+    TEST_ASSERT_EQUAL_UINT32(chip.registers[0x00] & TMCShadow::GCONF_EN_SPREADCYCLE ? 1 : 0, directSpreadCycle ? 1 : 0);
+    TEST_ASSERT_TRUE(bus.writes < directBus.writes); // Ripple within a flush period never hits the wire
+
+    char line[160];
+    snprintf(line, sizeof(line), "direct: %u writes, %.1f ms blocking the motor loop; shadow: %u writes, 0 ms on the loop (%.1f ms in the worker)",
+             directBus.writes, loopBusySeconds * 1000, bus.writes, bus.busySeconds * 1000);
+    TEST_MESSAGE(line);
+}
+
+void test_run_current_encoding(void) {
+    Tmc2209Model chip;
+    UartModelBus bus(chip);
+    TMCShadow shadow(R_SENSE);
+    boot(chip, shadow);
+
+    // Full current is the boot value: nothing to write
+    TEST_ASSERT_FALSE(shadow.setRunCurrent(2000));
+    TEST_ASSERT_EQUAL_UINT8(31, TMCShadow::currentScale(2000, R_SENSE, false));
+
+    // 50% stays in the normal range
+    TEST_ASSERT_TRUE(shadow.setRunCurrent(1000));
+    shadow.flush(bus);
+    TEST_ASSERT_EQUAL_UINT32(17, (chip.registers[0x10] >> 8) & 0x1F);
+    TEST_ASSERT_EQUAL_UINT32(1, chip.registers[0x10] & 0x1F); // IHOLD kept
+    TEST_ASSERT_FALSE(chip.registers[0x6C] & TMCShadow::CHOPCONF_VSENSE);
+
+    // Low current switches to the sensitive range; vsense lands before the new IRUN
+    chip.writeOrder.clear();
+    TEST_ASSERT_TRUE(shadow.setRunCurrent(300));
+    shadow.flush(bus);
+    TEST_ASSERT_TRUE(chip.registers[0x6C] & TMCShadow::CHOPCONF_VSENSE);
+    TEST_ASSERT_EQUAL_UINT32(8, (chip.registers[0x10] >> 8) & 0x1F);
+    TEST_ASSERT_EQUAL_UINT32(2, chip.writeOrder.size());
+    TEST_ASSERT_EQUAL_UINT8(0x6C, chip.writeOrder[0]);
+    TEST_ASSERT_EQUAL_UINT8(0x10, chip.writeOrder[1]);
+}
+
+void test_status_readbacks_come_from_the_shadow(void) {
+    Tmc2209Model chip;
+    UartModelBus bus(chip);
+    TMCShadow shadow(R_SENSE);
+    chip.registers[0x06] = 0x21000041; // IOIN: version 0x21
+    chip.registers[0x41] = 180;        // SG_RESULT
+
+    uint32_t value;
+    TEST_ASSERT_FALSE(shadow.getStatus(TMCShadow::Status::IOIN, value));
+
+    TEST_ASSERT_TRUE(shadow.poll(bus, TMCShadow::Status::IOIN));
+    TEST_ASSERT_TRUE(shadow.poll(bus, TMCShadow::Status::SG_RESULT));
+    uint32_t bytes = bus.bytes;
+    for (int i = 0; i < 100; i++)
+    {
+        TEST_ASSERT_TRUE(shadow.getStatus(TMCShadow::Status::IOIN, value));
+        TEST_ASSERT_EQUAL_UINT32(0x21000041, value);
+    }
+    TEST_ASSERT_EQUAL_UINT32(bytes, bus.bytes);
+    TEST_ASSERT_TRUE(shadow.getStatus(TMCShadow::Status::SG_RESULT, value));
+    TEST_ASSERT_EQUAL_UINT32(180, value);
+    TEST_ASSERT_EQUAL_UINT32(1, shadow.getStatusReads(TMCShadow::Status::SG_RESULT));
+}
+
+void test_failed_write_is_retried(void) {
+    Tmc2209Model chip;
+    UartModelBus bus(chip);
+    TMCShadow shadow(R_SENSE);
+    boot(chip, shadow);
+
+    shadow.set(TMCShadow::Reg::TPWMTHRS, 500);
+    bus.failNextWrites = 1;
+    TEST_ASSERT_EQUAL_UINT8(0, shadow.flush(bus));
+    TEST_ASSERT_TRUE(shadow.isPending());
+    TEST_ASSERT_EQUAL_UINT32(1, shadow.getErrorCount());
+
+    TEST_ASSERT_EQUAL_UINT8(1, shadow.flush(bus));
+    TEST_ASSERT_EQUAL_UINT32(500, chip.registers[0x13]);
+}
+
+// ============================================================================
+// StealthChop Threshold Tests
+// ============================================================================
+
+void test_threshold_converts_to_tstep_at_the_current_mres(void) {
+    Tmc2209Model chip;
+    UartModelBus bus(chip);
+    TMCShadow shadow(R_SENSE);
+    boot(chip, shadow);
+
+    // 50% of the default max speed at 1/8: 12 MHz * 8 / (256 * 7200 steps/s)
+    TEST_ASSERT_EQUAL_UINT16(8, shadow.getMicrosteps());
+    TEST_ASSERT_EQUAL_UINT32(52, TMCShadow::tstep(7200, 8));
+    TEST_ASSERT_EQUAL_UINT32(104, TMCShadow::tstep(7200, 16));
+    TEST_ASSERT_EQUAL_UINT32(TMCShadow::TPWMTHRS_MAX, TMCShadow::tstep(0, 8));   // SpreadCycle whenever moving
+    TEST_ASSERT_EQUAL_UINT32(TMCShadow::TPWMTHRS_MAX, TMCShadow::tstep(0.3f, 8)); // Saturates at 20 bits
+
+    TEST_ASSERT_TRUE(shadow.setStealthChopThreshold(7200));
+    TEST_ASSERT_FALSE(shadow.setStealthChopThreshold(7200));
+    shadow.flush(bus);
+    TEST_ASSERT_EQUAL_UINT32(52, chip.registers[0x13]);
+
+    // MRES 4 is 1/16: the same speed is twice the TSTEP units
+    shadow.setField(TMCShadow::Reg::CHOPCONF, TMCShadow::MRES_MASK, 4ul << TMCShadow::MRES_SHIFT);
+    TEST_ASSERT_EQUAL_UINT16(16, shadow.getMicrosteps());
+    shadow.setStealthChopThreshold(7200);
+    shadow.flush(bus);
+    TEST_ASSERT_EQUAL_UINT32(104, chip.registers[0x13]);
+}
+
+void test_chopper_mode_reported_from_drv_status(void) {
+    Tmc2209Model chip;
+    UartModelBus bus(chip);
+    TMCShadow shadow(R_SENSE);
+
+    uint32_t drvStatus;
+    chip.registers[0x6F] = TMCShadow::DRV_STATUS_STEALTH | (20ul << 16);
+    shadow.poll(bus, TMCShadow::Status::DRV_STATUS);
+    TEST_ASSERT_TRUE(shadow.getStatus(TMCShadow::Status::DRV_STATUS, drvStatus));
+    TEST_ASSERT_TRUE(drvStatus & TMCShadow::DRV_STATUS_STEALTH);
+
+    // Driver crossed TPWMTHRS on its own: the next poll shows SpreadCycle
+    chip.registers[0x6F] = 20ul << 16;
+    shadow.poll(bus, TMCShadow::Status::DRV_STATUS);
+    shadow.getStatus(TMCShadow::Status::DRV_STATUS, drvStatus);
+    TEST_ASSERT_FALSE(drvStatus & TMCShadow::DRV_STATUS_STEALTH);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    // UART model (1 test)
+    RUN_TEST(test_model_accepts_valid_datagrams_only);
+
+    // TMCShadow (7 tests)
+    RUN_TEST(test_redundant_writes_never_reach_the_uart);
+    RUN_TEST(test_changes_are_written_by_the_worker);
+    RUN_TEST(test_flapping_between_flushes_coalesces);
+    RUN_TEST(test_threshold_crossings_cost_the_motor_loop_nothing);
+    RUN_TEST(test_run_current_encoding);
+    RUN_TEST(test_status_readbacks_come_from_the_shadow);
+    RUN_TEST(test_failed_write_is_retried);
+
+    // StealthChop threshold (2 tests)
+    RUN_TEST(test_threshold_converts_to_tstep_at_the_current_mres);
+    RUN_TEST(test_chopper_mode_reported_from_drv_status);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "../../../src/modules/TMCShadow/TMCShadow.cpp"
+
+// Byte-level stand-in for a TMC2209 on its single-wire UART
+// Datagrams as in the datasheet: sync nibble 0x05, slave address, register
+// (bit 7 set for writes), 32-bit data MSB first, CRC8 (poly 0x07, LSB-first
+// bit order). Writes with a bad CRC are dropped; good ones bump IFCNT.
+struct Tmc2209Model
+{
+    static constexpr uint8_t IFCNT = 0x02;
+
+    uint32_t registers[128];
+    uint8_t slaveAddress;
+    uint32_t crcErrors = 0;
+    std::vector<uint8_t> writeOrder; // Register addresses in the order writes arrived
+
+    Tmc2209Model(uint8_t address = 0) : slaveAddress(address) { memset(registers, 0, sizeof(registers)); }
+
+    static uint8_t crc(const uint8_t *datagram, size_t length)
+    {
+        uint8_t crc = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            uint8_t byte = datagram[i];
+            for (uint8_t bit = 0; bit < 8; bit++)
+            {
+                if ((crc >> 7) ^ (byte & 0x01))
+                    crc = (uint8_t)((crc << 1) ^ 0x07);
+                else
+                    crc = (uint8_t)(crc << 1);
+                byte >>= 1;
+            }
+        }
+        return crc;
+    }
+
+    void receiveWrite(const uint8_t datagram[8])
+    {
+        if (datagram[0] != 0x05 || datagram[1] != slaveAddress || !(datagram[2] & 0x80) ||
+            crc(datagram, 7) != datagram[7])
+        {
+            crcErrors++;
+            return;
+        }
+        uint8_t reg = datagram[2] & 0x7F;
+        registers[reg] = (uint32_t)datagram[3] << 24 | (uint32_t)datagram[4] << 16 |
+                         (uint32_t)datagram[5] << 8 | datagram[6];
+        registers[IFCNT] = (registers[IFCNT] + 1) & 0xFF;
+        writeOrder.push_back(reg);
+    }
+
+    // Read request in, reply datagram out; false if the request was corrupt
+    bool receiveRead(const uint8_t request[4], uint8_t reply[8])
+    {
+        if (request[0] != 0x05 || request[1] != slaveAddress || crc(request, 3) != request[3])
+        {
+            crcErrors++;
+            return false;
+        }
+        uint8_t reg = request[2] & 0x7F;
+        uint32_t value = registers[reg];
+        reply[0] = 0x05;
+        reply[1] = 0xFF; // Master address
+        reply[2] = reg;
+        reply[3] = value >> 24;
+        reply[4] = value >> 16;
+        reply[5] = value >> 8;
+        reply[6] = value;
+        reply[7] = crc(reply, 7);
+        return true;
+    }
+};
+
+// TMCBus over the model, accounting the time the caller is blocked on the wire
+// at 115200 baud, 10 bits per byte, plus the chip's default SENDDELAY (8 bit times)
+struct UartModelBus : TMCBus
+{
+    static constexpr double BAUD = 115200.0;
+    static constexpr uint32_t SENDDELAY_BITS = 8;
+
+    Tmc2209Model &chip;
+    uint32_t bytes = 0;
+    uint32_t writes = 0;
+    uint32_t reads = 0;
+    double busySeconds = 0;
+    uint32_t failNextWrites = 0; // Simulated line errors
+
+    UartModelBus(Tmc2209Model &model) : chip(model) {}
+
+    bool writeRegister(uint8_t address, uint32_t value) override
+    {
+        uint8_t datagram[8] = {0x05, chip.slaveAddress, (uint8_t)(address | 0x80),
+                               (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value, 0};
+        datagram[7] = Tmc2209Model::crc(datagram, 7);
+        if (failNextWrites)
+        {
+            failNextWrites--;
+            datagram[5] ^= 0x10; // Corrupted on the wire
+        }
+        transfer(8, 0);
+        writes++;
+        uint32_t before = chip.registers[Tmc2209Model::IFCNT];
+        chip.receiveWrite(datagram);
+        return chip.registers[Tmc2209Model::IFCNT] != before;
+    }
+
+    bool readRegister(uint8_t address, uint32_t &value) override
+    {
+        uint8_t request[4] = {0x05, chip.slaveAddress, address, 0};
+        request[3] = Tmc2209Model::crc(request, 3);
+        uint8_t reply[8];
+        transfer(4, SENDDELAY_BITS);
+        reads++;
+        if (!chip.receiveRead(request, reply))
+            return false;
+        transfer(8, 0);
+        if (Tmc2209Model::crc(reply, 7) != reply[7])
+            return false;
+        value = (uint32_t)reply[3] << 24 | (uint32_t)reply[4] << 16 | (uint32_t)reply[5] << 8 | reply[6];
+        return true;
+    }
+
+    void transfer(uint32_t count, uint32_t extraBits)
+    {
+        bytes += count;
+        busySeconds += (count * 10 + extraBits) / BAUD;
+    }
+};
@@ -0,0 +1,176 @@
+#include <unity.h>
+#include <math.h>
+
+#include "../../../src/modules/VelocityObserver/VelocityObserver.cpp"
+
+static constexpr uint32_t SAMPLE_US = 500; // EncoderSampler rate (2 kHz)
+
+// Encoder reading of a true multi-turn position (counts), quantised like the MT6816
+static uint16_t encoderReading(double position)
+{
+    long counts = (long)floor(position) % VelocityObserver::COUNTS_PER_REV;
+    return (uint16_t)(counts < 0 ? counts + VelocityObserver::COUNTS_PER_REV : counts);
+}
+
+// ============================================================================
+// VelocityObserver Tests
+// ============================================================================
+
+void test_first_sample_initialises_at_rest(void) {
+    VelocityObserver observer;
+    TEST_ASSERT_FALSE(observer.isInitialized());
+    observer.update(1234, 1000);
+    TEST_ASSERT_TRUE(observer.isInitialized());
+    TEST_ASSERT_EQUAL_INT32(1234, observer.getPosition());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, observer.getVelocity());
+}
+
+void test_constant_velocity_tracked_through_wraps(void) {
+    // 5 rev/s forward: the angle wraps 5 times a second
+    VelocityObserver observer;
+    const double speed = 5.0 * VelocityObserver::COUNTS_PER_REV;
+    double position = 16000;
+    uint32_t time = 0;
+    for (int i = 0; i < 2000; i++)
+    {
+        observer.update(encoderReading(position), time);
+        position += speed * SAMPLE_US * 1e-6;
+        time += SAMPLE_US;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(speed * 0.002, speed, observer.getVelocity());
+    TEST_ASSERT_INT32_WITHIN(4, (long)(position - speed * SAMPLE_US * 1e-6), observer.getPosition());
+    TEST_ASSERT_FLOAT_WITHIN(1800.0f * 0.002f, 1800.0f, observer.getVelocityDegPerSec());
+}
+
+void test_reverse_through_zero(void) {
+    VelocityObserver observer;
+    const double speed = -3000;
+    double position = 200;
+    uint32_t time = 0;
+    for (int i = 0; i < 2000; i++)
+    {
+        observer.update(encoderReading(position), time);
+        position += speed * SAMPLE_US * 1e-6;
+        time += SAMPLE_US;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(fabs(speed) * 0.005, speed, observer.getVelocity());
+    TEST_ASSERT_INT32_WITHIN(4, (long)floor(position - speed * SAMPLE_US * 1e-6), observer.getPosition());
+    TEST_ASSERT_TRUE(observer.getPosition() < 0);
+}
+
+void test_constant_acceleration_without_lag(void) {
+    // Type-3 loop: a ramp at constant acceleration leaves no steady-state velocity error
+    VelocityObserver observer;
+    const double accel = 80000; // counts/s²
+    uint32_t time = 0;
+    double t = 0;
+    for (int i = 0; i < 2000; i++)
+    {
+        observer.update(encoderReading(0.5 * accel * t * t), time);
+        t += SAMPLE_US * 1e-6;
+        time += SAMPLE_US;
+    }
+    double lastT = t - SAMPLE_US * 1e-6;
+    TEST_ASSERT_FLOAT_WITHIN(accel * lastT * 0.002, accel * lastT, observer.getVelocity());
+    TEST_ASSERT_FLOAT_WITHIN(accel * 0.15, accel, observer.getAcceleration()); // Quantisation noise shows most in acceleration
+}
+
+void test_bandwidth_sets_settling_time(void) {
+    // Velocity step: a wider loop reaches 98% sooner
+    float bandwidths[2] = {10.0f, 80.0f};
+    int settle[2];
+    for (int b = 0; b < 2; b++)
+    {
+        VelocityObserver observer;
+        observer.setBandwidth(bandwidths[b]);
+        const double speed = 20000;
+        double position = 0;
+        uint32_t time = 0;
+        settle[b] = -1;
+        for (int i = 0; i < 4000 && settle[b] < 0; i++)
+        {
+            observer.update(encoderReading(position), time);
+            if (i > 0 && fabs(observer.getVelocity() - speed) < speed * 0.02 &&
+                fabs(observer.getAcceleration()) < speed * bandwidths[b])
+                settle[b] = i;
+            position += speed * SAMPLE_US * 1e-6;
+            time += SAMPLE_US;
+        }
+        TEST_ASSERT_GREATER_THAN_INT32(0, settle[b]);
+    }
+    TEST_ASSERT_LESS_THAN_INT32(settle[0], settle[1]);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(40, settle[1]); // 20 ms at 80 Hz
+}
+
+void test_bandwidth_is_clamped(void) {
+    VelocityObserver observer;
+    observer.setBandwidth(0);
+    TEST_ASSERT_EQUAL_FLOAT(VelocityObserver::MIN_BANDWIDTH_HZ, observer.getBandwidth());
+    observer.setBandwidth(10000);
+    TEST_ASSERT_EQUAL_FLOAT(VelocityObserver::MAX_BANDWIDTH_HZ, observer.getBandwidth());
+}
+
+void test_gap_restarts_from_sample(void) {
+    VelocityObserver observer;
+    uint32_t time = 0;
+    double position = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        observer.update(encoderReading(position), time);
+        position += 10;
+        time += SAMPLE_US;
+    }
+    TEST_ASSERT_TRUE(observer.getVelocity() > 15000);
+
+    // Samples stopped for longer than MAX_GAP_US: no velocity from a stale prediction
+    time += VelocityObserver::MAX_GAP_US + 1;
+    observer.update(5000, time);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, observer.getVelocity());
+    TEST_ASSERT_EQUAL_INT32(5000, observer.getAngle());
+}
+
+void test_timestamp_wrap(void) {
+    VelocityObserver observer;
+    uint32_t time = 0xFFFFFFFFu - 100 * SAMPLE_US;
+    double position = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        observer.update(encoderReading(position), time);
+        position += 2;
+        time += SAMPLE_US;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(40.0f, 4000.0f, observer.getVelocity());
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_first_sample_initialises_at_rest);
+    RUN_TEST(test_constant_velocity_tracked_through_wraps);
+    RUN_TEST(test_reverse_through_zero);
+    RUN_TEST(test_constant_acceleration_without_lag);
+    RUN_TEST(test_bandwidth_sets_settling_time);
+    RUN_TEST(test_bandwidth_is_clamped);
+    RUN_TEST(test_gap_restarts_from_sample);
+    RUN_TEST(test_timestamp_wrap);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty loop for native testing
+}
+
+// For native platform, provide main function
+#ifdef UNIT_TEST
+int main(int argc, char **argv) {
+    setup();
+    return 0;
+}
+#endif
@@ -2,6 +2,7 @@ import React, { useState, useEffect, useRef } from 'react';
 import { Card, CardContent, CardHeader, CardTitle } from '@/components/ui/card';
 import { Button } from '@/components/ui/button';
 import { Activity, Wifi, WifiOff, Trash2, RotateCcw } from 'lucide-react';
+import type { DebugFrame } from '@/types';
 import './DebugConsole.css';
 
 const DebugConsole: React.FC = () => {
@@ -10,6 +11,8 @@ const DebugConsole: React.FC = () => {
   const [connectionStatus, setConnectionStatus] = useState<'disconnected' | 'connecting' | 'connected'>('disconnected');
   const consoleRef = useRef<HTMLDivElement>(null);
   const wsRef = useRef<WebSocket | null>(null);
+  // Sequence number of the next line we need; sent as ?since= on reconnect
+  const nextSeqRef = useRef<number | null>(null);
 
   const connectWebSocket = () => {
     if (wsRef.current) {
@@ -20,7 +23,8 @@ const DebugConsole: React.FC = () => {
     setMessages(prev => [...prev, '[Connecting to debug stream...]']);
 
     const protocol = window.location.protocol === 'https:' ? 'wss:' : 'ws:';
-    const wsUrl = `${protocol}//${window.location.host}/debug`;
+    const since = nextSeqRef.current !== null ? `?since=${nextSeqRef.current}` : '';
+    const wsUrl = `${protocol}//${window.location.host}/debug${since}`;
 
     const ws = new WebSocket(wsUrl);
 
@@ -30,7 +34,21 @@ const DebugConsole: React.FC = () => {
     };
 
     ws.onmessage = (event) => {
-      setMessages(prev => [...prev, event.data]);
+      let frame: DebugFrame;
+      try {
+        frame = JSON.parse(event.data);
+      } catch {
+        setMessages(prev => [...prev, event.data]);
+        return;
+      }
+
+      if (frame.type === 'gap') {
+        nextSeqRef.current = frame.to;
+        setMessages(prev => [...prev, `[${frame.to - frame.from} lines lost]`]);
+      } else {
+        nextSeqRef.current = frame.seq + frame.lines.length;
+        setMessages(prev => [...prev, ...frame.lines]);
+      }
     };
 
     ws.onclose = () => {
@@ -10,6 +10,27 @@ export interface MotorStatus {
     max: boolean;
     any: boolean;
   };
+  target?: number;
+  queueDepth?: number;
+  queueFree?: number;
+  followingError?: number;
+  followingErrorFault?: boolean;
+  runCurrentPercent?: number;
+  servoCorrections?: number;
+  encoderSpeed?: number;
+  encoderAngle?: number;
+  positionRestored?: boolean;
+  encoderCalibrated?: boolean;
+  encoderCalibrating?: boolean;
+  homing?: boolean;
+  stealthChop?: boolean;
+  microsteps?: number;
+  limitRecovery?: 'idle' | 'latched' | 'backingOff' | 'done' | 'failed';
+  limitRecoveryFailure?: string;
+  limitStopUs?: number;
+  limitHandledUs?: number;
+  limitGlitches?: number;
+  logDropped?: number;
 }
 
 export interface PositionUpdate {
@@ -25,6 +46,14 @@ export interface MotorConfig {
   maxLimit: number;
   useStealthChop: boolean;
   freewheelAfterMove: boolean;
+  servoMode?: boolean;
+  stallThreshold?: number;
+  hardwareModeSwitch?: boolean;
+  modeHysteresis?: number;
+  adaptiveMicrosteps?: boolean;
+  limitBackoff?: number;
+  softLimits?: boolean;
+  softLimitZone?: number; // Steps crossed at creep speed next to each limit
 }
 
 export interface ConfigUpdatedResponse {
@@ -38,11 +67,50 @@ export interface ErrorResponse {
   message: string;
 }
 
+// Latency per InputTask consumer: ISR post (or due time) to the consumer running
+export interface InputSourceStats {
+  name: string;
+  runs: number;
+  meanUs: number;
+  maxUs: number;
+}
+
+export interface InputStatsResponse {
+  type: 'inputStats';
+  sources: InputSourceStats[];
+}
+
+// Frames on the /debug WebSocket: history replay and live lines alike
+export interface DebugLogFrame {
+  type: 'log';
+  seq: number; // Sequence number of lines[0]
+  lines: string[];
+}
+
+export interface DebugGapFrame {
+  type: 'gap';
+  from: number; // Lines from..to-1 were evicted before they could be sent
+  to: number;
+}
+
+export type DebugFrame = DebugLogFrame | DebugGapFrame;
+
+// Runtime level and compile-time ceiling per log module
+export type LogLevel = 'error' | 'warn' | 'info' | 'debug';
+
+export interface LogLevelsResponse {
+  type: 'logLevels';
+  levels: Record<string, LogLevel>;
+  max: Record<string, LogLevel>;
+}
+
 export type WebSocketMessage =
   | MotorStatus
   | PositionUpdate
   | MotorConfig
   | ConfigUpdatedResponse
+  | InputStatsResponse
+  | LogLevelsResponse
   | ErrorResponse;
 
 // Command types to send to controller
@@ -52,6 +120,13 @@ export interface MoveCommand {
   speed: number;
 }
 
+// Appends to the controller's motion queue; same-direction moves blend without stopping
+export interface QueueMoveCommand {
+  command: 'queueMove';
+  position: number;
+  speed: number;
+}
+
 export interface EmergencyStopCommand {
   command: 'emergencyStop';
 }
@@ -74,6 +149,41 @@ export interface SetConfigCommand {
   acceleration?: number;
   useStealthChop?: boolean;
   freewheelAfterMove?: boolean;
+  servoMode?: boolean;
+  stallThreshold?: number;
+  hardwareModeSwitch?: boolean;
+  modeHysteresis?: number;
+  adaptiveMicrosteps?: boolean;
+  limitBackoff?: number;
+  softLimits?: boolean;
+  softLimitZone?: number; // Steps crossed at creep speed next to each limit
+}
+
+// Sweeps one revolution and stores the encoder nonlinearity table
+export interface CalibrateEncoderCommand {
+  command: 'calibrateEncoder';
+}
+
+// Sensorless homing against the hard stop at one end
+export interface HomeCommand {
+  command: 'home';
+  direction: 'min' | 'max';
+  maxTravel?: number;
+}
+
+export interface GetInputStatsCommand {
+  command: 'getInputStats';
+}
+
+// Module name from getLogLevels, or 'all'
+export interface SetLogLevelCommand {
+  command: 'setLogLevel';
+  module: string;
+  level: LogLevel;
+}
+
+export interface GetLogLevelsCommand {
+  command: 'getLogLevels';
 }
 
 export interface JogStartCommand {
@@ -88,11 +198,17 @@ export interface JogStopCommand {
 
 export type ControlCommand =
   | MoveCommand
+  | QueueMoveCommand
   | EmergencyStopCommand
   | ResetCommand
   | StatusCommand
   | GetConfigCommand
   | SetConfigCommand
+  | CalibrateEncoderCommand
+  | HomeCommand
+  | GetInputStatsCommand
+  | SetLogLevelCommand
+  | GetLogLevelsCommand
   | JogStartCommand
   | JogStopCommand;
 